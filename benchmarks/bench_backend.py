@@ -0,0 +1,131 @@
+"""Per-call overhead of the extension module and the cffi backend.
+
+Times the CRC, protect and check functions with small frames, where the
+cost of the call dominates, once per backend (see e2e._backend). Run it
+under PyPy to see the cpyext overhead which the cffi backend avoids:
+
+    python benchmarks/bench_backend.py
+    python benchmarks/bench_backend.py --interpreters python3.12 pypy3.10 --json backend.json
+
+Each interpreter and backend runs in a subprocess with ``E2E_BACKEND`` set.
+A backend which is not available in an interpreter is reported as such.
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+FRAME_SIZE = 8
+BACKENDS = ("extension", "cffi")
+
+
+def _cases():
+    import e2e
+
+    p01 = bytearray(FRAME_SIZE)
+    p05 = bytearray(FRAME_SIZE)
+    p07 = bytearray(20)
+    e2e.p01.e2e_p01_protect(p01, FRAME_SIZE - 1, 0x1234)
+    e2e.p05.e2e_p05_protect(p05, FRAME_SIZE - 2, 0x1234)
+    e2e.p07.e2e_p07_protect(p07, 20, 0x0A0B0C0D)
+    data = bytes(FRAME_SIZE)
+    return {
+        "crc.calculate_crc8": lambda: e2e.crc.calculate_crc8(data),
+        "crc.calculate_crc32": lambda: e2e.crc.calculate_crc32(data),
+        "p01.e2e_p01_check": lambda: e2e.p01.e2e_p01_check(p01, FRAME_SIZE - 1, 0x1234),
+        "p05.e2e_p05_protect": lambda: e2e.p05.e2e_p05_protect(
+            p05, FRAME_SIZE - 2, 0x1234
+        ),
+        "p05.e2e_p05_check": lambda: e2e.p05.e2e_p05_check(p05, FRAME_SIZE - 2, 0x1234),
+        "p07.e2e_p07_check": lambda: e2e.p07.e2e_p07_check(p07, 20, 0x0A0B0C0D),
+    }
+
+
+def measure(args):
+    """Return the best nanoseconds per call of each case."""
+    results = {}
+    for name, func in _cases().items():
+        if args.filter and not re.search(args.filter, name):
+            continue
+        for _ in range(args.calls // 10):  # let the JIT compile the loop
+            func()
+        best = float("inf")
+        for _ in range(args.repeats):
+            t0 = time.perf_counter()
+            for _ in range(args.calls):
+                func()
+            best = min(best, (time.perf_counter() - t0) / args.calls)
+        results[name] = best * 1e9
+    return results
+
+
+def run(interpreter, backend, args):
+    forwarded = ["--calls", str(args.calls), "--repeats", str(args.repeats)]
+    if args.filter:
+        forwarded += ["--filter", args.filter]
+    env = dict(os.environ, E2E_BACKEND=backend)
+    output = subprocess.run(
+        [interpreter, os.path.abspath(__file__), "--raw", *forwarded],
+        check=True,
+        stdout=subprocess.PIPE,
+        env=env,
+    ).stdout
+    return json.loads(output)
+
+
+def print_report(report):
+    print(f"{report['executable']}: {report['implementation']} {report['version']}")
+    results = report["backends"]
+    names = next((r for r in results.values() if r), {})
+    print(f"{'function':<24}" + "".join(f"{b + ' [ns]':>18}" for b in results))
+    for name in names:
+        cells = [results[b].get(name) for b in results]
+        print(
+            f"{name:<24}"
+            + "".join(f"{'n/a':>18}" if c is None else f"{c:>18.1f}" for c in cells)
+        )
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--calls", type=int, default=1_000_000)
+    parser.add_argument("--repeats", type=int, default=5)
+    parser.add_argument("--filter", help="regular expression to select functions")
+    parser.add_argument("--interpreters", nargs="+", default=[sys.executable])
+    parser.add_argument("--json", help="write the results to this file")
+    parser.add_argument("--raw", action="store_true", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.raw:
+        from e2e import _backend
+
+        # an unavailable backend falls back to the extension module, report nothing
+        requested = os.environ.get("E2E_BACKEND", _backend.NAME)
+        results = measure(args) if requested == _backend.NAME else {}
+        info = {
+            "executable": sys.executable,
+            "implementation": sys.implementation.name,
+            "version": sys.version.split()[0],
+        }
+        json.dump({"info": info, "results": results}, sys.stdout)
+        return
+
+    reports = []
+    for interpreter in args.interpreters:
+        runs = {backend: run(interpreter, backend, args) for backend in BACKENDS}
+        report = dict(runs["extension"]["info"])
+        report["backends"] = {b: r["results"] for b, r in runs.items()}
+        reports.append(report)
+        print_report(report)
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(reports, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
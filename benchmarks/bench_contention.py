@@ -0,0 +1,84 @@
+"""Throughput of e2e.Router.check_batch with a growing number of threads.
+
+All threads check frames of the same small set of messages, so they
+compete for the same counter state. Run it on a free-threaded
+interpreter (e.g. python3.13t) to see the scaling of the lock-free
+state; with the GIL, threads only overlap while check_batch runs
+without the GIL.
+
+    python benchmarks/bench_contention.py --messages 4 --threads 1 2 4 8
+"""
+
+import argparse
+import os
+import sys
+import threading
+import time
+
+import e2e
+
+
+def make_frames(message_ids, frames_per_message):
+    ids = []
+    frames = []
+    for counter in range(frames_per_message):
+        for message_id in message_ids:
+            data = bytearray(8)
+            data[2] = (counter - 1) & 0xFF
+            e2e.p05.e2e_p05_protect(data, 6, message_id, increment_counter=True)
+            ids.append(message_id)
+            frames.append(bytes(data))
+    return ids, frames
+
+
+def run(thread_count, router, ids, frames, duration):
+    stop = threading.Event()
+    start = threading.Barrier(thread_count + 1)
+    counts = [0] * thread_count
+
+    def worker(index):
+        start.wait()
+        while not stop.is_set():
+            router.check_batch(ids, frames)
+            counts[index] += len(frames)
+
+    threads = [
+        threading.Thread(target=worker, args=(i,)) for i in range(thread_count)
+    ]
+    for thread in threads:
+        thread.start()
+    start.wait()
+    t0 = time.perf_counter()
+    time.sleep(duration)
+    stop.set()
+    for thread in threads:
+        thread.join()
+    return sum(counts) / (time.perf_counter() - t0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--messages", type=int, default=4)
+    parser.add_argument("--batch", type=int, default=4096)
+    parser.add_argument("--duration", type=float, default=1.0)
+    parser.add_argument(
+        "--threads", type=int, nargs="+", default=[1, 2, 4, 8, os.cpu_count()]
+    )
+    args = parser.parse_args()
+
+    message_ids = list(range(1, args.messages + 1))
+    router = e2e.Router({i: e2e.Config(5, i, 6) for i in message_ids})
+    ids, frames = make_frames(message_ids, max(1, args.batch // args.messages))
+
+    gil = getattr(sys, "_is_gil_enabled", lambda: True)()
+    print(f"Python {sys.version.split()[0]}, GIL {'enabled' if gil else 'disabled'}")
+    print(f"{'threads':>8} {'frames/s':>14} {'speedup':>8}")
+    baseline = None
+    for thread_count in sorted(set(args.threads)):
+        rate = run(thread_count, router, ids, frames, args.duration)
+        baseline = baseline or rate
+        print(f"{thread_count:>8} {rate:>14,.0f} {rate / baseline:>8.2f}")
+
+
+if __name__ == "__main__":
+    main()
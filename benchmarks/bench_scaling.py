@@ -0,0 +1,208 @@
+"""Thread scalability of the protect, check and CRC entry points.
+
+Every thread performs the same fixed number of calls, either on one buffer
+which all threads share or on a buffer of its own. The script reports the
+frames per second and the scaling efficiency, i.e. the rate with n threads
+divided by n times the rate with one thread. With the GIL the efficiency
+drops to about 1/n; on a free-threaded interpreter (3.13t, 3.14t) it shows
+where threads still contend, e.g. on reference counts of shared objects.
+
+    python benchmarks/bench_scaling.py --threads 1 2 4 8
+    python benchmarks/bench_scaling.py --interpreters python3.14 python3.14t --json scaling.json
+
+With --interpreters the script runs itself under each interpreter and
+prints one table per interpreter.
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import threading
+import time
+
+import e2e
+
+FRAME_SIZE = 64
+
+
+def _frame(protect, *args):
+    """Return a function which creates a valid frame for the check functions."""
+
+    def make():
+        data = bytearray(FRAME_SIZE)
+        protect(data, *args)
+        return data
+
+    return make
+
+
+def _router_frames(count):
+    data = bytearray(FRAME_SIZE)
+    frames = []
+    for _ in range(count):
+        e2e.p05.e2e_p05_protect(data, FRAME_SIZE - 2, 0x1234)
+        frames.append(bytes(data))
+    return frames
+
+
+def _buffer_call(func, make_data, *args):
+    def make():
+        data = make_data()
+        return lambda: func(data, *args)
+
+    return make
+
+
+def _router_call(batch):
+    def make():
+        router = e2e.Router({0x100: e2e.Config(5, 0x1234)})
+        ids = [0x100] * batch
+        frames = _router_frames(batch)
+        return lambda: router.check_batch(ids, frames)
+
+    return make
+
+
+# name: (frames per call, function which creates the buffers and returns a callable)
+def _workloads(batch):
+    p01 = (FRAME_SIZE - 1, 0x1234)
+    p02 = (FRAME_SIZE - 1, bytes(range(16)))
+    p05 = (FRAME_SIZE - 2, 0x1234)
+    p07 = (FRAME_SIZE, 0x0A0B0C0D)
+    p01_frame = _frame(e2e.p01.e2e_p01_protect, *p01)
+    p02_frame = _frame(e2e.p02.e2e_p02_protect, *p02)
+    p05_frame = _frame(e2e.p05.e2e_p05_protect, *p05)
+    p07_frame = _frame(e2e.p07.e2e_p07_protect, *p07)
+
+    return {
+        "crc.calculate_crc32": (1, _buffer_call(e2e.crc.calculate_crc32, p05_frame)),
+        "p01.e2e_p01_check": (1, _buffer_call(e2e.p01.e2e_p01_check, p01_frame, *p01)),
+        "p02.e2e_p02_check": (1, _buffer_call(e2e.p02.e2e_p02_check, p02_frame, *p02)),
+        "p05.e2e_p05_protect": (1, _buffer_call(e2e.p05.e2e_p05_protect, p05_frame, *p05)),
+        "p05.e2e_p05_check": (1, _buffer_call(e2e.p05.e2e_p05_check, p05_frame, *p05)),
+        "p07.e2e_p07_check": (1, _buffer_call(e2e.p07.e2e_p07_check, p07_frame, *p07)),
+        "Router.check_batch": (batch, _router_call(batch)),
+    }
+
+
+def run(make, frames_per_call, thread_count, calls, shared):
+    """Return the frames per second of thread_count threads."""
+    if shared:
+        funcs = [make()] * thread_count
+    else:
+        funcs = [make() for _ in range(thread_count)]
+    start = threading.Barrier(thread_count + 1)
+    done = threading.Barrier(thread_count + 1)
+
+    def worker(func):
+        start.wait()
+        for _ in range(calls):
+            func()
+        done.wait()
+
+    threads = [threading.Thread(target=worker, args=(f,)) for f in funcs]
+    for thread in threads:
+        thread.start()
+    start.wait()
+    t0 = time.perf_counter()
+    done.wait()
+    elapsed = time.perf_counter() - t0
+    for thread in threads:
+        thread.join()
+    return thread_count * calls * frames_per_call / elapsed
+
+
+def measure(args):
+    results = {}
+    for name, (frames_per_call, make) in _workloads(args.batch).items():
+        if args.filter and not re.search(args.filter, name):
+            continue
+        calls = max(1, args.calls // frames_per_call)
+        for mode in ("shared", "disjoint"):
+            rows = []
+            single = None
+            for thread_count in sorted(set(args.threads)):
+                rate = max(
+                    run(make, frames_per_call, thread_count, calls, mode == "shared")
+                    for _ in range(args.repeats)
+                )
+                single = single or rate / thread_count
+                rows.append(
+                    {
+                        "threads": thread_count,
+                        "frames_per_second": rate,
+                        "efficiency": rate / (thread_count * single),
+                    }
+                )
+            results[f"{name}[{mode}]"] = rows
+    return results
+
+
+def interpreter_info():
+    gil = getattr(sys, "_is_gil_enabled", lambda: True)()
+    return {
+        "executable": sys.executable,
+        "version": sys.version.split()[0],
+        "gil": gil,
+    }
+
+
+def print_results(info, results):
+    gil = "enabled" if info["gil"] else "disabled"
+    print(f"{info['executable']}: Python {info['version']}, GIL {gil}")
+    print(f"{'entry point':<36} {'threads':>7} {'frames/s':>14} {'efficiency':>10}")
+    for name, rows in results.items():
+        for row in rows:
+            print(
+                f"{name:<36} {row['threads']:>7} {row['frames_per_second']:>14,.0f} "
+                f"{row['efficiency']:>10.2f}"
+            )
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument(
+        "--threads", type=int, nargs="+", default=[1, 2, 4, 8, os.cpu_count()]
+    )
+    parser.add_argument("--calls", type=int, default=200_000, help="frames per thread")
+    parser.add_argument("--batch", type=int, default=256, help="frames per check_batch")
+    parser.add_argument("--repeats", type=int, default=3)
+    parser.add_argument("--filter", help="regular expression to select entry points")
+    parser.add_argument("--interpreters", nargs="+", help="run under these interpreters")
+    parser.add_argument("--json", help="write the results to this file")
+    parser.add_argument("--raw", action="store_true", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.interpreters:
+        forwarded = ["--threads", *map(str, args.threads)]
+        forwarded += ["--calls", str(args.calls), "--batch", str(args.batch)]
+        forwarded += ["--repeats", str(args.repeats)]
+        if args.filter:
+            forwarded += ["--filter", args.filter]
+        reports = []
+        for interpreter in args.interpreters:
+            output = subprocess.run(
+                [interpreter, os.path.abspath(__file__), "--raw", *forwarded],
+                check=True,
+                stdout=subprocess.PIPE,
+            ).stdout
+            reports.append(json.loads(output))
+    else:
+        reports = [{"interpreter": interpreter_info(), "results": measure(args)}]
+        if args.raw:
+            json.dump(reports[0], sys.stdout)
+            return
+
+    for report in reports:
+        print_results(report["interpreter"], report["results"])
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(reports, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
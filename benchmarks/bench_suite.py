@@ -0,0 +1,330 @@
+"""Throughput of the CRC functions, the E2E profiles and the batch router.
+
+Every calculate_crc* and every e2e_pXX_protect/e2e_pXX_check is timed for
+payload sizes from 8 B up to 16 MiB (limited to 64 KiB for profiles with a
+16-bit length), at offset 0 and at a non-zero offset, and for all data id
+modes of profile 1. Router.check and Router.check_batch are timed with
+batches of frames, FrameView.check over a buffer of 4096 frames against
+checking slices of it, Layout.check with a description of profile 5, and
+SignalCodec.pack_protect and SignalCodec.check_unpack against packing the
+signals in Python. Each case reports the best time per call over several
+repeats.
+
+Store a baseline once and compare later runs against it; the script exits
+with status 1 if any case got slower than the threshold:
+
+    python benchmarks/bench_suite.py --json baseline.json
+    python benchmarks/bench_suite.py --json current.json --baseline baseline.json --threshold 0.1
+
+Use --filter to select cases by regular expression and --max-size to skip
+large payloads for quick runs.
+"""
+
+import argparse
+import json
+import platform
+import re
+import sys
+import time
+
+import e2e
+
+SIZES = [8, 64, 512, 4096, 32768, 262144, 2097152, 16777216]
+BATCH_SIZES = [1, 64, 4096]
+
+# name: (minimum frame size, maximum frame size, length argument for a frame of size n)
+PROFILES = {
+    "p01": (3, 0xFFFF, lambda n: n - 1),
+    "p02": (3, SIZES[-1], lambda n: n - 1),
+    "p04": (12, 0xFFFF, lambda n: n),
+    "p05": (3, 0xFFFF, lambda n: n - 2),
+    "p06": (5, 0xFFFF, lambda n: n),
+    "p07": (20, SIZES[-1], lambda n: n),
+}
+HEADER_SIZES = {"p04": 12, "p05": 3, "p06": 5, "p07": 20}
+
+P01_MODES = {
+    "both": e2e.p01.E2E_P01_DATAID_BOTH,
+    "alt": e2e.p01.E2E_P01_DATAID_ALT,
+    "low": e2e.p01.E2E_P01_DATAID_LOW,
+    "nibble": e2e.p01.E2E_P01_DATAID_NIBBLE,
+}
+
+
+def measure(func, min_time, repeats):
+    """Return the best time per call in seconds."""
+    number = 1
+    while True:
+        t0 = time.perf_counter()
+        for _ in range(number):
+            func()
+        elapsed = time.perf_counter() - t0
+        if elapsed >= min_time / repeats or number >= 1 << 24:
+            break
+        number *= 2
+    best = elapsed / number
+    for _ in range(repeats - 1):
+        t0 = time.perf_counter()
+        for _ in range(number):
+            func()
+        best = min(best, (time.perf_counter() - t0) / number)
+    return best
+
+
+def sizes_of(profile, max_size):
+    minimum, maximum, _ = PROFILES[profile]
+    sizes = []
+    for size in SIZES:
+        size = max(size, minimum)
+        if size <= min(maximum, max_size) and size not in sizes:
+            sizes.append(size)
+    return sizes
+
+
+def crc_cases(max_size):
+    for name in sorted(n for n in dir(e2e.crc) if n.startswith("calculate_crc")):
+        func = getattr(e2e.crc, name)
+        for size in SIZES:
+            if size > max_size:
+                continue
+            data = bytes(size)
+            yield f"crc.{name}[size={size}]", size, lambda f=func, d=data: f(d)
+
+
+def profile_call(profile, kind, data, length, offset, mode):
+    module = getattr(e2e, profile)
+    func = getattr(module, f"e2e_{profile}_{kind}")
+    if profile == "p01":
+        return lambda: func(data, length, 0x1234, data_id_mode=mode)
+    if profile == "p02":
+        data_id_list = bytes(range(16))
+        return lambda: func(data, length, data_id_list)
+    if profile == "p07":
+        return lambda: func(data, length, 0x0A0B0C0D, offset=offset)
+    return lambda: func(data, length, 0x1234, offset=offset)
+
+
+def profile_cases(max_size):
+    for profile in PROFILES:
+        length_of = PROFILES[profile][2]
+        for size in sizes_of(profile, max_size):
+            data = bytearray(size)
+            if profile == "p01":
+                variants = [(f"mode={m}", 0, v) for m, v in P01_MODES.items()]
+            elif profile == "p02":
+                variants = [("", 0, 0)]
+            else:
+                # a non-zero offset moves the header out of the first cache line
+                offset = min(64, size - HEADER_SIZES[profile])
+                variants = [("offset=0", 0, 0), (f"offset={offset}", offset, 0)]
+            for label, offset, mode in variants:
+                params = ",".join(p for p in (f"size={size}", label) if p)
+                for kind in ("protect", "check"):
+                    call = profile_call(profile, kind, data, length_of(size), offset, mode)
+                    yield f"{profile}.{kind}[{params}]", size, call
+
+
+def router_frames(profile, size, count):
+    data = bytearray(size)
+    frames = []
+    for _ in range(count):
+        if profile == 4:
+            e2e.p04.e2e_p04_protect(data, size, 0x0A0B0C0D)
+        elif profile == 5:
+            e2e.p05.e2e_p05_protect(data, size - 2, 0x1234)
+        else:
+            e2e.p07.e2e_p07_protect(data, size, 0x0A0B0C0D)
+        frames.append(bytes(data))
+    return frames
+
+
+def router_cases(max_size):
+    for profile, data_id in ((4, 0x0A0B0C0D), (5, 0x1234), (7, 0x0A0B0C0D)):
+        for size in (8, 64, 1024):
+            size = max(size, HEADER_SIZES[f"p0{profile}"])
+            if size > max_size:
+                continue
+            # the frames are replayed, so after the first run they fail the
+            # sequence check, which comes after the full CRC check
+            router = e2e.Router({0x100: e2e.Config(profile, data_id)})
+            for count in BATCH_SIZES:
+                frames = router_frames(profile, size, count)
+                ids = [0x100] * count
+                params = f"profile={profile},size={size},frames={count}"
+                yield (
+                    f"router.check_batch[{params}]",
+                    size * count,
+                    lambda r=router, i=ids, f=frames: r.check_batch(i, f),
+                )
+            frame = router_frames(profile, size, 1)[0]
+            yield (
+                f"router.check[profile={profile},size={size}]",
+                size,
+                lambda r=router, f=frame: r.check(0x100, f),
+            )
+
+
+def frameview_cases(max_size):
+    # thousands of frames in one buffer, one call per frame
+    count = 4096
+    for size in (8, 64):
+        if size * count > max_size:
+            continue
+        buffer = bytearray(size * count)
+        view = e2e.FrameView(buffer)
+        config = e2e.Config(5, 0x1234)
+        offsets = range(0, len(buffer), size)
+        for offset in offsets:
+            view.protect(offset, size, config)
+        params = f"profile=5,size={size},frames={count}"
+
+        def pinned(v=view, o=offsets, n=size, c=config):
+            for i in o:
+                v.check(i, n, c)
+
+        def sliced(b=buffer, o=offsets, n=size, check=e2e.p05.e2e_p05_check):
+            for i in o:
+                check(b[i : i + n], n - 2, 0x1234)
+
+        yield f"frameview.check[{params}]", size * count, pinned
+        yield f"slice.check[{params}]", size * count, sliced
+
+
+def layout_cases(max_size):
+    # profile 5 as a Layout against the built-in e2e_p05_check
+    layout = e2e.Layout("crc16", 0, counter=(16, 8), byteorder="little", data_id_mode="both")
+    for size in SIZES:
+        if size > min(max_size, 0x10001):
+            continue
+        data = bytearray(size)
+        layout.protect(data, 0x1234)
+        yield f"layout.check[profile=5,size={size}]", size, lambda d=data: layout.check(d, 0x1234)
+
+
+def codec_cases(max_size):
+    # four signals in a profile 5 frame of 8 bytes
+    codec = e2e.SignalCodec(
+        [
+            ("speed", 24, 16, "little", False, 0.01),
+            ("torque", 47, 12, "big", True, 0.5),
+            ("gear", 48, 4),
+            ("valid", 56, 1),
+        ]
+    )
+    config = e2e.Config(5, 0x1234)
+    values = [88.5, -20.0, 3, 1]
+    data = bytearray(8)
+    yield "codec.pack_protect[profile=5,signals=4]", 8, lambda: codec.pack_protect(
+        data, values, config
+    )
+
+    def packed(d=data, v=values, protect=e2e.p05.e2e_p05_protect):
+        d[3:5] = round(v[0] / 0.01).to_bytes(2, "little")
+        torque = round(v[1] / 0.5) & 0xFFF
+        d[5] = torque >> 4
+        d[6] = d[6] & 0x0F | (torque & 0x0F) << 4
+        d[6] = d[6] & 0xF0 | v[2]
+        d[7] = d[7] & 0xFE | v[3]
+        protect(d, 6, 0x1234)
+
+    yield "python.pack_protect[profile=5,signals=4]", 8, packed
+
+    count = 4096
+    frames = []
+    for i in range(count):
+        codec.pack_protect(data, [i % 600, -20.0, i % 16, 1], config)
+        frames.append(bytes(data))
+    params = f"profile=5,signals=4,frames={count}"
+    yield f"codec.check_unpack[{params}]", 8 * count, lambda: codec.check_unpack(
+        frames, config
+    )
+
+    def unpacked(f=frames, check=e2e.p05.e2e_p05_check):
+        speed, torque, gear, valid = [], [], [], []
+        for d in f:
+            if check(d, 6, 0x1234):
+                speed.append(int.from_bytes(d[3:5], "little") * 0.01)
+                raw = d[5] << 4 | d[6] >> 4
+                torque.append((raw - (raw >> 11 << 12)) * 0.5)
+                gear.append(d[6] & 0x0F)
+                valid.append(d[7] & 1)
+
+    yield f"python.check_unpack[{params}]", 8 * count, unpacked
+
+
+def run(pattern, max_size, min_time, repeats):
+    results = {}
+    cases = [crc_cases(max_size), profile_cases(max_size), router_cases(max_size)]
+    cases += [frameview_cases(max_size), layout_cases(max_size), codec_cases(max_size)]
+    for generator in cases:
+        for name, nbytes, func in generator:
+            if pattern and not re.search(pattern, name):
+                continue
+            seconds = measure(func, min_time, repeats)
+            results[name] = {
+                "ns_per_call": seconds * 1e9,
+                "bytes_per_second": nbytes / seconds,
+            }
+            print(
+                f"{name:<60} {seconds * 1e9:>14,.1f} ns {nbytes / seconds / 1e6:>12,.1f} MB/s",
+                flush=True,
+            )
+    return results
+
+
+def compare(results, baseline, threshold):
+    """Return the cases which got slower than threshold against baseline."""
+    regressions = []
+    for name, value in sorted(results.items()):
+        reference = baseline.get(name)
+        if reference is None:
+            continue
+        ratio = value["ns_per_call"] / reference["ns_per_call"]
+        if ratio > 1.0 + threshold:
+            regressions.append((name, ratio))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--filter", help="regular expression to select cases")
+    parser.add_argument("--max-size", type=int, default=SIZES[-1])
+    parser.add_argument("--min-time", type=float, default=0.2, help="seconds per case")
+    parser.add_argument("--repeats", type=int, default=5)
+    parser.add_argument("--json", help="write the results to this file")
+    parser.add_argument("--baseline", help="results of an earlier run to compare with")
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.1,
+        help="allowed slowdown against the baseline, 0.1 means 10%%",
+    )
+    args = parser.parse_args()
+
+    print(f"Python {sys.version.split()[0]}, e2e {e2e.__version__}, {platform.machine()}")
+    results = run(args.filter, args.max_size, args.min_time, args.repeats)
+
+    if args.json:
+        report = {
+            "python": sys.version,
+            "implementation": platform.python_implementation(),
+            "machine": platform.machine(),
+            "e2e": e2e.__version__,
+            "results": results,
+        }
+        with open(args.json, "w") as f:
+            json.dump(report, f, indent=2)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)["results"]
+        regressions = compare(results, baseline, args.threshold)
+        for name, ratio in regressions:
+            print(f"REGRESSION {name}: {ratio:.2f}x slower than baseline")
+        if regressions:
+            sys.exit(1)
+        print(f"no regressions against {args.baseline}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,329 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+// Cycles per byte of the crclib kernels without Python in the way.
+//
+//   crcbench [-a algorithm] [-m max_size] [-b min_bytes]
+//
+// Every kernel runs on sizes from 1 B to max_size (default 64 MiB), on an
+// aligned and on an unaligned (+1 byte) input, with a warm and with a cold
+// cache. Time is measured with the TSC on x86, the generic timer on ARM64 and
+// a monotonic clock elsewhere. On Linux, perf_event_open() adds the core
+// cycles, instructions and L1 data cache read misses per byte if the kernel
+// allows it (see /proc/sys/kernel/perf_event_paranoid).
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "crclib.h"
+
+#define MAX_SIZE     (64u * 1024u * 1024u)
+#define ALIGNMENT    64u
+#define FLUSH_SIZE   (64u * 1024u * 1024u) // larger than the last level cache
+#define COUNTER_NONE UINT64_MAX
+
+static uint64_t clock_ticks(void)
+{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ volatile("isb; mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#elif defined(_WIN32)
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)counter.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#endif
+}
+
+static const char *clock_name(void)
+{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    return "tsc";
+#elif defined(__aarch64__)
+    return "cntvct";
+#elif defined(_WIN32)
+    return "qpc";
+#else
+    return "ns";
+#endif
+}
+
+// Hardware counters of the calling thread, fd < 0 if unavailable
+typedef struct {
+    int fd[3];
+} counters_t;
+
+static const char *const counter_names[3] = {"cycles", "instructions", "l1d_misses"};
+
+#ifdef __linux__
+static int open_counter(uint32_t type, uint64_t config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = type;
+    attr.config         = config;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+static void counters_open(counters_t *counters)
+{
+#ifdef __linux__
+    counters->fd[0] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    counters->fd[1] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    counters->fd[2] = open_counter(PERF_TYPE_HW_CACHE,
+                                   PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#else
+    counters->fd[0] = counters->fd[1] = counters->fd[2] = -1;
+#endif
+}
+
+static void counters_start(const counters_t *counters)
+{
+#ifdef __linux__
+    for (int i = 0; i < 3; ++i) {
+        if (counters->fd[i] >= 0) {
+            ioctl(counters->fd[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(counters->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+static void counters_stop(const counters_t *counters, uint64_t values[3])
+{
+    for (int i = 0; i < 3; ++i) {
+        values[i] = COUNTER_NONE;
+#ifdef __linux__
+        uint64_t value;
+        if (counters->fd[i] >= 0) {
+            ioctl(counters->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+            if (read(counters->fd[i], &value, sizeof(value)) == sizeof(value)) {
+                values[i] = value;
+            }
+        }
+#endif
+    }
+}
+
+static void *aligned_buffer(size_t size)
+{
+    uint8_t *raw = malloc(size + sizeof(void *) + ALIGNMENT);
+    if (raw == NULL) {
+        return NULL;
+    }
+    // keep the original pointer in front of the aligned block for free_buffer()
+    uintptr_t address = ((uintptr_t)raw + sizeof(void *) + ALIGNMENT - 1) & ~(uintptr_t)(ALIGNMENT - 1);
+    uint8_t  *aligned = (uint8_t *)address;
+    ((void **)aligned)[-1] = raw;
+    return aligned;
+}
+
+static void free_buffer(void *buffer)
+{
+    if (buffer != NULL) {
+        free(((void **)buffer)[-1]);
+    }
+}
+
+// Evict the input from all cache levels by streaming through a larger buffer
+static volatile uint64_t flush_sink;
+static void              flush_cache(uint8_t *flush)
+{
+    uint64_t sum = 0;
+    for (size_t i = 0; i < FLUSH_SIZE; i += ALIGNMENT) {
+        flush[i] += 1;
+        sum      += flush[i];
+    }
+    flush_sink = sum;
+}
+
+typedef struct {
+    double ticks_per_byte;
+    double counters_per_byte[3];
+} result_t;
+
+static volatile uint64_t result_sink;
+
+// Best of several runs of iterations calls. With a cold cache every call is
+// preceded by a flush, which is excluded from the measurement.
+static result_t measure(Crc_AlgorithmType algorithm,
+                        Crc_KernelType    kernel,
+                        const uint8_t    *data,
+                        uint32_t          size,
+                        uint64_t          min_bytes,
+                        bool              cold,
+                        uint8_t          *flush,
+                        const counters_t *counters)
+{
+    uint64_t iterations = cold ? 1 : (min_bytes + size - 1) / size;
+    int      runs       = cold ? 7 : 5;
+    result_t best;
+    best.ticks_per_byte = -1.0;
+    for (int i = 0; i < 3; ++i) {
+        best.counters_per_byte[i] = -1.0;
+    }
+
+    for (int run = 0; run < runs; ++run) {
+        uint64_t values[3];
+        if (cold) {
+            flush_cache(flush);
+        }
+        else {
+            result_sink = Crc_CalculateKernel(algorithm, kernel, data, size, 0, true); // warm up
+        }
+        counters_start(counters);
+        uint64_t start = clock_ticks();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            result_sink = Crc_CalculateKernel(algorithm, kernel, data, size, 0, true);
+        }
+        uint64_t ticks = clock_ticks() - start;
+        counters_stop(counters, values);
+
+        double bytes = (double)iterations * size;
+        if (best.ticks_per_byte < 0 || ticks / bytes < best.ticks_per_byte) {
+            best.ticks_per_byte = ticks / bytes;
+            for (int i = 0; i < 3; ++i) {
+                best.counters_per_byte[i] = (values[i] == COUNTER_NONE) ? -1.0 : values[i] / bytes;
+            }
+        }
+    }
+    return best;
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-a algorithm] [-m max_size] [-b min_bytes]\n", program);
+}
+
+int main(int argc, char **argv)
+{
+    const char *algorithm = NULL;
+    uint32_t    max_size  = MAX_SIZE;
+    uint64_t    min_bytes = 64u * 1024u * 1024u; // bytes per warm measurement
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            algorithm = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            max_size = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            min_bytes = strtoull(argv[++i], NULL, 0);
+        }
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (max_size == 0 || max_size > MAX_SIZE) {
+        fprintf(stderr, "max_size must be between 1 and %u\n", MAX_SIZE);
+        return 2;
+    }
+
+    uint8_t *data  = aligned_buffer((size_t)max_size + ALIGNMENT);
+    uint8_t *flush = aligned_buffer(FLUSH_SIZE);
+    if (data == NULL || flush == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (size_t i = 0; i < (size_t)max_size + ALIGNMENT; ++i) {
+        data[i] = (uint8_t)(i * 31u + 7u);
+    }
+    memset(flush, 0, FLUSH_SIZE);
+
+    counters_t counters;
+    counters_open(&counters);
+
+    printf("%-9s %-7s %10s %-9s %-5s %12s",
+           "algorithm",
+           "variant",
+           "size",
+           "alignment",
+           "cache",
+           clock_name());
+    for (int i = 0; i < 3; ++i) {
+        printf(" %12s", counters.fd[i] >= 0 ? counter_names[i] : "-");
+    }
+    printf("   (per byte)\n");
+
+    // every kernel of every algorithm, regardless of the thresholds of crclib
+    for (size_t k = 0; k < (size_t)CRC_ALGORITHM_COUNT * CRC_KERNEL_COUNT; ++k) {
+        Crc_AlgorithmType a = (Crc_AlgorithmType)(k / CRC_KERNEL_COUNT);
+        Crc_KernelType    v = (Crc_KernelType)(k % CRC_KERNEL_COUNT);
+        if (algorithm != NULL && strcmp(algorithm, Crc_AlgorithmName(a)) != 0) {
+            continue;
+        }
+        for (uint32_t size = 1; size <= max_size; size *= 4) {
+            for (int unaligned = 0; unaligned < 2; ++unaligned) {
+                for (int cold = 0; cold < 2; ++cold) {
+                    result_t result = measure(a,
+                                              v,
+                                              data + unaligned,
+                                              size,
+                                              min_bytes,
+                                              (bool)cold,
+                                              flush,
+                                              &counters);
+                    printf("%-9s %-7s %10u %-9s %-5s %12.3f",
+                           Crc_AlgorithmName(a),
+                           Crc_KernelName(v),
+                           size,
+                           unaligned ? "unaligned" : "aligned",
+                           cold ? "cold" : "warm",
+                           result.ticks_per_byte);
+                    for (int i = 0; i < 3; ++i) {
+                        if (result.counters_per_byte[i] < 0) {
+                            printf(" %12s", "-");
+                        }
+                        else {
+                            printf(" %12.3f", result.counters_per_byte[i]);
+                        }
+                    }
+                    printf("\n");
+                }
+            }
+            if (size > max_size / 4) {
+                break;
+            }
+        }
+    }
+
+    free_buffer(data);
+    free_buffer(flush);
+    return 0;
+}
@@ -0,0 +1,334 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+// libFuzzer target which compares the CRC kernels of crclib (table and
+// slice-by-8) and the profile functions of e2elib with bit-by-bit reference
+// implementations.
+//
+//   cmake -S . -B build -DCMAKE_C_COMPILER=clang -DE2E_FUZZ=ON
+//   cmake --build build --target crc_fuzzer
+//   build/crc_fuzzer -max_total_time=60
+//
+// The first bytes of the input select the algorithm, the alignment, the start
+// value and the chunks of a chained first_call=false sequence, or the profile,
+// data id, offset and length of a configuration, the rest is the data. Any
+// mismatch aborts, so libFuzzer stores the input as a reproducer.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crclib.h"
+#include "e2elib.h"
+
+#define MAX_ALIGNMENT 16u
+
+typedef struct {
+    const char *name;
+    uint8_t     width;
+    uint64_t    poly;
+    uint64_t    init;
+    uint64_t    xorout;
+    bool        reflected;
+    uint64_t (*kernel)(const uint8_t *data, uint32_t length, uint64_t start, bool first_call);
+} algorithm_t;
+
+static uint64_t crc8(const uint8_t *data, uint32_t length, uint64_t start, bool first_call)
+{
+    return Crc_CalculateCRC8(data, length, (uint8_t)start, first_call);
+}
+
+static uint64_t crc8h2f(const uint8_t *data, uint32_t length, uint64_t start, bool first_call)
+{
+    return Crc_CalculateCRC8H2F(data, length, (uint8_t)start, first_call);
+}
+
+static uint64_t crc16(const uint8_t *data, uint32_t length, uint64_t start, bool first_call)
+{
+    return Crc_CalculateCRC16(data, length, (uint16_t)start, first_call);
+}
+
+static uint64_t crc16arc(const uint8_t *data, uint32_t length, uint64_t start, bool first_call)
+{
+    return Crc_CalculateCRC16ARC(data, length, (uint16_t)start, first_call);
+}
+
+static uint64_t crc32(const uint8_t *data, uint32_t length, uint64_t start, bool first_call)
+{
+    return Crc_CalculateCRC32(data, length, (uint32_t)start, first_call);
+}
+
+static uint64_t crc32p4(const uint8_t *data, uint32_t length, uint64_t start, bool first_call)
+{
+    return Crc_CalculateCRC32P4(data, length, (uint32_t)start, first_call);
+}
+
+static uint64_t crc64(const uint8_t *data, uint32_t length, uint64_t start, bool first_call)
+{
+    return Crc_CalculateCRC64(data, length, start, first_call);
+}
+
+// in the order of Crc_AlgorithmType
+// clang-format off
+static const algorithm_t algorithms[] = {
+    {"crc8",     8,  0x1Du,                0xFFu,                0xFFu,                false, crc8    },
+    {"crc8h2f",  8,  0x2Fu,                0xFFu,                0xFFu,                false, crc8h2f },
+    {"crc16",    16, 0x1021u,              0xFFFFu,              0x0000u,              false, crc16   },
+    {"crc16arc", 16, 0x8005u,              0x0000u,              0x0000u,              true,  crc16arc},
+    {"crc32",    32, 0x04C11DB7u,          0xFFFFFFFFu,          0xFFFFFFFFu,          true,  crc32   },
+    {"crc32p4",  32, 0xF4ACFB13u,          0xFFFFFFFFu,          0xFFFFFFFFu,          true,  crc32p4 },
+    {"crc64",    64, 0x42F0E1EBA9EA3693uLL, 0xFFFFFFFFFFFFFFFFuLL, 0xFFFFFFFFFFFFFFFFuLL, true,  crc64   },
+};
+// clang-format on
+
+#define ALGORITHM_COUNT (sizeof(algorithms) / sizeof(algorithms[0]))
+
+static uint64_t mask_of(uint8_t width) { return (width == 64) ? UINT64_MAX : ((1uLL << width) - 1u); }
+
+static uint64_t reflect(uint64_t value, uint8_t width)
+{
+    uint64_t result = 0;
+    for (uint8_t i = 0; i < width; ++i) {
+        result = (result << 1) | ((value >> i) & 1u);
+    }
+    return result;
+}
+
+// Bit-by-bit CRC without tables, the reference for all kernels
+static uint64_t reference(const algorithm_t *a, const uint8_t *data, size_t length, uint64_t start, bool first)
+{
+    uint64_t mask = mask_of(a->width);
+    uint64_t crc  = first ? a->init : ((start ^ a->xorout) & mask);
+    if (a->reflected) {
+        uint64_t poly = reflect(a->poly, a->width);
+        for (size_t i = 0; i < length; ++i) {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1u) ? (crc >> 1) ^ poly : crc >> 1;
+            }
+        }
+    }
+    else {
+        uint64_t top = 1uLL << (a->width - 1);
+        for (size_t i = 0; i < length; ++i) {
+            crc ^= (uint64_t)data[i] << (a->width - 8);
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & top) ? (crc << 1) ^ a->poly : crc << 1;
+            }
+            crc &= mask;
+        }
+    }
+    return (crc ^ a->xorout) & mask;
+}
+
+static void mismatch(const char *what, const char *name, size_t length, uint64_t got, uint64_t expected)
+{
+    fprintf(stderr,
+            "%s mismatch in %s, length %zu: got 0x%llx, expected 0x%llx\n",
+            what,
+            name,
+            length,
+            (unsigned long long)got,
+            (unsigned long long)expected);
+    abort();
+}
+
+static uint64_t read_u64(const uint8_t *bytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= (uint64_t)bytes[i] << (8 * i);
+    }
+    return value;
+}
+
+static void fuzz_crc(const algorithm_t *a, const uint8_t *control, const uint8_t *data, size_t length)
+{
+    uint8_t *buffer = malloc(length + MAX_ALIGNMENT);
+    if (buffer == NULL) {
+        return;
+    }
+    uint8_t *shifted = buffer + (control[1] % MAX_ALIGNMENT);
+    memcpy(shifted, data, length);
+
+    uint64_t expected = reference(a, data, length, 0, true);
+    uint64_t got      = a->kernel(shifted, (uint32_t)length, 0, true);
+    if (got != expected) {
+        mismatch("one-shot", a->name, length, got, expected);
+    }
+
+    uint64_t start = read_u64(control + 2) & mask_of(a->width);
+    got            = a->kernel(shifted, (uint32_t)length, start, false);
+    expected       = reference(a, data, length, start, false);
+    if (got != expected) {
+        mismatch("start value", a->name, length, got, expected);
+    }
+
+    // chained sequence, the chunk sizes come from the control bytes
+    uint64_t crc      = 0;
+    size_t   position = 0;
+    for (int chunk = 0; position < length || chunk == 0; ++chunk) {
+        size_t size = (chunk < 6) ? control[10 + chunk] % (length - position + 1) : length - position;
+        crc         = a->kernel(shifted + position, (uint32_t)size, crc, chunk == 0);
+        position   += size;
+    }
+    expected = reference(a, data, length, 0, true);
+    if (crc != expected) {
+        mismatch("chained", a->name, length, crc, expected);
+    }
+
+    // every kernel on its own, regardless of the threshold of the algorithm
+    Crc_AlgorithmType id = (Crc_AlgorithmType)(a - algorithms);
+    expected             = reference(a, data, length, start, false);
+    for (int kernel = 0; kernel < CRC_KERNEL_COUNT; ++kernel) {
+        got = Crc_CalculateKernel(id, (Crc_KernelType)kernel, shifted, (uint32_t)length, start, false);
+        if (got != expected) {
+            mismatch(Crc_KernelName((Crc_KernelType)kernel), a->name, length, got, expected);
+        }
+    }
+    free(buffer);
+}
+
+// Check a frame with the profile function itself, bypassing e2e_config_check()
+static e2e_result_t profile_check(const e2e_config_t *config, const uint8_t *frame, uint32_t length)
+{
+    switch (config->profile) {
+        case 1:
+            return e2e_p01_check(frame,
+                                 (uint16_t)length,
+                                 (uint16_t)config->data_id,
+                                 config->data_id_mode,
+                                 NULL);
+        case 2:
+            return e2e_p02_check(frame, length, config->data_id_list, NULL);
+        case 4:
+            return e2e_p04_check(frame, (uint16_t)length, config->data_id, (uint16_t)config->offset, NULL);
+        case 5:
+            return e2e_p05_check(frame,
+                                 (uint16_t)length,
+                                 (uint16_t)config->data_id,
+                                 (uint16_t)config->offset,
+                                 NULL);
+        case 6:
+            return e2e_p06_check(frame,
+                                 (uint16_t)length,
+                                 (uint16_t)config->data_id,
+                                 (uint16_t)config->offset,
+                                 NULL);
+        default:
+            return e2e_p07_check(frame, length, config->data_id, config->offset, NULL);
+    }
+}
+
+// The router path e2e_config_check() must agree with the profile functions, a
+// protected frame must pass and a single bit flip must not go unnoticed.
+static void fuzz_profile(const uint8_t *control, const uint8_t *data, size_t length)
+{
+    static const uint8_t profiles[] = {1, 2, 4, 5, 6, 7};
+    e2e_config_t         config;
+    memset(&config, 0, sizeof(config));
+    config.profile           = profiles[control[1] % sizeof(profiles)];
+    config.data_id           = (uint32_t)read_u64(control + 2);
+    // With E2E_P01_DATAID_ALT or _NIBBLE the counter selects the data id, so a
+    // flipped counter bit changes more than one bit of the CRC input.
+    config.data_id_mode      = (control[10] & 1u) ? E2E_P01_DATAID_LOW : E2E_P01_DATAID_BOTH;
+    config.max_delta_counter = 1;
+    memcpy(config.data_id_list, control + 2, P02DATAID_LIST_LEN);
+    if (config.profile != 4 && config.profile != 7) {
+        config.data_id &= 0xFFFFu;
+    }
+    if (length > 0xFFFFu) {
+        length = 0xFFFFu;
+    }
+    // half of the inputs derive the length from the frame, the others take
+    // any length up to beyond the frame, including ones which do not contain
+    // the header at offset
+    uint32_t length_control = control[20] | (uint32_t)control[21] << 8;
+    config.length           = (length_control & 1u) ? 0u
+                                                    : (length_control >> 1) % ((uint32_t)length + 3u);
+    if (config.profile >= 4) {
+        config.offset = control[11];
+    }
+
+    // exactly length bytes, so that ASan reports any access beyond the frame
+    uint8_t *frame = malloc(length > 0 ? length : 1);
+    if (frame == NULL) {
+        return;
+    }
+    memcpy(frame, data, length);
+    // whatever the configuration, invalid ones included, nothing reads or
+    // writes outside the frame and frames which do not fit are rejected
+    if (e2e_config_frame_length(&config, length) == 0 &&
+        (e2e_config_check(&config, frame, length, NULL) != E2E_RESULT_BAD_FRAME ||
+         e2e_config_protect(&config, frame, length, true) != E2E_RESULT_BAD_FRAME)) {
+        fprintf(stderr,
+                "frame accepted which does not fit, profile %u, length %zu\n",
+                config.profile,
+                length);
+        abort();
+    }
+    e2e_config_check(&config, frame, length, NULL);
+    memcpy(frame, data, length);
+
+    if (config.profile >= 4) {
+        // halve the offset until the header fits into the frame
+        while (config.offset > 0 && e2e_config_frame_length(&config, length) == 0) {
+            config.offset /= 2;
+        }
+    }
+    if (e2e_config_error(&config) != NULL || e2e_config_frame_length(&config, length) == 0) {
+        free(frame);
+        return;
+    }
+
+    e2e_config_protect(&config, frame, length, true);
+    if (e2e_config_check(&config, frame, length, NULL) != E2E_RESULT_OK) {
+        fprintf(stderr, "protected frame fails, profile %u, length %zu\n", config.profile, length);
+        abort();
+    }
+
+    uint32_t protected_length = e2e_config_frame_length(&config, length);
+    size_t   bit              = read_u64(control + 12) % ((size_t)protected_length * 8u);
+    if (config.profile == 2 && bit / 8 == 1) {
+        bit += 8; // the counter in byte 1 selects the data id of profile 2
+    }
+    if (bit / 8 < length) {
+        frame[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+    }
+    e2e_result_t result = e2e_config_check(&config, frame, length, NULL);
+    if (result != profile_check(&config, frame, protected_length)) {
+        fprintf(stderr, "router and profile disagree, profile %u, length %zu\n", config.profile, length);
+        abort();
+    }
+    if (bit / 8 < length && result == E2E_RESULT_OK) {
+        fprintf(stderr, "bit flip %zu undetected, profile %u, length %zu\n", bit, config.profile, length);
+        abort();
+    }
+    free(frame);
+}
+
+#define CONTROL_SIZE 22u
+
+int LLVMFuzzerTestOneInput(const uint8_t *input, size_t size)
+{
+    if (size < CONTROL_SIZE) {
+        return 0;
+    }
+    const uint8_t *data   = input + CONTROL_SIZE;
+    size_t         length = size - CONTROL_SIZE;
+    if (length > UINT32_MAX) {
+        return 0;
+    }
+    Crc_Init(); // slicing tables, so that long inputs take the slice-by-8 path
+    if (input[0] < 0xC0u) {
+        fuzz_crc(&algorithms[input[0] % ALGORITHM_COUNT], input, data, length);
+    }
+    else {
+        fuzz_profile(input, data, length);
+    }
+    return 0;
+}
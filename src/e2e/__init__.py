@@ -7,13 +7,97 @@ __all__ = [
     "p05",
     "p06",
     "p07",
+    "Config",
+    "DeadlineMonitor",
+    "FlightRecorder",
+    "FrameRing",
+    "FrameView",
+    "Layout",
+    "Router",
+    "Scheduler",
+    "SignalCodec",
+    "Verifier",
+    "check_sequence",
+    "enable_stats",
+    "get_include",
+    "reset_stats",
+    "stats",
+    "E2E_STATUS_OK",
+    "E2E_STATUS_NONEWDATA",
+    "E2E_STATUS_ERROR",
+    "E2E_STATUS_REPEATED",
+    "E2E_STATUS_OKSOMELOST",
+    "E2E_STATUS_WRONGSEQUENCE",
+    "E2E_STATUS_UNKNOWN_ID",
 ]
 
-from e2e import crc as crc
-from e2e import p01 as p01
-from e2e import p02 as p02
-from e2e import p04 as p04
-from e2e import p05 as p05
-from e2e import p06 as p06
-from e2e import p07 as p07
+import os
+
+from e2e._e2e import (
+    E2E_STATUS_ERROR,
+    E2E_STATUS_NONEWDATA,
+    E2E_STATUS_OK,
+    E2E_STATUS_OKSOMELOST,
+    E2E_STATUS_REPEATED,
+    E2E_STATUS_UNKNOWN_ID,
+    E2E_STATUS_WRONGSEQUENCE,
+    Config,
+    DeadlineMonitor,
+    FlightRecorder,
+    FrameRing,
+    FrameView,
+    Layout,
+    Router,
+    Scheduler,
+    SignalCodec,
+    Verifier,
+    check_sequence,
+)
+from e2e._e2e import _C_API as _C_API  # PyCapsule_Import("e2e._C_API"), see e2e_capi.h
 from e2e._version import __version__
+
+# typing is slow to import, it is only needed by type checkers
+TYPE_CHECKING = False
+if TYPE_CHECKING:
+    from typing import Any, List
+
+    from e2e import crc, p01, p02, p04, p05, p06, p07
+    from e2e._stats import enable_stats, reset_stats, stats
+
+# e2e.crc and e2e.pXX are imported on first access, they are views of e2e._e2e.
+# The first of them applies the cached CRC kernel selection, see e2e._backend.
+_SUBMODULES = ("crc", "p01", "p02", "p04", "p05", "p06", "p07")
+# the statistics functions of e2e._stats, also imported on first access
+_STATS = ("enable_stats", "reset_stats", "stats")
+
+if os.environ.get("E2E_STATS", "0") not in ("", "0"):
+    from e2e._stats import enable_stats, reset_stats, stats
+if os.environ.get("E2E_CRC_KERNEL"):
+    from e2e import _crctune as _crctune  # the forced kernel applies to all classes
+
+
+def get_include() -> str:
+    """Return the directory of the C API headers.
+
+    Other extension modules include ``e2e_capi.h`` from this directory and
+    call ``E2E_CAPI_Import()`` to get the function table of the capsule
+    ``e2e._C_API``, e.g. the CRC kernels and the raw protect and check
+    functions, which they can call without the GIL.
+    """
+    return os.path.join(os.path.dirname(__file__), "include")
+
+
+def __getattr__(name: str) -> "Any":
+    if name in _SUBMODULES:
+        import importlib
+
+        return importlib.import_module(f"e2e.{name}")
+    if name in _STATS:
+        from e2e import _stats
+
+        return getattr(_stats, name)
+    raise AttributeError(f"module 'e2e' has no attribute {name!r}")
+
+
+def __dir__() -> "List[str]":
+    return sorted(set(globals()) | set(_SUBMODULES) | set(_STATS))
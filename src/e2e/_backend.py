@@ -0,0 +1,54 @@
+"""Implementation behind e2e.crc and e2e.pXX, selected once per process.
+
+``extension``
+    The functions of the extension module e2e._e2e, the default on CPython.
+``cffi``
+    e2e._cffi calls the same C core through cffi. On PyPy every call into
+    an extension module goes through the cpyext emulation layer, cffi calls
+    are inlined by the JIT instead, so this is the default there. It needs
+    the shared library ``_e2e_core``, which is built for PyPy or with the
+    CMake option ``E2E_CFFI``.
+
+The environment variable ``E2E_BACKEND`` selects a backend explicitly. If
+the cffi backend is not available, the extension module is used.
+"""
+
+import os
+import sys
+import warnings
+from types import ModuleType
+
+from e2e import _crctune  # noqa: F401, applies the cached CRC kernel selection
+from e2e import _e2e
+
+BACKENDS = ("extension", "cffi")
+
+
+def _select() -> str:
+    requested = os.environ.get("E2E_BACKEND", "")
+    if requested and requested not in BACKENDS:
+        warnings.warn(f"E2E_BACKEND: ignoring unknown backend {requested!r}")
+        requested = ""
+    if not requested:
+        requested = "cffi" if sys.implementation.name == "pypy" else "extension"
+    if requested == "extension":
+        return "extension"
+    try:
+        from e2e import _cffi  # noqa: F401
+    except (ImportError, OSError) as exc:
+        if "E2E_BACKEND" in os.environ:
+            warnings.warn(f"E2E_BACKEND: cffi backend unavailable ({exc})")
+        return "extension"
+    return "cffi"
+
+
+NAME = _select()
+
+
+def init_submodule(module: ModuleType) -> None:
+    """Fill the namespace of e2e.crc or e2e.pXX, called on their first import."""
+    _e2e._init_submodule(module)
+    if NAME == "cffi":
+        from e2e import _cffi
+
+        _cffi.install(module)
@@ -0,0 +1,426 @@
+"""cffi implementation of e2e.crc and e2e.pXX.
+
+The functions call the C core in the shared library ``_e2e_core`` through
+cffi. On PyPy the JIT inlines these calls, while every call into the
+extension module e2e._e2e goes through the cpyext emulation layer. The
+arguments are validated exactly like in the extension module, with the
+same exceptions and messages.
+
+Calls through this module are neither counted by e2e.stats() nor do they
+fire the USDT probes.
+"""
+
+import operator
+import os
+import sys
+from types import ModuleType
+from typing import Any, Callable, Dict, Tuple
+
+from cffi import FFI
+
+from e2e import _crctune
+
+ffi = FFI()
+ffi.cdef(
+    """
+    void     Crc_Init(void);
+    void     Crc_SetThreshold(int algorithm, uint32_t threshold);
+
+    uint8_t  Crc_CalculateCRC8(const uint8_t *, uint32_t, uint8_t, bool);
+    uint8_t  Crc_CalculateCRC8H2F(const uint8_t *, uint32_t, uint8_t, bool);
+    uint16_t Crc_CalculateCRC16(const uint8_t *, uint32_t, uint16_t, bool);
+    uint16_t Crc_CalculateCRC16ARC(const uint8_t *, uint32_t, uint16_t, bool);
+    uint32_t Crc_CalculateCRC32(const uint8_t *, uint32_t, uint32_t, bool);
+    uint32_t Crc_CalculateCRC32P4(const uint8_t *, uint32_t, uint32_t, bool);
+    uint64_t Crc_CalculateCRC64(const uint8_t *, uint32_t, uint64_t, bool);
+
+    void e2e_p01_protect(uint8_t *, uint16_t, uint16_t, uint16_t, bool);
+    int  e2e_p01_check(const uint8_t *, uint16_t, uint16_t, uint16_t, uint32_t *);
+    void e2e_p02_protect(uint8_t *, uint32_t, const uint8_t *, bool);
+    int  e2e_p02_check(const uint8_t *, uint32_t, const uint8_t *, uint32_t *);
+    void e2e_p04_protect(uint8_t *, uint16_t, uint32_t, uint16_t, bool);
+    int  e2e_p04_check(const uint8_t *, uint16_t, uint32_t, uint16_t, uint32_t *);
+    void e2e_p05_protect(uint8_t *, uint16_t, uint16_t, uint16_t, bool);
+    int  e2e_p05_check(const uint8_t *, uint16_t, uint16_t, uint16_t, uint32_t *);
+    void e2e_p06_protect(uint8_t *, uint16_t, uint16_t, uint16_t, bool);
+    int  e2e_p06_check(const uint8_t *, uint16_t, uint16_t, uint16_t, uint32_t *);
+    void e2e_p07_protect(uint8_t *, uint32_t, uint32_t, uint32_t, bool);
+    int  e2e_p07_check(const uint8_t *, uint32_t, uint32_t, uint32_t, uint32_t *);
+    """
+)
+
+
+def library_path() -> str:
+    """Return the path of ``_e2e_core``, the C core without Python bindings."""
+    suffix = ".dll" if sys.platform == "win32" else ".so"
+    return os.path.join(os.path.dirname(__file__), "_e2e_core" + suffix)
+
+
+lib: Any = ffi.dlopen(library_path())
+lib.Crc_Init()
+# _e2e_core has its own copy of the kernel thresholds, keep it in sync with
+# the tuned and cached values of the extension module
+_crctune.add_setter(
+    lambda algorithm, threshold: lib.Crc_SetThreshold(
+        _crctune.ALGORITHMS.index(algorithm), threshold
+    )
+)
+
+NULL = ffi.NULL
+E2E_RESULT_OK = 0
+
+# PyArg_Parse formats "B", "H", "I", "k" and "K" truncate without overflow check
+_U8 = 0xFF
+_U16 = 0xFFFF
+_U32 = 0xFFFFFFFF
+_ULONG = (1 << 8 * ffi.sizeof("unsigned long")) - 1
+_U64 = 0xFFFFFFFFFFFFFFFF
+
+_from_buffer = ffi.from_buffer
+_index = operator.index
+
+
+def _readable(data: Any) -> Any:
+    return _from_buffer("uint8_t[]", data)
+
+
+def _writable(data: Any) -> Any:
+    try:
+        return _from_buffer("uint8_t[]", data, require_writable=True)
+    except (BufferError, TypeError):
+        if memoryview(data).readonly:
+            raise ValueError(
+                '"data" must be mutable. Use a bytearray or any '
+                "object that implements the buffer protocol."
+            ) from None
+        raise
+
+
+def _length_error(condition: str) -> ValueError:
+    return ValueError(
+        f'Parameter "length" must fulfill the following condition: {condition}.'
+    )
+
+
+def _size_error(condition: str) -> ValueError:
+    return ValueError(f'The length of bytearray "data" must be {condition}.')
+
+
+def _offset_error() -> ValueError:
+    return ValueError('Argument "offset" invalid.')
+
+
+# e2e.crc
+
+
+def calculate_crc8(data: Any, start_value: int = 0xFF, first_call: bool = True) -> int:
+    buf = _readable(data)
+    start = _index(start_value) & _U8
+    return lib.Crc_CalculateCRC8(buf, len(buf) & _U32, start, bool(first_call))
+
+
+def calculate_crc8_h2f(
+    data: Any, start_value: int = 0xFF, first_call: bool = True
+) -> int:
+    buf = _readable(data)
+    start = _index(start_value) & _U8
+    return lib.Crc_CalculateCRC8H2F(buf, len(buf) & _U32, start, bool(first_call))
+
+
+def calculate_crc16(
+    data: Any, start_value: int = 0xFFFF, first_call: bool = True
+) -> int:
+    buf = _readable(data)
+    start = _index(start_value) & _U16
+    return lib.Crc_CalculateCRC16(buf, len(buf) & _U32, start, bool(first_call))
+
+
+def calculate_crc16_arc(
+    data: Any, start_value: int = 0x0000, first_call: bool = True
+) -> int:
+    buf = _readable(data)
+    start = _index(start_value) & _U16
+    return lib.Crc_CalculateCRC16ARC(buf, len(buf) & _U32, start, bool(first_call))
+
+
+def calculate_crc32(
+    data: Any, start_value: int = 0xFFFFFFFF, first_call: bool = True
+) -> int:
+    buf = _readable(data)
+    start = _index(start_value) & _ULONG & _U32
+    return lib.Crc_CalculateCRC32(buf, len(buf) & _U32, start, bool(first_call))
+
+
+def calculate_crc32_p4(
+    data: Any, start_value: int = 0xFFFFFFFF, first_call: bool = True
+) -> int:
+    buf = _readable(data)
+    start = _index(start_value) & _ULONG & _U32
+    return lib.Crc_CalculateCRC32P4(buf, len(buf) & _U32, start, bool(first_call))
+
+
+def calculate_crc64(
+    data: Any, start_value: int = 0xFFFFFFFFFFFFFFFF, first_call: bool = True
+) -> int:
+    buf = _readable(data)
+    start = _index(start_value) & _U64
+    return lib.Crc_CalculateCRC64(buf, len(buf) & _U32, start, bool(first_call))
+
+
+# e2e.p01
+
+
+def e2e_p01_protect(
+    data: Any,
+    length: int,
+    data_id: int,
+    *,
+    data_id_mode: int = 0,
+    increment_counter: bool = True,
+) -> None:
+    length, data_id = _index(length) & _U16, _index(data_id) & _U16
+    data_id_mode, increment = _index(data_id_mode) & _U16, bool(increment_counter)
+    buf = _writable(data)
+    size = len(buf)
+    if size <= 2:
+        raise _size_error("greater than 2")
+    if length < 1 or length > size - 1:
+        raise _length_error("1 <= length <= len(data) - 1")
+    lib.e2e_p01_protect(buf, length, data_id, data_id_mode, increment)
+
+
+def e2e_p01_check(
+    data: Any, length: int, data_id: int, *, data_id_mode: int = 0
+) -> bool:
+    length, data_id = _index(length) & _U16, _index(data_id) & _U16
+    data_id_mode = _index(data_id_mode) & _U16
+    buf = _writable(data)
+    size = len(buf)
+    if size < 2:
+        raise _size_error("greater than 1")
+    if length < 1 or length > size - 1:
+        raise _length_error("1 <= length < len(data)")
+    result = lib.e2e_p01_check(buf, length, data_id, data_id_mode, NULL)
+    return result == E2E_RESULT_OK
+
+
+# e2e.p02
+
+
+def _data_id_list(data_id_list: Any) -> Any:
+    ids = _readable(data_id_list)
+    if len(ids) != 16:
+        raise ValueError(
+            'Argument "data_id_list" must be a bytes object with length 16.'
+        )
+    return ids
+
+
+def e2e_p02_protect(
+    data: Any, length: int, data_id_list: Any, *, increment_counter: bool = True
+) -> None:
+    length, increment = _index(length) & _ULONG, bool(increment_counter)
+    buf = _writable(data)
+    size = len(buf)
+    if size <= 2:
+        raise _size_error("greater than 2")
+    if length < 1 or length > size - 1:
+        raise _length_error("1 <= length <= len(data) - 1")
+    lib.e2e_p02_protect(buf, length, _data_id_list(data_id_list), increment)
+
+
+def e2e_p02_check(data: Any, length: int, data_id_list: Any) -> bool:
+    length = _index(length) & _ULONG
+    buf = _readable(data)
+    size = len(buf)
+    if size < 2:
+        raise _size_error("greater than 1")
+    if length < 1 or length > size - 1:
+        raise _length_error("1 <= length < len(data)")
+    result = lib.e2e_p02_check(buf, length, _data_id_list(data_id_list), NULL)
+    return result == E2E_RESULT_OK
+
+
+# e2e.p04
+
+
+def e2e_p04_protect(
+    data: Any,
+    length: int,
+    data_id: int,
+    *,
+    offset: int = 0,
+    increment_counter: bool = True,
+) -> None:
+    length, data_id = _index(length) & _U16, _index(data_id) & _ULONG & _U32
+    offset, increment = _index(offset) & _U16, bool(increment_counter)
+    buf = _writable(data)
+    size = len(buf)
+    if size < 12:
+        raise _size_error("greater than or equal to 12")
+    if length < 12 or length > size:
+        raise _length_error("12 <= length <= len(data)")
+    if offset > size - 12:
+        raise _offset_error()
+    lib.e2e_p04_protect(buf, length, data_id, offset, increment)
+
+
+def e2e_p04_check(data: Any, length: int, data_id: int, *, offset: int = 0) -> bool:
+    length, data_id = _index(length) & _U16, _index(data_id) & _ULONG & _U32
+    offset = _index(offset) & _U16
+    buf = _readable(data)
+    size = len(buf)
+    if size < 12:
+        raise _size_error("greater or equal to 12")
+    if length < 12 or length > size:
+        raise _length_error("12 <= length <= len(data)")
+    if offset > size - 12:
+        raise _offset_error()
+    return lib.e2e_p04_check(buf, length, data_id, offset, NULL) == E2E_RESULT_OK
+
+
+# e2e.p05
+
+
+def e2e_p05_protect(
+    data: Any,
+    length: int,
+    data_id: int,
+    *,
+    offset: int = 0,
+    increment_counter: bool = True,
+) -> None:
+    length, data_id = _index(length) & _U16, _index(data_id) & _U16
+    offset, increment = _index(offset) & _U16, bool(increment_counter)
+    buf = _writable(data)
+    size = len(buf)
+    if size <= 3:
+        raise _size_error("greater than 3")
+    if length < 1 or length > size - 2:
+        raise _length_error("1 <= length <= len(data) - 2")
+    if offset > size - 3 or offset + 1 > length:
+        raise _offset_error()
+    lib.e2e_p05_protect(buf, length, data_id, offset, increment)
+
+
+def e2e_p05_check(data: Any, length: int, data_id: int, *, offset: int = 0) -> bool:
+    length, data_id = _index(length) & _U16, _index(data_id) & _U16
+    offset = _index(offset) & _U16
+    buf = _readable(data)
+    size = len(buf)
+    if size <= 3:
+        raise _size_error("greater than 3")
+    if length < 1 or length > size - 2:
+        raise _length_error("1 <= length <= len(data) - 2")
+    if offset > size - 3 or offset + 1 > length:
+        raise _offset_error()
+    return lib.e2e_p05_check(buf, length, data_id, offset, NULL) == E2E_RESULT_OK
+
+
+# e2e.p06
+
+
+def e2e_p06_protect(
+    data: Any,
+    length: int,
+    data_id: int,
+    *,
+    offset: int = 0,
+    increment_counter: bool = True,
+) -> None:
+    length, data_id = _index(length) & _U16, _index(data_id) & _U16
+    offset, increment = _index(offset) & _U16, bool(increment_counter)
+    buf = _writable(data)
+    size = len(buf)
+    if size < 5:
+        raise _size_error("greater than or equal to 20")  # sic, like e2e._e2e
+    if length < 5 or length > size:
+        raise _length_error("5 <= length <= len(data)")
+    if offset > size - 5 or offset + 5 > length:
+        raise _offset_error()
+    lib.e2e_p06_protect(buf, length, data_id, offset, increment)
+
+
+def e2e_p06_check(data: Any, length: int, data_id: int, *, offset: int = 0) -> bool:
+    length, data_id = _index(length) & _ULONG, _index(data_id) & _ULONG
+    offset = _index(offset) & _ULONG
+    buf = _readable(data)
+    size = len(buf)
+    if size < 5:
+        raise _size_error("greater or equal to 5")
+    if length < 5 or length > size:
+        raise _length_error("5 <= length <= len(data)")
+    if offset > size - 5 or (offset & _U16) + 5 > (length & _U16):
+        raise _offset_error()
+    # validated with the full values, then truncated like in e2e._e2e
+    result = lib.e2e_p06_check(buf, length & _U16, data_id & _U16, offset & _U16, NULL)
+    return result == E2E_RESULT_OK
+
+
+# e2e.p07
+
+
+def e2e_p07_protect(
+    data: Any,
+    length: int,
+    data_id: int,
+    *,
+    offset: int = 0,
+    increment_counter: bool = True,
+) -> None:
+    length, data_id = _index(length) & _ULONG, _index(data_id) & _ULONG & _U32
+    offset, increment = _index(offset) & _ULONG, bool(increment_counter)
+    buf = _writable(data)
+    size = len(buf)
+    if size < 20:
+        raise _size_error("greater than or equal to 20")
+    if length < 20 or length > size:
+        raise _length_error("20 <= length <= len(data)")
+    if offset > size - 20:
+        raise _offset_error()
+    lib.e2e_p07_protect(buf, length, data_id, offset, increment)
+
+
+def e2e_p07_check(data: Any, length: int, data_id: int, *, offset: int = 0) -> bool:
+    length, data_id = _index(length) & _ULONG, _index(data_id) & _ULONG & _U32
+    offset = _index(offset) & _ULONG
+    buf = _readable(data)
+    size = len(buf)
+    if size < 20:
+        raise _size_error("greater or equal to 20")
+    if length < 20 or length > size:
+        raise _length_error("20 <= length <= len(data)")
+    if offset > size - 20:
+        raise _offset_error()
+    return lib.e2e_p07_check(buf, length, data_id, offset, NULL) == E2E_RESULT_OK
+
+
+FUNCTIONS: Dict[str, Tuple[Callable[..., Any], ...]] = {
+    "e2e.crc": (
+        calculate_crc8,
+        calculate_crc8_h2f,
+        calculate_crc16,
+        calculate_crc16_arc,
+        calculate_crc32,
+        calculate_crc32_p4,
+        calculate_crc64,
+    ),
+    "e2e.p01": (e2e_p01_protect, e2e_p01_check),
+    "e2e.p02": (e2e_p02_protect, e2e_p02_check),
+    "e2e.p04": (e2e_p04_protect, e2e_p04_check),
+    "e2e.p05": (e2e_p05_protect, e2e_p05_check),
+    "e2e.p06": (e2e_p06_protect, e2e_p06_check),
+    "e2e.p07": (e2e_p07_protect, e2e_p07_check),
+}
+
+
+def install(module: ModuleType) -> None:
+    """Replace the extension functions of e2e.crc or e2e.pXX by the ones above.
+
+    The module must already be filled by e2e._e2e._init_submodule(), which
+    also provides the constants and the docstrings.
+    """
+    for func in FUNCTIONS[module.__name__]:
+        func.__doc__ = getattr(module, func.__name__).__doc__
+        func.__module__ = module.__name__
+        setattr(module, func.__name__, func)
@@ -0,0 +1,280 @@
+import os
+import sys
+import threading
+import warnings
+from typing import Any, Callable, Dict, Iterable, List, Optional
+
+from e2e import _e2e
+
+ALGORITHMS = ("crc8", "crc8h2f", "crc16", "crc16arc", "crc32", "crc32p4", "crc64")
+KERNELS = ("table", "slice8")
+NEVER = 0xFFFFFFFF  # threshold which keeps the table kernel for all lengths
+
+SIZES = (1, 2, 4, 8, 12, 16, 24, 32, 48, 64, 96, 128, 256, 512, 1024, 4096)
+_CACHE_VERSION = 1
+
+_lock = threading.Lock()
+_DEFAULTS: Dict[str, int] = _e2e._crc_thresholds()
+_sources: Dict[str, str] = dict.fromkeys(ALGORITHMS, "default")
+# every copy of crclib in the process, e2e._cffi adds the one of _e2e_core
+_setters: List[Callable[[str, int], None]] = [_e2e._set_crc_threshold]
+
+
+def cpu_signature() -> str:
+    """Return a string which identifies the CPU model, the key of the cache."""
+    # no platform module, it is slow to import and processor() may start a subprocess
+    if sys.platform == "win32":
+        fields = [os.environ.get("PROCESSOR_IDENTIFIER", "")]
+    else:
+        fields = [os.uname().machine]
+    if sys.platform.startswith("linux"):
+        keys = ("vendor_id", "cpu family", "model", "model name", "stepping")
+        keys += ("CPU implementer", "CPU part", "CPU variant", "CPU revision")
+        try:
+            with open("/proc/cpuinfo") as f:
+                for line in f:
+                    if not line.strip():
+                        break  # the first processor is enough
+                    key, _, value = line.partition(":")
+                    if key.strip() in keys:
+                        fields.append(value.strip())
+        except OSError:
+            pass
+    fields.append("+".join(KERNELS))
+    return "/".join(fields)
+
+
+def cache_path() -> str:
+    """Return the path of the cache file, ``E2E_CRC_CACHE`` overrides it."""
+    path = os.environ.get("E2E_CRC_CACHE")
+    if path:
+        return path
+    if sys.platform == "win32":
+        base = os.environ.get("LOCALAPPDATA") or os.path.expanduser("~")
+    elif sys.platform == "darwin":
+        base = os.path.expanduser("~/Library/Caches")
+    else:
+        base = os.environ.get("XDG_CACHE_HOME") or os.path.expanduser("~/.cache")
+    return os.path.join(base, "autosar-e2e", "crc_kernels.json")
+
+
+def _apply(thresholds: Dict[str, int], source: str) -> None:
+    for algorithm, threshold in thresholds.items():
+        for setter in _setters:
+            setter(algorithm, threshold)
+        _sources[algorithm] = source
+
+
+def add_setter(setter: Callable[[str, int], None]) -> None:
+    """Call ``setter(algorithm, threshold)`` now and whenever a threshold changes."""
+    with _lock:
+        for algorithm, threshold in _e2e._crc_thresholds().items():
+            setter(algorithm, threshold)
+        _setters.append(setter)
+
+
+def _forced() -> Dict[str, int]:
+    """Parse ``E2E_CRC_KERNEL``, e.g. ``slice8`` or ``crc32=table,crc64=slice8``."""
+    value = os.environ.get("E2E_CRC_KERNEL", "")
+    thresholds: Dict[str, int] = {}
+    for item in filter(None, (part.strip() for part in value.split(","))):
+        algorithm, _, kernel = item.rpartition("=")
+        algorithms = [algorithm] if algorithm else list(ALGORITHMS)
+        if kernel not in KERNELS or not set(algorithms) <= set(ALGORITHMS):
+            warnings.warn(f"E2E_CRC_KERNEL: ignoring invalid entry {item!r}")
+            continue
+        for name in algorithms:
+            thresholds[name] = 0 if kernel == "slice8" else NEVER
+    return thresholds
+
+
+def _read_cache(path: str) -> Dict[str, Any]:
+    try:
+        with open(path) as f:
+            text = f.read()
+    except OSError:
+        return {}
+    import json  # deferred, a fresh installation has no cache file
+
+    try:
+        data = json.loads(text)
+    except ValueError:
+        return {}
+    if not isinstance(data, dict) or data.get("version") != _CACHE_VERSION:
+        return {}
+    return data
+
+
+def _cached(path: str) -> Dict[str, int]:
+    """Return the valid thresholds of this CPU from the cache file at path.
+
+    The file may be stale or edited by hand, invalid parts are ignored with a
+    warning, so that they never break the import of e2e.
+    """
+    cpus = _read_cache(path).get("cpus", {})
+    if not isinstance(cpus, dict):
+        warnings.warn(f"{path}: ignoring invalid 'cpus' entry")
+        return {}
+    entry = cpus.get(cpu_signature(), {})
+    if not isinstance(entry, dict):
+        warnings.warn(f"{path}: ignoring invalid entry of this CPU")
+        return {}
+    thresholds: Dict[str, int] = {}
+    for algorithm, threshold in entry.items():
+        if algorithm not in ALGORITHMS:
+            continue
+        if type(threshold) is not int or not 0 <= threshold <= NEVER:
+            warnings.warn(f"{path}: ignoring invalid threshold {algorithm}={threshold!r}")
+            continue
+        thresholds[algorithm] = threshold
+    return thresholds
+
+
+def load() -> None:
+    """Apply the cached crossover table of this CPU and ``E2E_CRC_KERNEL``."""
+    with _lock:
+        _apply(_DEFAULTS, "default")
+        _apply(_cached(cache_path()), "cache")
+        _apply(_forced(), "environment")
+
+
+def _time(
+    algorithm: str, kernel: str, size: int, min_time: float, repeats: int
+) -> float:
+    """Return the best time per call in seconds."""
+    number = 1
+    while True:
+        elapsed = _e2e._time_crc_kernel(algorithm, kernel, size, number)
+        if elapsed >= min_time or number >= 1 << 24:
+            break
+        number *= 2
+    best = elapsed / number
+    for _ in range(repeats - 1):
+        best = min(best, _e2e._time_crc_kernel(algorithm, kernel, size, number) / number)
+    return best
+
+
+def _crossover(times: Dict[int, Dict[str, float]]) -> int:
+    """Return the smallest size from which on slice-by-8 is always faster."""
+    threshold = NEVER
+    for size in sorted(times, reverse=True):
+        if times[size]["slice8"] >= times[size]["table"]:
+            break
+        threshold = size
+    return threshold
+
+
+def tune(
+    sizes: Optional[Iterable[int]] = None,
+    min_time: float = 0.001,
+    repeats: int = 3,
+    save: bool = True,
+) -> Dict[str, int]:
+    """Measure the CRC kernels on this CPU and select the fastest per size.
+
+    Every algorithm has a byte-wise table kernel and a slice-by-8 kernel. The
+    table kernel has less setup cost, slice-by-8 processes 8 bytes per step;
+    where one overtakes the other depends on the CPU. This function times
+    both kernels for each size, applies the resulting crossover table and
+    stores it in a cache file keyed by the CPU model, so that later processes
+    on the same CPU model load it without measuring, on the first import of
+    e2e.crc or a profile module e2e.pXX. The cache file is
+    ``~/.cache/autosar-e2e/crc_kernels.json`` on Linux (the environment
+    variable ``E2E_CRC_CACHE`` sets another path).
+
+    A kernel forced by the environment variable ``E2E_CRC_KERNEL``, e.g.
+    ``E2E_CRC_KERNEL=table`` or ``E2E_CRC_KERNEL=crc32=slice8,crc64=table``,
+    takes precedence over the measured table.
+
+    :param sizes:
+        data lengths to measure, by default 1 B to 4 KiB
+    :param float min_time:
+        minimum seconds per measurement
+    :param int repeats:
+        measurements per kernel and size, the best one counts
+    :param bool save:
+        `True` to write the result to the cache file
+    :return:
+        A dict which maps each algorithm to its threshold, the data length
+        from which on slice-by-8 is used. ``0xFFFFFFFF`` means always table.
+    """
+    sizes = sorted(set(SIZES if sizes is None else sizes))
+    thresholds = {}
+    for algorithm in ALGORITHMS:
+        times = {
+            size: {
+                kernel: _time(algorithm, kernel, size, min_time, repeats)
+                for kernel in KERNELS
+            }
+            for size in sizes
+        }
+        thresholds[algorithm] = _crossover(times)
+
+    with _lock:
+        _apply(thresholds, "tuned")
+        _apply(_forced(), "environment")
+    if save:
+        _save(thresholds)
+    return thresholds
+
+
+def _save(thresholds: Dict[str, int]) -> None:
+    import json
+    import tempfile
+
+    path = cache_path()
+    data = _read_cache(path) or {"version": _CACHE_VERSION}
+    if not isinstance(data.get("cpus"), dict):
+        data["cpus"] = {}
+    data["cpus"][cpu_signature()] = thresholds
+    directory = os.path.dirname(path) or "."
+    os.makedirs(directory, exist_ok=True)
+    # write a temporary file and rename it, so that readers never see a partial file
+    fd, tmp = tempfile.mkstemp(dir=directory, suffix=".tmp")
+    try:
+        with os.fdopen(fd, "w") as f:
+            json.dump(data, f, indent=2, sort_keys=True)
+        os.replace(tmp, path)
+    except BaseException:
+        os.unlink(tmp)
+        raise
+
+
+def backend() -> Dict[str, Any]:
+    """Return the active CRC kernel selection.
+
+    :return:
+        A dict with the keys `cpu` (the CPU signature which keys the cache),
+        `cache` (path of the cache file), `kernels` (the available kernels) and
+        `algorithms`. `algorithms` maps each algorithm, e.g. ``"crc32"``, to a
+        dict with `threshold` (data length from which on slice-by-8 is used,
+        ``0xFFFFFFFF`` for never), `kernel` (``"table"``, ``"slice8"`` or
+        ``"table+slice8"`` if the choice depends on the length) and `source`
+        (``"default"``, ``"cache"``, ``"tuned"`` or ``"environment"``).
+    """
+    with _lock:
+        thresholds = _e2e._crc_thresholds()
+        sources = dict(_sources)
+    algorithms = {}
+    for algorithm in ALGORITHMS:
+        threshold = thresholds[algorithm]
+        if threshold == NEVER:
+            kernel = "table"
+        elif threshold <= 8:
+            kernel = "slice8"  # below 8 bytes both kernels run the same byte loop
+        else:
+            kernel = "table+slice8"
+        algorithms[algorithm] = {
+            "threshold": threshold,
+            "kernel": kernel,
+            "source": sources[algorithm],
+        }
+    return {
+        "cpu": cpu_signature(),
+        "cache": cache_path(),
+        "kernels": list(KERNELS),
+        "algorithms": algorithms,
+    }
+
+
+load()
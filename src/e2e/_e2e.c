@@ -0,0 +1,248 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include "e2elib.h"
+#include "kernels.h"
+#include "module.h"
+#include "stats.h"
+
+#if PY_VERSION_HEX < 0x03090000
+// PyType_GetModule() is not available, there is only one module instance
+static module_state *legacy_state = NULL;
+#endif
+
+module_state *get_module_state(PyObject *module) { return (module_state *)PyModule_GetState(module); }
+
+module_state *get_module_state_by_type(PyTypeObject *type)
+{
+#if PY_VERSION_HEX >= 0x03090000
+    PyObject *module = PyType_GetModule(type);
+    if (module == NULL) {
+        return NULL;
+    }
+    return get_module_state(module);
+#else
+    return legacy_state;
+#endif
+}
+
+PyTypeObject *add_type(PyObject *module, PyType_Spec *spec)
+{
+#if PY_VERSION_HEX >= 0x03090000
+    PyObject *type = PyType_FromModuleAndSpec(module, spec, NULL);
+#else
+    PyObject *type = PyType_FromSpec(spec);
+#endif
+    if (type == NULL) {
+        return NULL;
+    }
+
+    const char *name = strrchr(spec->name, '.');
+    name             = (name == NULL) ? spec->name : name + 1;
+    Py_INCREF(type);
+    if (PyModule_AddObject(module, name, type) < 0) {
+        Py_DECREF(type);
+        Py_DECREF(type);
+        return NULL;
+    }
+    // the module state keeps the second reference
+    return (PyTypeObject *)type;
+}
+
+PyObject *alloc_instance(PyTypeObject *type)
+{
+    allocfunc alloc = (allocfunc)PyType_GetSlot(type, Py_tp_alloc);
+    return alloc(type, 0);
+}
+
+static int _AddUnsignedIntConstant(PyObject *module, const char *name, uint64_t value)
+{
+    PyObject *obj = PyLong_FromUnsignedLongLong(value);
+    if (PyModule_AddObject(module, name, obj) < 0) {
+        Py_XDECREF(obj);
+        return -1;
+    }
+    return 0;
+}
+
+#define _AddUnsignedIntMacro(m, c) _AddUnsignedIntConstant(m, #c, c)
+
+typedef struct {
+    const char *name;
+    int (*init)(PyObject *module);
+} submodule_t;
+
+static const submodule_t submodules[] = {
+    {"e2e.crc", crc_init_submodule},
+    {"e2e.p01", p01_init_submodule},
+    {"e2e.p02", p02_init_submodule},
+    {"e2e.p04", p04_init_submodule},
+    {"e2e.p05", p05_init_submodule},
+    {"e2e.p06", p06_init_submodule},
+    {"e2e.p07", p07_init_submodule},
+};
+
+// Add the functions and constants of a submodule to the module object of its Python file
+static PyObject *py_init_submodule(PyObject *module, PyObject *submodule)
+{
+    PyObject *name = PyModule_GetNameObject(submodule);
+    if (name == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0; i < sizeof(submodules) / sizeof(submodules[0]); ++i) {
+        if (PyUnicode_CompareWithASCIIString(name, submodules[i].name) == 0) {
+            Py_DECREF(name);
+            if (submodules[i].init(submodule) < 0) {
+                return NULL;
+            }
+            Py_RETURN_NONE;
+        }
+    }
+    PyErr_Format(PyExc_ValueError, "unknown submodule %R", name);
+    Py_DECREF(name);
+    return NULL;
+}
+
+// clang-format off
+static struct PyMethodDef _e2e_methods[] = {
+    {"_init_submodule", (PyCFunction)py_init_submodule, METH_O, NULL},
+    {NULL} // sentinel
+};
+// clang-format on
+
+// Module execution function for multi-phase initialization
+static int _e2e_exec(PyObject *module)
+{
+    module_state *state = get_module_state(module);
+#if PY_VERSION_HEX < 0x03090000
+    legacy_state = state;
+#endif
+
+    if (_AddUnsignedIntMacro(module, E2E_STATUS_OK) < 0 ||
+        _AddUnsignedIntMacro(module, E2E_STATUS_NONEWDATA) < 0 ||
+        _AddUnsignedIntMacro(module, E2E_STATUS_ERROR) < 0 ||
+        _AddUnsignedIntMacro(module, E2E_STATUS_REPEATED) < 0 ||
+        _AddUnsignedIntMacro(module, E2E_STATUS_OKSOMELOST) < 0 ||
+        _AddUnsignedIntMacro(module, E2E_STATUS_WRONGSEQUENCE) < 0 ||
+        _AddUnsignedIntMacro(module, E2E_STATUS_UNKNOWN_ID) < 0) {
+        return -1;
+    }
+
+    if (column_init_type(module, state) < 0 || config_init_type(module, state) < 0 ||
+        router_init_type(module, state) < 0 || monitor_init_type(module, state) < 0 ||
+        framering_init_type(module, state) < 0 || scheduler_init_type(module, state) < 0 ||
+        verifier_init_type(module, state) < 0 || recorder_init_type(module, state) < 0 ||
+        frameview_init_type(module, state) < 0 || layout_init_type(module, state) < 0 ||
+        signalcodec_init_type(module, state) < 0 || batch_init_functions(module, state) < 0) {
+        return -1;
+    }
+    if (PyModule_AddFunctions(module, _e2e_methods) < 0 || e2e_stats_add_functions(module) < 0 ||
+        e2e_kernels_add_functions(module) < 0 || e2e_capi_add_capsule(module) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static int _e2e_traverse(PyObject *module, visitproc visit, void *arg)
+{
+    module_state *state = get_module_state(module);
+    Py_VISIT(state->column_type);
+    Py_VISIT(state->config_type);
+    Py_VISIT(state->router_type);
+    Py_VISIT(state->monitor_type);
+    Py_VISIT(state->framering_type);
+    Py_VISIT(state->scheduler_type);
+    Py_VISIT(state->verifier_type);
+    Py_VISIT(state->recorder_type);
+    Py_VISIT(state->frameview_type);
+    Py_VISIT(state->layout_type);
+    Py_VISIT(state->signalcodec_type);
+    return 0;
+}
+
+static int _e2e_clear(PyObject *module)
+{
+    module_state *state = get_module_state(module);
+    Py_CLEAR(state->column_type);
+    Py_CLEAR(state->config_type);
+    Py_CLEAR(state->router_type);
+    Py_CLEAR(state->monitor_type);
+    Py_CLEAR(state->framering_type);
+    Py_CLEAR(state->scheduler_type);
+    Py_CLEAR(state->verifier_type);
+    Py_CLEAR(state->recorder_type);
+    Py_CLEAR(state->frameview_type);
+    Py_CLEAR(state->layout_type);
+    Py_CLEAR(state->signalcodec_type);
+    return 0;
+}
+
+static void _e2e_free(void *module) { _e2e_clear((PyObject *)module); }
+
+#if PY_VERSION_HEX >= 0x030B0000 && !defined(Py_mod_multiple_interpreters)
+// The limited API of Python 3.11 hides these, their values are part of the stable ABI since 3.12
+#define Py_mod_multiple_interpreters         3
+#define Py_MOD_PER_INTERPRETER_GIL_SUPPORTED ((void *)2)
+#endif
+
+// Array of slot definitions for multi-phase initialization. Python 3.11
+// rejects unknown slots, so the abi3 build selects the slots at runtime.
+static PyModuleDef_Slot _e2e_slots[] = {{Py_mod_exec, (void *)_e2e_exec},
+#ifdef Py_GIL_DISABLED
+                                        {Py_mod_gil, Py_MOD_GIL_NOT_USED},
+#endif
+                                        {0, NULL}};
+
+#if PY_VERSION_HEX >= 0x030B0000
+// All Python objects live in the module state and in heap types, the C state
+// which is shared by the whole process (CRC tables and thresholds, stats) is
+// atomic. So every isolated subinterpreter with its own GIL may load e2e.
+static PyModuleDef_Slot _e2e_slots_isolated[] = {
+    {Py_mod_exec, (void *)_e2e_exec},
+    {Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED},
+#ifdef Py_GIL_DISABLED
+    {Py_mod_gil, Py_MOD_GIL_NOT_USED},
+#endif
+    {0, NULL}};
+#endif
+
+// Module definition
+static struct PyModuleDef _e2e_module = {PyModuleDef_HEAD_INIT,
+                                         .m_name     = "e2e._e2e",
+                                         .m_doc      = "",
+                                         .m_size     = sizeof(module_state),
+                                         .m_methods  = NULL,
+                                         .m_slots    = _e2e_slots,
+                                         .m_traverse = _e2e_traverse,
+                                         .m_clear    = _e2e_clear,
+                                         .m_free     = _e2e_free};
+
+#if PY_VERSION_HEX >= 0x030B0000
+static struct PyModuleDef _e2e_module_isolated = {PyModuleDef_HEAD_INIT,
+                                                  .m_name     = "e2e._e2e",
+                                                  .m_doc      = "",
+                                                  .m_size     = sizeof(module_state),
+                                                  .m_methods  = NULL,
+                                                  .m_slots    = _e2e_slots_isolated,
+                                                  .m_traverse = _e2e_traverse,
+                                                  .m_clear    = _e2e_clear,
+                                                  .m_free     = _e2e_free};
+#endif
+
+// Init function
+PyMODINIT_FUNC PyInit__e2e(void)
+{
+#if PY_VERSION_HEX >= 0x030B0000
+    if (Py_Version >= 0x030C0000) {
+        return PyModuleDef_Init(&_e2e_module_isolated);
+    }
+#endif
+    return PyModuleDef_Init(&_e2e_module);
+}
@@ -0,0 +1,309 @@
+from array import array
+from types import ModuleType
+from typing import (
+    Any,
+    Dict,
+    Final,
+    Iterable,
+    List,
+    Literal,
+    Mapping,
+    Optional,
+    Sequence,
+    Tuple,
+    Union,
+    overload,
+)
+
+E2E_STATUS_OK: Final[int]
+E2E_STATUS_NONEWDATA: Final[int]
+E2E_STATUS_ERROR: Final[int]
+E2E_STATUS_REPEATED: Final[int]
+E2E_STATUS_OKSOMELOST: Final[int]
+E2E_STATUS_WRONGSEQUENCE: Final[int]
+E2E_STATUS_UNKNOWN_ID: Final[int]
+_C_API: Final[Any]  # PyCapsule "e2e._C_API"
+
+class Config:
+    def __init__(
+        self,
+        profile: int,
+        data_id: int = 0,
+        length: int = 0,
+        *,
+        offset: int = 0,
+        data_id_mode: int = 0,
+        data_id_list: Union[bytes, None] = None,
+        max_delta_counter: int = 1,
+    ) -> None: ...
+    @property
+    def profile(self) -> int: ...
+    @property
+    def data_id(self) -> int: ...
+    @property
+    def length(self) -> int: ...
+    @property
+    def offset(self) -> int: ...
+    @property
+    def data_id_mode(self) -> int: ...
+    @property
+    def data_id_list(self) -> Union[bytes, None]: ...
+    @property
+    def max_delta_counter(self) -> int: ...
+
+class Router:
+    def __init__(
+        self,
+        configs: Union[Mapping[int, Config], Iterable[Tuple[int, Config]]],
+        *,
+        buffer: Union[bytearray, memoryview, None] = None,
+    ) -> None: ...
+    def check(self, id: int, data: bytes) -> int: ...
+    def check_batch(
+        self, ids: Union[Sequence[int], array], frames: Sequence[bytes]
+    ) -> bytes: ...
+    def index(self, id: int) -> int: ...
+    def reset(self) -> None: ...
+    def snapshot(self) -> bytes: ...
+    @classmethod
+    def from_snapshot(
+        cls, buffer: Union[bytes, bytearray, memoryview]
+    ) -> "Router": ...
+    @staticmethod
+    def buffer_size(count: int) -> int: ...
+    def __len__(self) -> int: ...
+    def __contains__(self, id: object) -> bool: ...
+    @property
+    def ids(self) -> memoryview: ...
+    @property
+    def counters(self) -> memoryview: ...
+    @property
+    def statuses(self) -> memoryview: ...
+    @property
+    def frames(self) -> memoryview: ...
+    @property
+    def errors(self) -> memoryview: ...
+    @property
+    def recorder(self) -> Optional["FlightRecorder"]: ...
+
+class DeadlineMonitor:
+    def __init__(
+        self,
+        timeouts: Union[Mapping[int, int], Iterable[Tuple[int, int]]],
+        *,
+        cycle_times: Union[Mapping[int, int], Iterable[Tuple[int, int]], None] = None,
+        start: int = 0,
+        resolution: int = 1,
+    ) -> None: ...
+    def received(self, id: int, now: int) -> None: ...
+    def received_batch(
+        self,
+        ids: Union[Sequence[int], array],
+        times: Union[Sequence[int], array],
+        statuses: Optional[bytes] = None,
+    ) -> None: ...
+    def poll(self, now: int) -> List[int]: ...
+    def __len__(self) -> int: ...
+    def __contains__(self, id: object) -> bool: ...
+    @property
+    def ids(self) -> memoryview: ...
+    @property
+    def last_seen(self) -> memoryview: ...
+    @property
+    def timed_out(self) -> memoryview: ...
+    @property
+    def cycle_histogram(self) -> memoryview: ...
+    @property
+    def jitter_histogram(self) -> memoryview: ...
+
+class FrameRing:
+    def __init__(self, buffer: bytearray, frame_size: int) -> None: ...
+    def push(self, id: int, time: int, data: bytes) -> bool: ...
+    @overload
+    def pop(
+        self, *, status: Literal[False] = False
+    ) -> Optional[Tuple[int, int, bytes]]: ...
+    @overload
+    def pop(
+        self, *, status: Literal[True]
+    ) -> Optional[Tuple[int, int, int, bytes]]: ...
+    @overload
+    def drain(
+        self, limit: int = -1, *, status: Literal[False] = False
+    ) -> List[Tuple[int, int, bytes]]: ...
+    @overload
+    def drain(
+        self, limit: int = -1, *, status: Literal[True]
+    ) -> List[Tuple[int, int, int, bytes]]: ...
+    def __len__(self) -> int: ...
+    @property
+    def capacity(self) -> int: ...
+    @property
+    def frame_size(self) -> int: ...
+
+class FrameView:
+    def __init__(self, buffer: Any) -> None: ...
+    def protect(
+        self, offset: int, length: int, config: Config, *, increment_counter: bool = True
+    ) -> None: ...
+    def check(self, offset: int, length: int, config: Config) -> bool: ...
+    def release(self) -> None: ...
+    def __enter__(self) -> "FrameView": ...
+    def __exit__(self, *args: object) -> None: ...
+    def __len__(self) -> int: ...
+    @property
+    def readonly(self) -> bool: ...
+    @property
+    def released(self) -> bool: ...
+
+class Layout:
+    def __init__(
+        self,
+        algorithm: Literal[
+            "crc8", "crc8h2f", "crc16", "crc16arc", "crc32", "crc32p4", "crc64"
+        ],
+        crc: int,
+        *,
+        counter: Optional[Tuple[int, int]] = None,
+        data_id: Optional[Tuple[int, int]] = None,
+        length: Optional[Tuple[int, int]] = None,
+        byteorder: Literal["big", "little"] = "big",
+        counter_max: Optional[int] = None,
+        data_id_mode: Literal[
+            "none", "both", "low", "alternating", "nibble", "list"
+        ] = "none",
+        data_id_size: int = 2,
+        data_id_shift: int = 0,
+        data_id_position: Literal["prepend", "append"] = "append",
+        crc_initial: Optional[int] = None,
+        crc_xor: Optional[int] = None,
+        coverage: Optional[Iterable[Tuple[int, Optional[int]]]] = None,
+    ) -> None: ...
+    def protect(
+        self,
+        data: Any,
+        data_id: Union[int, bytes],
+        *,
+        offset: int = 0,
+        length: int = 0,
+        increment_counter: bool = True,
+    ) -> None: ...
+    def check(
+        self,
+        data: Any,
+        data_id: Union[int, bytes],
+        *,
+        offset: int = 0,
+        length: int = 0,
+    ) -> bool: ...
+    @property
+    def algorithm(self) -> str: ...
+    @property
+    def header_length(self) -> int: ...
+    @property
+    def counter_max(self) -> int: ...
+    @property
+    def data_id_mode(self) -> str: ...
+
+class Scheduler:
+    def __init__(
+        self,
+        messages: Iterable[
+            Union[Tuple[int, Config, bytes, int], Tuple[int, Config, bytes, int, int]]
+        ],
+        *,
+        start: int = 0,
+        resolution: int = 1,
+    ) -> None: ...
+    def tick(self, now: int, ring: FrameRing) -> int: ...
+    def __len__(self) -> int: ...
+    @property
+    def ids(self) -> memoryview: ...
+    @property
+    def next_times(self) -> memoryview: ...
+    @property
+    def sent(self) -> memoryview: ...
+    @property
+    def frame_size(self) -> int: ...
+
+def check_sequence(
+    keys: Union[Sequence[int], array],
+    frames: Sequence[bytes],
+    configs: Mapping[int, Config],
+    state: Optional[Mapping[int, Optional[int]]] = None,
+) -> Tuple[bytes, Dict[int, Optional[int]]]: ...
+
+class SignalCodec:
+    def __init__(
+        self,
+        signals: Iterable[
+            Union[
+                Tuple[str, int, int],
+                Tuple[str, int, int, Literal["big", "little"]],
+                Tuple[str, int, int, Literal["big", "little"], bool],
+                Tuple[str, int, int, Literal["big", "little"], bool, float],
+                Tuple[str, int, int, Literal["big", "little"], bool, float, float],
+            ]
+        ],
+    ) -> None: ...
+    def pack_protect(
+        self,
+        data: Any,
+        values: Union[Sequence[float], Dict[str, float]],
+        config: Config,
+        *,
+        increment_counter: bool = True,
+    ) -> None: ...
+    def check_unpack(
+        self, frames: Sequence[Any], config: Config
+    ) -> Tuple[bytes, Dict[str, memoryview]]: ...
+    def __len__(self) -> int: ...
+    @property
+    def names(self) -> Tuple[str, ...]: ...
+    @property
+    def frame_size(self) -> int: ...
+
+class Verifier:
+    def __init__(
+        self,
+        router: Router,
+        input: FrameRing,
+        output: FrameRing,
+        *,
+        errors_only: bool = False,
+        idle_time: int = 100,
+    ) -> None: ...
+    def close(self) -> None: ...
+    def __enter__(self) -> "Verifier": ...
+    def __exit__(self, *args: object) -> None: ...
+    @property
+    def running(self) -> bool: ...
+    @property
+    def processed(self) -> int: ...
+    @property
+    def failed(self) -> int: ...
+
+class FlightRecorder:
+    def __init__(
+        self,
+        router: Router,
+        *,
+        depth: int = 4,
+        capacity: int = 64,
+        frame_size: int = 64,
+    ) -> None: ...
+    def dump(self) -> List[Dict[str, Any]]: ...
+    @property
+    def errors(self) -> int: ...
+    @property
+    def depth(self) -> int: ...
+    @property
+    def capacity(self) -> int: ...
+    @property
+    def frame_size(self) -> int: ...
+def _init_submodule(module: ModuleType, /) -> None: ...
+def _stats() -> Tuple[str, Dict[str, Dict[str, Any]]]: ...
+def _enable_stats(enabled: bool, /) -> None: ...
+def _crc_thresholds() -> Dict[str, int]: ...
+def _set_crc_threshold(algorithm: str, threshold: int, /) -> None: ...
+def _time_crc_kernel(algorithm: str, kernel: str, size: int, number: int, /) -> float: ...
@@ -0,0 +1,80 @@
+import os
+import threading
+from typing import Any, Dict, List
+
+from e2e import _e2e
+
+_lock = threading.Lock()
+_enabled = False
+_baseline: Dict[str, Dict[str, Any]] = {}
+
+
+def _collect() -> "tuple[str, Dict[str, Dict[str, Any]]]":
+    return _e2e._stats()
+
+
+def _subtract(value: Dict[str, Any], base: Dict[str, Any]) -> Dict[str, Any]:
+    latency: List[int] = [a - b for a, b in zip(value["latency"], base["latency"])]
+    return {
+        "calls": value["calls"] - base["calls"],
+        "bytes": value["bytes"] - base["bytes"],
+        "failures": {
+            reason: count - base["failures"][reason]
+            for reason, count in value["failures"].items()
+        },
+        "latency": latency,
+    }
+
+
+def enable_stats(enabled: bool = True) -> None:
+    """Switch the collection of call statistics on or off.
+
+    Statistics are off by default, a disabled function pays a single flag
+    test. Setting the environment variable ``E2E_STATS=1`` enables them on
+    import.
+
+    :param bool enabled:
+        `True` to count every call of the protect, check and CRC functions
+    """
+    global _enabled
+    with _lock:
+        _e2e._enable_stats(enabled)
+        _enabled = bool(enabled)
+
+
+def stats() -> Dict[str, Any]:
+    """Return the call statistics of the protect, check and CRC functions.
+
+    Counters are kept per thread and summed up on each call of this function.
+
+    :return:
+        A dict with the keys `enabled`, `clock` and `functions`. `clock` names
+        the time base of the latency histograms: ``"tsc"`` (x86 time stamp
+        counter), ``"cntvct"`` (ARM generic timer), ``"qpc"`` (Windows
+        performance counter) or ``"ns"`` (monotonic nanoseconds). `functions`
+        maps each function name, e.g. ``"e2e_p05_check"``, to a dict with
+        `calls`, `bytes` (total length of the passed data), `failures` (failed
+        checks per reason ``"bad_frame"``, ``"length_mismatch"``,
+        ``"data_id_mismatch"``, ``"counter_range"`` and ``"crc_mismatch"``)
+        and `latency`, a list of 32 buckets where bucket `i` counts the calls
+        which took :math:`[2^i, 2^{i+1})` clock ticks.
+    """
+    with _lock:
+        clock, functions = _collect()
+        if _baseline:
+            functions = {
+                name: _subtract(value, _baseline[name])
+                for name, value in functions.items()
+            }
+        return {"enabled": _enabled, "clock": clock, "functions": functions}
+
+
+def reset_stats() -> None:
+    """Set all call statistics to zero."""
+    global _baseline
+    with _lock:
+        _baseline = _collect()[1]
+
+
+if os.environ.get("E2E_STATS", "0") not in ("", "0"):
+    enable_stats()
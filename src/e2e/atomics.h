@@ -0,0 +1,206 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef ATOMICS_H
+#define ATOMICS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Minimal atomic operations on the columns of the message table. The columns
+// are plain arrays inside one memory block, so the operations take ordinary
+// pointers. C11 <stdatomic.h> is used where available, MSVC falls back to
+// the Interlocked intrinsics.
+
+#if defined(_MSC_VER) && !defined(__clang__)
+
+#include <intrin.h>
+
+typedef volatile int64_t  e2e_atomic_i64_t;
+typedef volatile uint64_t e2e_atomic_u64_t;
+typedef volatile uint8_t  e2e_atomic_u8_t;
+typedef void *volatile    e2e_atomic_ptr_t;
+
+static __inline int64_t e2e_atomic_load_i64(e2e_atomic_i64_t *ptr)
+{
+    return _InterlockedCompareExchange64((volatile __int64 *)ptr, 0, 0);
+}
+
+static __inline void e2e_atomic_store_i64(e2e_atomic_i64_t *ptr, int64_t value)
+{
+    _InterlockedExchange64((volatile __int64 *)ptr, value);
+}
+
+static __inline bool e2e_atomic_cas_i64(e2e_atomic_i64_t *ptr, int64_t *expected, int64_t desired)
+{
+    int64_t previous = _InterlockedCompareExchange64((volatile __int64 *)ptr, desired, *expected);
+    if (previous == *expected) {
+        return true;
+    }
+    *expected = previous;
+    return false;
+}
+
+static __inline uint64_t e2e_atomic_load_u64(e2e_atomic_u64_t *ptr)
+{
+    return (uint64_t)_InterlockedCompareExchange64((volatile __int64 *)ptr, 0, 0);
+}
+
+static __inline void e2e_atomic_store_u64(e2e_atomic_u64_t *ptr, uint64_t value)
+{
+    _InterlockedExchange64((volatile __int64 *)ptr, (__int64)value);
+}
+
+static __inline uint64_t e2e_atomic_load_acquire_u64(e2e_atomic_u64_t *ptr)
+{
+    return (uint64_t)_InterlockedCompareExchange64((volatile __int64 *)ptr, 0, 0);
+}
+
+static __inline void e2e_atomic_store_release_u64(e2e_atomic_u64_t *ptr, uint64_t value)
+{
+    _InterlockedExchange64((volatile __int64 *)ptr, (__int64)value);
+}
+
+static __inline void e2e_atomic_add_u64(e2e_atomic_u64_t *ptr, uint64_t value)
+{
+    _InterlockedExchangeAdd64((volatile __int64 *)ptr, (__int64)value);
+}
+
+static __inline uint64_t e2e_atomic_fetch_add_u64(e2e_atomic_u64_t *ptr, uint64_t value)
+{
+    return (uint64_t)_InterlockedExchangeAdd64((volatile __int64 *)ptr, (__int64)value);
+}
+
+static __inline void *e2e_atomic_load_ptr(e2e_atomic_ptr_t *ptr)
+{
+    return _InterlockedCompareExchangePointer((void *volatile *)ptr, NULL, NULL);
+}
+
+static __inline void e2e_atomic_store_ptr(e2e_atomic_ptr_t *ptr, void *value)
+{
+    _InterlockedExchangePointer((void *volatile *)ptr, value);
+}
+
+static __inline bool e2e_atomic_cas_ptr(e2e_atomic_ptr_t *ptr, void **expected, void *desired)
+{
+    void *previous = _InterlockedCompareExchangePointer((void *volatile *)ptr, desired, *expected);
+    if (previous == *expected) {
+        return true;
+    }
+    *expected = previous;
+    return false;
+}
+
+#if defined(_M_ARM64)
+static __inline void e2e_atomic_fence_acquire(void) { __dmb(_ARM64_BARRIER_ISH); }
+
+static __inline void e2e_atomic_fence_release(void) { __dmb(_ARM64_BARRIER_ISH); }
+#else
+// x86 does not reorder loads with loads or stores with stores
+static __inline void e2e_atomic_fence_acquire(void) { _ReadWriteBarrier(); }
+
+static __inline void e2e_atomic_fence_release(void) { _ReadWriteBarrier(); }
+#endif
+
+static __inline uint8_t e2e_atomic_load_u8(e2e_atomic_u8_t *ptr) { return *ptr; }
+
+static __inline void e2e_atomic_store_u8(e2e_atomic_u8_t *ptr, uint8_t value)
+{
+    _InterlockedExchange8((volatile char *)ptr, (char)value);
+}
+
+#else
+
+#include <stdatomic.h>
+
+typedef _Atomic(int64_t)  e2e_atomic_i64_t;
+typedef _Atomic(uint64_t) e2e_atomic_u64_t;
+typedef _Atomic(uint8_t)  e2e_atomic_u8_t;
+typedef _Atomic(void *)   e2e_atomic_ptr_t;
+
+static inline int64_t e2e_atomic_load_i64(e2e_atomic_i64_t *ptr)
+{
+    return atomic_load_explicit(ptr, memory_order_acquire);
+}
+
+static inline void e2e_atomic_store_i64(e2e_atomic_i64_t *ptr, int64_t value)
+{
+    atomic_store_explicit(ptr, value, memory_order_release);
+}
+
+static inline bool e2e_atomic_cas_i64(e2e_atomic_i64_t *ptr, int64_t *expected, int64_t desired)
+{
+    return atomic_compare_exchange_weak_explicit(ptr,
+                                                 expected,
+                                                 desired,
+                                                 memory_order_acq_rel,
+                                                 memory_order_acquire);
+}
+
+static inline uint64_t e2e_atomic_load_u64(e2e_atomic_u64_t *ptr)
+{
+    return atomic_load_explicit(ptr, memory_order_relaxed);
+}
+
+static inline void e2e_atomic_store_u64(e2e_atomic_u64_t *ptr, uint64_t value)
+{
+    atomic_store_explicit(ptr, value, memory_order_relaxed);
+}
+
+static inline uint64_t e2e_atomic_load_acquire_u64(e2e_atomic_u64_t *ptr)
+{
+    return atomic_load_explicit(ptr, memory_order_acquire);
+}
+
+static inline void e2e_atomic_store_release_u64(e2e_atomic_u64_t *ptr, uint64_t value)
+{
+    atomic_store_explicit(ptr, value, memory_order_release);
+}
+
+static inline void e2e_atomic_add_u64(e2e_atomic_u64_t *ptr, uint64_t value)
+{
+    atomic_fetch_add_explicit(ptr, value, memory_order_relaxed);
+}
+
+static inline uint64_t e2e_atomic_fetch_add_u64(e2e_atomic_u64_t *ptr, uint64_t value)
+{
+    return atomic_fetch_add_explicit(ptr, value, memory_order_relaxed);
+}
+
+static inline void *e2e_atomic_load_ptr(e2e_atomic_ptr_t *ptr)
+{
+    return atomic_load_explicit(ptr, memory_order_acquire);
+}
+
+static inline void e2e_atomic_store_ptr(e2e_atomic_ptr_t *ptr, void *value)
+{
+    atomic_store_explicit(ptr, value, memory_order_release);
+}
+
+static inline bool e2e_atomic_cas_ptr(e2e_atomic_ptr_t *ptr, void **expected, void *desired)
+{
+    return atomic_compare_exchange_weak_explicit(ptr,
+                                                 expected,
+                                                 desired,
+                                                 memory_order_acq_rel,
+                                                 memory_order_acquire);
+}
+
+static inline void e2e_atomic_fence_acquire(void) { atomic_thread_fence(memory_order_acquire); }
+
+static inline void e2e_atomic_fence_release(void) { atomic_thread_fence(memory_order_release); }
+
+static inline uint8_t e2e_atomic_load_u8(e2e_atomic_u8_t *ptr)
+{
+    return atomic_load_explicit(ptr, memory_order_relaxed);
+}
+
+static inline void e2e_atomic_store_u8(e2e_atomic_u8_t *ptr, uint8_t value)
+{
+    atomic_store_explicit(ptr, value, memory_order_relaxed);
+}
+
+#endif
+
+#endif
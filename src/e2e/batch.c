@@ -0,0 +1,378 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e2elib.h"
+#include "module.h"
+#include "table.h"
+
+// Fill table from a mapping or an iterable of (id, Config) pairs
+int table_from_configs(module_state *state, e2e_table_t *table, PyObject *configs, Py_buffer *block)
+{
+    PyObject *items;
+    if (PyDict_Check(configs)) {
+        items = PyDict_Items(configs);
+    }
+    else if (PyMapping_Check(configs) && PyObject_HasAttrString(configs, "items")) {
+        items = PyMapping_Items(configs);
+    }
+    else {
+        items = PySequence_List(configs);
+    }
+    if (items == NULL) {
+        return -1;
+    }
+
+    Py_ssize_t count = PyList_Size(items);
+    if (count > E2E_TABLE_MAX_COUNT) {
+        PyErr_SetString(PyExc_ValueError, "Too many messages.");
+        goto error;
+    }
+    if (block != NULL) {
+        if (e2e_table_init(table, block->buf, (size_t)block->len, (uint32_t)count) < 0) {
+            PyErr_Format(PyExc_ValueError,
+                         "Buffer must be 8 byte aligned and hold at least %llu bytes.",
+                         (unsigned long long)e2e_table_size((uint32_t)count));
+            Py_DECREF(items);
+            return -1;
+        }
+    }
+    else if (e2e_table_create(table, (uint32_t)count) < 0) {
+        PyErr_NoMemory();
+        Py_DECREF(items);
+        return -1;
+    }
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        PyObject           *pair = PySequence_Tuple(PyList_GetItem(items, i));
+        PyObject           *id_obj;
+        PyObject           *config_obj;
+        const e2e_config_t *config;
+        unsigned long long  id;
+
+        if (pair == NULL) {
+            goto error;
+        }
+        if (!PyArg_ParseTuple(pair, "OO:Router", &id_obj, &config_obj)) {
+            Py_DECREF(pair);
+            goto error;
+        }
+        id     = PyLong_AsUnsignedLongLong(id_obj);
+        config = (id == (unsigned long long)-1 && PyErr_Occurred())
+                     ? NULL
+                     : config_from_object(state, config_obj);
+        Py_DECREF(pair);
+        if (config == NULL) {
+            goto error;
+        }
+        if (e2e_table_insert(table, (uint32_t)i, (uint64_t)id, config) < 0) {
+            PyErr_Format(PyExc_ValueError, "Duplicate message id %llu.", id);
+            goto error;
+        }
+    }
+    Py_DECREF(items);
+    return 0;
+
+error:
+    Py_DECREF(items);
+    e2e_table_destroy(table);
+    return -1;
+}
+
+// Read message ids from an integer buffer or from an iterable of int
+uint64_t *read_ids(PyObject *ids, Py_ssize_t *count)
+{
+    uint64_t *result;
+
+    if (PyObject_CheckBuffer(ids)) {
+        Py_buffer view;
+        if (PyObject_GetBuffer(ids, &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0) {
+            return NULL;
+        }
+        const char *format = (view.format == NULL) ? "B" : view.format;
+        if (format[0] == '@' || format[0] == '=') {
+            format++;
+        }
+        if (format[0] == '\0' || format[1] != '\0' || strchr("BHILQN", format[0]) == NULL) {
+            PyErr_Format(PyExc_TypeError,
+                         "Message ids must be a buffer of unsigned integers, not \"%s\".",
+                         view.format);
+            PyBuffer_Release(&view);
+            return NULL;
+        }
+
+        *count = view.len / view.itemsize;
+        result = PyMem_Malloc((size_t)(*count + 1) * sizeof(uint64_t));
+        if (result == NULL) {
+            PyBuffer_Release(&view);
+            PyErr_NoMemory();
+            return NULL;
+        }
+        for (Py_ssize_t i = 0; i < *count; ++i) {
+            const uint8_t *item = (const uint8_t *)view.buf + i * view.itemsize;
+            switch (view.itemsize) {
+                case 1:
+                    result[i] = *item;
+                    break;
+                case 2:
+                    result[i] = *(const uint16_t *)item;
+                    break;
+                case 4:
+                    result[i] = *(const uint32_t *)item;
+                    break;
+                default:
+                    result[i] = *(const uint64_t *)item;
+                    break;
+            }
+        }
+        PyBuffer_Release(&view);
+        return result;
+    }
+
+    PyObject *list = PySequence_List(ids);
+    if (list == NULL) {
+        return NULL;
+    }
+    *count = PyList_Size(list);
+    result = PyMem_Malloc((size_t)(*count + 1) * sizeof(uint64_t));
+    if (result == NULL) {
+        Py_DECREF(list);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    for (Py_ssize_t i = 0; i < *count; ++i) {
+        unsigned long long id = PyLong_AsUnsignedLongLong(PyList_GetItem(list, i));
+        if (id == (unsigned long long)-1 && PyErr_Occurred()) {
+            Py_DECREF(list);
+            PyMem_Free(result);
+            return NULL;
+        }
+        result[i] = id;
+    }
+    Py_DECREF(list);
+    return result;
+}
+
+Py_buffer *acquire_frames(PyObject *frames_obj, Py_ssize_t count)
+{
+    PyObject  *frames = PySequence_List(frames_obj);
+    Py_buffer *buffers;
+
+    if (frames == NULL) {
+        return NULL;
+    }
+    if (PyList_Size(frames) != count) {
+        PyErr_SetString(PyExc_ValueError, "Every frame needs exactly one message id.");
+        Py_DECREF(frames);
+        return NULL;
+    }
+    if ((buffers = PyMem_Malloc((size_t)(count + 1) * sizeof(Py_buffer))) == NULL) {
+        PyErr_NoMemory();
+        Py_DECREF(frames);
+        return NULL;
+    }
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        if (PyObject_GetBuffer(PyList_GetItem(frames, i), &buffers[i], PyBUF_SIMPLE) < 0) {
+            release_frames(buffers, i);
+            Py_DECREF(frames);
+            return NULL;
+        }
+    }
+    // every buffer keeps a reference to its frame
+    Py_DECREF(frames);
+    return buffers;
+}
+
+void release_frames(Py_buffer *buffers, Py_ssize_t count)
+{
+    if (buffers == NULL) {
+        return;
+    }
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        PyBuffer_Release(&buffers[i]);
+    }
+    PyMem_Free(buffers);
+}
+
+// Seed the counters of table from a {key: counter} snapshot
+static int restore_counters(e2e_table_t *table, PyObject *state)
+{
+    PyObject *items = PyMapping_Items(state);
+    if (items == NULL) {
+        return -1;
+    }
+
+    for (Py_ssize_t i = 0; i < PyList_Size(items); ++i) {
+        PyObject          *item    = PyList_GetItem(items, i);
+        PyObject          *key_obj = PyTuple_GetItem(item, 0);
+        PyObject          *value   = PyTuple_GetItem(item, 1);
+        unsigned long long key     = PyLong_AsUnsignedLongLong(key_obj);
+        long long          counter = -1;
+
+        if (key == (unsigned long long)-1 && PyErr_Occurred()) {
+            goto error;
+        }
+        int64_t index = e2e_table_find(table, key);
+        if (index < 0) {
+            PyErr_Format(PyExc_ValueError, "State contains unknown key %llu.", key);
+            goto error;
+        }
+        if (value != Py_None) {
+            counter = PyLong_AsLongLong(value);
+            if (counter == -1 && PyErr_Occurred()) {
+                goto error;
+            }
+            if (counter < 0 ||
+                (uint64_t)counter >= e2e_counter_modulus(table->configs[index].profile)) {
+                PyErr_Format(PyExc_ValueError, "Counter %lld of key %llu is out of range.", counter, key);
+                goto error;
+            }
+        }
+        e2e_atomic_store_i64(&table->counters[index], counter);
+    }
+    Py_DECREF(items);
+    return 0;
+
+error:
+    Py_DECREF(items);
+    return -1;
+}
+
+// Return the counter state of table as {key: counter}
+static PyObject *snapshot_counters(e2e_table_t *table)
+{
+    PyObject *state = PyDict_New();
+    if (state == NULL) {
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < table->header->count; ++i) {
+        int64_t   counter = e2e_atomic_load_i64(&table->counters[i]);
+        PyObject *key     = PyLong_FromUnsignedLongLong(table->ids[i]);
+        PyObject *value;
+        if (counter < 0) {
+            Py_INCREF(Py_None);
+            value = Py_None;
+        }
+        else {
+            value = PyLong_FromLongLong(counter);
+        }
+        if (key == NULL || value == NULL || PyDict_SetItem(state, key, value) < 0) {
+            Py_XDECREF(key);
+            Py_XDECREF(value);
+            Py_DECREF(state);
+            return NULL;
+        }
+        Py_DECREF(key);
+        Py_DECREF(value);
+    }
+    return state;
+}
+
+// clang-format off
+PyDoc_STRVAR(check_sequence_doc,
+             "check_sequence(keys: Sequence[int] | Buffer, frames: Sequence[bytes], configs: Mapping[int, Config], state: Mapping[int, int | None] | None = None) -> tuple[bytes, dict[int, int | None]]\n"
+             "Check the CRC and the counter sequence of a time-ordered batch of frames, \n"
+             "e.g. a recorded bus log, in a single native pass. \n"
+             "\n"
+             "Each frame is evaluated against the previous valid frame with the same key. \n"
+             "A long log can be split into consecutive batches by passing the returned \n"
+             "state of one batch as `state` of the next one. \n"
+             "\n"
+             ":param keys: \n"
+             "    Message key of each frame. Either a sequence of int or a buffer of \n"
+             "    unsigned integers like :class:`array.array`. \n"
+             ":param frames: \n"
+             "    Sequence of `bytes-like objects <https://docs.python.org/3/glossary.html#term-bytes-like-object>`_\n"
+             "    in reception order. \n"
+             ":param configs: \n"
+             "    Mapping of message key to :class:`~e2e.Config`. \n"
+             ":param state: \n"
+             "    Last valid counter of each key, ``None`` if no valid frame was received yet. \n"
+             "    Keys which are missing start without counter state. \n"
+             ":return: \n"
+             "    A tuple of one ``E2E_STATUS_*`` code per frame and the final state.");
+// clang-format on
+static PyObject *check_sequence(PyObject *module, PyObject *args, PyObject *kwargs)
+{
+    PyObject    *keys_obj;
+    PyObject    *frames_obj;
+    PyObject    *configs_obj;
+    PyObject    *state_obj = Py_None;
+    PyObject    *statuses  = NULL;
+    PyObject    *state     = NULL;
+    uint64_t    *keys      = NULL;
+    Py_buffer   *buffers   = NULL;
+    Py_ssize_t   count     = 0;
+    e2e_table_t  table     = {0};
+    static char *kwlist[]  = {"keys", "frames", "configs", "state", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args,
+                                     kwargs,
+                                     "OOO|O:check_sequence",
+                                     kwlist,
+                                     &keys_obj,
+                                     &frames_obj,
+                                     &configs_obj,
+                                     &state_obj)) {
+        return NULL;
+    }
+    if (table_from_configs(get_module_state(module), &table, configs_obj, NULL) < 0) {
+        return NULL;
+    }
+    if (state_obj != Py_None && restore_counters(&table, state_obj) < 0) {
+        goto exit;
+    }
+    if ((keys = read_ids(keys_obj, &count)) == NULL) {
+        goto exit;
+    }
+    if ((buffers = acquire_frames(frames_obj, count)) == NULL) {
+        goto exit;
+    }
+    if ((statuses = PyBytes_FromStringAndSize(NULL, count)) == NULL) {
+        goto exit;
+    }
+
+    uint8_t *status_ptr = (uint8_t *)PyBytes_AsString(statuses);
+    Py_BEGIN_ALLOW_THREADS
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        status_ptr[i] = e2e_table_check_id(&table,
+                                           keys[i],
+                                           E2E_RECORDER_NOW,
+                                           (uint8_t *)buffers[i].buf,
+                                           (size_t)buffers[i].len);
+    }
+    Py_END_ALLOW_THREADS
+
+    if ((state = snapshot_counters(&table)) == NULL) {
+        Py_CLEAR(statuses);
+    }
+
+exit:
+    release_frames(buffers, count);
+    PyMem_Free(keys);
+    e2e_table_destroy(&table);
+    if (statuses == NULL) {
+        return NULL;
+    }
+    return Py_BuildValue("(NN)", statuses, state);
+}
+
+// clang-format off
+static PyMethodDef batch_functions[] = {
+    {"check_sequence", (PyCFunction)check_sequence, METH_VARARGS | METH_KEYWORDS, check_sequence_doc},
+    {NULL} // sentinel
+};
+// clang-format on
+
+int batch_init_functions(PyObject *module, module_state *state)
+{
+    return PyModule_AddFunctions(module, batch_functions);
+}
@@ -0,0 +1,75 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#include "e2e_capi.h"
+#include "module.h"
+
+// The FrameRing type belongs to the e2e._e2e module of the calling interpreter
+static e2e_ring_t *capi_ring_from_object(PyObject *obj)
+{
+    PyObject *module = PyImport_ImportModule("e2e._e2e");
+    if (module == NULL) {
+        return NULL;
+    }
+    e2e_ring_t *ring = ring_from_object(get_module_state(module), obj);
+    Py_DECREF(module);
+    return ring;
+}
+
+// clang-format off
+static const e2e_capi_t capi = {
+    .version             = E2E_CAPI_VERSION,
+    .size                = sizeof(e2e_capi_t),
+
+    .crc8                = Crc_CalculateCRC8,
+    .crc8h2f             = Crc_CalculateCRC8H2F,
+    .crc16               = Crc_CalculateCRC16,
+    .crc16arc            = Crc_CalculateCRC16ARC,
+    .crc32               = Crc_CalculateCRC32,
+    .crc32p4             = Crc_CalculateCRC32P4,
+    .crc64               = Crc_CalculateCRC64,
+
+    .compute_p01_crc     = compute_p01_crc,
+    .compute_p02_crc     = compute_p02_crc,
+    .compute_p04_crc     = compute_p04_crc,
+    .compute_p05_crc     = compute_p05_crc,
+    .compute_p06_crc     = compute_p06_crc,
+    .compute_p07_crc     = compute_p07_crc,
+
+    .p01_protect         = e2e_p01_protect,
+    .p01_check           = e2e_p01_check,
+    .p02_protect         = e2e_p02_protect,
+    .p02_check           = e2e_p02_check,
+    .p04_protect         = e2e_p04_protect,
+    .p04_check           = e2e_p04_check,
+    .p05_protect         = e2e_p05_protect,
+    .p05_check           = e2e_p05_check,
+    .p06_protect         = e2e_p06_protect,
+    .p06_check           = e2e_p06_check,
+    .p07_protect         = e2e_p07_protect,
+    .p07_check           = e2e_p07_check,
+
+    .config_error        = e2e_config_error,
+    .config_frame_length = e2e_config_frame_length,
+    .config_protect      = e2e_config_protect,
+    .config_check        = e2e_config_check,
+
+    .ring_from_object    = capi_ring_from_object,
+    .ring_reserve        = e2e_ring_reserve,
+    .ring_commit         = e2e_ring_commit,
+    .ring_slot_data      = e2e_ring_slot_data,
+    .ring_push           = e2e_ring_push,
+};
+// clang-format on
+
+int e2e_capi_add_capsule(PyObject *module)
+{
+    // the table is immutable, the capsule only hands out its address
+    PyObject *capsule = PyCapsule_New((void *)&capi, E2E_CAPI_NAME, NULL);
+    if (PyModule_AddObject(module, "_C_API", capsule) < 0) {
+        Py_XDECREF(capsule);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "codec.h"
+
+static uint64_t length_mask(uint8_t length)
+{
+    return length >= 64 ? UINT64_MAX : (UINT64_C(1) << length) - 1u;
+}
+
+const char *e2e_codec_compile(e2e_codec_signal_t *signal,
+                              uint32_t            start_bit,
+                              uint8_t             length,
+                              bool                big_endian,
+                              bool                is_signed,
+                              double              scale,
+                              double              offset)
+{
+    if (length < 1 || length > 64) {
+        return "The signal length must fulfill 1 <= length <= 64.";
+    }
+    if (!isfinite(scale) || !isfinite(offset) || scale == 0.0) {
+        return "The scale must be finite and not 0, the offset must be finite.";
+    }
+
+    *signal           = (e2e_codec_signal_t){0};
+    signal->scale     = scale;
+    signal->offset    = offset;
+    signal->length    = length;
+    signal->is_signed = is_signed;
+    signal->integer   = scale == 1.0 && offset == 0.0;
+
+    uint64_t pos       = start_bit;
+    uint8_t  remaining = length;
+    while (remaining > 0) {
+        e2e_codec_segment_t *segment = &signal->segments[signal->segment_count++];
+        uint8_t              bit     = (uint8_t)(pos % 8);
+        uint8_t              count;
+
+        if (pos / 8 > UINT32_MAX - 1) {
+            return "The signal exceeds the maximum frame size.";
+        }
+        segment->byte = (uint32_t)(pos / 8);
+        if (big_endian) {
+            // Motorola: from the most significant bit downwards, then on
+            // with bit 7 of the next byte
+            count                = bit + 1 < remaining ? bit + 1 : remaining;
+            remaining           -= count;
+            segment->shift       = (uint8_t)(bit + 1 - count);
+            segment->value_shift = remaining;
+            pos                  = (pos / 8 + 1) * 8 + 7;
+        }
+        else {
+            // Intel: from the least significant bit upwards
+            count                = 8 - bit < remaining ? 8 - bit : remaining;
+            segment->shift       = bit;
+            segment->value_shift = (uint8_t)(length - remaining);
+            remaining           -= count;
+            pos                 += count;
+        }
+        segment->mask = (uint8_t)length_mask(count);
+        if (segment->byte + 1 > signal->end) {
+            signal->end = segment->byte + 1;
+        }
+    }
+    return NULL;
+}
+
+bool e2e_codec_encode(const e2e_codec_signal_t *signal, double value, uint64_t *raw)
+{
+    double scaled = round((value - signal->offset) / signal->scale);
+    double limit  = ldexp(1.0, signal->is_signed ? signal->length - 1 : signal->length);
+    double lowest = signal->is_signed ? -limit : 0.0;
+
+    // also false for NaN
+    if (!(scaled >= lowest && scaled < limit)) {
+        return false;
+    }
+    if (signal->is_signed) {
+        *raw = (uint64_t)(int64_t)scaled & length_mask(signal->length);
+    }
+    else {
+        *raw = (uint64_t)scaled;
+    }
+    return true;
+}
+
+double e2e_codec_decode(const e2e_codec_signal_t *signal, uint64_t raw)
+{
+    double value = signal->is_signed ? (double)(int64_t)raw : (double)raw;
+    return value * signal->scale + signal->offset;
+}
+
+void e2e_codec_pack(const e2e_codec_signal_t *signal, uint8_t *data_ptr, uint64_t raw)
+{
+    for (uint8_t i = 0; i < signal->segment_count; ++i) {
+        const e2e_codec_segment_t *segment = &signal->segments[i];
+        uint8_t                    mask    = (uint8_t)(segment->mask << segment->shift);
+        uint8_t                    bits    = (uint8_t)((raw >> segment->value_shift) & segment->mask);
+        uint8_t                   *byte    = &data_ptr[segment->byte];
+        *byte                              = (uint8_t)((*byte & ~mask) | (bits << segment->shift));
+    }
+}
+
+uint64_t e2e_codec_unpack(const e2e_codec_signal_t *signal, const uint8_t *data_ptr)
+{
+    uint64_t raw = 0;
+    for (uint8_t i = 0; i < signal->segment_count; ++i) {
+        const e2e_codec_segment_t *segment = &signal->segments[i];
+        uint64_t                   bits    = (data_ptr[segment->byte] >> segment->shift) & segment->mask;
+        raw                               |= bits << segment->value_shift;
+    }
+    if (signal->is_signed && signal->length < 64 && (raw >> (signal->length - 1)) & 1u) {
+        raw |= ~length_mask(signal->length);
+    }
+    return raw;
+}
@@ -0,0 +1,63 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// a signal of 64 bits which does not start at a byte boundary touches 9 bytes
+#define E2E_CODEC_MAX_SEGMENTS 9u
+
+// Bits of a signal inside one byte of the frame
+typedef struct {
+    uint32_t byte;        // byte index in the frame
+    uint8_t  shift;       // lowest bit of the segment inside the byte
+    uint8_t  mask;        // segment bits after shifting down
+    uint8_t  value_shift; // position of the lowest segment bit in the raw value
+    uint8_t  reserved;
+} e2e_codec_segment_t;
+
+// Signal compiled from a DBC style description. The raw value is
+// scattered over its segments, so packing and unpacking need no bit loop.
+typedef struct {
+    double              scale;
+    double              offset;
+    uint32_t            end; // the frame must hold at least end bytes
+    uint8_t             length;
+    bool                is_signed;
+    bool                integer; // scale 1 and offset 0, raw and physical value are the same
+    uint8_t             segment_count;
+    e2e_codec_segment_t segments[E2E_CODEC_MAX_SEGMENTS];
+} e2e_codec_signal_t;
+
+// Compile a signal like the DBC line "SG_ name : start_bit|length@1+ (scale,offset)".
+// start_bit is the least significant bit for little endian (Intel, @1) and
+// the most significant bit for big endian (Motorola, @0) signals, bit i is
+// bit i % 8 of byte i / 8. Returns NULL on success, otherwise an error message.
+const char *e2e_codec_compile(e2e_codec_signal_t *signal,
+                              uint32_t            start_bit,
+                              uint8_t             length,
+                              bool                big_endian,
+                              bool                is_signed,
+                              double              scale,
+                              double              offset);
+
+// Convert a physical value into the raw value, rounded to the nearest integer.
+// Returns false if it does not fit the signal.
+bool        e2e_codec_encode(const e2e_codec_signal_t *signal, double value, uint64_t *raw);
+
+// Convert a raw value from e2e_codec_unpack() into the physical value
+double      e2e_codec_decode(const e2e_codec_signal_t *signal, uint64_t raw);
+
+// Write the raw value into the frame, the other bits of the frame are kept.
+// The frame must hold signal->end bytes.
+void        e2e_codec_pack(const e2e_codec_signal_t *signal, uint8_t *data_ptr, uint64_t raw);
+
+// Read the raw value from the frame, sign extended for signed signals
+uint64_t    e2e_codec_unpack(const e2e_codec_signal_t *signal, const uint8_t *data_ptr);
+
+#endif
@@ -0,0 +1,129 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "module.h"
+
+// Buffer exporter for one column of a native table. It only lives as the
+// base object of a memoryview.
+typedef struct {
+    PyObject_HEAD
+    PyObject   *owner;
+    const void *buf;
+    const char *format;
+    int         ndim;
+    Py_ssize_t  itemsize;
+    Py_ssize_t  shape[2];
+    Py_ssize_t  strides[2];
+} ColumnObject;
+
+PyObject *column_matrix(module_state *state,
+                        PyObject     *owner,
+                        const void   *buf,
+                        Py_ssize_t    rows,
+                        Py_ssize_t    columns,
+                        Py_ssize_t    itemsize,
+                        const char   *format)
+{
+    ColumnObject *column = (ColumnObject *)alloc_instance(state->column_type);
+    if (column == NULL) {
+        return NULL;
+    }
+    Py_INCREF(owner);
+    column->owner      = owner;
+    column->buf        = buf;
+    column->format     = format;
+    column->itemsize   = itemsize;
+    column->ndim       = (columns == 0) ? 1 : 2;
+    column->shape[0]   = rows;
+    column->shape[1]   = columns;
+    column->strides[0] = (columns == 0) ? itemsize : columns * itemsize;
+    column->strides[1] = itemsize;
+
+    PyObject *view     = PyMemoryView_FromObject((PyObject *)column);
+    Py_DECREF(column);
+    return view;
+}
+
+PyObject *column_view(module_state *state,
+                      PyObject     *owner,
+                      const void   *buf,
+                      Py_ssize_t    count,
+                      Py_ssize_t    itemsize,
+                      const char   *format)
+{
+    return column_matrix(state, owner, buf, count, 0, itemsize, format);
+}
+
+static int column_getbuffer(PyObject *self, Py_buffer *view, int flags)
+{
+    ColumnObject *column = (ColumnObject *)self;
+
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "Object is not writable.");
+        view->obj = NULL;
+        return -1;
+    }
+
+    Py_INCREF(self);
+    view->obj        = self;
+    view->buf        = (void *)column->buf;
+    view->len        = column->shape[0] * column->strides[0];
+    view->itemsize   = column->itemsize;
+    view->readonly   = 1;
+    view->ndim       = column->ndim;
+    view->format     = (flags & PyBUF_FORMAT) ? (char *)column->format : NULL;
+    view->shape      = (flags & PyBUF_ND) ? column->shape : NULL;
+    view->strides    = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? column->strides : NULL;
+    view->suboffsets = NULL;
+    view->internal   = NULL;
+    return 0;
+}
+
+static PyObject *column_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    PyErr_SetString(PyExc_TypeError, "Cannot create e2e._Column instances.");
+    return NULL;
+}
+
+static void column_dealloc(PyObject *self)
+{
+    PyTypeObject *type = Py_TYPE(self);
+    Py_XDECREF(((ColumnObject *)self)->owner);
+    freefunc tp_free = (freefunc)PyType_GetSlot(type, Py_tp_free);
+    tp_free(self);
+    Py_DECREF(type);
+}
+
+// clang-format off
+static PyType_Slot column_slots[] = {
+    {Py_tp_new,           column_new},
+    {Py_tp_dealloc,       column_dealloc},
+#if PY_VERSION_HEX >= 0x03090000
+    {Py_bf_getbuffer,     column_getbuffer},
+#endif
+    {0, NULL}
+};
+// clang-format on
+
+static PyType_Spec column_spec = {.name      = "e2e._Column",
+                                  .basicsize = sizeof(ColumnObject),
+                                  .itemsize  = 0,
+                                  .flags     = Py_TPFLAGS_DEFAULT,
+                                  .slots     = column_slots};
+
+int column_init_type(PyObject *module, module_state *state)
+{
+    state->column_type = add_type(module, &column_spec);
+    if (state->column_type == NULL) {
+        return -1;
+    }
+#if PY_VERSION_HEX < 0x03090000
+    // buffer slots cannot be set with PyType_FromSpec before Python 3.9
+    state->column_type->tp_as_buffer->bf_getbuffer = column_getbuffer;
+#endif
+    return 0;
+}
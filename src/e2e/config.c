@@ -0,0 +1,220 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e2elib.h"
+#include "module.h"
+
+// clang-format off
+PyDoc_STRVAR(config_doc,
+             "Config(profile: int, data_id: int = 0, length: int = 0, *, offset: int = 0, data_id_mode: int = E2E_P01_DATAID_BOTH, data_id_list: bytes | None = None, max_delta_counter: int = 1)\n"
+             "Immutable receiver configuration of one E2E protected message. \n"
+             "\n"
+             ":param int profile: \n"
+             "    E2E profile number, one of 1, 2, 4, 5, 6 or 7. \n"
+             ":param int data_id: \n"
+             "    A unique identifier which is used to protect against masquerading. \n"
+             "    Ignored by profile 2 which uses `data_id_list` instead. \n"
+             ":param int length: \n"
+             "    The `length` argument of the corresponding ``e2e_pXX_check`` function. \n"
+             "    If `length` is 0, it is derived from the size of each frame. \n"
+             ":param int offset: \n"
+             "    Byte offset of the E2E header (profiles 4, 5, 6 and 7). A nonzero `length` \n"
+             "    must contain the header at `offset`. \n"
+             ":param int data_id_mode: \n"
+             "    Inclusion mode of the `data_id` (profile 1). \n"
+             ":param bytes data_id_list: \n"
+             "    A `bytes-like object <https://docs.python.org/3/glossary.html#term-bytes-like-object>`_\n"
+             "    of length 16 (profile 2). \n"
+             ":param int max_delta_counter: \n"
+             "    Maximum allowed counter increment between two consecutive valid frames. \n"
+             "    Larger increments are reported as :attr:`~e2e.E2E_STATUS_WRONGSEQUENCE`. \n");
+// clang-format on
+static PyObject *config_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    unsigned long profile;
+    unsigned long data_id           = 0;
+    unsigned long length            = 0;
+    unsigned long offset            = 0;
+    unsigned long data_id_mode      = E2E_P01_DATAID_BOTH;
+    PyObject     *data_id_list      = Py_None;
+    unsigned long max_delta_counter = 1;
+
+    static char  *kwlist[]          = {"profile",
+                                       "data_id",
+                                       "length",
+                                       "offset",
+                                       "data_id_mode",
+                                       "data_id_list",
+                                       "max_delta_counter",
+                                       NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args,
+                                     kwargs,
+                                     "k|kk$kkOk:Config",
+                                     kwlist,
+                                     &profile,
+                                     &data_id,
+                                     &length,
+                                     &offset,
+                                     &data_id_mode,
+                                     &data_id_list,
+                                     &max_delta_counter)) {
+        return NULL;
+    }
+    if (profile > UINT8_MAX || data_id > UINT32_MAX || length > UINT32_MAX || offset > UINT32_MAX ||
+        data_id_mode > UINT8_MAX || max_delta_counter > UINT32_MAX) {
+        PyErr_SetString(PyExc_ValueError, "Argument out of range.");
+        return NULL;
+    }
+
+    e2e_config_t config      = {0};
+    config.profile           = (uint8_t)profile;
+    config.data_id_mode      = (uint8_t)data_id_mode;
+    config.length            = (uint32_t)length;
+    config.data_id           = (uint32_t)data_id;
+    config.offset            = (uint32_t)offset;
+    config.max_delta_counter = (uint32_t)max_delta_counter;
+
+    if (profile == 2) {
+        Py_buffer buffer;
+        if (data_id_list == Py_None) {
+            PyErr_SetString(PyExc_ValueError, "Profile 2 requires argument \"data_id_list\".");
+            return NULL;
+        }
+        if (PyObject_GetBuffer(data_id_list, &buffer, PyBUF_SIMPLE) < 0) {
+            return NULL;
+        }
+        if (buffer.len != P02DATAID_LIST_LEN) {
+            PyBuffer_Release(&buffer);
+            PyErr_SetString(PyExc_ValueError,
+                            "Argument \"data_id_list\" must be a bytes object with length 16.");
+            return NULL;
+        }
+        memcpy(config.data_id_list, buffer.buf, P02DATAID_LIST_LEN);
+        PyBuffer_Release(&buffer);
+    }
+
+    const char *error = e2e_config_error(&config);
+    if (error != NULL) {
+        PyErr_SetString(PyExc_ValueError, error);
+        return NULL;
+    }
+
+    ConfigObject *self = (ConfigObject *)alloc_instance(type);
+    if (self == NULL) {
+        return NULL;
+    }
+    self->config = config;
+    return (PyObject *)self;
+}
+
+static void config_dealloc(PyObject *self)
+{
+    PyTypeObject *type    = Py_TYPE(self);
+    freefunc      tp_free = (freefunc)PyType_GetSlot(type, Py_tp_free);
+    tp_free(self);
+    Py_DECREF(type);
+}
+
+static PyObject *config_repr(PyObject *self)
+{
+    const e2e_config_t *config = &((ConfigObject *)self)->config;
+    return PyUnicode_FromFormat("Config(profile=%u, data_id=%lu, length=%lu, offset=%lu, "
+                                "data_id_mode=%u, max_delta_counter=%lu)",
+                                (unsigned int)config->profile,
+                                (unsigned long)config->data_id,
+                                (unsigned long)config->length,
+                                (unsigned long)config->offset,
+                                (unsigned int)config->data_id_mode,
+                                (unsigned long)config->max_delta_counter);
+}
+
+const e2e_config_t *config_from_object(module_state *state, PyObject *obj)
+{
+    if (!PyObject_TypeCheck(obj, state->config_type)) {
+        PyErr_Format(PyExc_TypeError, "Expected an e2e.Config instance, got %R.", Py_TYPE(obj));
+        return NULL;
+    }
+    return &((ConfigObject *)obj)->config;
+}
+
+static PyObject *config_get_profile(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((ConfigObject *)self)->config.profile);
+}
+
+static PyObject *config_get_data_id(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((ConfigObject *)self)->config.data_id);
+}
+
+static PyObject *config_get_length(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((ConfigObject *)self)->config.length);
+}
+
+static PyObject *config_get_offset(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((ConfigObject *)self)->config.offset);
+}
+
+static PyObject *config_get_data_id_mode(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((ConfigObject *)self)->config.data_id_mode);
+}
+
+static PyObject *config_get_data_id_list(PyObject *self, void *closure)
+{
+    const e2e_config_t *config = &((ConfigObject *)self)->config;
+    if (config->profile != 2) {
+        Py_RETURN_NONE;
+    }
+    return PyBytes_FromStringAndSize((const char *)config->data_id_list, P02DATAID_LIST_LEN);
+}
+
+static PyObject *config_get_max_delta_counter(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((ConfigObject *)self)->config.max_delta_counter);
+}
+
+// clang-format off
+static PyGetSetDef config_getset[] = {
+    {"profile",           config_get_profile,           NULL, "E2E profile number", NULL},
+    {"data_id",           config_get_data_id,           NULL, "Data ID", NULL},
+    {"length",            config_get_length,            NULL, "Expected length, 0 if derived from the frame size", NULL},
+    {"offset",            config_get_offset,            NULL, "Byte offset of the E2E header", NULL},
+    {"data_id_mode",      config_get_data_id_mode,      NULL, "Data ID inclusion mode of profile 1", NULL},
+    {"data_id_list",      config_get_data_id_list,      NULL, "Data ID list of profile 2", NULL},
+    {"max_delta_counter", config_get_max_delta_counter, NULL, "Maximum allowed counter increment", NULL},
+    {NULL} // sentinel
+};
+
+static PyType_Slot config_slots[] = {
+    {Py_tp_doc,     (void *)config_doc},
+    {Py_tp_new,     config_new},
+    {Py_tp_dealloc, config_dealloc},
+    {Py_tp_repr,    config_repr},
+    {Py_tp_getset,  config_getset},
+    {0, NULL}
+};
+// clang-format on
+
+static PyType_Spec config_spec = {.name      = "e2e.Config",
+                                  .basicsize = sizeof(ConfigObject),
+                                  .itemsize  = 0,
+                                  .flags     = Py_TPFLAGS_DEFAULT,
+                                  .slots     = config_slots};
+
+int config_init_type(PyObject *module, module_state *state)
+{
+    state->config_type = add_type(module, &config_spec);
+    return (state->config_type == NULL) ? -1 : 0;
+}
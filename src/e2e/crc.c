@@ -9,6 +9,8 @@
 #include <stdint.h>
 
 #include "crclib.h"
+#include "module.h"
+#include "stats.h"
 
 // clang-format off
 PyDoc_STRVAR(py_calculate_crc8_doc,
@@ -44,10 +46,12 @@ static PyObject *py_calculate_crc8(PyObject *module, PyObject *args, PyObject *k
         return NULL;
     }
 
-    uint8_t crc = Crc_CalculateCRC8((uint8_t *)data.buf,
-                                    (uint32_t)data.len,
-                                    (uint8_t)start_value,
-                                    (bool)first_call);
+    uint64_t start = e2e_stats_start();
+    uint8_t  crc   = Crc_CalculateCRC8((uint8_t *)data.buf,
+                                       (uint32_t)data.len,
+                                       (uint8_t)start_value,
+                                       (bool)first_call);
+    e2e_stats_stop(E2E_STAT_CRC8, start, (size_t)data.len, E2E_RESULT_OK);
     PyBuffer_Release(&data);
 
     return (PyLong_FromUnsignedLong(crc));
@@ -87,10 +91,12 @@ static PyObject *py_calculate_crc8_h2f(PyObject *module, PyObject *args, PyObjec
         return NULL;
     }
 
-    uint8_t crc = Crc_CalculateCRC8H2F((uint8_t *)data.buf,
-                                       (uint32_t)data.len,
-                                       (uint8_t)start_value,
-                                       (bool)first_call);
+    uint64_t start = e2e_stats_start();
+    uint8_t  crc   = Crc_CalculateCRC8H2F((uint8_t *)data.buf,
+                                          (uint32_t)data.len,
+                                          (uint8_t)start_value,
+                                          (bool)first_call);
+    e2e_stats_stop(E2E_STAT_CRC8_H2F, start, (size_t)data.len, E2E_RESULT_OK);
 
     PyBuffer_Release(&data);
 
@@ -131,10 +137,12 @@ static PyObject *py_calculate_crc16(PyObject *module, PyObject *args, PyObject *
         return NULL;
     }
 
-    uint16_t crc = Crc_CalculateCRC16((uint8_t *)data.buf,
-                                      (uint32_t)data.len,
-                                      (uint16_t)start_value,
-                                      (bool)first_call);
+    uint64_t start = e2e_stats_start();
+    uint16_t crc   = Crc_CalculateCRC16((uint8_t *)data.buf,
+                                        (uint32_t)data.len,
+                                        (uint16_t)start_value,
+                                        (bool)first_call);
+    e2e_stats_stop(E2E_STAT_CRC16, start, (size_t)data.len, E2E_RESULT_OK);
 
     PyBuffer_Release(&data);
 
@@ -175,10 +183,12 @@ static PyObject *py_calculate_crc16_arc(PyObject *module, PyObject *args, PyObje
         return NULL;
     }
 
-    uint16_t crc = Crc_CalculateCRC16ARC((uint8_t *)data.buf,
-                                         (uint32_t)data.len,
-                                         (uint16_t)start_value,
-                                         (bool)first_call);
+    uint64_t start = e2e_stats_start();
+    uint16_t crc   = Crc_CalculateCRC16ARC((uint8_t *)data.buf,
+                                           (uint32_t)data.len,
+                                           (uint16_t)start_value,
+                                           (bool)first_call);
+    e2e_stats_stop(E2E_STAT_CRC16_ARC, start, (size_t)data.len, E2E_RESULT_OK);
     PyBuffer_Release(&data);
 
     return (PyLong_FromUnsignedLong(crc));
@@ -218,10 +228,12 @@ static PyObject *py_calculate_crc32(PyObject *module, PyObject *args, PyObject *
         return NULL;
     }
 
-    uint32_t crc = Crc_CalculateCRC32((uint8_t *)data.buf,
-                                      (uint32_t)data.len,
-                                      (uint32_t)start_value,
-                                      (bool)first_call);
+    uint64_t start = e2e_stats_start();
+    uint32_t crc   = Crc_CalculateCRC32((uint8_t *)data.buf,
+                                        (uint32_t)data.len,
+                                        (uint32_t)start_value,
+                                        (bool)first_call);
+    e2e_stats_stop(E2E_STAT_CRC32, start, (size_t)data.len, E2E_RESULT_OK);
     PyBuffer_Release(&data);
 
     return (PyLong_FromUnsignedLong(crc));
@@ -261,10 +273,12 @@ static PyObject *py_calculate_crc32_p4(PyObject *module, PyObject *args, PyObjec
         return NULL;
     }
 
-    uint32_t crc = Crc_CalculateCRC32P4((uint8_t *)data.buf,
-                                        (uint32_t)data.len,
-                                        (uint32_t)start_value,
-                                        (bool)first_call);
+    uint64_t start = e2e_stats_start();
+    uint32_t crc   = Crc_CalculateCRC32P4((uint8_t *)data.buf,
+                                          (uint32_t)data.len,
+                                          (uint32_t)start_value,
+                                          (bool)first_call);
+    e2e_stats_stop(E2E_STAT_CRC32_P4, start, (size_t)data.len, E2E_RESULT_OK);
     PyBuffer_Release(&data);
 
     return (PyLong_FromUnsignedLong(crc));
@@ -304,10 +318,12 @@ static PyObject *py_calculate_crc64(PyObject *module, PyObject *args, PyObject *
         return NULL;
     }
 
-    uint64_t crc = Crc_CalculateCRC64((uint8_t *)data.buf,
-                                      (uint32_t)data.len,
-                                      (uint64_t)start_value,
-                                      (bool)first_call);
+    uint64_t start = e2e_stats_start();
+    uint64_t crc   = Crc_CalculateCRC64((uint8_t *)data.buf,
+                                        (uint32_t)data.len,
+                                        (uint64_t)start_value,
+                                        (bool)first_call);
+    e2e_stats_stop(E2E_STAT_CRC64, start, (size_t)data.len, E2E_RESULT_OK);
     PyBuffer_Release(&data);
 
     return (PyLong_FromUnsignedLongLong(crc));
@@ -339,8 +355,8 @@ static int _AddUnsignedIntConstant(PyObject *module, const char *name, uint64_t
 
 #define _AddUnsignedIntMacro(m, c) _AddUnsignedIntConstant(m, #c, c)
 
-// Module execution function for multi-phase initialization
-static int crc_exec(PyObject *module)
+// Fill the namespace of e2e.crc, called by e2e._e2e._init_submodule()
+int crc_init_submodule(PyObject *module)
 {
     // Add constants to module
     _AddUnsignedIntMacro(module, CRC8_INITIAL_VALUE);
@@ -385,21 +401,3 @@ static int crc_exec(PyObject *module)
 
     return 0;
 }
-
-// Array of slot definitions for multi-phase initialization
-static PyModuleDef_Slot crc_slots[] = {{Py_mod_exec, (void *)crc_exec},
-#ifdef Py_GIL_DISABLED
-                                       {Py_mod_gil, Py_MOD_GIL_NOT_USED},
-#endif
-                                       {0, NULL}};
-
-// Module definition
-static struct PyModuleDef crc_module = {PyModuleDef_HEAD_INIT,
-                                        .m_name    = "e2e.crc",
-                                        .m_doc     = "",
-                                        .m_size    = 0,
-                                        .m_methods = NULL, // Methods added dynamically
-                                        .m_slots   = crc_slots};
-
-// Init function
-PyMODINIT_FUNC            PyInit_crc(void) { return PyModuleDef_Init(&crc_module); }
@@ -0,0 +1,10 @@
+"""CRC routines, the functions are implemented in e2e._e2e or e2e._cffi."""
+
+import sys as _sys
+
+from e2e._backend import init_submodule as _init_submodule
+from e2e._crctune import backend as backend
+from e2e._crctune import tune as tune
+
+_init_submodule(_sys.modules[__name__])
+del _sys, _init_submodule
@@ -56,3 +56,10 @@ CRC64_INITIAL_VALUE: typing.Final[int]
 CRC64_XOR_VALUE: typing.Final[int]
 CRC64_CHECK: typing.Final[int]
 CRC64_MAGIC_CHECK: typing.Final[int]
+def tune(
+    sizes: typing.Optional[typing.Iterable[int]] = None,
+    min_time: float = 0.001,
+    repeats: int = 3,
+    save: bool = True,
+) -> typing.Dict[str, int]: ...
+def backend() -> typing.Dict[str, typing.Any]: ...
@@ -0,0 +1,159 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef E2E_CAPI_H
+#define E2E_CAPI_H
+
+// C API of the e2e package for other extension modules. The kernels are
+// exported as a table of function pointers in the capsule e2e._C_API:
+//
+//   #include <Python.h>
+//   #include "e2e_capi.h"   // directory: python -c "import e2e; print(e2e.get_include())"
+//
+//   static const e2e_capi_t *e2e_api;
+//
+//   // in the exec function of the module
+//   e2e_api = E2E_CAPI_Import();
+//   if (e2e_api == NULL) {
+//       return -1;
+//   }
+//
+//   // anywhere, with or without the GIL
+//   e2e_api->p05_protect(frame, length, data_id, 0, true);
+//
+// Apart from ring_from_object(), none of the functions touches Python objects,
+// they may be called without holding the GIL. The raw protect and check
+// functions do not validate their arguments, the caller must make sure that
+// the header at offset fits into length bytes and length into the frame.
+// config_error() rejects a configuration whose length does not contain the
+// header at offset; config_protect() and config_check() validate the frame
+// against the configuration and return E2E_RESULT_BAD_FRAME if it does not
+// fit, also for configurations which config_error() rejects. Calls through
+// the C API are not counted by e2e.stats().
+
+#include <Python.h>
+
+#include "crclib.h"
+#include "e2elib.h"
+#include "ring.h"
+
+#define E2E_CAPI_NAME    "e2e._C_API"
+
+// Incremented whenever functions are appended to e2e_capi_t. Existing members
+// never change, so an extension which is built against an older header works
+// with every newer e2e.
+#define E2E_CAPI_VERSION 2
+
+typedef struct {
+    uint32_t version; // E2E_CAPI_VERSION of the exporting e2e
+    uint32_t size;    // sizeof(e2e_capi_t) of the exporting e2e
+
+    // CRC kernels, see crclib.h
+    uint8_t (*crc8)(const uint8_t *data, uint32_t length, uint8_t start, bool first_call);
+    uint8_t (*crc8h2f)(const uint8_t *data, uint32_t length, uint8_t start, bool first_call);
+    uint16_t (*crc16)(const uint8_t *data, uint32_t length, uint16_t start, bool first_call);
+    uint16_t (*crc16arc)(const uint8_t *data, uint32_t length, uint16_t start, bool first_call);
+    uint32_t (*crc32)(const uint8_t *data, uint32_t length, uint32_t start, bool first_call);
+    uint32_t (*crc32p4)(const uint8_t *data, uint32_t length, uint32_t start, bool first_call);
+    uint64_t (*crc64)(const uint8_t *data, uint32_t length, uint64_t start, bool first_call);
+
+    // CRC of a frame like the profile computes it, without writing it
+    uint8_t (*compute_p01_crc)(const uint8_t *data,
+                               uint16_t       length,
+                               uint16_t       data_id,
+                               uint16_t       data_id_mode,
+                               uint8_t        counter,
+                               uint16_t       crc_offset);
+    uint8_t (*compute_p02_crc)(const uint8_t *data, uint32_t length, const uint8_t *data_id_list);
+    uint32_t (*compute_p04_crc)(const uint8_t *data, uint16_t length, uint16_t offset);
+    uint16_t (*compute_p05_crc)(const uint8_t *data, uint16_t length, uint16_t data_id, uint16_t offset);
+    uint16_t (*compute_p06_crc)(const uint8_t *data, uint16_t length, uint16_t data_id, uint16_t offset);
+    uint64_t (*compute_p07_crc)(const uint8_t *data, uint32_t length, uint32_t offset);
+
+    // Raw buffer protect and check functions, see e2elib.h
+    void (*p01_protect)(uint8_t *data,
+                        uint16_t length,
+                        uint16_t data_id,
+                        uint16_t data_id_mode,
+                        bool     increment_counter);
+    e2e_result_t (*p01_check)(const uint8_t *data,
+                              uint16_t       length,
+                              uint16_t       data_id,
+                              uint16_t       data_id_mode,
+                              uint32_t      *counter);
+    void (*p02_protect)(uint8_t *data, uint32_t length, const uint8_t *data_id_list, bool increment_counter);
+    e2e_result_t (*p02_check)(const uint8_t *data,
+                              uint32_t       length,
+                              const uint8_t *data_id_list,
+                              uint32_t      *counter);
+    void (*p04_protect)(uint8_t *data, uint16_t length, uint32_t data_id, uint16_t offset, bool increment_counter);
+    e2e_result_t (*p04_check)(const uint8_t *data,
+                              uint16_t       length,
+                              uint32_t       data_id,
+                              uint16_t       offset,
+                              uint32_t      *counter);
+    void (*p05_protect)(uint8_t *data, uint16_t length, uint16_t data_id, uint16_t offset, bool increment_counter);
+    e2e_result_t (*p05_check)(const uint8_t *data,
+                              uint16_t       length,
+                              uint16_t       data_id,
+                              uint16_t       offset,
+                              uint32_t      *counter);
+    void (*p06_protect)(uint8_t *data, uint16_t length, uint16_t data_id, uint16_t offset, bool increment_counter);
+    e2e_result_t (*p06_check)(const uint8_t *data,
+                              uint16_t       length,
+                              uint16_t       data_id,
+                              uint16_t       offset,
+                              uint32_t      *counter);
+    void (*p07_protect)(uint8_t *data, uint32_t length, uint32_t data_id, uint32_t offset, bool increment_counter);
+    e2e_result_t (*p07_check)(const uint8_t *data,
+                              uint32_t       length,
+                              uint32_t       data_id,
+                              uint32_t       offset,
+                              uint32_t      *counter);
+
+    // Protect and check with a configuration, the frame length is validated
+    const char *(*config_error)(const e2e_config_t *config);
+    uint32_t (*config_frame_length)(const e2e_config_t *config, size_t data_len);
+    e2e_result_t (*config_protect)(const e2e_config_t *config,
+                                   uint8_t            *data,
+                                   size_t              data_len,
+                                   bool                increment_counter);
+    e2e_result_t (*config_check)(const e2e_config_t *config,
+                                 const uint8_t      *data,
+                                 size_t              data_len,
+                                 uint32_t           *counter);
+
+    // Version 2: producer side of an e2e.FrameRing, see ring.h. ring_from_object()
+    // requires the GIL and returns the ring of a FrameRing or sets TypeError and
+    // returns NULL. The ring stays valid as long as the caller holds a reference
+    // to the FrameRing. Only one thread may produce into a ring at a time, this
+    // includes FrameRing.push() and native producers like e2e.Scheduler.
+    e2e_ring_t *(*ring_from_object)(PyObject *obj);
+    e2e_ring_slot_t *(*ring_reserve)(e2e_ring_t *ring);
+    void (*ring_commit)(e2e_ring_t *ring);
+    uint8_t *(*ring_slot_data)(e2e_ring_slot_t *slot);
+    bool (*ring_push)(e2e_ring_t    *ring,
+                      uint64_t       id,
+                      uint64_t       time,
+                      uint32_t       status,
+                      const uint8_t *data,
+                      uint32_t       length);
+} e2e_capi_t;
+
+// Import e2e and return its function table, or set an exception and return
+// NULL. Requires the GIL. The table stays valid for the life of the process.
+static inline const e2e_capi_t *E2E_CAPI_Import(void)
+{
+    const e2e_capi_t *api = (const e2e_capi_t *)PyCapsule_Import(E2E_CAPI_NAME, 0);
+    if (api != NULL && api->version < E2E_CAPI_VERSION) {
+        PyErr_Format(PyExc_ImportError,
+                     "e2e C API version %u is older than version %u of e2e_capi.h",
+                     (unsigned int)api->version,
+                     (unsigned int)E2E_CAPI_VERSION);
+        return NULL;
+    }
+    return api;
+}
+
+#endif
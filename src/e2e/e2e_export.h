@@ -0,0 +1,24 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef E2E_EXPORT_H
+#define E2E_EXPORT_H
+
+// Visibility of the public functions of crclib.h and e2elib.h. E2E_BUILD_SHARED
+// is defined while the shared libe2e is compiled, E2E_SHARED by its users
+// (target e2e::e2e). The extension module and the static libe2e compile the
+// same sources without either, there the macro is empty.
+#if defined(E2E_BUILD_SHARED)
+#if defined(_WIN32)
+#define E2E_API __declspec(dllexport)
+#else
+#define E2E_API __attribute__((visibility("default")))
+#endif
+#elif defined(_WIN32) && defined(E2E_SHARED)
+#define E2E_API __declspec(dllimport)
+#else
+#define E2E_API
+#endif
+
+#endif
@@ -0,0 +1,752 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crclib.h"
+#include "e2elib.h"
+#include "util.h"
+
+uint8_t compute_p01_crc(const uint8_t *data_ptr,
+                        uint16_t       length,
+                        uint16_t       data_id,
+                        uint16_t       data_id_mode,
+                        uint8_t        counter,
+                        uint16_t       crc_offset)
+{
+    uint8_t data_id_lo_byte = (uint8_t)data_id;
+    uint8_t data_id_hi_byte = (uint8_t)(data_id >> 8);
+    uint8_t crc             = 0x00u;
+
+    switch (data_id_mode) {
+        case E2E_P01_DATAID_BOTH:
+            crc = Crc_CalculateCRC8(&data_id_lo_byte, 1u, CRC8_XOR_VALUE, false);
+            crc = Crc_CalculateCRC8(&data_id_hi_byte, 1u, crc, false);
+            break;
+
+        case E2E_P01_DATAID_LOW:
+            crc = Crc_CalculateCRC8(&data_id_lo_byte, 1u, CRC8_XOR_VALUE, false);
+            break;
+
+        case E2E_P01_DATAID_ALT:
+            if (counter % 2 == 0) {
+                crc = Crc_CalculateCRC8(&data_id_lo_byte, 1u, CRC8_XOR_VALUE, false);
+            }
+            else {
+                crc = Crc_CalculateCRC8(&data_id_hi_byte, 1u, CRC8_XOR_VALUE, false);
+            }
+            break;
+
+        case E2E_P01_DATAID_NIBBLE:
+            crc             = Crc_CalculateCRC8(&data_id_lo_byte, 1u, CRC8_XOR_VALUE, false);
+            data_id_hi_byte = 0;
+            crc             = Crc_CalculateCRC8(&data_id_hi_byte, 1u, crc, false);
+            break;
+    }
+
+    if (crc_offset >= 8) {
+        // compute crc over data before the crc byte
+        crc = Crc_CalculateCRC8(data_ptr, (crc_offset >> 3), crc, false);
+    }
+
+    if ((crc_offset >> 3) < length) {
+        // compute crc over area after crc byte
+        unsigned short start_byte = (crc_offset >> 3) + 1;
+        unsigned short byte_count = length - (crc_offset >> 3);
+        crc                       = Crc_CalculateCRC8(data_ptr + start_byte, byte_count, crc, false);
+    }
+
+    return crc ^ CRC8_XOR_VALUE;
+}
+
+uint8_t compute_p02_crc(const uint8_t *data_ptr, uint32_t length, const uint8_t *data_id_list)
+{
+    uint8_t counter = data_ptr[1] & 0x0Fu;
+    uint8_t crc     = Crc_CalculateCRC8H2F(data_ptr + 1, length, CRC8H2F_INITIAL_VALUE, true);
+    return Crc_CalculateCRC8H2F(data_id_list + counter, 1u, crc, false);
+}
+
+uint32_t compute_p04_crc(const uint8_t *data_ptr, uint16_t length, uint16_t offset)
+{
+    uint32_t crc;
+
+    // bytes before crc bytes
+    uint32_t crc_offset = (uint32_t)(offset + P04CRC_POS);
+    crc                 = P04CALCULATE_CRC(data_ptr, crc_offset, CRC32P4_INITIAL_VALUE, true);
+
+    // bytes after crc bytes, if any
+    if (offset + P04HEADER_LEN < length) {
+        const uint8_t *second_part_ptr    = data_ptr + offset + P04HEADER_LEN;
+        uint32_t       second_part_length = length - offset - P04HEADER_LEN;
+        crc = P04CALCULATE_CRC(second_part_ptr, second_part_length, crc, false);
+    }
+    return crc;
+}
+
+uint16_t compute_p05_crc(const uint8_t *data_ptr, uint16_t length, uint16_t data_id, uint16_t offset)
+{
+    uint16_t crc;
+    uint8_t  data_id_lo_byte = (uint8_t)data_id;
+    uint8_t  data_id_hi_byte = (uint8_t)(data_id >> 8);
+    if (offset > 0) {
+        crc = P05CALCULATE_CRC(data_ptr, offset, CRC16_INITIAL_VALUE, true);
+        crc = P05CALCULATE_CRC(&data_ptr[offset + P05COUNTER_POS], length - offset, crc, false);
+    }
+    else {
+        crc = P05CALCULATE_CRC(&data_ptr[P05COUNTER_POS], length, CRC16_INITIAL_VALUE, true);
+    }
+    crc = P05CALCULATE_CRC(&data_id_lo_byte, 1, crc, false);
+    crc = P05CALCULATE_CRC(&data_id_hi_byte, 1, crc, false);
+
+    return crc;
+}
+
+uint16_t compute_p06_crc(const uint8_t *data_ptr, uint16_t length, uint16_t data_id, uint16_t offset)
+{
+    uint16_t crc;
+    uint8_t  data_id_lo_byte = (uint8_t)data_id;
+    uint8_t  data_id_hi_byte = (uint8_t)(data_id >> 8);
+    if (offset > 0) {
+        crc = P06CALCULATE_CRC(data_ptr, offset, CRC16_INITIAL_VALUE, true);
+        crc = P06CALCULATE_CRC(&data_ptr[offset + P06LENGTH_POS],
+                               length - offset - P06LENGTH_POS,
+                               crc,
+                               false);
+    }
+    else {
+        crc = P06CALCULATE_CRC(&data_ptr[P06LENGTH_POS],
+                               length - P06LENGTH_POS,
+                               CRC16_INITIAL_VALUE,
+                               true);
+    }
+    crc = P06CALCULATE_CRC(&data_id_hi_byte, 1, crc, false);
+    crc = P06CALCULATE_CRC(&data_id_lo_byte, 1, crc, false);
+
+    return crc;
+}
+
+uint64_t compute_p07_crc(const uint8_t *data_ptr, uint32_t length, uint32_t offset)
+{
+    uint64_t crc;
+
+    // bytes before crc bytes
+    uint32_t crc_offset = (uint32_t)(offset + P07CRC_POS);
+    crc                 = P07CALCULATE_CRC(data_ptr, crc_offset, CRC64_INITIAL_VALUE, true);
+
+    // bytes after crc bytes, if any
+    if (offset + P07CRC_POS + P07CRC_LEN < length) {
+        uint32_t       second_part_offset = offset + P07CRC_POS + P07CRC_LEN;
+        const uint8_t *second_part_ptr    = data_ptr + second_part_offset;
+        uint32_t       second_part_len    = length - (uint32_t)(offset + P07CRC_POS + P07CRC_LEN);
+        crc = P07CALCULATE_CRC(second_part_ptr, second_part_len, crc, false);
+    }
+    return crc;
+}
+
+void e2e_p01_protect(uint8_t *data_ptr,
+                     uint16_t length,
+                     uint16_t data_id,
+                     uint16_t data_id_mode,
+                     bool     increment_counter)
+{
+    // The counter goes either into low nibble or high nibble of data
+    uint8_t counter = 0;
+    if (P01COUNTER_OFFSET % 8 == 0) {
+        counter = (*(data_ptr + (P01COUNTER_OFFSET >> 3)) & 0x0F);
+        if (increment_counter) {
+            counter = (counter + 1) % 0x0F; // alive counter in range 0-14
+            *(data_ptr + (P01COUNTER_OFFSET >> 3)) =
+                (*(data_ptr + (P01COUNTER_OFFSET >> 3)) & 0xF0) | counter;
+        }
+    }
+    else {
+        counter = (*(data_ptr + (P01COUNTER_OFFSET >> 3)) & 0xF0) >> 4;
+        if (increment_counter) {
+            counter = (counter + 1) % 0x0F; // alive counter in range 0-14
+            *(data_ptr + (P01COUNTER_OFFSET >> 3)) =
+                (*(data_ptr + (P01COUNTER_OFFSET >> 3)) & 0x0F) | ((counter << 4) & 0xF0);
+        }
+    }
+
+    if (data_id_mode == E2E_P01_DATAID_NIBBLE) {
+        // Write the low nibble of high byte of data_id
+        if (P01DATAID_NIBBLE_OFFSET % 8 == 0) {
+            *(data_ptr + (P01DATAID_NIBBLE_OFFSET >> 3)) =
+                (*(data_ptr + (P01DATAID_NIBBLE_OFFSET >> 3)) & 0xF0) | ((data_id >> 8) & 0x0F);
+        }
+        else {
+            *(data_ptr + (P01DATAID_NIBBLE_OFFSET >> 3)) =
+                (*(data_ptr + (P01DATAID_NIBBLE_OFFSET >> 3)) & 0x0F) | ((data_id >> 4) & 0xF0);
+        }
+    }
+
+    // calculate CRC and write it to data
+    *(data_ptr + (P01CRC_OFFSET / 8)) =
+        compute_p01_crc(data_ptr, length, data_id, data_id_mode, counter, P01CRC_OFFSET);
+}
+
+e2e_result_t e2e_p01_check(const uint8_t *data_ptr,
+                           uint16_t       length,
+                           uint16_t       data_id,
+                           uint16_t       data_id_mode,
+                           uint32_t      *counter)
+{
+    // Check the alive counter value. The counter is located either in the low
+    // or the high nibble of data
+    uint8_t counter_actual = 0u;
+    if (P01COUNTER_OFFSET % 8u == 0u) {
+        counter_actual = (*(data_ptr + (P01COUNTER_OFFSET >> 3)) & 0x0F);
+    }
+    else {
+        counter_actual = (*(data_ptr + (P01COUNTER_OFFSET >> 3)) & 0xF0) >> 4;
+    }
+    if (counter != NULL) {
+        *counter = counter_actual;
+    }
+    if (counter_actual > P01MAX_COUNTER) {
+        return E2E_RESULT_COUNTER_RANGE;
+    }
+
+    // check the data_id nibble if it is sent explicitly
+    if (data_id_mode == E2E_P01_DATAID_NIBBLE) {
+        uint8_t data_id_nibble = *(data_ptr + (P01DATAID_NIBBLE_OFFSET >> 3)) >> 4;
+        if (data_id_nibble != ((uint8_t)(data_id >> 8) & 0x0F)) {
+            return E2E_RESULT_DATA_ID_MISMATCH;
+        }
+    }
+
+    // check CRC
+    uint8_t crc_actual = *(data_ptr + (P01CRC_OFFSET / 8));
+    uint8_t crc =
+        compute_p01_crc(data_ptr, length, data_id, data_id_mode, counter_actual, P01CRC_OFFSET);
+    if (crc_actual != crc) {
+        return E2E_RESULT_CRC_MISMATCH;
+    }
+    return E2E_RESULT_OK;
+}
+
+void e2e_p02_protect(uint8_t       *data_ptr,
+                     uint32_t       length,
+                     const uint8_t *data_id_list,
+                     bool           increment_counter)
+{
+    // increment counter
+    if (increment_counter) {
+        uint8_t counter = ((data_ptr[1] & 0x0Fu) + 1) % 16u;
+        data_ptr[1]     = (data_ptr[1] & 0xF0u) | counter;
+    }
+
+    // calculate CRC
+    data_ptr[0] = compute_p02_crc(data_ptr, length, data_id_list);
+}
+
+e2e_result_t e2e_p02_check(const uint8_t *data_ptr,
+                           uint32_t       length,
+                           const uint8_t *data_id_list,
+                           uint32_t      *counter)
+{
+    if (counter != NULL) {
+        *counter = data_ptr[1] & 0x0Fu;
+    }
+    if (data_ptr[0] != compute_p02_crc(data_ptr, length, data_id_list)) {
+        return E2E_RESULT_CRC_MISMATCH;
+    }
+    return E2E_RESULT_OK;
+}
+
+void e2e_p04_protect(uint8_t *data_ptr,
+                     uint16_t length,
+                     uint32_t data_id,
+                     uint16_t offset,
+                     bool     increment_counter)
+{
+    // write length
+    uint16_to_bigendian(data_ptr + offset + P04LENGTH_POS, length);
+
+    // increment counter
+    if (increment_counter) {
+        uint16_t counter = bigendian_to_uint16(data_ptr + offset + P04COUNTER_POS);
+        counter++;
+        uint16_to_bigendian(data_ptr + offset + P04COUNTER_POS, counter);
+    }
+
+    // write data_id
+    uint32_to_bigendian(data_ptr + offset + P04DATAID_POS, data_id);
+
+    // calculate CRC
+    uint32_t crc = compute_p04_crc(data_ptr, length, offset);
+    uint32_to_bigendian(data_ptr + offset + P04CRC_POS, crc);
+}
+
+e2e_result_t e2e_p04_check(const uint8_t *data_ptr,
+                           uint16_t       length,
+                           uint32_t       data_id,
+                           uint16_t       offset,
+                           uint32_t      *counter)
+{
+    if (counter != NULL) {
+        *counter = bigendian_to_uint16(data_ptr + offset + P04COUNTER_POS);
+    }
+    if (bigendian_to_uint16(data_ptr + offset + P04LENGTH_POS) != length) {
+        return E2E_RESULT_LENGTH_MISMATCH;
+    }
+    if (bigendian_to_uint32(data_ptr + offset + P04DATAID_POS) != data_id) {
+        return E2E_RESULT_DATA_ID_MISMATCH;
+    }
+    if (bigendian_to_uint32(data_ptr + offset + P04CRC_POS) != compute_p04_crc(data_ptr, length, offset)) {
+        return E2E_RESULT_CRC_MISMATCH;
+    }
+    return E2E_RESULT_OK;
+}
+
+void e2e_p05_protect(uint8_t *data_ptr,
+                     uint16_t length,
+                     uint16_t data_id,
+                     uint16_t offset,
+                     bool     increment_counter)
+{
+    // increment counter
+    if (increment_counter) {
+        data_ptr[offset + P05COUNTER_POS]++;
+    }
+
+    // calculate CRC
+    uint16_t crc = compute_p05_crc(data_ptr, length, data_id, offset);
+    uint16_to_littleendian(data_ptr + offset + P05CRC_POS, crc);
+}
+
+e2e_result_t e2e_p05_check(const uint8_t *data_ptr,
+                           uint16_t       length,
+                           uint16_t       data_id,
+                           uint16_t       offset,
+                           uint32_t      *counter)
+{
+    if (counter != NULL) {
+        *counter = data_ptr[offset + P05COUNTER_POS];
+    }
+    if (littleendian_to_uint16(data_ptr + offset + P05CRC_POS) !=
+        compute_p05_crc(data_ptr, length, data_id, offset)) {
+        return E2E_RESULT_CRC_MISMATCH;
+    }
+    return E2E_RESULT_OK;
+}
+
+void e2e_p06_protect(uint8_t *data_ptr,
+                     uint16_t length,
+                     uint16_t data_id,
+                     uint16_t offset,
+                     bool     increment_counter)
+{
+    // write length
+    uint16_to_bigendian(data_ptr + offset + P06LENGTH_POS, length);
+
+    // increment counter
+    if (increment_counter) {
+        data_ptr[offset + P06COUNTER_POS]++;
+    }
+
+    // calculate CRC
+    uint16_t crc = compute_p06_crc(data_ptr, length, data_id, offset);
+    uint16_to_bigendian(data_ptr + offset + P06CRC_POS, crc);
+}
+
+e2e_result_t e2e_p06_check(const uint8_t *data_ptr,
+                           uint16_t       length,
+                           uint16_t       data_id,
+                           uint16_t       offset,
+                           uint32_t      *counter)
+{
+    if (counter != NULL) {
+        *counter = data_ptr[offset + P06COUNTER_POS];
+    }
+    if (bigendian_to_uint16(data_ptr + offset + P06LENGTH_POS) != length) {
+        return E2E_RESULT_LENGTH_MISMATCH;
+    }
+    if (bigendian_to_uint16(data_ptr + offset + P06CRC_POS) !=
+        compute_p06_crc(data_ptr, length, data_id, offset)) {
+        return E2E_RESULT_CRC_MISMATCH;
+    }
+    return E2E_RESULT_OK;
+}
+
+void e2e_p07_protect(uint8_t *data_ptr,
+                     uint32_t length,
+                     uint32_t data_id,
+                     uint32_t offset,
+                     bool     increment_counter)
+{
+    // write length
+    uint32_to_bigendian(data_ptr + offset + P07LENGTH_POS, length);
+
+    // increment counter
+    if (increment_counter) {
+        uint32_t counter = bigendian_to_uint32(data_ptr + offset + P07COUNTER_POS);
+        counter += 1;
+        uint32_to_bigendian(data_ptr + offset + P07COUNTER_POS, counter);
+    }
+
+    // write data_id
+    uint32_to_bigendian(data_ptr + offset + P07DATAID_POS, data_id);
+
+    // calculate CRC
+    uint64_t crc = compute_p07_crc(data_ptr, length, offset);
+    uint64_to_bigendian(data_ptr + offset + P07CRC_POS, crc);
+}
+
+e2e_result_t e2e_p07_check(const uint8_t *data_ptr,
+                           uint32_t       length,
+                           uint32_t       data_id,
+                           uint32_t       offset,
+                           uint32_t      *counter)
+{
+    if (counter != NULL) {
+        *counter = bigendian_to_uint32(data_ptr + offset + P07COUNTER_POS);
+    }
+    if (bigendian_to_uint32(data_ptr + offset + P07LENGTH_POS) != length) {
+        return E2E_RESULT_LENGTH_MISMATCH;
+    }
+    if (bigendian_to_uint32(data_ptr + offset + P07DATAID_POS) != data_id) {
+        return E2E_RESULT_DATA_ID_MISMATCH;
+    }
+    if (bigendian_to_uint64(data_ptr + offset + P07CRC_POS) != compute_p07_crc(data_ptr, length, offset)) {
+        return E2E_RESULT_CRC_MISMATCH;
+    }
+    return E2E_RESULT_OK;
+}
+
+const char *e2e_config_error(const e2e_config_t *config)
+{
+    switch (config->profile) {
+        case 1:
+            if (config->data_id > 0xFFFFu) {
+                return "Argument \"data_id\" must be a 16bit unsigned integer for profile 1.";
+            }
+            if (config->data_id_mode > E2E_P01_DATAID_NIBBLE) {
+                return "Argument \"data_id_mode\" invalid.";
+            }
+            if (config->offset != 0) {
+                return "Profile 1 does not support an \"offset\".";
+            }
+            if (config->length > 0xFFFFu) {
+                return "Argument \"length\" must fulfill 0 <= length <= 65535 for profile 1.";
+            }
+            break;
+
+        case 2:
+            if (config->offset != 0) {
+                return "Profile 2 does not support an \"offset\".";
+            }
+            break;
+
+        case 4:
+            if (config->offset > 0xFFFFu) {
+                return "Argument \"offset\" invalid.";
+            }
+            if (config->length != 0 && (config->length < P04HEADER_LEN || config->length > 0xFFFFu)) {
+                return "Argument \"length\" must be 0 or fulfill 12 <= length <= 65535 for profile 4.";
+            }
+            if (config->length != 0 && config->length < config->offset + P04HEADER_LEN) {
+                return "Argument \"length\" must be 0 or fulfill offset + 12 <= length for profile 4.";
+            }
+            break;
+
+        case 5:
+            if (config->data_id > 0xFFFFu) {
+                return "Argument \"data_id\" must be a 16bit unsigned integer for profile 5.";
+            }
+            if (config->offset > 0xFFFFu) {
+                return "Argument \"offset\" invalid.";
+            }
+            if (config->length > 0xFFFFu) {
+                return "Argument \"length\" must fulfill 0 <= length <= 65535 for profile 5.";
+            }
+            // length excludes the two CRC bytes, the counter must lie within it
+            if (config->length != 0 && config->length < config->offset + P05COUNTER_LEN) {
+                return "Argument \"length\" must be 0 or fulfill offset + 1 <= length for profile 5.";
+            }
+            break;
+
+        case 6:
+            if (config->data_id > 0xFFFFu) {
+                return "Argument \"data_id\" must be a 16bit unsigned integer for profile 6.";
+            }
+            if (config->offset > 0xFFFFu) {
+                return "Argument \"offset\" invalid.";
+            }
+            if (config->length != 0 && (config->length < P06HEADER_LEN || config->length > 0xFFFFu)) {
+                return "Argument \"length\" must be 0 or fulfill 5 <= length <= 65535 for profile 6.";
+            }
+            if (config->length != 0 && config->length < config->offset + P06HEADER_LEN) {
+                return "Argument \"length\" must be 0 or fulfill offset + 5 <= length for profile 6.";
+            }
+            break;
+
+        case 7:
+            if (config->length != 0 && config->length < P07HEADER_LEN) {
+                return "Argument \"length\" must be 0 or greater than or equal to 20 for profile 7.";
+            }
+            if (config->length != 0 && config->length < (uint64_t)config->offset + P07HEADER_LEN) {
+                return "Argument \"length\" must be 0 or fulfill offset + 20 <= length for profile 7.";
+            }
+            break;
+
+        default:
+            return "Argument \"profile\" must be one of 1, 2, 4, 5, 6 or 7.";
+    }
+
+    if (config->max_delta_counter < 1 ||
+        config->max_delta_counter >= e2e_counter_modulus(config->profile)) {
+        return "Argument \"max_delta_counter\" is out of range for this profile.";
+    }
+    return NULL;
+}
+
+uint32_t e2e_config_frame_length(const e2e_config_t *config, size_t data_len)
+{
+    uint64_t length = config->length;
+    uint64_t offset = config->offset;
+
+    switch (config->profile) {
+        case 1:
+        case 2:
+            if (data_len < 2) {
+                return 0;
+            }
+            if (length == 0) {
+                length = data_len - 1;
+            }
+            if (length > data_len - 1 || (config->profile == 1 && length > 0xFFFFu)) {
+                return 0;
+            }
+            break;
+
+        case 4:
+        case 6:
+        case 7: {
+            size_t header_len = config->profile == 4   ? P04HEADER_LEN
+                                : config->profile == 6 ? P06HEADER_LEN
+                                                       : P07HEADER_LEN;
+            if (data_len < header_len || offset > data_len - header_len) {
+                return 0;
+            }
+            if (length == 0) {
+                length = data_len;
+            }
+            // the header at offset must lie within the length
+            if (length < offset + header_len || length > data_len ||
+                (config->profile != 7 && length > 0xFFFFu) || length > 0xFFFFFFFFu) {
+                return 0;
+            }
+            break;
+        }
+
+        case 5:
+            if (data_len <= P05HEADER_LEN || offset > data_len - P05HEADER_LEN) {
+                return 0;
+            }
+            if (length == 0) {
+                length = data_len - P05CRC_LEN;
+            }
+            // length excludes the CRC, the counter at offset must lie within it
+            if (length < offset + P05COUNTER_LEN || length > data_len - P05CRC_LEN || length > 0xFFFFu) {
+                return 0;
+            }
+            break;
+
+        default:
+            return 0;
+    }
+    return (uint32_t)length;
+}
+
+e2e_result_t e2e_config_check(const e2e_config_t *config,
+                              const uint8_t      *data_ptr,
+                              size_t              data_len,
+                              uint32_t           *counter)
+{
+    uint32_t length = e2e_config_frame_length(config, data_len);
+    if (length == 0) {
+        return E2E_RESULT_BAD_FRAME;
+    }
+
+    switch (config->profile) {
+        case 1:
+            return e2e_p01_check(data_ptr,
+                                 (uint16_t)length,
+                                 (uint16_t)config->data_id,
+                                 config->data_id_mode,
+                                 counter);
+        case 2:
+            return e2e_p02_check(data_ptr, length, config->data_id_list, counter);
+        case 4:
+            return e2e_p04_check(data_ptr,
+                                 (uint16_t)length,
+                                 config->data_id,
+                                 (uint16_t)config->offset,
+                                 counter);
+        case 5:
+            return e2e_p05_check(data_ptr,
+                                 (uint16_t)length,
+                                 (uint16_t)config->data_id,
+                                 (uint16_t)config->offset,
+                                 counter);
+        case 6:
+            return e2e_p06_check(data_ptr,
+                                 (uint16_t)length,
+                                 (uint16_t)config->data_id,
+                                 (uint16_t)config->offset,
+                                 counter);
+        case 7:
+            return e2e_p07_check(data_ptr, length, config->data_id, config->offset, counter);
+    }
+    return E2E_RESULT_BAD_FRAME;
+}
+
+e2e_result_t e2e_config_protect(const e2e_config_t *config,
+                                uint8_t            *data_ptr,
+                                size_t              data_len,
+                                bool                increment_counter)
+{
+    uint32_t length = e2e_config_frame_length(config, data_len);
+    if (length == 0) {
+        return E2E_RESULT_BAD_FRAME;
+    }
+
+    switch (config->profile) {
+        case 1:
+            e2e_p01_protect(data_ptr,
+                            (uint16_t)length,
+                            (uint16_t)config->data_id,
+                            config->data_id_mode,
+                            increment_counter);
+            break;
+        case 2:
+            e2e_p02_protect(data_ptr, length, config->data_id_list, increment_counter);
+            break;
+        case 4:
+            e2e_p04_protect(data_ptr,
+                            (uint16_t)length,
+                            config->data_id,
+                            (uint16_t)config->offset,
+                            increment_counter);
+            break;
+        case 5:
+            e2e_p05_protect(data_ptr,
+                            (uint16_t)length,
+                            (uint16_t)config->data_id,
+                            (uint16_t)config->offset,
+                            increment_counter);
+            break;
+        case 6:
+            e2e_p06_protect(data_ptr,
+                            (uint16_t)length,
+                            (uint16_t)config->data_id,
+                            (uint16_t)config->offset,
+                            increment_counter);
+            break;
+        case 7:
+            e2e_p07_protect(data_ptr, length, config->data_id, config->offset, increment_counter);
+            break;
+        default:
+            return E2E_RESULT_BAD_FRAME;
+    }
+    return E2E_RESULT_OK;
+}
+
+bool e2e_config_crc(const e2e_config_t *config,
+                    const uint8_t      *data_ptr,
+                    size_t              data_len,
+                    uint64_t           *received,
+                    uint64_t           *computed)
+{
+    uint32_t length = e2e_config_frame_length(config, data_len);
+    if (length == 0) {
+        return false;
+    }
+
+    const uint8_t *header = data_ptr + config->offset;
+    switch (config->profile) {
+        case 1: {
+            uint8_t counter = (P01COUNTER_OFFSET % 8u == 0u)
+                                  ? (data_ptr[P01COUNTER_OFFSET >> 3] & 0x0F)
+                                  : (data_ptr[P01COUNTER_OFFSET >> 3] & 0xF0) >> 4;
+            *received       = data_ptr[P01CRC_OFFSET / 8];
+            *computed       = compute_p01_crc(data_ptr,
+                                        (uint16_t)length,
+                                        (uint16_t)config->data_id,
+                                        config->data_id_mode,
+                                        counter,
+                                        P01CRC_OFFSET);
+            return true;
+        }
+        case 2:
+            *received = data_ptr[0];
+            *computed = compute_p02_crc(data_ptr, length, config->data_id_list);
+            return true;
+        case 4:
+            *received = bigendian_to_uint32(header + P04CRC_POS);
+            *computed = compute_p04_crc(data_ptr, (uint16_t)length, (uint16_t)config->offset);
+            return true;
+        case 5:
+            *received = littleendian_to_uint16(header + P05CRC_POS);
+            *computed = compute_p05_crc(data_ptr,
+                                        (uint16_t)length,
+                                        (uint16_t)config->data_id,
+                                        (uint16_t)config->offset);
+            return true;
+        case 6:
+            *received = bigendian_to_uint16(header + P06CRC_POS);
+            *computed = compute_p06_crc(data_ptr,
+                                        (uint16_t)length,
+                                        (uint16_t)config->data_id,
+                                        (uint16_t)config->offset);
+            return true;
+        case 7:
+            *received = bigendian_to_uint64(header + P07CRC_POS);
+            *computed = compute_p07_crc(data_ptr, length, config->offset);
+            return true;
+    }
+    return false;
+}
+
+// number of distinct counter values of a profile
+uint64_t e2e_counter_modulus(uint8_t profile)
+{
+    switch (profile) {
+        case 1:
+            return P01MAX_COUNTER + 1u;
+        case 2:
+            return 16u;
+        case 4:
+            return 0x10000u;
+        case 5:
+        case 6:
+            return 0x100u;
+        case 7:
+            return 0x100000000u;
+    }
+    return 1u;
+}
+
+uint32_t e2e_counter_delta(uint8_t profile, uint32_t last_counter, uint32_t counter)
+{
+    uint64_t modulus = e2e_counter_modulus(profile);
+    return (uint32_t)(((uint64_t)counter + modulus - ((uint64_t)last_counter % modulus)) % modulus);
+}
+
+uint8_t e2e_sequence_status(uint32_t delta, uint32_t max_delta_counter)
+{
+    if (delta == 0) {
+        return E2E_STATUS_REPEATED;
+    }
+    if (delta == 1) {
+        return E2E_STATUS_OK;
+    }
+    if (delta <= max_delta_counter) {
+        return E2E_STATUS_OKSOMELOST;
+    }
+    return E2E_STATUS_WRONGSEQUENCE;
+}
@@ -0,0 +1,223 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef E2ELIB_H
+#define E2ELIB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "e2e_export.h"
+
+#define E2E_P01_DATAID_BOTH     0x0
+#define E2E_P01_DATAID_ALT      0x1
+#define E2E_P01_DATAID_LOW      0x2
+#define E2E_P01_DATAID_NIBBLE   0x3
+
+// bit offsets of the profile 1 header fields
+#define P01CRC_OFFSET           0u
+#define P01COUNTER_OFFSET       8u
+#define P01DATAID_NIBBLE_OFFSET 12u
+#define P01MAX_COUNTER          14u
+
+#define P02DATAID_LIST_LEN      16u
+
+#define P04LENGTH_POS           0u
+#define P04LENGTH_LEN           2u
+#define P04COUNTER_POS          2u
+#define P04COUNTER_LEN          2u
+#define P04DATAID_POS           4u
+#define P04DATAID_LEN           4u
+#define P04CRC_POS              8u
+#define P04CRC_LEN              4u
+#define P04CALCULATE_CRC        Crc_CalculateCRC32P4
+
+#define P04HEADER_LEN           (P04LENGTH_LEN + P04COUNTER_LEN + P04DATAID_LEN + P04CRC_LEN)
+
+#define P05LENGTH_POS           0u
+#define P05LENGTH_LEN           0u
+#define P05COUNTER_POS          2u
+#define P05COUNTER_LEN          1u
+#define P05DATAID_POS           0u
+#define P05DATAID_LEN           0u
+#define P05CRC_POS              0u
+#define P05CRC_LEN              2u
+#define P05CALCULATE_CRC        Crc_CalculateCRC16
+
+#define P05HEADER_LEN           (P05CRC_LEN + P05COUNTER_LEN)
+
+#define P06LENGTH_POS           2u
+#define P06LENGTH_LEN           2u
+#define P06COUNTER_POS          4u
+#define P06COUNTER_LEN          1u
+#define P06DATAID_POS           0u
+#define P06DATAID_LEN           0u
+#define P06CRC_POS              0u
+#define P06CRC_LEN              2u
+#define P06CALCULATE_CRC        Crc_CalculateCRC16
+
+#define P06HEADER_LEN           (P06CRC_LEN + P06LENGTH_LEN + P06COUNTER_LEN)
+
+#define P07LENGTH_POS           8u
+#define P07LENGTH_LEN           4u
+#define P07COUNTER_POS          12u
+#define P07COUNTER_LEN          4u
+#define P07DATAID_POS           16u
+#define P07DATAID_LEN           4u
+#define P07CRC_POS              0u
+#define P07CRC_LEN              8u
+#define P07CALCULATE_CRC        Crc_CalculateCRC64
+
+#define P07HEADER_LEN           (P07CRC_LEN + P07LENGTH_LEN + P07COUNTER_LEN + P07DATAID_LEN)
+
+// Check status, the values follow E2E_P04CheckStatusType
+#define E2E_STATUS_OK            0x00u
+#define E2E_STATUS_NONEWDATA     0x01u
+#define E2E_STATUS_ERROR         0x07u
+#define E2E_STATUS_REPEATED      0x08u
+#define E2E_STATUS_OKSOMELOST    0x20u
+#define E2E_STATUS_WRONGSEQUENCE 0x40u
+#define E2E_STATUS_UNKNOWN_ID    0xFFu
+
+// Outcome of a single frame check. Everything except E2E_RESULT_OK maps to E2E_STATUS_ERROR.
+typedef enum {
+    E2E_RESULT_OK = 0,
+    E2E_RESULT_BAD_FRAME,        // frame is too short for the configured length and offset
+    E2E_RESULT_LENGTH_MISMATCH,  // length field differs from the expected length
+    E2E_RESULT_DATA_ID_MISMATCH, // transmitted data_id differs from the configured one
+    E2E_RESULT_COUNTER_RANGE,    // counter value is not allowed by the profile
+    E2E_RESULT_CRC_MISMATCH,
+} e2e_result_t;
+
+// Receiver configuration of one message. The layout is fixed because it is
+// stored as is in the message table.
+typedef struct {
+    uint8_t  profile;      // 1, 2, 4, 5, 6 or 7
+    uint8_t  data_id_mode; // profile 1 only
+    uint16_t reserved;
+    uint32_t length; // 0 means: derive the length from the frame size
+    uint32_t data_id;
+    uint32_t offset;
+    uint32_t max_delta_counter;
+    uint8_t  data_id_list[P02DATAID_LIST_LEN]; // profile 2 only
+} e2e_config_t;
+
+E2E_API uint8_t      compute_p01_crc(const uint8_t *data_ptr,
+                                     uint16_t       length,
+                                     uint16_t       data_id,
+                                     uint16_t       data_id_mode,
+                                     uint8_t        counter,
+                                     uint16_t       crc_offset);
+E2E_API uint8_t      compute_p02_crc(const uint8_t *data_ptr,
+                                     uint32_t       length,
+                                     const uint8_t *data_id_list);
+E2E_API uint32_t     compute_p04_crc(const uint8_t *data_ptr, uint16_t length, uint16_t offset);
+E2E_API uint16_t     compute_p05_crc(const uint8_t *data_ptr,
+                                     uint16_t       length,
+                                     uint16_t       data_id,
+                                     uint16_t       offset);
+E2E_API uint16_t     compute_p06_crc(const uint8_t *data_ptr,
+                                     uint16_t       length,
+                                     uint16_t       data_id,
+                                     uint16_t       offset);
+E2E_API uint64_t     compute_p07_crc(const uint8_t *data_ptr, uint32_t length, uint32_t offset);
+
+// Raw buffer protect and check functions. The arguments must already be
+// validated against the buffer size like the Python wrappers do it.
+// The received counter is written to *counter if counter is not NULL.
+E2E_API void         e2e_p01_protect(uint8_t *data_ptr,
+                                     uint16_t length,
+                                     uint16_t data_id,
+                                     uint16_t data_id_mode,
+                                     bool     increment_counter);
+E2E_API e2e_result_t e2e_p01_check(const uint8_t *data_ptr,
+                                   uint16_t       length,
+                                   uint16_t       data_id,
+                                   uint16_t       data_id_mode,
+                                   uint32_t      *counter);
+
+E2E_API void         e2e_p02_protect(uint8_t       *data_ptr,
+                                     uint32_t       length,
+                                     const uint8_t *data_id_list,
+                                     bool           increment_counter);
+E2E_API e2e_result_t e2e_p02_check(const uint8_t *data_ptr,
+                                   uint32_t       length,
+                                   const uint8_t *data_id_list,
+                                   uint32_t      *counter);
+
+E2E_API void         e2e_p04_protect(uint8_t *data_ptr,
+                                     uint16_t length,
+                                     uint32_t data_id,
+                                     uint16_t offset,
+                                     bool     increment_counter);
+E2E_API e2e_result_t e2e_p04_check(const uint8_t *data_ptr,
+                                   uint16_t       length,
+                                   uint32_t       data_id,
+                                   uint16_t       offset,
+                                   uint32_t      *counter);
+
+E2E_API void         e2e_p05_protect(uint8_t *data_ptr,
+                                     uint16_t length,
+                                     uint16_t data_id,
+                                     uint16_t offset,
+                                     bool     increment_counter);
+E2E_API e2e_result_t e2e_p05_check(const uint8_t *data_ptr,
+                                   uint16_t       length,
+                                   uint16_t       data_id,
+                                   uint16_t       offset,
+                                   uint32_t      *counter);
+
+E2E_API void         e2e_p06_protect(uint8_t *data_ptr,
+                                     uint16_t length,
+                                     uint16_t data_id,
+                                     uint16_t offset,
+                                     bool     increment_counter);
+E2E_API e2e_result_t e2e_p06_check(const uint8_t *data_ptr,
+                                   uint16_t       length,
+                                   uint16_t       data_id,
+                                   uint16_t       offset,
+                                   uint32_t      *counter);
+
+E2E_API void         e2e_p07_protect(uint8_t *data_ptr,
+                                     uint32_t length,
+                                     uint32_t data_id,
+                                     uint32_t offset,
+                                     bool     increment_counter);
+E2E_API e2e_result_t e2e_p07_check(const uint8_t *data_ptr,
+                                   uint32_t       length,
+                                   uint32_t       data_id,
+                                   uint32_t       offset,
+                                   uint32_t      *counter);
+
+// Return NULL if the configuration is consistent, otherwise an error message.
+E2E_API const char  *e2e_config_error(const e2e_config_t *config);
+
+// Length which is passed to the profile function for a frame of data_len bytes,
+// or 0 if the frame does not fit the configuration.
+E2E_API uint32_t     e2e_config_frame_length(const e2e_config_t *config, size_t data_len);
+
+E2E_API e2e_result_t e2e_config_check(const e2e_config_t *config,
+                                      const uint8_t      *data_ptr,
+                                      size_t              data_len,
+                                      uint32_t           *counter);
+E2E_API e2e_result_t e2e_config_protect(const e2e_config_t *config,
+                                        uint8_t            *data_ptr,
+                                        size_t              data_len,
+                                        bool                increment_counter);
+
+// Read the transmitted CRC of a frame and compute the expected one, returns
+// false if the frame does not fit the configuration. Used for diagnostics only.
+E2E_API bool         e2e_config_crc(const e2e_config_t *config,
+                                    const uint8_t      *data_ptr,
+                                    size_t              data_len,
+                                    uint64_t           *received,
+                                    uint64_t           *computed);
+
+// Counter sequence evaluation
+E2E_API uint64_t     e2e_counter_modulus(uint8_t profile);
+E2E_API uint32_t     e2e_counter_delta(uint8_t profile, uint32_t last_counter, uint32_t counter);
+E2E_API uint8_t      e2e_sequence_status(uint32_t delta, uint32_t max_delta_counter);
+
+#endif
@@ -0,0 +1,301 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include "e2elib.h"
+#include "module.h"
+#include "recorder.h"
+
+typedef struct {
+    PyObject_HEAD
+    e2e_recorder_t recorder;
+} FlightRecorderObject;
+
+// Name of the reason of an error entry
+static const char *reason_name(uint8_t result)
+{
+    switch ((e2e_result_t)result) {
+        case E2E_RESULT_OK:
+            return "sequence";
+        case E2E_RESULT_BAD_FRAME:
+            return "bad_frame";
+        case E2E_RESULT_LENGTH_MISMATCH:
+            return "length_mismatch";
+        case E2E_RESULT_DATA_ID_MISMATCH:
+            return "data_id_mismatch";
+        case E2E_RESULT_COUNTER_RANGE:
+            return "counter_range";
+        case E2E_RESULT_CRC_MISMATCH:
+            return "crc_mismatch";
+    }
+    return "unknown";
+}
+
+// clang-format off
+PyDoc_STRVAR(recorder_doc,
+             "FlightRecorder(router: Router, *, depth: int = 4, capacity: int = 64, frame_size: int = 64)\n"
+             "Fixed memory recorder of failed checks for post-mortem analysis. \n"
+             "\n"
+             "Once created, the recorder sees every check of `router`, including the checks \n"
+             "of a :class:`Verifier`. It copies each accepted frame into a per message ring \n"
+             "of the last `depth` frames. When a check fails, i.e. the status is neither \n"
+             ":attr:`~e2e.E2E_STATUS_OK` nor :attr:`~e2e.E2E_STATUS_OKSOMELOST`, it stores \n"
+             "the frame, the reason, the counter, the transmitted and the expected CRC and \n"
+             "the ring of preceding good frames in a ring of the last `capacity` errors. \n"
+             "All memory is allocated on construction and recording does not take locks. \n"
+             "\n"
+             "A router has at most one recorder and keeps it alive. \n"
+             "\n"
+             ":param Router router: \n"
+             "    Router whose checks are recorded \n"
+             ":param int depth: \n"
+             "    Number of good frames which are kept per message as context, at most 256 \n"
+             ":param int capacity: \n"
+             "    Number of errors which are kept, older errors are overwritten \n"
+             ":param int frame_size: \n"
+             "    Number of bytes which are stored per frame, longer frames are truncated \n");
+// clang-format on
+static PyObject *recorder_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    PyObject     *router;
+    unsigned long depth      = 4;
+    unsigned long capacity   = 64;
+    unsigned long frame_size = 64;
+    static char  *kwlist[]   = {"router", "depth", "capacity", "frame_size", NULL};
+    module_state *state      = get_module_state_by_type(type);
+
+    if (state == NULL) {
+        return NULL;
+    }
+    if (!PyArg_ParseTupleAndKeywords(args,
+                                     kwargs,
+                                     "O|$kkk:FlightRecorder",
+                                     kwlist,
+                                     &router,
+                                     &depth,
+                                     &capacity,
+                                     &frame_size)) {
+        return NULL;
+    }
+    e2e_table_t *table = table_from_object(state, router);
+    if (table == NULL) {
+        return NULL;
+    }
+    if (depth > E2E_RECORDER_MAX_DEPTH) {
+        PyErr_SetString(PyExc_ValueError, "Parameter \"depth\" must not exceed 256.");
+        return NULL;
+    }
+    if (capacity == 0 || capacity > E2E_RECORDER_MAX_CAPACITY) {
+        PyErr_SetString(PyExc_ValueError, "Parameter \"capacity\" must be between 1 and 1048576.");
+        return NULL;
+    }
+    if (frame_size > E2E_RECORDER_MAX_FRAME_SIZE) {
+        PyErr_SetString(PyExc_ValueError, "Parameter \"frame_size\" must not exceed 65536.");
+        return NULL;
+    }
+
+    FlightRecorderObject *self = (FlightRecorderObject *)alloc_instance(type);
+    if (self == NULL) {
+        return NULL;
+    }
+    if (e2e_recorder_create(&self->recorder,
+                            table->header->count,
+                            (uint32_t)depth,
+                            (uint32_t)capacity,
+                            (uint32_t)frame_size) < 0) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    if (router_attach_recorder(router, (PyObject *)self, &self->recorder) < 0) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    return (PyObject *)self;
+}
+
+static void recorder_dealloc(PyObject *self)
+{
+    PyTypeObject *type = Py_TYPE(self);
+    e2e_recorder_destroy(&((FlightRecorderObject *)self)->recorder);
+    freefunc tp_free = (freefunc)PyType_GetSlot(type, Py_tp_free);
+    tp_free(self);
+    Py_DECREF(type);
+}
+
+// Convert a frame entry into (time, counter, data)
+static PyObject *frame_tuple(e2e_recorder_t *recorder, e2e_recorder_frame_t *frame)
+{
+    uint32_t length = (frame->length > recorder->frame_size) ? recorder->frame_size : frame->length;
+    return Py_BuildValue("(Kky#)",
+                         (unsigned long long)frame->time,
+                         (unsigned long)frame->counter,
+                         (const char *)e2e_recorder_frame_data(frame),
+                         (Py_ssize_t)length);
+}
+
+// Convert an error entry into a dict
+static PyObject *error_dict(e2e_recorder_t *recorder, e2e_recorder_error_t *error)
+{
+    PyObject *history = PyList_New(error->history);
+    if (history == NULL) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < error->history; ++i) {
+        PyObject *frame = frame_tuple(recorder, e2e_recorder_error_history(recorder, error, i));
+        if (frame == NULL) {
+            Py_DECREF(history);
+            return NULL;
+        }
+        PyList_SetItem(history, i, frame);
+    }
+
+    PyObject *received_crc;
+    PyObject *computed_crc;
+    if (error->result == E2E_RESULT_BAD_FRAME) {
+        Py_INCREF(Py_None);
+        Py_INCREF(Py_None);
+        received_crc = Py_None;
+        computed_crc = Py_None;
+    }
+    else {
+        received_crc = PyLong_FromUnsignedLongLong(error->received_crc);
+        computed_crc = PyLong_FromUnsignedLongLong(error->computed_crc);
+    }
+
+    uint32_t length = (error->length > recorder->frame_size) ? recorder->frame_size : error->length;
+    return Py_BuildValue("{s:K,s:k,s:K,s:k,s:s,s:k,s:k,s:N,s:N,s:y#,s:N}",
+                         "id",
+                         (unsigned long long)error->id,
+                         "index",
+                         (unsigned long)error->index,
+                         "time",
+                         (unsigned long long)error->time,
+                         "status",
+                         (unsigned long)error->status,
+                         "reason",
+                         reason_name(error->result),
+                         "counter",
+                         (unsigned long)error->counter,
+                         "length",
+                         (unsigned long)error->length,
+                         "received_crc",
+                         received_crc,
+                         "computed_crc",
+                         computed_crc,
+                         "frame",
+                         (const char *)e2e_recorder_error_data(error),
+                         (Py_ssize_t)length,
+                         "history",
+                         history);
+}
+
+// clang-format off
+PyDoc_STRVAR(recorder_dump_doc,
+             "dump() -> list[dict[str, Any]]\n"
+             "Return the recorded errors, oldest first. Errors can be dumped while frames \n"
+             "are checked; entries which are overwritten meanwhile are skipped. \n"
+             "\n"
+             ":return: \n"
+             "    One dict per error with the keys `id`, `index` (row in the router tables), \n"
+             "    `time`, `status` (``E2E_STATUS_*``), `reason` (one of ``\"bad_frame\"``, \n"
+             "    ``\"length_mismatch\"``, ``\"data_id_mismatch\"``, ``\"counter_range\"``, \n"
+             "    ``\"crc_mismatch\"`` or ``\"sequence\"`` for valid frames out of sequence), \n"
+             "    `counter`, `length` (of the received frame), `received_crc` and \n"
+             "    `computed_crc` (``None`` for ``\"bad_frame\"``), `frame` (the truncated frame \n"
+             "    data) and `history`, a list of (time, counter, data) tuples of the preceding \n"
+             "    good frames of the message. Times are the timestamps of the frames in a \n"
+             "    :class:`FrameRing` or nanoseconds of a monotonic clock for direct checks.");
+// clang-format on
+static PyObject *recorder_dump(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    e2e_recorder_t *recorder = &((FlightRecorderObject *)self)->recorder;
+    uint64_t        head     = e2e_recorder_error_count(recorder);
+    uint64_t        first    = (head > recorder->capacity) ? head - recorder->capacity : 0;
+
+    e2e_recorder_error_t *entry = PyMem_Malloc(recorder->error_slot_size);
+    if (entry == NULL) {
+        return PyErr_NoMemory();
+    }
+    PyObject *errors = PyList_New(0);
+    if (errors == NULL) {
+        PyMem_Free(entry);
+        return NULL;
+    }
+    for (uint64_t position = first; position < head; ++position) {
+        if (!e2e_recorder_read_error(recorder, position, entry)) {
+            continue;
+        }
+        PyObject *error = error_dict(recorder, entry);
+        if (error == NULL || PyList_Append(errors, error) < 0) {
+            Py_XDECREF(error);
+            Py_DECREF(errors);
+            PyMem_Free(entry);
+            return NULL;
+        }
+        Py_DECREF(error);
+    }
+    PyMem_Free(entry);
+    return errors;
+}
+
+static PyObject *recorder_get_errors(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLongLong(e2e_recorder_error_count(&((FlightRecorderObject *)self)->recorder));
+}
+
+static PyObject *recorder_get_depth(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((FlightRecorderObject *)self)->recorder.depth);
+}
+
+static PyObject *recorder_get_capacity(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((FlightRecorderObject *)self)->recorder.capacity);
+}
+
+static PyObject *recorder_get_frame_size(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((FlightRecorderObject *)self)->recorder.frame_size);
+}
+
+// clang-format off
+static PyMethodDef recorder_methods[] = {
+    {"dump", (PyCFunction)recorder_dump, METH_NOARGS, recorder_dump_doc},
+    {NULL} // sentinel
+};
+
+static PyGetSetDef recorder_getset[] = {
+    {"errors",     recorder_get_errors,     NULL, "Number of recorded errors, including overwritten ones", NULL},
+    {"depth",      recorder_get_depth,      NULL, "Number of context frames per message", NULL},
+    {"capacity",   recorder_get_capacity,   NULL, "Number of errors which are kept", NULL},
+    {"frame_size", recorder_get_frame_size, NULL, "Number of bytes which are stored per frame", NULL},
+    {NULL} // sentinel
+};
+
+static PyType_Slot recorder_slots[] = {
+    {Py_tp_doc,     (void *)recorder_doc},
+    {Py_tp_new,     recorder_new},
+    {Py_tp_dealloc, recorder_dealloc},
+    {Py_tp_methods, recorder_methods},
+    {Py_tp_getset,  recorder_getset},
+    {0, NULL}
+};
+// clang-format on
+
+static PyType_Spec recorder_spec = {.name      = "e2e.FlightRecorder",
+                                    .basicsize = sizeof(FlightRecorderObject),
+                                    .itemsize  = 0,
+                                    .flags     = Py_TPFLAGS_DEFAULT,
+                                    .slots     = recorder_slots};
+
+int recorder_init_type(PyObject *module, module_state *state)
+{
+    state->recorder_type = add_type(module, &recorder_spec);
+    return (state->recorder_type == NULL) ? -1 : 0;
+}
@@ -0,0 +1,271 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "module.h"
+#include "ring.h"
+
+typedef struct {
+    PyObject_HEAD
+    Py_buffer  view;
+    e2e_ring_t ring;
+} FrameRingObject;
+
+// clang-format off
+PyDoc_STRVAR(framering_doc,
+             "FrameRing(buffer: bytearray, frame_size: int)\n"
+             "Single producer, single consumer ring of frames inside a caller provided \n"
+             "writable buffer, e.g. a :class:`bytearray`, :class:`mmap.mmap` or shared memory. \n"
+             "Native producers like :meth:`Scheduler.tick` write into the ring, Python \n"
+             "drains it with :meth:`pop` or :meth:`drain`. In the other direction Python \n"
+             "feeds a native consumer like :class:`Verifier` with :meth:`push`. The ring \n"
+             "is reset on construction. \n"
+             "\n"
+             ":param buffer: \n"
+             "    Writable, C-contiguous buffer. The first 128 bytes hold the read and write \n"
+             "    positions, the rest is divided into slots of 24 bytes plus `frame_size`, \n"
+             "    rounded up to a multiple of 8. \n"
+             ":param int frame_size: \n"
+             "    Maximum frame length in bytes. \n");
+// clang-format on
+static PyObject *framering_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    PyObject     *buffer;
+    unsigned long frame_size;
+    static char  *kwlist[] = {"buffer", "frame_size", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "Ok:FrameRing", kwlist, &buffer, &frame_size)) {
+        return NULL;
+    }
+    if ((uint64_t)frame_size > E2E_RING_MAX_FRAME_SIZE) {
+        PyErr_SetString(PyExc_ValueError, "Parameter \"frame_size\" is too large.");
+        return NULL;
+    }
+
+    FrameRingObject *self = (FrameRingObject *)alloc_instance(type);
+    if (self == NULL) {
+        return NULL;
+    }
+    if (PyObject_GetBuffer(buffer, &self->view, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) < 0) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    if (e2e_ring_init(&self->ring, self->view.buf, (size_t)self->view.len, (uint32_t)frame_size) < 0) {
+        PyErr_SetString(PyExc_ValueError, "Buffer is too small or not 8 byte aligned.");
+        Py_DECREF(self);
+        return NULL;
+    }
+    return (PyObject *)self;
+}
+
+static void framering_dealloc(PyObject *self)
+{
+    PyTypeObject    *type = Py_TYPE(self);
+    FrameRingObject *ring = (FrameRingObject *)self;
+    if (ring->view.obj != NULL) {
+        PyBuffer_Release(&ring->view);
+    }
+    freefunc tp_free = (freefunc)PyType_GetSlot(type, Py_tp_free);
+    tp_free(self);
+    Py_DECREF(type);
+}
+
+e2e_ring_t *ring_from_object(module_state *state, PyObject *obj)
+{
+    if (!PyObject_TypeCheck(obj, state->framering_type)) {
+        PyErr_Format(PyExc_TypeError, "Expected an e2e.FrameRing instance, got %R.", Py_TYPE(obj));
+        return NULL;
+    }
+    return &((FrameRingObject *)obj)->ring;
+}
+
+// Remove the oldest frame and return it as (id, time, data) or (id, time, status, data)
+static PyObject *framering_take(e2e_ring_t *ring, bool with_status)
+{
+    e2e_ring_slot_t *slot = e2e_ring_peek(ring);
+    if (slot == NULL) {
+        Py_RETURN_NONE;
+    }
+    uint32_t  length = (slot->length > ring->frame_size) ? ring->frame_size : slot->length;
+    PyObject *frame;
+    if (with_status) {
+        frame = Py_BuildValue("(KKky#)",
+                              (unsigned long long)slot->id,
+                              (unsigned long long)slot->time,
+                              (unsigned long)slot->status,
+                              (const char *)e2e_ring_slot_data(slot),
+                              (Py_ssize_t)length);
+    }
+    else {
+        frame = Py_BuildValue("(KKy#)",
+                              (unsigned long long)slot->id,
+                              (unsigned long long)slot->time,
+                              (const char *)e2e_ring_slot_data(slot),
+                              (Py_ssize_t)length);
+    }
+    if (frame != NULL) {
+        e2e_ring_release(ring);
+    }
+    return frame;
+}
+
+// clang-format off
+PyDoc_STRVAR(framering_push_doc,
+             "push(id: int, time: int, data: bytes) -> bool\n"
+             "Append a frame to the ring. Only one thread may push at a time. \n"
+             "\n"
+             ":param int id: \n"
+             "    Message id \n"
+             ":param int time: \n"
+             "    Timestamp of the frame, e.g. the reception time \n"
+             ":param bytes data: \n"
+             "    Frame data, at most `frame_size` bytes \n"
+             ":return: \n"
+             "    ``False`` if the ring is full and the frame was not added.");
+// clang-format on
+static PyObject *framering_push(PyObject *self, PyObject *args)
+{
+    e2e_ring_t        *ring = &((FrameRingObject *)self)->ring;
+    unsigned long long id;
+    unsigned long long time;
+    Py_buffer          data;
+
+    if (!PyArg_ParseTuple(args, "KKy*:push", &id, &time, &data)) {
+        return NULL;
+    }
+    if ((uint64_t)data.len > ring->frame_size) {
+        PyErr_Format(PyExc_ValueError, "Frame is longer than frame_size (%lu).", (unsigned long)ring->frame_size);
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+
+    bool pushed = e2e_ring_push(ring, id, time, 0, (const uint8_t *)data.buf, (uint32_t)data.len);
+    PyBuffer_Release(&data);
+    return PyBool_FromLong(pushed);
+}
+
+// clang-format off
+PyDoc_STRVAR(framering_pop_doc,
+             "pop(*, status: bool = False) -> tuple[int, int, bytes] | tuple[int, int, int, bytes] | None\n"
+             "Remove the oldest frame from the ring. \n"
+             "\n"
+             ":param bool status: \n"
+             "    Include the ``E2E_STATUS_*`` code which a native consumer like \n"
+             "    :class:`Verifier` stored with the frame. \n"
+             ":return: \n"
+             "    A tuple of message id, time, optionally status, and frame data or ``None`` \n"
+             "    if the ring is empty.");
+// clang-format on
+static PyObject *framering_pop(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    int          with_status = 0;
+    static char *kwlist[]    = {"status", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|$p:pop", kwlist, &with_status)) {
+        return NULL;
+    }
+    return framering_take(&((FrameRingObject *)self)->ring, with_status);
+}
+
+// clang-format off
+PyDoc_STRVAR(framering_drain_doc,
+             "drain(limit: int = -1, *, status: bool = False) -> list[tuple]\n"
+             "Remove up to `limit` frames from the ring, all frames if `limit` is negative. \n"
+             "\n"
+             ":param bool status: \n"
+             "    Include the ``E2E_STATUS_*`` code of every frame, see :meth:`pop`. \n"
+             ":return: \n"
+             "    A list of (message id, time, frame data) or (message id, time, status, \n"
+             "    frame data) tuples, oldest first.");
+// clang-format on
+static PyObject *framering_drain(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    e2e_ring_t  *ring        = &((FrameRingObject *)self)->ring;
+    Py_ssize_t   limit       = -1;
+    int          with_status = 0;
+    static char *kwlist[]    = {"limit", "status", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|n$p:drain", kwlist, &limit, &with_status)) {
+        return NULL;
+    }
+    PyObject *frames = PyList_New(0);
+    if (frames == NULL) {
+        return NULL;
+    }
+    for (Py_ssize_t i = 0; limit < 0 || i < limit; ++i) {
+        PyObject *frame = framering_take(ring, with_status);
+        if (frame == NULL) {
+            Py_DECREF(frames);
+            return NULL;
+        }
+        if (frame == Py_None) {
+            Py_DECREF(frame);
+            break;
+        }
+        int error = PyList_Append(frames, frame);
+        Py_DECREF(frame);
+        if (error < 0) {
+            Py_DECREF(frames);
+            return NULL;
+        }
+    }
+    return frames;
+}
+
+static Py_ssize_t framering_length(PyObject *self)
+{
+    return (Py_ssize_t)e2e_ring_size(&((FrameRingObject *)self)->ring);
+}
+
+static PyObject *framering_get_capacity(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((FrameRingObject *)self)->ring.slot_count);
+}
+
+static PyObject *framering_get_frame_size(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((FrameRingObject *)self)->ring.frame_size);
+}
+
+// clang-format off
+static PyMethodDef framering_methods[] = {
+    {"push",  (PyCFunction)framering_push,  METH_VARARGS,                 framering_push_doc},
+    {"pop",   (PyCFunction)framering_pop,   METH_VARARGS | METH_KEYWORDS, framering_pop_doc},
+    {"drain", (PyCFunction)framering_drain, METH_VARARGS | METH_KEYWORDS, framering_drain_doc},
+    {NULL} // sentinel
+};
+
+static PyGetSetDef framering_getset[] = {
+    {"capacity",   framering_get_capacity,   NULL, "Number of slots", NULL},
+    {"frame_size", framering_get_frame_size, NULL, "Maximum frame length", NULL},
+    {NULL} // sentinel
+};
+
+static PyType_Slot framering_slots[] = {
+    {Py_tp_doc,     (void *)framering_doc},
+    {Py_tp_new,     framering_new},
+    {Py_tp_dealloc, framering_dealloc},
+    {Py_tp_methods, framering_methods},
+    {Py_tp_getset,  framering_getset},
+    {Py_sq_length,  framering_length},
+    {0, NULL}
+};
+// clang-format on
+
+static PyType_Spec framering_spec = {.name      = "e2e.FrameRing",
+                                     .basicsize = sizeof(FrameRingObject),
+                                     .itemsize  = 0,
+                                     .flags     = Py_TPFLAGS_DEFAULT,
+                                     .slots     = framering_slots};
+
+int framering_init_type(PyObject *module, module_state *state)
+{
+    state->framering_type = add_type(module, &framering_spec);
+    return (state->framering_type == NULL) ? -1 : 0;
+}
@@ -0,0 +1,280 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "e2elib.h"
+#include "module.h"
+
+// release() must not free the buffer while another thread checks a frame in it
+#ifdef Py_GIL_DISABLED
+#define FRAMEVIEW_LOCK(self)   Py_BEGIN_CRITICAL_SECTION(self)
+#define FRAMEVIEW_UNLOCK(self) Py_END_CRITICAL_SECTION()
+#else
+#define FRAMEVIEW_LOCK(self)
+#define FRAMEVIEW_UNLOCK(self)
+#endif
+
+typedef struct {
+    PyObject_HEAD
+    Py_buffer view; // view.obj is NULL after release()
+} FrameViewObject;
+
+// clang-format off
+PyDoc_STRVAR(frameview_doc,
+             "FrameView(buffer: bytes)\n"
+             "Pinned view of a buffer which holds many frames, e.g. a :class:`bytearray` or \n"
+             ":class:`mmap.mmap`. The buffer is acquired once, :meth:`protect` and :meth:`check` \n"
+             "address a frame by its byte offset and length inside the buffer, without slicing \n"
+             "and without acquiring the buffer again per frame. While the view exists the buffer \n"
+             "cannot be resized or closed, use :meth:`release` or a ``with`` statement. \n"
+             "\n"
+             ":param buffer: \n"
+             "    C-contiguous `bytes-like object <https://docs.python.org/3/glossary.html#term-bytes-like-object>`_. \n"
+             "    :meth:`protect` requires a writable buffer. \n");
+// clang-format on
+static PyObject *frameview_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    PyObject    *buffer;
+    static char *kwlist[] = {"buffer", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O:FrameView", kwlist, &buffer)) {
+        return NULL;
+    }
+
+    FrameViewObject *self = (FrameViewObject *)alloc_instance(type);
+    if (self == NULL) {
+        return NULL;
+    }
+    // without PyBUF_WRITABLE, so that read-only buffers can be checked; writable
+    // exporters still report readonly == 0
+    if (PyObject_GetBuffer(buffer, &self->view, PyBUF_C_CONTIGUOUS) < 0) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    return (PyObject *)self;
+}
+
+static void frameview_dealloc(PyObject *self)
+{
+    PyTypeObject    *type = Py_TYPE(self);
+    FrameViewObject *view = (FrameViewObject *)self;
+    if (view->view.obj != NULL) {
+        PyBuffer_Release(&view->view);
+    }
+    freefunc tp_free = (freefunc)PyType_GetSlot(type, Py_tp_free);
+    tp_free(self);
+    Py_DECREF(type);
+}
+
+// Return the frame at offset after checking that it lies inside the buffer,
+// otherwise set an exception and return NULL
+static uint8_t *frameview_frame(FrameViewObject *self, Py_ssize_t offset, Py_ssize_t length)
+{
+    if (self->view.obj == NULL) {
+        PyErr_SetString(PyExc_ValueError, "Operation on a released FrameView.");
+        return NULL;
+    }
+    if (offset < 0 || length < 0 || offset > self->view.len || length > self->view.len - offset) {
+        PyErr_Format(PyExc_IndexError,
+                     "Frame at offset %zd with length %zd exceeds the buffer of %zd bytes.",
+                     offset,
+                     length,
+                     self->view.len);
+        return NULL;
+    }
+    return (uint8_t *)self->view.buf + offset;
+}
+
+// clang-format off
+PyDoc_STRVAR(frameview_protect_doc,
+             "protect(offset: int, length: int, config: Config, *, increment_counter: bool = True) -> None\n"
+             "Calculate the CRC of a frame inside the buffer inplace, like the ``e2e_pXX_protect`` \n"
+             "function of the profile of `config`. \n"
+             "\n"
+             ":param int offset: \n"
+             "    Byte offset of the frame in the buffer \n"
+             ":param int length: \n"
+             "    Length of the frame in bytes \n"
+             ":param Config config: \n"
+             "    Profile, data id, header offset etc. of the message \n"
+             ":param bool increment_counter: \n"
+             "    If `True` the counter will be incremented before calculating the CRC. \n");
+// clang-format on
+static PyObject *frameview_protect(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    FrameViewObject *view = (FrameViewObject *)self;
+    Py_ssize_t       offset;
+    Py_ssize_t       length;
+    PyObject        *config_obj;
+    int              increment = true;
+    static char     *kwlist[]  = {"offset", "length", "config", "increment_counter", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args,
+                                     kwargs,
+                                     "nnO|$p:protect",
+                                     kwlist,
+                                     &offset,
+                                     &length,
+                                     &config_obj,
+                                     &increment)) {
+        return NULL;
+    }
+    const e2e_config_t *config = config_from_object(get_module_state_by_type(Py_TYPE(self)), config_obj);
+    if (config == NULL) {
+        return NULL;
+    }
+    PyObject *result = NULL;
+    FRAMEVIEW_LOCK(self);
+    uint8_t *frame = frameview_frame(view, offset, length);
+    if (frame != NULL && view->view.readonly) {
+        PyErr_SetString(PyExc_ValueError, "The buffer of the FrameView is read-only.");
+    }
+    else if (frame != NULL) {
+        if (e2e_config_protect(config, frame, (size_t)length, (bool)increment) == E2E_RESULT_OK) {
+            result = Py_None;
+            Py_INCREF(result);
+        }
+        else {
+            PyErr_Format(PyExc_ValueError, "Frame of length %zd does not fit its Config.", length);
+        }
+    }
+    FRAMEVIEW_UNLOCK(self);
+    return result;
+}
+
+// clang-format off
+PyDoc_STRVAR(frameview_check_doc,
+             "check(offset: int, length: int, config: Config) -> bool\n"
+             "Return ``True`` if the CRC of a frame inside the buffer is correct, like the \n"
+             "``e2e_pXX_check`` function of the profile of `config`. The counter is not \n"
+             "evaluated, use :class:`Router` for sequence checks. \n"
+             "\n"
+             ":param int offset: \n"
+             "    Byte offset of the frame in the buffer \n"
+             ":param int length: \n"
+             "    Length of the frame in bytes \n"
+             ":param Config config: \n"
+             "    Profile, data id, header offset etc. of the message \n"
+             ":return: \n"
+             "    `True` if the CRC is valid, `False` if it is not or if the frame does \n"
+             "    not fit `config`.");
+// clang-format on
+static PyObject *frameview_check(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    FrameViewObject *view = (FrameViewObject *)self;
+    Py_ssize_t       offset;
+    Py_ssize_t       length;
+    PyObject        *config_obj;
+    static char     *kwlist[] = {"offset", "length", "config", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "nnO:check", kwlist, &offset, &length, &config_obj)) {
+        return NULL;
+    }
+    const e2e_config_t *config = config_from_object(get_module_state_by_type(Py_TYPE(self)), config_obj);
+    if (config == NULL) {
+        return NULL;
+    }
+    PyObject *result = NULL;
+    FRAMEVIEW_LOCK(self);
+    const uint8_t *frame = frameview_frame(view, offset, length);
+    if (frame != NULL) {
+        result = PyBool_FromLong(e2e_config_check(config, frame, (size_t)length, NULL) == E2E_RESULT_OK);
+    }
+    FRAMEVIEW_UNLOCK(self);
+    return result;
+}
+
+// clang-format off
+PyDoc_STRVAR(frameview_release_doc,
+             "release() -> None\n"
+             "Release the buffer, so that it can be resized or closed again. Later calls \n"
+             "of :meth:`protect` and :meth:`check` raise :exc:`ValueError`.");
+// clang-format on
+static PyObject *frameview_release(PyObject *self, PyObject *unused)
+{
+    FrameViewObject *view = (FrameViewObject *)self;
+    FRAMEVIEW_LOCK(self);
+    if (view->view.obj != NULL) {
+        PyBuffer_Release(&view->view);
+        view->view.obj = NULL;
+    }
+    FRAMEVIEW_UNLOCK(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject *frameview_enter(PyObject *self, PyObject *unused)
+{
+    if (((FrameViewObject *)self)->view.obj == NULL) {
+        PyErr_SetString(PyExc_ValueError, "Operation on a released FrameView.");
+        return NULL;
+    }
+    Py_INCREF(self);
+    return self;
+}
+
+static PyObject *frameview_exit(PyObject *self, PyObject *args) { return frameview_release(self, NULL); }
+
+static Py_ssize_t frameview_length(PyObject *self)
+{
+    FrameViewObject *view = (FrameViewObject *)self;
+    if (view->view.obj == NULL) {
+        PyErr_SetString(PyExc_ValueError, "Operation on a released FrameView.");
+        return -1;
+    }
+    return view->view.len;
+}
+
+static PyObject *frameview_get_readonly(PyObject *self, void *closure)
+{
+    return PyBool_FromLong(((FrameViewObject *)self)->view.readonly);
+}
+
+static PyObject *frameview_get_released(PyObject *self, void *closure)
+{
+    return PyBool_FromLong(((FrameViewObject *)self)->view.obj == NULL);
+}
+
+// clang-format off
+static PyMethodDef frameview_methods[] = {
+    {"protect",   (PyCFunction)frameview_protect, METH_VARARGS | METH_KEYWORDS, frameview_protect_doc},
+    {"check",     (PyCFunction)frameview_check,   METH_VARARGS | METH_KEYWORDS, frameview_check_doc},
+    {"release",   (PyCFunction)frameview_release, METH_NOARGS,                  frameview_release_doc},
+    {"__enter__", (PyCFunction)frameview_enter,   METH_NOARGS,                  NULL},
+    {"__exit__",  (PyCFunction)frameview_exit,    METH_VARARGS,                 NULL},
+    {NULL} // sentinel
+};
+
+static PyGetSetDef frameview_getset[] = {
+    {"readonly", frameview_get_readonly, NULL, "True if the buffer is read-only", NULL},
+    {"released", frameview_get_released, NULL, "True after release()", NULL},
+    {NULL} // sentinel
+};
+
+static PyType_Slot frameview_slots[] = {
+    {Py_tp_doc,     (void *)frameview_doc},
+    {Py_tp_new,     frameview_new},
+    {Py_tp_dealloc, frameview_dealloc},
+    {Py_tp_methods, frameview_methods},
+    {Py_tp_getset,  frameview_getset},
+    {Py_sq_length,  frameview_length},
+    {0, NULL}
+};
+// clang-format on
+
+static PyType_Spec frameview_spec = {.name      = "e2e.FrameView",
+                                     .basicsize = sizeof(FrameViewObject),
+                                     .itemsize  = 0,
+                                     .flags     = Py_TPFLAGS_DEFAULT,
+                                     .slots     = frameview_slots};
+
+int frameview_init_type(PyObject *module, module_state *state)
+{
+    state->frameview_type = add_type(module, &frameview_spec);
+    return (state->frameview_type == NULL) ? -1 : 0;
+}
@@ -0,0 +1,151 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "crclib.h"
+#include "kernels.h"
+
+static double seconds(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+#endif
+}
+
+static int find_algorithm(const char *name, Crc_AlgorithmType *algorithm)
+{
+    for (int i = 0; i < CRC_ALGORITHM_COUNT; ++i) {
+        if (strcmp(name, Crc_AlgorithmName((Crc_AlgorithmType)i)) == 0) {
+            *algorithm = (Crc_AlgorithmType)i;
+            return 0;
+        }
+    }
+    PyErr_Format(PyExc_ValueError, "unknown CRC algorithm '%s'", name);
+    return -1;
+}
+
+static int find_kernel(const char *name, Crc_KernelType *kernel)
+{
+    for (int i = 0; i < CRC_KERNEL_COUNT; ++i) {
+        if (strcmp(name, Crc_KernelName((Crc_KernelType)i)) == 0) {
+            *kernel = (Crc_KernelType)i;
+            return 0;
+        }
+    }
+    PyErr_Format(PyExc_ValueError, "unknown CRC kernel '%s'", name);
+    return -1;
+}
+
+static PyObject *py_crc_thresholds(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *result = PyDict_New();
+    if (result == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < CRC_ALGORITHM_COUNT; ++i) {
+        PyObject *value = PyLong_FromUnsignedLong(Crc_GetThreshold((Crc_AlgorithmType)i));
+        if (value == NULL ||
+            PyDict_SetItemString(result, Crc_AlgorithmName((Crc_AlgorithmType)i), value) < 0) {
+            Py_XDECREF(value);
+            Py_DECREF(result);
+            return NULL;
+        }
+        Py_DECREF(value);
+    }
+    return result;
+}
+
+static PyObject *py_set_crc_threshold(PyObject *module, PyObject *args)
+{
+    const char       *name;
+    unsigned long     threshold;
+    Crc_AlgorithmType algorithm;
+
+    if (!PyArg_ParseTuple(args, "sk:_set_crc_threshold", &name, &threshold) ||
+        find_algorithm(name, &algorithm) < 0) {
+        return NULL;
+    }
+    if (threshold > CRC_THRESHOLD_NEVER) {
+        threshold = CRC_THRESHOLD_NEVER;
+    }
+    Crc_SetThreshold(algorithm, (uint32_t)threshold);
+    Py_RETURN_NONE;
+}
+
+// Seconds for number calls of one kernel on size bytes
+static PyObject *py_time_crc_kernel(PyObject *module, PyObject *args)
+{
+    const char       *algorithm_name;
+    const char       *kernel_name;
+    Py_ssize_t        size;
+    Py_ssize_t        number;
+    Crc_AlgorithmType algorithm;
+    Crc_KernelType    kernel;
+
+    if (!PyArg_ParseTuple(args,
+                          "ssnn:_time_crc_kernel",
+                          &algorithm_name,
+                          &kernel_name,
+                          &size,
+                          &number) ||
+        find_algorithm(algorithm_name, &algorithm) < 0 || find_kernel(kernel_name, &kernel) < 0) {
+        return NULL;
+    }
+    if (size < 0 || size > UINT32_MAX || number < 1) {
+        PyErr_SetString(PyExc_ValueError, "size must be in [0, 2**32) and number positive");
+        return NULL;
+    }
+    uint8_t *data = calloc((size_t)size + 1, 1);
+    if (data == NULL) {
+        return PyErr_NoMemory();
+    }
+
+    volatile uint64_t sink = 0;
+    double            elapsed;
+    Py_BEGIN_ALLOW_THREADS;
+    double start = seconds();
+    for (Py_ssize_t i = 0; i < number; ++i) {
+        sink ^= Crc_CalculateKernel(algorithm, kernel, data, (uint32_t)size, sink, true);
+    }
+    elapsed = seconds() - start;
+    Py_END_ALLOW_THREADS;
+
+    free(data);
+    return PyFloat_FromDouble(elapsed);
+}
+
+// clang-format off
+static struct PyMethodDef kernels_methods[] = {
+    {"_crc_thresholds",    (PyCFunction)py_crc_thresholds,    METH_NOARGS,  NULL},
+    {"_set_crc_threshold", (PyCFunction)py_set_crc_threshold, METH_VARARGS, NULL},
+    {"_time_crc_kernel",   (PyCFunction)py_time_crc_kernel,   METH_VARARGS, NULL},
+    {NULL} // sentinel
+};
+// clang-format on
+
+int e2e_kernels_add_functions(PyObject *module)
+{
+    Crc_Init();
+    return PyModule_AddFunctions(module, kernels_methods);
+}
@@ -0,0 +1,17 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+// CRC kernel selection from Python: _crc_thresholds(), _set_crc_threshold()
+// and _time_crc_kernel() of e2e._e2e, used by e2e._crctune.
+
+// Build the slicing tables of crclib and add the kernel functions to module
+int e2e_kernels_add_functions(PyObject *module);
+
+#endif
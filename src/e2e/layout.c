@@ -0,0 +1,556 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "crclib.h"
+#include "e2elib.h"
+#include "module.h"
+#include "plan.h"
+
+typedef struct {
+    PyObject_HEAD
+    e2e_layout_t layout;
+    e2e_plan_t   plan;
+} LayoutObject;
+
+static const char *const data_id_mode_names[E2E_LAYOUT_DATAID_COUNT] = {
+    "none",
+    "both",
+    "low",
+    "alternating",
+    "nibble",
+    "list",
+};
+
+// Parse None or a tuple (bit, width), returns -1 with an exception set on error
+static int parse_field(PyObject *obj, const char *name, e2e_layout_field_t *field)
+{
+    Py_ssize_t bit;
+    Py_ssize_t width;
+
+    if (obj == Py_None) {
+        *field = (e2e_layout_field_t){0};
+        return 0;
+    }
+    if (!PyTuple_Check(obj) || !PyArg_ParseTuple(obj, "nn", &bit, &width)) {
+        PyErr_Clear();
+        PyErr_Format(PyExc_TypeError, "Argument \"%s\" must be None or a tuple (bit, width).", name);
+        return -1;
+    }
+    if (bit < 0 || (uint64_t)bit > UINT32_MAX || width < 1 || width > 64) {
+        PyErr_Format(PyExc_ValueError, "Argument \"%s\" out of range.", name);
+        return -1;
+    }
+    field->bit   = (uint32_t)bit;
+    field->width = (uint8_t)width;
+    return 0;
+}
+
+// Parse an iterable of (start, stop) tuples, stop may be None
+static int parse_coverage(PyObject *obj, e2e_layout_t *layout)
+{
+    if (obj == Py_None) {
+        return 0; // the whole frame
+    }
+    PyObject *iterator = PyObject_GetIter(obj);
+    if (iterator == NULL) {
+        return -1;
+    }
+    PyObject *item;
+    layout->range_count = 0;
+    while ((item = PyIter_Next(iterator)) != NULL) {
+        long long start;
+        PyObject *stop;
+        int       ok = PyTuple_Check(item) && PyArg_ParseTuple(item, "LO", &start, &stop);
+        Py_DECREF(item);
+        if (!ok) {
+            PyErr_Clear();
+            PyErr_SetString(PyExc_TypeError,
+                            "Argument \"coverage\" must be an iterable of (start, stop) tuples.");
+            break;
+        }
+        if (layout->range_count == E2E_LAYOUT_MAX_RANGES) {
+            PyErr_SetString(PyExc_ValueError, "The CRC coverage must consist of 1 to 4 ranges.");
+            break;
+        }
+        e2e_layout_range_t *range = &layout->ranges[layout->range_count++];
+        range->start              = start;
+        range->stop               = E2E_LAYOUT_END;
+        if (stop != Py_None) {
+            range->stop = PyLong_AsLongLong(stop);
+            if (range->stop == -1 && PyErr_Occurred()) {
+                break;
+            }
+        }
+    }
+    Py_DECREF(iterator);
+    return PyErr_Occurred() ? -1 : 0;
+}
+
+// Parse None, which keeps the default of the algorithm, or an int
+static int parse_crc_value(PyObject *obj, uint64_t *value)
+{
+    if (obj == Py_None) {
+        return 0;
+    }
+    *value = PyLong_AsUnsignedLongLong(obj);
+    return (*value == (uint64_t)-1 && PyErr_Occurred()) ? -1 : 0;
+}
+
+// clang-format off
+PyDoc_STRVAR(layout_doc,
+             "Layout(algorithm: str, crc: int, *, counter: tuple[int, int] | None = None, data_id: tuple[int, int] | None = None, length: tuple[int, int] | None = None, byteorder: str = \"big\", counter_max: int | None = None, data_id_mode: str = \"none\", data_id_size: int = 2, data_id_shift: int = 0, data_id_position: str = \"append\", crc_initial: int | None = None, crc_xor: int | None = None, coverage: Iterable[tuple[int, int | None]] | None = None)\n"
+             "Declarative description of a custom E2E profile, e.g. a supplier variant of a \n"
+             "standard profile with shifted fields. The description is compiled once into a \n"
+             "native execution plan, :meth:`protect` and :meth:`check` run it without Python \n"
+             "code in between. The profiles 1 to 7 can be described as well, see the documentation. \n"
+             "\n"
+             "Header fields are ``(bit, width)`` tuples relative to the header offset, bit 0 \n"
+             "is the least significant bit of the first header byte. Fields of 8 bits and \n"
+             "more must be byte aligned, narrower fields must lie inside one byte. \n"
+             "\n"
+             ":param str algorithm: \n"
+             "    CRC algorithm, one of ``\"crc8\"``, ``\"crc8h2f\"``, ``\"crc16\"``, ``\"crc16arc\"``, \n"
+             "    ``\"crc32\"``, ``\"crc32p4\"`` or ``\"crc64\"``. \n"
+             ":param int crc: \n"
+             "    Bit position of the CRC field, its width is the width of the algorithm. \n"
+             ":param counter: \n"
+             "    Position and width of the counter field or `None`. \n"
+             ":param data_id: \n"
+             "    Position and width of a field which transmits ``data_id >> data_id_shift`` or `None`. \n"
+             ":param length: \n"
+             "    Position and width of a field which transmits the frame length or `None`. \n"
+             ":param str byteorder: \n"
+             "    ``\"big\"`` or ``\"little\"``, byte order of the fields and of the data_id bytes in the CRC. \n"
+             ":param int counter_max: \n"
+             "    Largest counter value, the counter wraps to 0 after it. Defaults to the \n"
+             "    largest value of the counter field. \n"
+             ":param str data_id_mode: \n"
+             "    How the data_id enters the CRC: ``\"none\"``, ``\"both\"`` (`data_id_size` bytes), \n"
+             "    ``\"low\"`` (low byte), ``\"alternating\"`` (low byte for even counters, high byte \n"
+             "    for odd ones), ``\"nibble\"`` (like ``\"both\"`` with only the low byte set) or \n"
+             "    ``\"list\"`` (``data_id[counter]`` of a data_id list like profile 2). \n"
+             ":param int data_id_size: \n"
+             "    Number of data_id bytes in the CRC for ``\"both\"`` and ``\"nibble\"``. \n"
+             ":param int data_id_shift: \n"
+             "    Right shift of the data_id before it is written to the data_id field. \n"
+             ":param str data_id_position: \n"
+             "    ``\"prepend\"`` or ``\"append\"`` the data_id bytes to the covered bytes. \n"
+             ":param int crc_initial: \n"
+             "    CRC register before the first byte, defaults to the initial value of the algorithm. \n"
+             ":param int crc_xor: \n"
+             "    Final XOR value, defaults to the XOR value of the algorithm. \n"
+             ":param coverage: \n"
+             "    Up to 4 byte ranges ``(start, stop)`` of the frame over which the CRC is \n"
+             "    calculated, in this order. Negative values count from the end of the frame, \n"
+             "    a `stop` of `None` is the end of the frame. The CRC field is always left out. \n"
+             "    Defaults to the whole frame. \n");
+// clang-format on
+static PyObject *layout_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    const char *algorithm;
+    Py_ssize_t  crc;
+    PyObject   *counter          = Py_None;
+    PyObject   *data_id          = Py_None;
+    PyObject   *length           = Py_None;
+    const char *byteorder        = "big";
+    PyObject   *counter_max      = Py_None;
+    const char *data_id_mode     = "none";
+    Py_ssize_t  data_id_size     = 2;
+    Py_ssize_t  data_id_shift    = 0;
+    const char *data_id_position = "append";
+    PyObject   *crc_initial      = Py_None;
+    PyObject   *crc_xor          = Py_None;
+    PyObject   *coverage         = Py_None;
+
+    static char *kwlist[]        = {"algorithm",
+                                    "crc",
+                                    "counter",
+                                    "data_id",
+                                    "length",
+                                    "byteorder",
+                                    "counter_max",
+                                    "data_id_mode",
+                                    "data_id_size",
+                                    "data_id_shift",
+                                    "data_id_position",
+                                    "crc_initial",
+                                    "crc_xor",
+                                    "coverage",
+                                    NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args,
+                                     kwargs,
+                                     "sn|$OOOsOsnnsOOO:Layout",
+                                     kwlist,
+                                     &algorithm,
+                                     &crc,
+                                     &counter,
+                                     &data_id,
+                                     &length,
+                                     &byteorder,
+                                     &counter_max,
+                                     &data_id_mode,
+                                     &data_id_size,
+                                     &data_id_shift,
+                                     &data_id_position,
+                                     &crc_initial,
+                                     &crc_xor,
+                                     &coverage)) {
+        return NULL;
+    }
+
+    Crc_AlgorithmType alg = CRC_ALGORITHM_COUNT;
+    for (int i = 0; i < CRC_ALGORITHM_COUNT; ++i) {
+        if (strcmp(algorithm, Crc_AlgorithmName((Crc_AlgorithmType)i)) == 0) {
+            alg = (Crc_AlgorithmType)i;
+        }
+    }
+    if (alg == CRC_ALGORITHM_COUNT) {
+        PyErr_Format(PyExc_ValueError, "Unknown CRC algorithm \"%s\".", algorithm);
+        return NULL;
+    }
+    e2e_layout_t layout;
+    e2e_layout_init(&layout, alg);
+    if (crc < 0 || (uint64_t)crc > UINT32_MAX) {
+        PyErr_SetString(PyExc_ValueError, "Argument \"crc\" out of range.");
+        return NULL;
+    }
+    layout.crc.bit = (uint32_t)crc;
+    if (parse_field(counter, "counter", &layout.counter) < 0 ||
+        parse_field(data_id, "data_id", &layout.data_id) < 0 ||
+        parse_field(length, "length", &layout.length) < 0) {
+        return NULL;
+    }
+
+    if (strcmp(byteorder, "big") == 0 || strcmp(byteorder, "little") == 0) {
+        layout.big_endian = byteorder[0] == 'b';
+    }
+    else {
+        PyErr_SetString(PyExc_ValueError, "Argument \"byteorder\" must be \"big\" or \"little\".");
+        return NULL;
+    }
+
+    if (counter_max == Py_None) {
+        uint8_t width      = layout.counter.width;
+        layout.counter_max = width == 0 ? 0 : width >= 32 ? UINT32_MAX : (UINT32_C(1) << width) - 1u;
+    }
+    else {
+        unsigned long value = PyLong_AsUnsignedLong(counter_max);
+        if (value == (unsigned long)-1 && PyErr_Occurred()) {
+            return NULL;
+        }
+        if (value > UINT32_MAX) {
+            PyErr_SetString(PyExc_ValueError, "Argument \"counter_max\" out of range.");
+            return NULL;
+        }
+        layout.counter_max = (uint32_t)value;
+    }
+
+    layout.data_id_mode = E2E_LAYOUT_DATAID_COUNT;
+    for (int i = 0; i < E2E_LAYOUT_DATAID_COUNT; ++i) {
+        if (strcmp(data_id_mode, data_id_mode_names[i]) == 0) {
+            layout.data_id_mode = (uint8_t)i;
+        }
+    }
+    if (data_id_size < 0 || data_id_size > UINT8_MAX || data_id_shift < 0 || data_id_shift > UINT8_MAX) {
+        PyErr_SetString(PyExc_ValueError, "Argument out of range.");
+        return NULL;
+    }
+    layout.data_id_size  = (uint8_t)data_id_size;
+    layout.data_id_shift = (uint8_t)data_id_shift;
+    if (strcmp(data_id_position, "prepend") == 0 || strcmp(data_id_position, "append") == 0) {
+        layout.data_id_append = data_id_position[0] == 'a';
+    }
+    else {
+        PyErr_SetString(PyExc_ValueError,
+                        "Argument \"data_id_position\" must be \"prepend\" or \"append\".");
+        return NULL;
+    }
+
+    if (parse_crc_value(crc_initial, &layout.crc_initial) < 0 || parse_crc_value(crc_xor, &layout.crc_xor) < 0 ||
+        parse_coverage(coverage, &layout) < 0) {
+        return NULL;
+    }
+
+    e2e_plan_t  plan;
+    const char *error = e2e_plan_compile(&plan, &layout);
+    if (error != NULL) {
+        PyErr_SetString(PyExc_ValueError, error);
+        return NULL;
+    }
+
+    LayoutObject *self = (LayoutObject *)alloc_instance(type);
+    if (self == NULL) {
+        return NULL;
+    }
+    self->layout = layout;
+    self->plan   = plan;
+    return (PyObject *)self;
+}
+
+static void layout_dealloc(PyObject *self)
+{
+    PyTypeObject *type    = Py_TYPE(self);
+    freefunc      tp_free = (freefunc)PyType_GetSlot(type, Py_tp_free);
+    tp_free(self);
+    Py_DECREF(type);
+}
+
+// Read the data_id argument: an int, or a buffer of counter_max + 1 bytes for
+// the "list" mode. list->obj is NULL unless a buffer was acquired.
+static int layout_data_id(LayoutObject *self, PyObject *obj, uint32_t *data_id, Py_buffer *list)
+{
+    list->obj = NULL;
+    list->buf = NULL;
+    *data_id  = 0;
+    if (self->layout.data_id_mode == E2E_LAYOUT_DATAID_LIST) {
+        if (PyObject_GetBuffer(obj, list, PyBUF_SIMPLE) < 0) {
+            return -1;
+        }
+        if (list->len != (Py_ssize_t)self->layout.counter_max + 1) {
+            PyErr_Format(PyExc_ValueError,
+                         "Argument \"data_id\" must be a data_id list of %zd bytes.",
+                         (Py_ssize_t)self->layout.counter_max + 1);
+            PyBuffer_Release(list);
+            list->obj = NULL;
+            return -1;
+        }
+        return 0;
+    }
+    unsigned long value = PyLong_AsUnsignedLong(obj);
+    if (value == (unsigned long)-1 && PyErr_Occurred()) {
+        return -1;
+    }
+    if (value > UINT32_MAX) {
+        PyErr_SetString(PyExc_ValueError, "Argument \"data_id\" must be a 32bit unsigned integer.");
+        return -1;
+    }
+    *data_id = (uint32_t)value;
+    return 0;
+}
+
+// Frame length for the length argument, -1 with ValueError if it is invalid
+static Py_ssize_t layout_frame_length(const Py_buffer *data, Py_ssize_t length, Py_ssize_t offset)
+{
+    if (length == 0) {
+        length = data->len;
+    }
+    if (length < 0 || length > data->len) {
+        PyErr_SetString(PyExc_ValueError, "Argument \"length\" must fulfill 0 <= length <= len(data).");
+        return -1;
+    }
+    if (offset < 0) {
+        PyErr_SetString(PyExc_ValueError, "Argument \"offset\" invalid.");
+        return -1;
+    }
+    return length;
+}
+
+// clang-format off
+PyDoc_STRVAR(layout_protect_doc,
+             "protect(data: bytearray, data_id: int | bytes, *, offset: int = 0, length: int = 0, increment_counter: bool = True) -> None\n"
+             "Write the length and data_id fields, increment the counter and calculate the CRC inplace. \n"
+             "\n"
+             ":param bytearray data: \n"
+             "    Mutable `bytes-like object <https://docs.python.org/3/glossary.html#term-bytes-like-object>`_.\n"
+             ":param data_id: \n"
+             "    A 32bit unsigned integer, or a data_id list of ``counter_max + 1`` bytes for \n"
+             "    the ``\"list\"`` data_id mode. \n"
+             ":param int offset: \n"
+             "    Byte offset of the E2E header. \n"
+             ":param int length: \n"
+             "    Frame length, the frame is ``data[:length]``. 0 stands for ``len(data)``. \n"
+             ":param bool increment_counter: \n"
+             "    If `True` the counter will be incremented before calculating the CRC. \n");
+// clang-format on
+static PyObject *layout_protect(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    LayoutObject *layout = (LayoutObject *)self;
+    Py_buffer     data;
+    PyObject     *data_id_obj;
+    Py_ssize_t    offset    = 0;
+    Py_ssize_t    length    = 0;
+    int           increment = true;
+
+    static char  *kwlist[]  = {"data", "data_id", "offset", "length", "increment_counter", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args,
+                                     kwargs,
+                                     "y*O|$nnp:protect",
+                                     kwlist,
+                                     &data,
+                                     &data_id_obj,
+                                     &offset,
+                                     &length,
+                                     &increment)) {
+        return NULL;
+    }
+    if (data.readonly) {
+        PyErr_SetString(PyExc_ValueError,
+                        "\"data\" must be mutable. Use a bytearray or any "
+                        "object that implements the buffer protocol.");
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+    uint32_t  data_id;
+    Py_buffer list;
+    length = layout_frame_length(&data, length, offset);
+    if (length < 0 || layout_data_id(layout, data_id_obj, &data_id, &list) < 0) {
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+
+    e2e_result_t result = e2e_plan_protect(&layout->plan,
+                                           (uint8_t *)data.buf,
+                                           (size_t)length,
+                                           (size_t)offset,
+                                           data_id,
+                                           (const uint8_t *)list.buf,
+                                           (bool)increment);
+    if (list.obj != NULL) {
+        PyBuffer_Release(&list);
+    }
+    PyBuffer_Release(&data);
+
+    if (result == E2E_RESULT_BAD_FRAME) {
+        PyErr_SetString(PyExc_ValueError, "The frame does not fit the layout.");
+        return NULL;
+    }
+    if (result == E2E_RESULT_COUNTER_RANGE) {
+        PyErr_SetString(PyExc_ValueError, "The counter exceeds \"counter_max\".");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// clang-format off
+PyDoc_STRVAR(layout_check_doc,
+             "check(data: bytes, data_id: int | bytes, *, offset: int = 0, length: int = 0) -> bool\n"
+             "Return ``True`` if the counter, length, data_id and CRC fields of the frame are valid. \n"
+             "\n"
+             ":param data: \n"
+             "    `bytes-like object <https://docs.python.org/3/glossary.html#term-bytes-like-object>`_. \n"
+             ":param data_id: \n"
+             "    A 32bit unsigned integer, or a data_id list of ``counter_max + 1`` bytes for \n"
+             "    the ``\"list\"`` data_id mode. \n"
+             ":param int offset: \n"
+             "    Byte offset of the E2E header. \n"
+             ":param int length: \n"
+             "    Frame length, the frame is ``data[:length]``. 0 stands for ``len(data)``. \n"
+             ":return:\n"
+             "    `True` if the frame is valid, otherwise return `False`");
+// clang-format on
+static PyObject *layout_check(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    LayoutObject *layout = (LayoutObject *)self;
+    Py_buffer     data;
+    PyObject     *data_id_obj;
+    Py_ssize_t    offset   = 0;
+    Py_ssize_t    length   = 0;
+
+    static char  *kwlist[] = {"data", "data_id", "offset", "length", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args,
+                                     kwargs,
+                                     "y*O|$nn:check",
+                                     kwlist,
+                                     &data,
+                                     &data_id_obj,
+                                     &offset,
+                                     &length)) {
+        return NULL;
+    }
+    uint32_t  data_id;
+    Py_buffer list;
+    length = layout_frame_length(&data, length, offset);
+    if (length < 0 || layout_data_id(layout, data_id_obj, &data_id, &list) < 0) {
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+
+    e2e_result_t result = e2e_plan_check(&layout->plan,
+                                         (const uint8_t *)data.buf,
+                                         (size_t)length,
+                                         (size_t)offset,
+                                         data_id,
+                                         (const uint8_t *)list.buf,
+                                         NULL);
+    if (list.obj != NULL) {
+        PyBuffer_Release(&list);
+    }
+    PyBuffer_Release(&data);
+
+    if (result == E2E_RESULT_BAD_FRAME) {
+        PyErr_SetString(PyExc_ValueError, "The frame does not fit the layout.");
+        return NULL;
+    }
+    if (result == E2E_RESULT_OK) {
+        Py_RETURN_TRUE;
+    }
+    Py_RETURN_FALSE;
+}
+
+static PyObject *layout_get_algorithm(PyObject *self, void *closure)
+{
+    return PyUnicode_FromString(Crc_AlgorithmName(((LayoutObject *)self)->layout.algorithm));
+}
+
+static PyObject *layout_get_header_length(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((LayoutObject *)self)->plan.header_len);
+}
+
+static PyObject *layout_get_counter_max(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((LayoutObject *)self)->layout.counter_max);
+}
+
+static PyObject *layout_get_data_id_mode(PyObject *self, void *closure)
+{
+    return PyUnicode_FromString(data_id_mode_names[((LayoutObject *)self)->layout.data_id_mode]);
+}
+
+// clang-format off
+static PyMethodDef layout_methods[] = {
+    {"protect", (PyCFunction)layout_protect, METH_VARARGS | METH_KEYWORDS, layout_protect_doc},
+    {"check",   (PyCFunction)layout_check,   METH_VARARGS | METH_KEYWORDS, layout_check_doc},
+    {NULL} // sentinel
+};
+
+static PyGetSetDef layout_getset[] = {
+    {"algorithm",     layout_get_algorithm,     NULL, "CRC algorithm", NULL},
+    {"header_length", layout_get_header_length, NULL, "Bytes from the header offset to the end of the last field", NULL},
+    {"counter_max",   layout_get_counter_max,   NULL, "Largest counter value", NULL},
+    {"data_id_mode",  layout_get_data_id_mode,  NULL, "How the data_id enters the CRC", NULL},
+    {NULL} // sentinel
+};
+
+static PyType_Slot layout_slots[] = {
+    {Py_tp_doc,     (void *)layout_doc},
+    {Py_tp_new,     layout_new},
+    {Py_tp_dealloc, layout_dealloc},
+    {Py_tp_methods, layout_methods},
+    {Py_tp_getset,  layout_getset},
+    {0, NULL}
+};
+// clang-format on
+
+static PyType_Spec layout_spec = {.name      = "e2e.Layout",
+                                  .basicsize = sizeof(LayoutObject),
+                                  .itemsize  = 0,
+                                  .flags     = Py_TPFLAGS_DEFAULT,
+                                  .slots     = layout_slots};
+
+int layout_init_type(PyObject *module, module_state *state)
+{
+    state->layout_type = add_type(module, &layout_spec);
+    return (state->layout_type == NULL) ? -1 : 0;
+}
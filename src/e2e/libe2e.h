@@ -0,0 +1,26 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef LIBE2E_H
+#define LIBE2E_H
+
+// Public header of libe2e, the standalone C library with the CRC kernels and
+// the profile functions of the e2e Python package:
+//
+//   #include <e2e/libe2e.h>
+//
+//   cc app.c $(pkg-config --cflags --libs e2e)
+//   target_link_libraries(app PRIVATE e2e::e2e)   # find_package(e2e)
+//
+// Call Crc_Init() once at startup, until then the CRC functions use the
+// byte-wise table kernels only. Everything else needs no initialization and
+// is thread-safe. The e2e_pXX_protect/check functions do not validate their
+// arguments, the e2e_config_* and e2e_plan_* functions check the frame length
+// themselves. plan.h describes custom profiles as data, see e2e_plan_compile().
+
+#include "crclib.h"
+#include "e2elib.h"
+#include "plan.h"
+
+#endif
@@ -0,0 +1,117 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef MODULE_H
+#define MODULE_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "e2elib.h"
+#include "recorder.h"
+#include "ring.h"
+#include "table.h"
+
+// State of the e2e._e2e module, holds the heap types
+typedef struct {
+    PyTypeObject *column_type;
+    PyTypeObject *config_type;
+    PyTypeObject *router_type;
+    PyTypeObject *monitor_type;
+    PyTypeObject *framering_type;
+    PyTypeObject *scheduler_type;
+    PyTypeObject *verifier_type;
+    PyTypeObject *recorder_type;
+    PyTypeObject *frameview_type;
+    PyTypeObject *layout_type;
+    PyTypeObject *signalcodec_type;
+} module_state;
+
+typedef struct {
+    PyObject_HEAD
+    e2e_config_t config;
+} ConfigObject;
+
+module_state *get_module_state(PyObject *module);
+module_state *get_module_state_by_type(PyTypeObject *type);
+
+// Create a heap type which is bound to module and add it to the module namespace
+PyTypeObject *add_type(PyObject *module, PyType_Spec *spec);
+
+// Allocate an instance of a type without calling tp_new
+PyObject     *alloc_instance(PyTypeObject *type);
+
+// Read-only 1-dimensional memoryview of a C array which keeps owner alive
+PyObject     *column_view(module_state *state,
+                          PyObject     *owner,
+                          const void   *buf,
+                          Py_ssize_t    count,
+                          Py_ssize_t    itemsize,
+                          const char   *format);
+
+// Read-only 2-dimensional memoryview of a C array with shape (rows, columns)
+PyObject     *column_matrix(module_state *state,
+                            PyObject     *owner,
+                            const void   *buf,
+                            Py_ssize_t    rows,
+                            Py_ssize_t    columns,
+                            Py_ssize_t    itemsize,
+                            const char   *format);
+
+int           column_init_type(PyObject *module, module_state *state);
+int           config_init_type(PyObject *module, module_state *state);
+int           router_init_type(PyObject *module, module_state *state);
+int           monitor_init_type(PyObject *module, module_state *state);
+int           framering_init_type(PyObject *module, module_state *state);
+int           scheduler_init_type(PyObject *module, module_state *state);
+int           verifier_init_type(PyObject *module, module_state *state);
+int           recorder_init_type(PyObject *module, module_state *state);
+int           frameview_init_type(PyObject *module, module_state *state);
+int           layout_init_type(PyObject *module, module_state *state);
+int           signalcodec_init_type(PyObject *module, module_state *state);
+int           batch_init_functions(PyObject *module, module_state *state);
+
+// Fill the namespaces of the submodules e2e.crc and e2e.pXX. Their Python
+// files call _e2e._init_submodule() on import, so they load lazily and all
+// share the kernels and tables of this extension.
+int           crc_init_submodule(PyObject *module);
+int           p01_init_submodule(PyObject *module);
+int           p02_init_submodule(PyObject *module);
+int           p04_init_submodule(PyObject *module);
+int           p05_init_submodule(PyObject *module);
+int           p06_init_submodule(PyObject *module);
+int           p07_init_submodule(PyObject *module);
+
+// Add the capsule e2e._C_API with the function table of e2e_capi.h
+int           e2e_capi_add_capsule(PyObject *module);
+
+// Return the configuration of a Config instance or set TypeError and return NULL
+const e2e_config_t *config_from_object(module_state *state, PyObject *obj);
+
+// Return the ring of a FrameRing instance or set TypeError and return NULL
+e2e_ring_t         *ring_from_object(module_state *state, PyObject *obj);
+
+// Return the table of a Router instance or set TypeError and return NULL
+e2e_table_t        *table_from_object(module_state *state, PyObject *obj);
+
+// Let router keep recorder_obj alive and record all checks with recorder,
+// set ValueError and return -1 if the router already has a recorder.
+int                 router_attach_recorder(PyObject *router, PyObject *recorder_obj, e2e_recorder_t *recorder);
+
+// Fill a new table from a mapping or an iterable of (id, Config) pairs. The
+// table is placed in block if it is not NULL, otherwise it is allocated.
+int                 table_from_configs(module_state *state,
+                                       e2e_table_t  *table,
+                                       PyObject     *configs,
+                                       Py_buffer    *block);
+
+// Read message ids from an integer buffer or from an iterable of int,
+// the result must be freed with PyMem_Free()
+uint64_t           *read_ids(PyObject *ids, Py_ssize_t *count);
+
+// Acquire the buffers of count frames, the result must be released with release_frames()
+Py_buffer          *acquire_frames(PyObject *frames, Py_ssize_t count);
+void                release_frames(Py_buffer *buffers, Py_ssize_t count);
+
+#endif
@@ -0,0 +1,547 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e2elib.h"
+#include "module.h"
+#include "table.h"
+#include "wheel.h"
+
+#define MONITOR_HISTOGRAM_BINS 32u
+
+#ifdef Py_GIL_DISABLED
+#define MONITOR_LOCK(self)   Py_BEGIN_CRITICAL_SECTION(self)
+#define MONITOR_UNLOCK(self) Py_END_CRITICAL_SECTION()
+#else
+#define MONITOR_LOCK(self)
+#define MONITOR_UNLOCK(self)
+#endif
+
+typedef struct {
+    PyObject_HEAD
+    uint32_t    count;
+    uint32_t    capacity;
+    uint64_t    resolution;
+    uint32_t   *slots; // hash index over ids
+    uint64_t   *ids;
+    uint64_t   *timeouts;
+    uint64_t   *cycle_times; // expected cycle time, 0 if unknown
+    int64_t    *last_seen;   // time of the last reception, -1 if nothing was received
+    uint8_t    *timed_out;
+    uint32_t   *cycle_histogram;
+    uint32_t   *jitter_histogram;
+    e2e_wheel_t wheel;
+} MonitorObject;
+
+// Bin 0 counts the value 0, bin k counts values in [2**(k-1), 2**k), the last bin
+// also counts all larger values.
+static uint32_t histogram_bin(uint64_t value)
+{
+    uint32_t bin = 0;
+    while (value != 0 && bin < MONITOR_HISTOGRAM_BINS - 1) {
+        value >>= 1;
+        bin++;
+    }
+    return (value == 0) ? bin : MONITOR_HISTOGRAM_BINS - 1;
+}
+
+static uint64_t monitor_deadline(const MonitorObject *self, uint32_t index, uint64_t now)
+{
+    // round up, a message must not time out before its timeout elapsed
+    uint64_t deadline = now + self->timeouts[index];
+    return deadline / self->resolution + (deadline % self->resolution != 0);
+}
+
+static void monitor_receive(MonitorObject *self, uint32_t index, uint64_t now)
+{
+    int64_t last_seen = self->last_seen[index];
+    if (last_seen >= 0) {
+        uint64_t cycle_time = (now > (uint64_t)last_seen) ? now - (uint64_t)last_seen : 0;
+        self->cycle_histogram[index * MONITOR_HISTOGRAM_BINS + histogram_bin(cycle_time)]++;
+        if (self->cycle_times[index] != 0) {
+            uint64_t expected = self->cycle_times[index];
+            uint64_t jitter   = (cycle_time > expected) ? cycle_time - expected : expected - cycle_time;
+            self->jitter_histogram[index * MONITOR_HISTOGRAM_BINS + histogram_bin(jitter)]++;
+        }
+    }
+    self->last_seen[index] = (int64_t)now;
+    self->timed_out[index] = 0;
+    e2e_wheel_arm(&self->wheel, index, monitor_deadline(self, index, now));
+}
+
+// Read a mapping or an iterable of (id, int) pairs into a list of tuples
+static PyObject *monitor_items(PyObject *obj)
+{
+    if (PyDict_Check(obj)) {
+        return PyDict_Items(obj);
+    }
+    if (PyMapping_Check(obj) && PyObject_HasAttrString(obj, "items")) {
+        return PyMapping_Items(obj);
+    }
+    return PySequence_List(obj);
+}
+
+static int monitor_load(MonitorObject *self, PyObject *timeouts, PyObject *cycle_times, uint64_t start)
+{
+    PyObject *items = monitor_items(timeouts);
+    if (items == NULL) {
+        return -1;
+    }
+
+    Py_ssize_t count = PyList_Size(items);
+    if (count > E2E_TABLE_MAX_COUNT) {
+        PyErr_SetString(PyExc_ValueError, "Too many messages.");
+        goto error;
+    }
+    self->count            = (uint32_t)count;
+    self->capacity         = e2e_hash_capacity(self->count);
+    self->slots            = PyMem_Calloc(self->capacity, sizeof(uint32_t));
+    self->ids              = PyMem_Calloc((size_t)count + 1, sizeof(uint64_t));
+    self->timeouts         = PyMem_Calloc((size_t)count + 1, sizeof(uint64_t));
+    self->cycle_times      = PyMem_Calloc((size_t)count + 1, sizeof(uint64_t));
+    self->last_seen        = PyMem_Calloc((size_t)count + 1, sizeof(int64_t));
+    self->timed_out        = PyMem_Calloc((size_t)count + 1, sizeof(uint8_t));
+    self->cycle_histogram  = PyMem_Calloc((size_t)count * MONITOR_HISTOGRAM_BINS + 1, sizeof(uint32_t));
+    self->jitter_histogram = PyMem_Calloc((size_t)count * MONITOR_HISTOGRAM_BINS + 1, sizeof(uint32_t));
+    if (self->slots == NULL || self->ids == NULL || self->timeouts == NULL || self->cycle_times == NULL ||
+        self->last_seen == NULL || self->timed_out == NULL || self->cycle_histogram == NULL ||
+        self->jitter_histogram == NULL || e2e_wheel_create(&self->wheel, self->count, 0) < 0) {
+        PyErr_NoMemory();
+        goto error;
+    }
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        PyObject          *pair = PySequence_Tuple(PyList_GetItem(items, i));
+        unsigned long long id;
+        unsigned long long timeout;
+
+        if (pair == NULL) {
+            goto error;
+        }
+        if (!PyArg_ParseTuple(pair, "KK:DeadlineMonitor", &id, &timeout)) {
+            Py_DECREF(pair);
+            goto error;
+        }
+        Py_DECREF(pair);
+        if (timeout == 0) {
+            PyErr_Format(PyExc_ValueError, "Timeout of message id %llu must be positive.", id);
+            goto error;
+        }
+        self->ids[i]       = id;
+        self->timeouts[i]  = timeout;
+        self->last_seen[i] = -1;
+        if (e2e_hash_insert(self->slots, self->capacity, self->ids, (uint32_t)i) < 0) {
+            PyErr_Format(PyExc_ValueError, "Duplicate message id %llu.", id);
+            goto error;
+        }
+    }
+    Py_DECREF(items);
+
+    if (cycle_times != Py_None) {
+        if ((items = monitor_items(cycle_times)) == NULL) {
+            return -1;
+        }
+        for (Py_ssize_t i = 0; i < PyList_Size(items); ++i) {
+            PyObject          *pair = PySequence_Tuple(PyList_GetItem(items, i));
+            unsigned long long id;
+            unsigned long long cycle_time;
+
+            if (pair == NULL) {
+                goto error;
+            }
+            if (!PyArg_ParseTuple(pair, "KK:DeadlineMonitor", &id, &cycle_time)) {
+                Py_DECREF(pair);
+                goto error;
+            }
+            Py_DECREF(pair);
+            int64_t index = e2e_hash_find(self->slots, self->capacity, self->ids, id);
+            if (index < 0) {
+                PyErr_Format(PyExc_ValueError, "Cycle time for unknown message id %llu.", id);
+                goto error;
+            }
+            self->cycle_times[index] = cycle_time;
+        }
+        Py_DECREF(items);
+    }
+
+    // every message has to arrive within its timeout after start
+    self->wheel.now = start / self->resolution;
+    for (uint32_t i = 0; i < self->count; ++i) {
+        e2e_wheel_arm(&self->wheel, i, monitor_deadline(self, i, start));
+    }
+    return 0;
+
+error:
+    Py_DECREF(items);
+    return -1;
+}
+
+// clang-format off
+PyDoc_STRVAR(monitor_doc,
+             "DeadlineMonitor(timeouts: Mapping[int, int], *, cycle_times: Mapping[int, int] | None = None, start: int = 0, resolution: int = 1)\n"
+             "Reception deadline monitor for many messages, used to detect messages \n"
+             "which stopped arriving (``E2E_STATUS_NONEWDATA``). \n"
+             "\n"
+             "The deadlines are kept in a hierarchical timing wheel, so re-arming a message \n"
+             "after a successful check is O(1) and :meth:`poll` does not scan all messages. \n"
+             "All times are integers in the same unit, e.g. milliseconds or the result \n"
+             "of :func:`time.monotonic_ns`. \n"
+             "\n"
+             "The monitor also collects a histogram of the cycle time of every message and, \n"
+             "if the expected cycle time is known, a histogram of the deviation from it. \n"
+             "Bin 0 counts the value 0 and bin k counts values in [2**(k-1), 2**k). \n"
+             "\n"
+             ":param timeouts: \n"
+             "    Mapping of message id to its reception timeout. \n"
+             ":param cycle_times: \n"
+             "    Mapping of message id to its expected cycle time. \n"
+             ":param int start: \n"
+             "    Start time, messages which are never received time out relative to it. \n"
+             ":param int resolution: \n"
+             "    Length of one timing wheel tick. Deadlines are rounded up to full ticks. \n");
+// clang-format on
+static PyObject *monitor_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    PyObject          *timeouts;
+    PyObject          *cycle_times = Py_None;
+    unsigned long long start       = 0;
+    unsigned long long resolution  = 1;
+    static char       *kwlist[]    = {"timeouts", "cycle_times", "start", "resolution", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args,
+                                     kwargs,
+                                     "O|$OKK:DeadlineMonitor",
+                                     kwlist,
+                                     &timeouts,
+                                     &cycle_times,
+                                     &start,
+                                     &resolution)) {
+        return NULL;
+    }
+    if (resolution == 0) {
+        PyErr_SetString(PyExc_ValueError, "Parameter \"resolution\" must be positive.");
+        return NULL;
+    }
+
+    MonitorObject *self = (MonitorObject *)alloc_instance(type);
+    if (self == NULL) {
+        return NULL;
+    }
+    self->resolution = resolution;
+    if (monitor_load(self, timeouts, cycle_times, start) < 0) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    return (PyObject *)self;
+}
+
+static void monitor_dealloc(PyObject *self)
+{
+    PyTypeObject  *type    = Py_TYPE(self);
+    MonitorObject *monitor = (MonitorObject *)self;
+    e2e_wheel_destroy(&monitor->wheel);
+    PyMem_Free(monitor->slots);
+    PyMem_Free(monitor->ids);
+    PyMem_Free(monitor->timeouts);
+    PyMem_Free(monitor->cycle_times);
+    PyMem_Free(monitor->last_seen);
+    PyMem_Free(monitor->timed_out);
+    PyMem_Free(monitor->cycle_histogram);
+    PyMem_Free(monitor->jitter_histogram);
+    freefunc tp_free = (freefunc)PyType_GetSlot(type, Py_tp_free);
+    tp_free(self);
+    Py_DECREF(type);
+}
+
+// clang-format off
+PyDoc_STRVAR(monitor_received_doc,
+             "received(id: int, now: int) -> None\n"
+             "Re-arm the deadline of message `id` after a frame passed the E2E check. \n"
+             "\n"
+             ":param int id: \n"
+             "    Message id \n"
+             ":param int now: \n"
+             "    Reception time \n"
+             ":raises KeyError: \n"
+             "    if `id` is not monitored");
+// clang-format on
+static PyObject *monitor_received(PyObject *self, PyObject *args)
+{
+    MonitorObject     *monitor = (MonitorObject *)self;
+    unsigned long long id;
+    unsigned long long now;
+
+    if (!PyArg_ParseTuple(args, "KK:received", &id, &now)) {
+        return NULL;
+    }
+    int64_t index = e2e_hash_find(monitor->slots, monitor->capacity, monitor->ids, id);
+    if (index < 0) {
+        PyObject *key = PyLong_FromUnsignedLongLong(id);
+        if (key != NULL) {
+            PyErr_SetObject(PyExc_KeyError, key);
+            Py_DECREF(key);
+        }
+        return NULL;
+    }
+
+    MONITOR_LOCK(self);
+    monitor_receive(monitor, (uint32_t)index, now);
+    MONITOR_UNLOCK(self);
+    Py_RETURN_NONE;
+}
+
+// clang-format off
+PyDoc_STRVAR(monitor_received_batch_doc,
+             "received_batch(ids: Sequence[int] | Buffer, times: Sequence[int] | Buffer, statuses: bytes | None = None) -> None\n"
+             "Re-arm the deadlines of many received frames, e.g. after :meth:`Router.check_batch`. \n"
+             "Unknown message ids are ignored. \n"
+             "\n"
+             ":param ids: \n"
+             "    Message id of each frame. \n"
+             ":param times: \n"
+             "    Reception time of each frame in ascending order. \n"
+             ":param statuses: \n"
+             "    Optional ``E2E_STATUS_*`` code of each frame. Only frames with status \n"
+             "    :attr:`~e2e.E2E_STATUS_OK` or :attr:`~e2e.E2E_STATUS_OKSOMELOST` re-arm \n"
+             "    their message.");
+// clang-format on
+static PyObject *monitor_received_batch(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    MonitorObject *monitor  = (MonitorObject *)self;
+    PyObject      *ids_obj;
+    PyObject      *times_obj;
+    PyObject      *statuses = Py_None;
+    uint64_t      *ids      = NULL;
+    uint64_t      *times    = NULL;
+    Py_buffer      view     = {0};
+    Py_ssize_t     count;
+    Py_ssize_t     times_count;
+    PyObject      *result   = NULL;
+    static char   *kwlist[] = {"ids", "times", "statuses", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args,
+                                     kwargs,
+                                     "OO|O:received_batch",
+                                     kwlist,
+                                     &ids_obj,
+                                     &times_obj,
+                                     &statuses)) {
+        return NULL;
+    }
+    if ((ids = read_ids(ids_obj, &count)) == NULL || (times = read_ids(times_obj, &times_count)) == NULL) {
+        goto exit;
+    }
+    if (times_count != count) {
+        PyErr_SetString(PyExc_ValueError, "Every frame needs exactly one reception time.");
+        goto exit;
+    }
+    if (statuses != Py_None) {
+        if (PyObject_GetBuffer(statuses, &view, PyBUF_SIMPLE) < 0) {
+            goto exit;
+        }
+        if (view.len != count) {
+            PyErr_SetString(PyExc_ValueError, "Every frame needs exactly one status.");
+            goto exit;
+        }
+    }
+
+    const uint8_t *status_ptr = (const uint8_t *)view.buf;
+    MONITOR_LOCK(self);
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        if (status_ptr != NULL && status_ptr[i] != E2E_STATUS_OK && status_ptr[i] != E2E_STATUS_OKSOMELOST) {
+            continue;
+        }
+        int64_t index = e2e_hash_find(monitor->slots, monitor->capacity, monitor->ids, ids[i]);
+        if (index >= 0) {
+            monitor_receive(monitor, (uint32_t)index, times[i]);
+        }
+    }
+    MONITOR_UNLOCK(self);
+    Py_INCREF(Py_None);
+    result = Py_None;
+
+exit:
+    if (view.obj != NULL) {
+        PyBuffer_Release(&view);
+    }
+    PyMem_Free(ids);
+    PyMem_Free(times);
+    return result;
+}
+
+typedef struct {
+    MonitorObject *monitor;
+    PyObject      *expired;
+    int            error;
+} poll_context_t;
+
+static void monitor_expire(void *context, uint32_t index)
+{
+    poll_context_t *poll = (poll_context_t *)context;
+
+    poll->monitor->timed_out[index] = 1;
+    if (poll->error) {
+        return;
+    }
+    PyObject *id = PyLong_FromUnsignedLongLong(poll->monitor->ids[index]);
+    if (id == NULL || PyList_Append(poll->expired, id) < 0) {
+        poll->error = 1;
+    }
+    Py_XDECREF(id);
+}
+
+// clang-format off
+PyDoc_STRVAR(monitor_poll_doc,
+             "poll(now: int) -> list[int]\n"
+             "Advance the monitor to time `now` and return the ids of all messages whose \n"
+             "deadline expired since the last call. An expired message is reported once \n"
+             "and armed again by its next reception. \n"
+             "\n"
+             ":param int now: \n"
+             "    Current time");
+// clang-format on
+static PyObject *monitor_poll(PyObject *self, PyObject *now_obj)
+{
+    MonitorObject     *monitor = (MonitorObject *)self;
+    unsigned long long now     = PyLong_AsUnsignedLongLong(now_obj);
+    if (now == (unsigned long long)-1 && PyErr_Occurred()) {
+        return NULL;
+    }
+
+    poll_context_t context = {monitor, PyList_New(0), 0};
+    if (context.expired == NULL) {
+        return NULL;
+    }
+    MONITOR_LOCK(self);
+    e2e_wheel_advance(&monitor->wheel, now / monitor->resolution, monitor_expire, &context);
+    MONITOR_UNLOCK(self);
+    if (context.error) {
+        Py_DECREF(context.expired);
+        return NULL;
+    }
+    return context.expired;
+}
+
+static Py_ssize_t monitor_length(PyObject *self) { return ((MonitorObject *)self)->count; }
+
+static int monitor_contains(PyObject *self, PyObject *id_obj)
+{
+    MonitorObject *monitor = (MonitorObject *)self;
+    if (!PyLong_Check(id_obj)) {
+        return 0;
+    }
+    unsigned long long id = PyLong_AsUnsignedLongLong(id_obj);
+    if (id == (unsigned long long)-1 && PyErr_Occurred()) {
+        if (!PyErr_ExceptionMatches(PyExc_OverflowError)) {
+            return -1;
+        }
+        PyErr_Clear();
+        return 0;
+    }
+    return e2e_hash_find(monitor->slots, monitor->capacity, monitor->ids, id) >= 0;
+}
+
+static PyObject *monitor_get_ids(PyObject *self, void *closure)
+{
+    MonitorObject *monitor = (MonitorObject *)self;
+    return column_view(get_module_state_by_type(Py_TYPE(self)),
+                       self,
+                       monitor->ids,
+                       monitor->count,
+                       sizeof(uint64_t),
+                       "Q");
+}
+
+static PyObject *monitor_get_last_seen(PyObject *self, void *closure)
+{
+    MonitorObject *monitor = (MonitorObject *)self;
+    return column_view(get_module_state_by_type(Py_TYPE(self)),
+                       self,
+                       monitor->last_seen,
+                       monitor->count,
+                       sizeof(int64_t),
+                       "q");
+}
+
+static PyObject *monitor_get_timed_out(PyObject *self, void *closure)
+{
+    MonitorObject *monitor = (MonitorObject *)self;
+    return column_view(get_module_state_by_type(Py_TYPE(self)),
+                       self,
+                       monitor->timed_out,
+                       monitor->count,
+                       sizeof(uint8_t),
+                       "B");
+}
+
+static PyObject *monitor_get_cycle_histogram(PyObject *self, void *closure)
+{
+    MonitorObject *monitor = (MonitorObject *)self;
+    return column_matrix(get_module_state_by_type(Py_TYPE(self)),
+                         self,
+                         monitor->cycle_histogram,
+                         monitor->count,
+                         MONITOR_HISTOGRAM_BINS,
+                         sizeof(uint32_t),
+                         "I");
+}
+
+static PyObject *monitor_get_jitter_histogram(PyObject *self, void *closure)
+{
+    MonitorObject *monitor = (MonitorObject *)self;
+    return column_matrix(get_module_state_by_type(Py_TYPE(self)),
+                         self,
+                         monitor->jitter_histogram,
+                         monitor->count,
+                         MONITOR_HISTOGRAM_BINS,
+                         sizeof(uint32_t),
+                         "I");
+}
+
+// clang-format off
+static PyMethodDef monitor_methods[] = {
+    {"received",       (PyCFunction)monitor_received,       METH_VARARGS,                 monitor_received_doc},
+    {"received_batch", (PyCFunction)monitor_received_batch, METH_VARARGS | METH_KEYWORDS, monitor_received_batch_doc},
+    {"poll",           (PyCFunction)monitor_poll,           METH_O,                       monitor_poll_doc},
+    {NULL} // sentinel
+};
+
+static PyGetSetDef monitor_getset[] = {
+    {"ids",              monitor_get_ids,              NULL, "Message id of each table row (read-only memoryview)", NULL},
+    {"last_seen",        monitor_get_last_seen,        NULL, "Time of the last reception, -1 if nothing was received (read-only memoryview)", NULL},
+    {"timed_out",        monitor_get_timed_out,        NULL, "1 if the message missed its deadline (read-only memoryview)", NULL},
+    {"cycle_histogram",  monitor_get_cycle_histogram,  NULL, "Cycle time histogram of each message (read-only memoryview)", NULL},
+    {"jitter_histogram", monitor_get_jitter_histogram, NULL, "Cycle time deviation histogram of each message (read-only memoryview)", NULL},
+    {NULL} // sentinel
+};
+
+static PyType_Slot monitor_slots[] = {
+    {Py_tp_doc,       (void *)monitor_doc},
+    {Py_tp_new,       monitor_new},
+    {Py_tp_dealloc,   monitor_dealloc},
+    {Py_tp_methods,   monitor_methods},
+    {Py_tp_getset,    monitor_getset},
+    {Py_sq_length,    monitor_length},
+    {Py_sq_contains,  monitor_contains},
+    {0, NULL}
+};
+// clang-format on
+
+static PyType_Spec monitor_spec = {.name      = "e2e.DeadlineMonitor",
+                                   .basicsize = sizeof(MonitorObject),
+                                   .itemsize  = 0,
+                                   .flags     = Py_TPFLAGS_DEFAULT,
+                                   .slots     = monitor_slots};
+
+int monitor_init_type(PyObject *module, module_state *state)
+{
+    state->monitor_type = add_type(module, &monitor_spec);
+    return (state->monitor_type == NULL) ? -1 : 0;
+}
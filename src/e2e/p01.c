@@ -8,65 +8,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#include "crclib.h"
-
-#define E2E_P01_DATAID_BOTH   0x0
-#define E2E_P01_DATAID_ALT    0x1
-#define E2E_P01_DATAID_LOW    0x2
-#define E2E_P01_DATAID_NIBBLE 0x3
-
-uint8_t compute_p01_crc(uint8_t *data_ptr,
-                        uint16_t length,
-                        uint16_t data_id,
-                        uint16_t data_id_mode,
-                        uint8_t  counter,
-                        uint16_t crc_offset)
-{
-    uint8_t data_id_lo_byte = (uint8_t)data_id;
-    uint8_t data_id_hi_byte = (uint8_t)(data_id >> 8);
-    uint8_t crc             = 0x00u;
-
-    switch (data_id_mode) {
-        case E2E_P01_DATAID_BOTH:
-            crc = Crc_CalculateCRC8(&data_id_lo_byte, 1u, CRC8_XOR_VALUE, false);
-            crc = Crc_CalculateCRC8(&data_id_hi_byte, 1u, crc, false);
-            break;
-
-        case E2E_P01_DATAID_LOW:
-            crc = Crc_CalculateCRC8(&data_id_lo_byte, 1u, CRC8_XOR_VALUE, false);
-            break;
-
-        case E2E_P01_DATAID_ALT:
-            if (counter % 2 == 0) {
-                crc = Crc_CalculateCRC8(&data_id_lo_byte, 1u, CRC8_XOR_VALUE, false);
-            }
-            else {
-                crc = Crc_CalculateCRC8(&data_id_hi_byte, 1u, CRC8_XOR_VALUE, false);
-            }
-            break;
-
-        case E2E_P01_DATAID_NIBBLE:
-            crc             = Crc_CalculateCRC8(&data_id_lo_byte, 1u, CRC8_XOR_VALUE, false);
-            data_id_hi_byte = 0;
-            crc             = Crc_CalculateCRC8(&data_id_hi_byte, 1u, crc, false);
-            break;
-    }
-
-    if (crc_offset >= 8) {
-        // compute crc over data before the crc byte
-        crc = Crc_CalculateCRC8(data_ptr, (crc_offset >> 3), crc, false);
-    }
-
-    if ((crc_offset >> 3) < length) {
-        // compute crc over area after crc byte
-        unsigned short start_byte = (crc_offset >> 3) + 1;
-        unsigned short byte_count = length - (crc_offset >> 3);
-        crc                       = Crc_CalculateCRC8(data_ptr + start_byte, byte_count, crc, false);
-    }
-
-    // write CRC to data
-    return crc ^ CRC8_XOR_VALUE;
-}
+#include "e2elib.h"
+#include "probes.h"
+#include "module.h"
+#include "stats.h"
 
 // clang-format off
 PyDoc_STRVAR(e2e_p01_protect_doc,
@@ -95,9 +40,6 @@ static PyObject *py_e2e_p01_protect(PyObject *module, PyObject *args, PyObject *
     unsigned short data_id;
     unsigned short data_id_mode          = E2E_P01_DATAID_BOTH;
     int            increment_counter     = true;
-    unsigned short crc_offset            = 0;
-    unsigned short counter_offset        = 8;
-    unsigned short data_id_nibble_offset = 12;
 
     static char   *kwlist[] = {"data", "length", "data_id", "data_id_mode", "increment_counter", NULL};
 
@@ -130,43 +72,11 @@ static PyObject *py_e2e_p01_protect(PyObject *module, PyObject *args, PyObject *
         goto error;
     }
 
-    uint8_t *data_ptr = (uint8_t *)data.buf;
-
-    // The counter goes either into low nibble or high nibble of data
-    uint8_t  counter  = 0;
-    if (counter_offset % 8 == 0) {
-        counter = (*(data_ptr + (counter_offset >> 3)) & 0x0F);
-        if (increment_counter) {
-            counter                             = (counter + 1) % 0x0F; // alive counter in range 0-14
-            *(data_ptr + (counter_offset >> 3)) = (*(data_ptr + (counter_offset >> 3)) & 0xF0) | counter;
-        }
-    }
-    else {
-        counter = (*(data_ptr + (counter_offset >> 3)) & 0xF0) >> 4;
-        if (increment_counter) {
-            counter = (counter + 1) % 0x0F; // alive counter in range 0-14
-            *(data_ptr + (counter_offset >> 3)) =
-                (*(data_ptr + (counter_offset >> 3)) & 0x0F) | ((counter << 4) & 0xF0);
-        }
-    }
-
-    if (data_id_mode == E2E_P01_DATAID_NIBBLE) {
-        // Write the low nibble of high byte of data_id
-        if (data_id_nibble_offset % 8 == 0) {
-            *(data_ptr + (data_id_nibble_offset >> 3)) =
-                (*(data_ptr + (data_id_nibble_offset >> 3)) & 0xF0) | ((data_id >> 8) & 0x0F);
-        }
-        else {
-            *(data_ptr + (data_id_nibble_offset >> 3)) =
-                (*(data_ptr + (data_id_nibble_offset >> 3)) & 0x0F) | ((data_id >> 4) & 0xF0);
-        }
-    }
-
-    // calculate CRC
-    uint8_t crc = compute_p01_crc(data_ptr, length, data_id, data_id_mode, counter, crc_offset);
-
-    // write CRC to data
-    *(data_ptr + (crc_offset / 8)) = crc;
+    E2E_PROBE2(p01_protect_entry, length, data_id);
+    uint64_t start = e2e_stats_start();
+    e2e_p01_protect((uint8_t *)data.buf, length, data_id, data_id_mode, (bool)increment_counter);
+    e2e_stats_stop(E2E_STAT_P01_PROTECT, start, (size_t)data.len, E2E_RESULT_OK);
+    E2E_PROBE3(p01_protect_return, length, data_id, 0);
 
     PyBuffer_Release(&data);
     Py_RETURN_NONE;
@@ -202,12 +112,9 @@ static PyObject *py_e2e_p01_check(PyObject *module, PyObject *args, PyObject *kw
     Py_buffer      data;
     unsigned short length;
     unsigned short data_id;
-    unsigned short data_id_mode          = E2E_P01_DATAID_BOTH;
-    unsigned short crc_offset            = 0;
-    unsigned short counter_offset        = 8;
-    unsigned short data_id_nibble_offset = 12;
+    unsigned short data_id_mode = E2E_P01_DATAID_BOTH;
 
-    static char   *kwlist[]              = {"data", "length", "data_id", "data_id_mode", NULL};
+    static char   *kwlist[]     = {"data", "length", "data_id", "data_id_mode", NULL};
 
     if (!PyArg_ParseTupleAndKeywords(args,
                                      kwargs,
@@ -237,36 +144,16 @@ static PyObject *py_e2e_p01_check(PyObject *module, PyObject *args, PyObject *kw
         goto error;
     }
 
-    uint8_t *data_ptr = (uint8_t *)data.buf;
+    E2E_PROBE2(p01_check_entry, length, data_id);
+    uint64_t     start  = e2e_stats_start();
+    e2e_result_t result = e2e_p01_check((uint8_t *)data.buf, length, data_id, data_id_mode, NULL);
+    e2e_stats_stop(E2E_STAT_P01_CHECK, start, (size_t)data.len, result);
+    E2E_PROBE3(p01_check_return, length, data_id, result);
 
-    // Check the alive counter value. The counter is located either in the low
-    // or the high nibble of data
-    uint8_t  counter  = 0u;
-    if (counter_offset % 8u == 0u) {
-        counter = (*(data_ptr + (counter_offset >> 3)) & 0x0F);
-    }
-    else {
-        counter = (*(data_ptr + (counter_offset >> 3)) & 0xF0) >> 4;
-    }
-    if (counter > 14u) {
-        // counter must be in 0-14
+    if (result != E2E_RESULT_OK) {
         goto return_false;
     }
 
-    // check the data_id nibble if it is sent excplicitely
-    if (data_id_mode == E2E_P01_DATAID_NIBBLE) {
-        uint8_t data_id_nibble = *(data_ptr + (data_id_nibble_offset >> 3)) >> 4;
-        if (data_id_nibble != ((uint8_t)(data_id >> 8) & 0x0F))
-            goto return_false;
-    }
-
-    // check CRC
-    uint8_t crc_in_data = *(data_ptr + (crc_offset / 8));
-    uint8_t calculated_crc =
-        compute_p01_crc(data_ptr, length, data_id, data_id_mode, counter, crc_offset);
-    if (crc_in_data != calculated_crc)
-        goto return_false;
-
     PyBuffer_Release(&data);
     Py_RETURN_TRUE;
 
@@ -300,8 +187,8 @@ static int _AddUnsignedIntConstant(PyObject *module, const char *name, uint64_t
 
 #define _AddUnsignedIntMacro(m, c) _AddUnsignedIntConstant(m, #c, c)
 
-// Module execution function for multi-phase initialization
-static int p01_exec(PyObject *module)
+// Fill the namespace of e2e.p01, called by e2e._e2e._init_submodule()
+int p01_init_submodule(PyObject *module)
 {
     // Add constants
     _AddUnsignedIntMacro(module, E2E_P01_DATAID_BOTH);
@@ -316,21 +203,3 @@ static int p01_exec(PyObject *module)
 
     return 0;
 }
-
-// Array of slot definitions for multi-phase initialization
-static PyModuleDef_Slot p01_slots[] = {{Py_mod_exec, (void *)p01_exec},
-#ifdef Py_GIL_DISABLED
-                                       {Py_mod_gil, Py_MOD_GIL_NOT_USED},
-#endif
-                                       {0, NULL}};
-
-// Module definition using multi-phase init
-static struct PyModuleDef p01_module = {PyModuleDef_HEAD_INIT,
-                                        .m_name    = "e2e.p01",
-                                        .m_doc     = "",
-                                        .m_size    = 0,
-                                        .m_methods = NULL,
-                                        .m_slots   = p01_slots};
-
-// Init function
-PyMODINIT_FUNC            PyInit_p01(void) { return PyModuleDef_Init(&p01_module); }
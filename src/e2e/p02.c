@@ -8,7 +8,14 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#include "crclib.h"
+#include "e2elib.h"
+#include "probes.h"
+#include "module.h"
+#include "stats.h"
+
+// data id of the list entry which is selected by the counter of the frame
+#define P02_DATA_ID(data, data_id_list)                                                                     \
+    (((const uint8_t *)(data_id_list).buf)[((const uint8_t *)(data).buf)[1] & 0x0Fu])
 
 // clang-format off
 PyDoc_STRVAR(e2e_p02_protect_doc,
@@ -68,20 +75,14 @@ static PyObject *py_e2e_p02_protect(PyObject *module, PyObject *args, PyObject *
         goto error;
     }
 
-    uint8_t *data_ptr    = (uint8_t *)data.buf;
-    uint8_t *data_id_ptr = (uint8_t *)data_id_list.buf;
-
-    // increment counter
-    uint8_t  counter     = data_ptr[1] & 0x0Fu;
-    if (increment) {
-        counter     = (counter + 1) % 16u;
-        data_ptr[1] = (data_ptr[1] & 0xF0u) | counter;
-    }
-
-    // calculate CRC
-    uint8_t crc = Crc_CalculateCRC8H2F(data_ptr + 1, (uint32_t)length, CRC8H2F_INITIAL_VALUE, true);
-    crc         = Crc_CalculateCRC8H2F(data_id_ptr + counter, 1u, crc, false);
-    data_ptr[0] = crc;
+    E2E_PROBE2(p02_protect_entry, length, P02_DATA_ID(data, data_id_list));
+    uint64_t start = e2e_stats_start();
+    e2e_p02_protect((uint8_t *)data.buf,
+                    (uint32_t)length,
+                    (uint8_t *)data_id_list.buf,
+                    (bool)increment);
+    e2e_stats_stop(E2E_STAT_P02_PROTECT, start, (size_t)data.len, E2E_RESULT_OK);
+    E2E_PROBE3(p02_protect_return, length, P02_DATA_ID(data, data_id_list), 0);
 
     PyBuffer_Release(&data);
     PyBuffer_Release(&data_id_list);
@@ -145,20 +146,17 @@ static PyObject *py_e2e_p02_check(PyObject *module, PyObject *args, PyObject *kw
         goto error;
     }
 
-    uint8_t *data_ptr    = (uint8_t *)data.buf;
-    uint8_t *data_id_ptr = (uint8_t *)data_id_list.buf;
-
-    // get counter
-    uint8_t  counter     = data_ptr[1] & 0x0Fu;
-
-    // calculate CRC
-    uint8_t  crc = Crc_CalculateCRC8H2F(data_ptr + 1, (uint32_t)length, CRC8H2F_INITIAL_VALUE, true);
-    crc          = Crc_CalculateCRC8H2F(data_id_ptr + counter, 1u, crc, false);
+    E2E_PROBE2(p02_check_entry, length, P02_DATA_ID(data, data_id_list));
+    uint64_t     start  = e2e_stats_start();
+    e2e_result_t result =
+        e2e_p02_check((uint8_t *)data.buf, (uint32_t)length, (uint8_t *)data_id_list.buf, NULL);
+    e2e_stats_stop(E2E_STAT_P02_CHECK, start, (size_t)data.len, result);
+    E2E_PROBE3(p02_check_return, length, P02_DATA_ID(data, data_id_list), result);
 
     PyBuffer_Release(&data);
     PyBuffer_Release(&data_id_list);
 
-    if (data_ptr[0] == crc) {
+    if (result == E2E_RESULT_OK) {
         Py_RETURN_TRUE;
     }
     else {
@@ -180,29 +178,11 @@ static struct PyMethodDef methods[] = {
 };
 // clang-format on
 
-// Module execution function for multi-phase initialization
-static int p02_exec(PyObject *module)
+// Fill the namespace of e2e.p02, called by e2e._e2e._init_submodule()
+int p02_init_submodule(PyObject *module)
 {
     if (PyModule_AddFunctions(module, methods) < 0) {
         return -1;
     }
     return 0;
 }
-
-// Array of slot definitions for multi-phase initialization
-static PyModuleDef_Slot p02_slots[] = {{Py_mod_exec, (void *)p02_exec},
-#ifdef Py_GIL_DISABLED
-                                       {Py_mod_gil, Py_MOD_GIL_NOT_USED},
-#endif
-                                       {0, NULL}};
-
-// Module definition
-static struct PyModuleDef p02_module = {PyModuleDef_HEAD_INIT,
-                                        .m_name    = "e2e.p02",
-                                        .m_doc     = "",
-                                        .m_size    = 0,
-                                        .m_methods = NULL,
-                                        .m_slots   = p02_slots};
-
-// Initialization function
-PyMODINIT_FUNC            PyInit_p02(void) { return PyModuleDef_Init(&p02_module); }
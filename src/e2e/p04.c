@@ -8,37 +8,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#include "crclib.h"
-#include "util.h"
-
-#define P04LENGTH_POS    0u
-#define P04LENGTH_LEN    2u
-#define P04COUNTER_POS   2u
-#define P04COUNTER_LEN   2u
-#define P04DATAID_POS    4u
-#define P04DATAID_LEN    4u
-#define P04CRC_POS       8u
-#define P04CRC_LEN       4u
-#define P04CALCULATE_CRC Crc_CalculateCRC32P4
-
-#define P04HEADER_LEN    (P04LENGTH_LEN + P04COUNTER_LEN + P04DATAID_LEN + P04CRC_LEN)
-
-uint32_t compute_p04_crc(uint8_t *data_ptr, uint16_t length, uint16_t offset)
-{
-    uint32_t crc;
-
-    // bytes before crc bytes
-    uint32_t crc_offset = (uint32_t)(offset + P04CRC_POS);
-    crc                 = P04CALCULATE_CRC(data_ptr, crc_offset, CRC32P4_INITIAL_VALUE, true);
-
-    // bytes after crc bytes, if any
-    if (offset + P04HEADER_LEN < length) {
-        uint8_t *second_part_ptr    = data_ptr + offset + P04HEADER_LEN;
-        uint32_t second_part_length = length - offset - P04HEADER_LEN;
-        crc                         = P04CALCULATE_CRC(second_part_ptr, second_part_length, crc, false);
-    }
-    return crc;
-}
+#include "e2elib.h"
+#include "probes.h"
+#include "module.h"
+#include "stats.h"
 
 // clang-format off
 PyDoc_STRVAR(e2e_p04_protect_doc,
@@ -101,24 +74,11 @@ static PyObject *py_e2e_p04_protect(PyObject *module, PyObject *args, PyObject *
         goto error;
     }
 
-    uint8_t *data_ptr = (uint8_t *)data.buf;
-
-    // write length
-    uint16_to_bigendian(data_ptr + offset + P04LENGTH_POS, length);
-
-    // increment counter
-    if (increment) {
-        uint16_t counter = bigendian_to_uint16(data_ptr + offset + P04COUNTER_POS);
-        counter++;
-        uint16_to_bigendian(data_ptr + offset + P04COUNTER_POS, counter);
-    }
-
-    // write data_id
-    uint32_to_bigendian(data_ptr + offset + P04DATAID_POS, data_id);
-
-    // calculate CRC
-    uint32_t crc = compute_p04_crc(data_ptr, length, offset);
-    uint32_to_bigendian(data_ptr + offset + P04CRC_POS, crc);
+    E2E_PROBE2(p04_protect_entry, length, data_id);
+    uint64_t start = e2e_stats_start();
+    e2e_p04_protect((uint8_t *)data.buf, length, (uint32_t)data_id, offset, (bool)increment);
+    e2e_stats_stop(E2E_STAT_P04_PROTECT, start, (size_t)data.len, E2E_RESULT_OK);
+    E2E_PROBE3(p04_protect_return, length, data_id, 0);
 
     PyBuffer_Release(&data);
 
@@ -183,23 +143,15 @@ static PyObject *py_e2e_p04_check(PyObject *module, PyObject *args, PyObject *kw
         goto error;
     }
 
-    uint8_t *data_ptr       = (uint8_t *)data.buf;
-
-    // read length
-    uint16_t length_actual  = bigendian_to_uint16(data_ptr + offset + P04LENGTH_POS);
-
-    // read data_id
-    uint32_t data_id_actual = bigendian_to_uint32(data_ptr + offset + P04DATAID_POS);
-
-    // read crc
-    uint32_t crc_actual     = bigendian_to_uint32(data_ptr + offset + P04CRC_POS);
-
-    // calculate CRC
-    uint32_t crc            = compute_p04_crc(data_ptr, length, offset);
+    E2E_PROBE2(p04_check_entry, length, data_id);
+    uint64_t     start  = e2e_stats_start();
+    e2e_result_t result = e2e_p04_check((uint8_t *)data.buf, length, (uint32_t)data_id, offset, NULL);
+    e2e_stats_stop(E2E_STAT_P04_CHECK, start, (size_t)data.len, result);
+    E2E_PROBE3(p04_check_return, length, data_id, result);
 
     PyBuffer_Release(&data);
 
-    if ((length_actual == length) && (data_id_actual == data_id) && (crc_actual == crc)) {
+    if (result == E2E_RESULT_OK) {
         Py_RETURN_TRUE;
     }
     else {
@@ -220,29 +172,11 @@ static struct PyMethodDef methods[] = {
 };
 // clang-format on
 
-// Module execution function for multi-phase initialization
-static int p04_exec(PyObject *module)
+// Fill the namespace of e2e.p04, called by e2e._e2e._init_submodule()
+int p04_init_submodule(PyObject *module)
 {
     if (PyModule_AddFunctions(module, methods) < 0) {
         return -1;
     }
     return 0;
 }
-
-// Array of slot definitions for multi-phase initialization
-static PyModuleDef_Slot p04_slots[] = {{Py_mod_exec, (void *)p04_exec},
-#ifdef Py_GIL_DISABLED
-                                       {Py_mod_gil, Py_MOD_GIL_NOT_USED},
-#endif
-                                       {0, NULL}};
-
-// Module definition using slots
-static struct PyModuleDef p04_module = {PyModuleDef_HEAD_INIT,
-                                        .m_name    = "e2e.p04",
-                                        .m_doc     = "",
-                                        .m_size    = 0, // 0 for no state, change if using module state
-                                        .m_methods = NULL, // Set in exec
-                                        .m_slots   = p04_slots};
-
-// Init function
-PyMODINIT_FUNC            PyInit_p04(void) { return PyModuleDef_Init(&p04_module); }
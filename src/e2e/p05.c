@@ -8,38 +8,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#include "crclib.h"
-#include "util.h"
-
-#define P05LENGTH_POS    0u
-#define P05LENGTH_LEN    0u
-#define P05COUNTER_POS   2u
-#define P05COUNTER_LEN   1u
-#define P05DATAID_POS    0u
-#define P05DATAID_LEN    0u
-#define P05CRC_POS       0u
-#define P05CRC_LEN       2u
-#define P05CALCULATE_CRC Crc_CalculateCRC16
-
-#define P05HEADER_LEN    (P05CRC_LEN + P05COUNTER_LEN)
-
-uint16_t compute_p05_crc(uint8_t *data_ptr, uint16_t length, uint16_t data_id, uint16_t offset)
-{
-    uint16_t crc;
-    uint8_t  data_id_lo_byte = (uint8_t)data_id;
-    uint8_t  data_id_hi_byte = (uint8_t)(data_id >> 8);
-    if (offset > 0) {
-        crc = P05CALCULATE_CRC(data_ptr, offset, CRC16_INITIAL_VALUE, true);
-        crc = P05CALCULATE_CRC(&data_ptr[offset + P05COUNTER_POS], length - offset, crc, false);
-    }
-    else {
-        crc = P05CALCULATE_CRC(&data_ptr[P05COUNTER_POS], length, CRC16_INITIAL_VALUE, true);
-    }
-    crc = P05CALCULATE_CRC(&data_id_lo_byte, 1, crc, false);
-    crc = P05CALCULATE_CRC(&data_id_hi_byte, 1, crc, false);
-
-    return crc;
-}
+#include "e2elib.h"
+#include "probes.h"
+#include "module.h"
+#include "stats.h"
 
 // clang-format off
 PyDoc_STRVAR(e2e_p05_protect_doc,
@@ -95,20 +67,16 @@ static PyObject *py_e2e_p05_protect(PyObject *module, PyObject *args, PyObject *
                         "condition: 1 <= length <= len(data) - 2.");
         goto error;
     }
-    if (offset > data.len - P05HEADER_LEN) {
+    if (offset > data.len - P05HEADER_LEN || offset + P05COUNTER_LEN > length) {
         PyErr_SetString(PyExc_ValueError, "Argument \"offset\" invalid.");
         goto error;
     }
 
-    uint8_t *data_ptr = (uint8_t *)data.buf;
-
-    // increment counter
-    if (increment) {
-        data_ptr[offset + P05COUNTER_POS]++;
-    }
-    // calculate CRC
-    uint16_t crc = compute_p05_crc(data_ptr, length, data_id, offset);
-    uint16_to_littleendian(data_ptr + offset + P05CRC_POS, crc);
+    E2E_PROBE2(p05_protect_entry, length, data_id);
+    uint64_t start = e2e_stats_start();
+    e2e_p05_protect((uint8_t *)data.buf, length, data_id, offset, (bool)increment);
+    e2e_stats_stop(E2E_STAT_P05_PROTECT, start, (size_t)data.len, E2E_RESULT_OK);
+    E2E_PROBE3(p05_protect_return, length, data_id, 0);
 
     PyBuffer_Release(&data);
 
@@ -166,20 +134,20 @@ static PyObject *py_e2e_p05_check(PyObject *module, PyObject *args, PyObject *kw
                         "condition: 1 <= length <= len(data) - 2.");
         goto error;
     }
-    if (offset > data.len - P05HEADER_LEN) {
+    if (offset > data.len - P05HEADER_LEN || offset + P05COUNTER_LEN > length) {
         PyErr_SetString(PyExc_ValueError, "Argument \"offset\" invalid.");
         goto error;
     }
 
-    uint8_t *data_ptr   = (uint8_t *)data.buf;
-
-    // calculate CRC
-    uint16_t crc        = compute_p05_crc(data_ptr, length, data_id, offset);
-    uint16_t crc_actual = littleendian_to_uint16(data_ptr + offset + P05CRC_POS);
+    E2E_PROBE2(p05_check_entry, length, data_id);
+    uint64_t     start  = e2e_stats_start();
+    e2e_result_t result = e2e_p05_check((uint8_t *)data.buf, length, data_id, offset, NULL);
+    e2e_stats_stop(E2E_STAT_P05_CHECK, start, (size_t)data.len, result);
+    E2E_PROBE3(p05_check_return, length, data_id, result);
 
     PyBuffer_Release(&data);
 
-    if (crc == crc_actual) {
+    if (result == E2E_RESULT_OK) {
         Py_RETURN_TRUE;
     }
     else {
@@ -200,29 +168,11 @@ static struct PyMethodDef methods[] = {
 };
 // clang-format on
 
-// Module execution function for multi-phase initialization
-static int p05_exec(PyObject *module)
+// Fill the namespace of e2e.p05, called by e2e._e2e._init_submodule()
+int p05_init_submodule(PyObject *module)
 {
     if (PyModule_AddFunctions(module, methods) < 0) {
         return -1;
     }
     return 0;
 }
-
-// Array of slot definitions for multi-phase initialization
-static PyModuleDef_Slot p05_slots[] = {{Py_mod_exec, (void *)p05_exec},
-#ifdef Py_GIL_DISABLED
-                                       {Py_mod_gil, Py_MOD_GIL_NOT_USED},
-#endif
-                                       {0, NULL}};
-
-// Module definition
-static struct PyModuleDef p05_module = {PyModuleDef_HEAD_INIT,
-                                        .m_name    = "e2e.p05",
-                                        .m_doc     = "",
-                                        .m_size    = 0,
-                                        .m_methods = NULL,
-                                        .m_slots   = p05_slots};
-
-// Module initialization function
-PyMODINIT_FUNC            PyInit_p05(void) { return PyModuleDef_Init(&p05_module); }
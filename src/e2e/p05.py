@@ -0,0 +1,8 @@
+"""E2E profile 5, the functions are implemented in e2e._e2e or e2e._cffi."""
+
+import sys as _sys
+
+from e2e._backend import init_submodule as _init_submodule
+
+_init_submodule(_sys.modules[__name__])
+del _sys, _init_submodule
@@ -5,44 +5,10 @@
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
 
-#include "crclib.h"
-#include "util.h"
-
-#define P06LENGTH_POS    2u
-#define P06LENGTH_LEN    2u
-#define P06COUNTER_POS   4u
-#define P06COUNTER_LEN   1u
-#define P06DATAID_POS    0u
-#define P06DATAID_LEN    0u
-#define P06CRC_POS       0u
-#define P06CRC_LEN       2u
-#define P06CALCULATE_CRC Crc_CalculateCRC16
-
-#define P06HEADER_LEN    (P06CRC_LEN + P06LENGTH_LEN + P06COUNTER_LEN)
-
-uint16_t compute_p06_crc(uint8_t *data_ptr, uint16_t length, uint16_t data_id, uint16_t offset)
-{
-    uint16_t crc;
-    uint8_t  data_id_lo_byte = (uint8_t)data_id;
-    uint8_t  data_id_hi_byte = (uint8_t)(data_id >> 8);
-    if (offset > 0) {
-        crc = P06CALCULATE_CRC(data_ptr, offset, CRC16_INITIAL_VALUE, true);
-        crc = P06CALCULATE_CRC(&data_ptr[offset + P06LENGTH_POS],
-                               length - offset - P06LENGTH_POS,
-                               crc,
-                               false);
-    }
-    else {
-        crc = P06CALCULATE_CRC(&data_ptr[P06LENGTH_POS],
-                               length - P06LENGTH_POS,
-                               CRC16_INITIAL_VALUE,
-                               true);
-    }
-    crc = P06CALCULATE_CRC(&data_id_hi_byte, 1, crc, false);
-    crc = P06CALCULATE_CRC(&data_id_lo_byte, 1, crc, false);
-
-    return crc;
-}
+#include "e2elib.h"
+#include "probes.h"
+#include "module.h"
+#include "stats.h"
 
 // clang-format off
 PyDoc_STRVAR(e2e_p06_protect_doc,
@@ -100,26 +66,16 @@ static PyObject *py_e2e_p06_protect(PyObject *module, PyObject *args, PyObject *
                         "condition: 5 <= length <= len(data).");
         goto error;
     }
-    if (offset > data.len - P06HEADER_LEN) {
+    if (offset > data.len - P06HEADER_LEN || offset + P06HEADER_LEN > length) {
         PyErr_SetString(PyExc_ValueError, "Argument \"offset\" invalid.");
         goto error;
     }
 
-    uint8_t *data_ptr = (uint8_t *)data.buf;
-
-    // write length
-    uint16_to_bigendian(data_ptr + offset + P06LENGTH_POS, length);
-
-    // increment counter
-    if (increment) {
-        uint8_t counter = data_ptr[offset + P06COUNTER_POS];
-        counter += 1;
-        data_ptr[offset + P06COUNTER_POS] = counter;
-    }
-
-    // calculate CRC
-    uint16_t crc = compute_p06_crc(data_ptr, length, data_id, offset);
-    uint16_to_bigendian(data_ptr + offset + P06CRC_POS, crc);
+    E2E_PROBE2(p06_protect_entry, length, data_id);
+    uint64_t start = e2e_stats_start();
+    e2e_p06_protect((uint8_t *)data.buf, length, data_id, offset, (bool)increment);
+    e2e_stats_stop(E2E_STAT_P06_PROTECT, start, (size_t)data.len, E2E_RESULT_OK);
+    E2E_PROBE3(p06_protect_return, length, data_id, 0);
 
     PyBuffer_Release(&data);
 
@@ -177,25 +133,25 @@ static PyObject *py_e2e_p06_check(PyObject *module, PyObject *args, PyObject *kw
                         "condition: 5 <= length <= len(data).");
         goto error;
     }
-    if (offset > data.len - P06HEADER_LEN) {
+    // the profile function gets the truncated values
+    if (offset > data.len - P06HEADER_LEN || (uint16_t)offset + P06HEADER_LEN > (uint16_t)length) {
         PyErr_SetString(PyExc_ValueError, "Argument \"offset\" invalid.");
         goto error;
     }
 
-    uint8_t *data_ptr      = (uint8_t *)data.buf;
-
-    // read length
-    uint16_t length_actual = bigendian_to_uint16(data_ptr + offset + P06LENGTH_POS);
-
-    // read crc
-    uint16_t crc_actual    = bigendian_to_uint16(data_ptr + offset + P06CRC_POS);
-
-    // calculate CRC
-    uint16_t crc           = compute_p06_crc(data_ptr, length, data_id, offset);
+    E2E_PROBE2(p06_check_entry, length, data_id);
+    uint64_t     start  = e2e_stats_start();
+    e2e_result_t result = e2e_p06_check((uint8_t *)data.buf,
+                                        (uint16_t)length,
+                                        (uint16_t)data_id,
+                                        (uint16_t)offset,
+                                        NULL);
+    e2e_stats_stop(E2E_STAT_P06_CHECK, start, (size_t)data.len, result);
+    E2E_PROBE3(p06_check_return, length, data_id, result);
 
     PyBuffer_Release(&data);
 
-    if ((length_actual == length) && (crc_actual == crc)) {
+    if (result == E2E_RESULT_OK) {
         Py_RETURN_TRUE;
     }
     else {
@@ -216,31 +172,11 @@ static struct PyMethodDef methods[] = {
 };
 // clang-format on
 
-// Module execution function for multi-phase initialization
-static int p06_exec(PyObject *module)
+// Fill the namespace of e2e.p06, called by e2e._e2e._init_submodule()
+int p06_init_submodule(PyObject *module)
 {
     if (PyModule_AddFunctions(module, methods) < 0) {
         return -1;
     }
     return 0;
 }
-
-// Array of slot definitions for multi-phase initialization
-static PyModuleDef_Slot p06_slots[] = {{Py_mod_exec, (void *)p06_exec},
-#ifdef Py_GIL_DISABLED
-                                       {Py_mod_gil, Py_MOD_GIL_NOT_USED},
-#endif
-                                       {0, NULL}};
-
-// Module definition
-static struct PyModuleDef p06_module = {
-    PyModuleDef_HEAD_INIT,
-    .m_name    = "e2e.p06",
-    .m_doc     = "",
-    .m_size    = 0,
-    .m_methods = NULL,
-    .m_slots   = p06_slots,
-};
-
-// Module init function
-PyMODINIT_FUNC PyInit_p06(void) { return PyModuleDef_Init(&p06_module); }
@@ -8,38 +8,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#include "crclib.h"
-#include "util.h"
-
-#define P07LENGTH_POS    8u
-#define P07LENGTH_LEN    4u
-#define P07COUNTER_POS   12u
-#define P07COUNTER_LEN   4u
-#define P07DATAID_POS    16u
-#define P07DATAID_LEN    4u
-#define P07CRC_POS       0u
-#define P07CRC_LEN       8u
-#define P07CALCULATE_CRC Crc_CalculateCRC64
-
-#define P07HEADER_LEN    (P07CRC_LEN + P07LENGTH_LEN + P07COUNTER_LEN + P07DATAID_LEN)
-
-uint64_t compute_p07_crc(uint8_t *data_ptr, uint32_t length, uint32_t offset)
-{
-    uint64_t crc;
-
-    // bytes before crc bytes
-    uint32_t crc_offset = (uint32_t)(offset + P07CRC_POS);
-    crc                 = P07CALCULATE_CRC(data_ptr, crc_offset, CRC64_INITIAL_VALUE, true);
-
-    // bytes after crc bytes, if any
-    if (offset + P07CRC_POS + P07CRC_LEN < length) {
-        uint32_t second_part_offset = offset + P07CRC_POS + P07CRC_LEN;
-        uint8_t *second_part_ptr    = data_ptr + second_part_offset;
-        uint32_t second_part_len    = length - (uint32_t)(offset + P07CRC_POS + P07CRC_LEN);
-        crc                         = P07CALCULATE_CRC(second_part_ptr, second_part_len, crc, false);
-    }
-    return crc;
-}
+#include "e2elib.h"
+#include "probes.h"
+#include "module.h"
+#include "stats.h"
 
 // clang-format off
 PyDoc_STRVAR(e2e_p07_protect_doc,
@@ -102,24 +74,15 @@ static PyObject *py_e2e_p07_protect(PyObject *module, PyObject *args, PyObject *
         goto error;
     }
 
-    uint8_t *data_ptr = (uint8_t *)data.buf;
-
-    // write length
-    uint32_to_bigendian(data_ptr + offset + P07LENGTH_POS, length);
-
-    // increment counter
-    if (increment) {
-        uint32_t counter = bigendian_to_uint32(data_ptr + offset + P07COUNTER_POS);
-        counter += 1;
-        uint32_to_bigendian(data_ptr + offset + P07COUNTER_POS, counter);
-    }
-
-    // write data_id
-    uint32_to_bigendian(data_ptr + offset + P07DATAID_POS, data_id);
-
-    // calculate CRC
-    uint64_t crc = compute_p07_crc(data_ptr, length, offset);
-    uint64_to_bigendian(data_ptr + offset + P07CRC_POS, crc);
+    E2E_PROBE2(p07_protect_entry, length, data_id);
+    uint64_t start = e2e_stats_start();
+    e2e_p07_protect((uint8_t *)data.buf,
+                    (uint32_t)length,
+                    (uint32_t)data_id,
+                    (uint32_t)offset,
+                    (bool)increment);
+    e2e_stats_stop(E2E_STAT_P07_PROTECT, start, (size_t)data.len, E2E_RESULT_OK);
+    E2E_PROBE3(p07_protect_return, length, data_id, 0);
 
     PyBuffer_Release(&data);
 
@@ -182,23 +145,19 @@ static PyObject *py_e2e_p07_check(PyObject *module, PyObject *args, PyObject *kw
         goto error;
     }
 
-    uint8_t *data_ptr       = (uint8_t *)data.buf;
-
-    // read length
-    uint32_t length_actual  = bigendian_to_uint32(data_ptr + offset + P07LENGTH_POS);
-
-    // read data_id
-    uint32_t data_id_actual = bigendian_to_uint32(data_ptr + offset + P07DATAID_POS);
-
-    // read crc
-    uint64_t crc_actual     = bigendian_to_uint64(data_ptr + offset + P07CRC_POS);
-
-    // calculate CRC
-    uint64_t crc            = compute_p07_crc(data_ptr, length, offset);
+    E2E_PROBE2(p07_check_entry, length, data_id);
+    uint64_t     start  = e2e_stats_start();
+    e2e_result_t result = e2e_p07_check((uint8_t *)data.buf,
+                                        (uint32_t)length,
+                                        (uint32_t)data_id,
+                                        (uint32_t)offset,
+                                        NULL);
+    e2e_stats_stop(E2E_STAT_P07_CHECK, start, (size_t)data.len, result);
+    E2E_PROBE3(p07_check_return, length, data_id, result);
 
     PyBuffer_Release(&data);
 
-    if ((length_actual == length) && (data_id_actual == data_id) && (crc_actual == crc)) {
+    if (result == E2E_RESULT_OK) {
         Py_RETURN_TRUE;
     }
     else {
@@ -219,31 +178,11 @@ static struct PyMethodDef methods[] = {
 };
 // clang-format on
 
-// Module execution function for multi-phase initialization
-static int p07_exec(PyObject *module)
+// Fill the namespace of e2e.p07, called by e2e._e2e._init_submodule()
+int p07_init_submodule(PyObject *module)
 {
     if (PyModule_AddFunctions(module, methods) < 0) {
         return -1;
     }
     return 0;
 }
-
-// Array of slot definitions for multi-phase initialization
-static PyModuleDef_Slot p07_slots[] = {{Py_mod_exec, (void *)p07_exec},
-#ifdef Py_GIL_DISABLED
-                                       {Py_mod_gil, Py_MOD_GIL_NOT_USED},
-#endif
-                                       {0, NULL}};
-
-// Module definition
-static struct PyModuleDef p07_module = {
-    PyModuleDef_HEAD_INIT,
-    .m_name    = "e2e.p07",
-    .m_doc     = "",
-    .m_size    = 0,
-    .m_methods = NULL,
-    .m_slots   = p07_slots,
-};
-
-// Module init function
-PyMODINIT_FUNC PyInit_p07(void) { return PyModuleDef_Init(&p07_module); }
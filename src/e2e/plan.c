@@ -0,0 +1,446 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crclib.h"
+#include "e2elib.h"
+#include "plan.h"
+
+// The kernels are always called with Crc_IsFirstCall == false, the plan
+// chains them with start values. This makes custom initial and XOR values
+// possible, e.g. profile 1 uses CRC8 with an initial value of 0x00.
+static uint64_t plan_crc8(const uint8_t *data_ptr, uint32_t length, uint64_t start_value)
+{
+    return Crc_CalculateCRC8(data_ptr, length, (uint8_t)start_value, false);
+}
+
+static uint64_t plan_crc8h2f(const uint8_t *data_ptr, uint32_t length, uint64_t start_value)
+{
+    return Crc_CalculateCRC8H2F(data_ptr, length, (uint8_t)start_value, false);
+}
+
+static uint64_t plan_crc16(const uint8_t *data_ptr, uint32_t length, uint64_t start_value)
+{
+    return Crc_CalculateCRC16(data_ptr, length, (uint16_t)start_value, false);
+}
+
+static uint64_t plan_crc16arc(const uint8_t *data_ptr, uint32_t length, uint64_t start_value)
+{
+    return Crc_CalculateCRC16ARC(data_ptr, length, (uint16_t)start_value, false);
+}
+
+static uint64_t plan_crc32(const uint8_t *data_ptr, uint32_t length, uint64_t start_value)
+{
+    return Crc_CalculateCRC32(data_ptr, length, (uint32_t)start_value, false);
+}
+
+static uint64_t plan_crc32p4(const uint8_t *data_ptr, uint32_t length, uint64_t start_value)
+{
+    return Crc_CalculateCRC32P4(data_ptr, length, (uint32_t)start_value, false);
+}
+
+static uint64_t plan_crc64(const uint8_t *data_ptr, uint32_t length, uint64_t start_value)
+{
+    return Crc_CalculateCRC64(data_ptr, length, start_value, false);
+}
+
+typedef struct {
+    e2e_plan_crc_t crc;
+    uint8_t        width;
+    uint64_t       initial_value;
+    uint64_t       xor_value;
+} plan_algorithm_t;
+
+// clang-format off
+static const plan_algorithm_t algorithms[CRC_ALGORITHM_COUNT] = {
+    [CRC_ALGORITHM_CRC8]     = {plan_crc8,     8,  CRC8_INITIAL_VALUE,     CRC8_XOR_VALUE},
+    [CRC_ALGORITHM_CRC8H2F]  = {plan_crc8h2f,  8,  CRC8H2F_INITIAL_VALUE,  CRC8H2F_XOR_VALUE},
+    [CRC_ALGORITHM_CRC16]    = {plan_crc16,    16, CRC16_INITIAL_VALUE,    CRC16_XOR_VALUE},
+    [CRC_ALGORITHM_CRC16ARC] = {plan_crc16arc, 16, CRC16ARC_INITIAL_VALUE, CRC16ARC_XOR_VALUE},
+    [CRC_ALGORITHM_CRC32]    = {plan_crc32,    32, CRC32_INITIAL_VALUE,    CRC32_XOR_VALUE},
+    [CRC_ALGORITHM_CRC32P4]  = {plan_crc32p4,  32, CRC32P4_INITIAL_VALUE,  CRC32P4_XOR_VALUE},
+    [CRC_ALGORITHM_CRC64]    = {plan_crc64,    64, CRC64_INITIAL_VALUE,    CRC64_XOR_VALUE},
+};
+// clang-format on
+
+static uint64_t width_mask(uint8_t width) { return width >= 64 ? UINT64_MAX : (UINT64_C(1) << width) - 1u; }
+
+static bool compile_field(e2e_plan_field_t *field, const e2e_layout_field_t *layout_field, uint8_t max_width)
+{
+    uint8_t width = layout_field->width;
+
+    *field        = (e2e_plan_field_t){0};
+    if (width == 0) {
+        return true;
+    }
+    if (width > max_width) {
+        return false;
+    }
+    field->pos = layout_field->bit >> 3;
+    if (width < 8) {
+        // inside one byte
+        uint32_t shift = layout_field->bit & 7u;
+        if (shift + width > 8) {
+            return false;
+        }
+        field->size  = 1;
+        field->shift = (uint8_t)shift;
+        field->mask  = (uint8_t)width_mask(width);
+        return true;
+    }
+    if (width % 8 != 0 || layout_field->bit % 8 != 0) {
+        return false;
+    }
+    field->size = width / 8;
+    return true;
+}
+
+static uint64_t field_max(const e2e_plan_field_t *field)
+{
+    return field->mask != 0 ? field->mask : width_mask((uint8_t)(field->size * 8));
+}
+
+static uint64_t field_read(const e2e_plan_field_t *field, const uint8_t *header, bool big_endian)
+{
+    const uint8_t *source = header + field->pos;
+    uint64_t       value  = 0;
+
+    if (field->mask != 0) {
+        return (source[0] >> field->shift) & field->mask;
+    }
+    for (uint8_t i = 0; i < field->size; ++i) {
+        if (big_endian) {
+            value = (value << 8) | source[i];
+        }
+        else {
+            value |= (uint64_t)source[i] << (i * 8);
+        }
+    }
+    return value;
+}
+
+static void field_write(const e2e_plan_field_t *field, uint8_t *header, bool big_endian, uint64_t value)
+{
+    uint8_t *target = header + field->pos;
+
+    if (field->mask != 0) {
+        uint8_t mask = (uint8_t)(field->mask << field->shift);
+        target[0]    = (uint8_t)((target[0] & ~mask) | ((value << field->shift) & mask));
+        return;
+    }
+    for (uint8_t i = 0; i < field->size; ++i) {
+        uint8_t shift = (uint8_t)(big_endian ? (field->size - 1 - i) * 8 : i * 8);
+        target[i]     = (uint8_t)(value >> shift);
+    }
+}
+
+static bool fields_overlap(const e2e_layout_field_t *a, const e2e_layout_field_t *b)
+{
+    if (a->width == 0 || b->width == 0) {
+        return false;
+    }
+    return (uint64_t)a->bit < (uint64_t)b->bit + b->width && (uint64_t)b->bit < (uint64_t)a->bit + a->width;
+}
+
+void e2e_layout_init(e2e_layout_t *layout, Crc_AlgorithmType algorithm)
+{
+    *layout           = (e2e_layout_t){0};
+    layout->algorithm = algorithm;
+    if ((unsigned int)algorithm < CRC_ALGORITHM_COUNT) {
+        layout->crc_initial = algorithms[algorithm].initial_value;
+        layout->crc_xor     = algorithms[algorithm].xor_value;
+    }
+    layout->big_endian   = true;
+    layout->data_id_size = 2;
+    layout->range_count  = 1;
+    layout->ranges[0]    = (e2e_layout_range_t){0, E2E_LAYOUT_END};
+}
+
+const char *e2e_plan_compile(e2e_plan_t *plan, const e2e_layout_t *layout)
+{
+    if ((unsigned int)layout->algorithm >= CRC_ALGORITHM_COUNT) {
+        return "Argument \"algorithm\" invalid.";
+    }
+    const plan_algorithm_t *algorithm = &algorithms[layout->algorithm];
+    if (layout->crc_initial > width_mask(algorithm->width) || layout->crc_xor > width_mask(algorithm->width)) {
+        return "Arguments \"crc_initial\" and \"crc_xor\" must fit the CRC width.";
+    }
+
+    e2e_layout_field_t crc_field = {layout->crc.bit, algorithm->width};
+    if (!compile_field(&plan->crc_field, &crc_field, 64)) {
+        return "The CRC field must be byte aligned.";
+    }
+    if (!compile_field(&plan->counter, &layout->counter, 32)) {
+        return "Invalid \"counter\" field: fields of 8 bits and more must be byte aligned with a "
+               "width of 8, 16, 24 or 32 bits, narrower fields must lie inside one byte.";
+    }
+    if (!compile_field(&plan->data_id, &layout->data_id, 32)) {
+        return "Invalid \"data_id\" field: fields of 8 bits and more must be byte aligned with a "
+               "width of 8, 16, 24 or 32 bits, narrower fields must lie inside one byte.";
+    }
+    if (!compile_field(&plan->length, &layout->length, 32)) {
+        return "Invalid \"length\" field: fields of 8 bits and more must be byte aligned with a "
+               "width of 8, 16, 24 or 32 bits, narrower fields must lie inside one byte.";
+    }
+
+    const e2e_layout_field_t *fields[]  = {&crc_field, &layout->counter, &layout->data_id, &layout->length};
+    uint64_t                  header_len = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = i + 1; j < 4; ++j) {
+            if (fields_overlap(fields[i], fields[j])) {
+                return "The header fields overlap.";
+            }
+        }
+        uint64_t end = ((uint64_t)fields[i]->bit + fields[i]->width + 7u) / 8u;
+        if (fields[i]->width != 0 && end > header_len) {
+            header_len = end;
+        }
+    }
+    if (header_len > UINT32_MAX) {
+        return "The header is too long.";
+    }
+
+    if (layout->counter.width != 0) {
+        if (layout->counter_max < 1 || layout->counter_max > width_mask(layout->counter.width)) {
+            return "Argument \"counter_max\" must fulfill 1 <= counter_max < 2 ** counter width.";
+        }
+        plan->counter_modulus = (uint64_t)layout->counter_max + 1u;
+    }
+    else {
+        plan->counter_modulus = 1u;
+    }
+
+    switch (layout->data_id_mode) {
+        case E2E_LAYOUT_DATAID_NONE:
+        case E2E_LAYOUT_DATAID_LOW:
+            break;
+        case E2E_LAYOUT_DATAID_BOTH:
+        case E2E_LAYOUT_DATAID_NIBBLE:
+            if (layout->data_id_size < 1 || layout->data_id_size > 4) {
+                return "Argument \"data_id_size\" must fulfill 1 <= data_id_size <= 4.";
+            }
+            break;
+        case E2E_LAYOUT_DATAID_ALT:
+        case E2E_LAYOUT_DATAID_LIST:
+            if (layout->counter.width == 0) {
+                return "This \"data_id_mode\" requires a \"counter\" field.";
+            }
+            if (layout->data_id_mode == E2E_LAYOUT_DATAID_LIST && layout->counter_max > 0xFFu) {
+                return "The \"list\" data_id mode supports counters up to 255 only.";
+            }
+            break;
+        default:
+            return "Argument \"data_id_mode\" invalid.";
+    }
+    if (layout->data_id_shift >= 32) {
+        return "Argument \"data_id_shift\" must be less than 32.";
+    }
+
+    if (layout->range_count < 1 || layout->range_count > E2E_LAYOUT_MAX_RANGES) {
+        return "The CRC coverage must consist of 1 to 4 ranges.";
+    }
+    for (uint32_t i = 0; i < layout->range_count; ++i) {
+        const e2e_layout_range_t *range = &layout->ranges[i];
+        if (range->start >= 0 && range->stop >= 0 && range->start > range->stop) {
+            return "A CRC coverage range ends before it starts.";
+        }
+        plan->ranges[i] = *range;
+    }
+    plan->range_count    = layout->range_count;
+
+    plan->crc            = algorithm->crc;
+    plan->crc_start      = layout->crc_initial ^ algorithm->xor_value;
+    plan->crc_xor        = layout->crc_xor ^ algorithm->xor_value;
+    plan->big_endian     = layout->big_endian;
+    plan->data_id_mode   = layout->data_id_mode;
+    plan->data_id_size   = layout->data_id_size;
+    plan->data_id_shift  = layout->data_id_shift;
+    plan->data_id_append = layout->data_id_append;
+    plan->header_len     = (uint32_t)header_len;
+    return NULL;
+}
+
+// Resolve a coverage bound against the frame length, returns -1 if it lies outside
+static int64_t resolve_bound(int64_t bound, size_t data_len)
+{
+    if (bound == E2E_LAYOUT_END) {
+        return (int64_t)data_len;
+    }
+    if (bound < 0) {
+        bound += (int64_t)data_len;
+    }
+    return (bound < 0 || bound > (int64_t)data_len) ? -1 : bound;
+}
+
+// Return true if the header and every coverage range fit into the frame
+static bool plan_fits(const e2e_plan_t *plan, size_t data_len, size_t offset)
+{
+    if (data_len > UINT32_MAX || offset > data_len || data_len - offset < plan->header_len) {
+        return false;
+    }
+    if (plan->length.size != 0 && data_len > field_max(&plan->length)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < plan->range_count; ++i) {
+        int64_t start = resolve_bound(plan->ranges[i].start, data_len);
+        int64_t stop  = resolve_bound(plan->ranges[i].stop, data_len);
+        if (start < 0 || stop < 0 || start > stop) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Bytes of the data_id which enter the CRC, returns their number
+static size_t plan_data_id_bytes(const e2e_plan_t *plan,
+                                 uint32_t          data_id,
+                                 const uint8_t    *data_id_list,
+                                 uint64_t          counter,
+                                 uint8_t           bytes[4])
+{
+    uint32_t value = data_id;
+
+    switch (plan->data_id_mode) {
+        case E2E_LAYOUT_DATAID_LOW:
+            bytes[0] = (uint8_t)data_id;
+            return 1;
+        case E2E_LAYOUT_DATAID_ALT:
+            bytes[0] = (uint8_t)(counter % 2 == 0 ? data_id : data_id >> 8);
+            return 1;
+        case E2E_LAYOUT_DATAID_LIST:
+            bytes[0] = data_id_list[counter];
+            return 1;
+        case E2E_LAYOUT_DATAID_NIBBLE:
+            value = data_id & 0xFFu;
+            // fall through
+        case E2E_LAYOUT_DATAID_BOTH:
+            for (uint8_t i = 0; i < plan->data_id_size; ++i) {
+                uint8_t shift = (uint8_t)(plan->big_endian ? (plan->data_id_size - 1 - i) * 8 : i * 8);
+                bytes[i]      = (uint8_t)(value >> shift);
+            }
+            return plan->data_id_size;
+    }
+    return 0;
+}
+
+static uint64_t plan_compute_crc(const e2e_plan_t *plan,
+                                 const uint8_t    *data_ptr,
+                                 size_t            data_len,
+                                 size_t            offset,
+                                 uint32_t          data_id,
+                                 const uint8_t    *data_id_list,
+                                 uint64_t          counter)
+{
+    uint8_t  id_bytes[4];
+    size_t   id_len    = plan_data_id_bytes(plan, data_id, data_id_list, counter, id_bytes);
+    uint64_t crc       = plan->crc_start;
+    size_t   crc_start = offset + plan->crc_field.pos;
+    size_t   crc_stop  = crc_start + plan->crc_field.size;
+
+    if (id_len != 0 && !plan->data_id_append) {
+        crc = plan->crc(id_bytes, (uint32_t)id_len, crc);
+    }
+    for (uint32_t i = 0; i < plan->range_count; ++i) {
+        size_t start = (size_t)resolve_bound(plan->ranges[i].start, data_len);
+        size_t stop  = (size_t)resolve_bound(plan->ranges[i].stop, data_len);
+
+        // leave out the CRC field
+        if (start < crc_start) {
+            size_t end = stop < crc_start ? stop : crc_start;
+            crc        = plan->crc(data_ptr + start, (uint32_t)(end - start), crc);
+        }
+        if (stop > crc_stop) {
+            size_t begin = start > crc_stop ? start : crc_stop;
+            crc          = plan->crc(data_ptr + begin, (uint32_t)(stop - begin), crc);
+        }
+    }
+    if (id_len != 0 && plan->data_id_append) {
+        crc = plan->crc(id_bytes, (uint32_t)id_len, crc);
+    }
+    return crc ^ plan->crc_xor;
+}
+
+e2e_result_t e2e_plan_protect(const e2e_plan_t *plan,
+                              uint8_t          *data_ptr,
+                              size_t            data_len,
+                              size_t            offset,
+                              uint32_t          data_id,
+                              const uint8_t    *data_id_list,
+                              bool              increment_counter)
+{
+    if (!plan_fits(plan, data_len, offset)) {
+        return E2E_RESULT_BAD_FRAME;
+    }
+    uint8_t *header = data_ptr + offset;
+
+    // write length
+    if (plan->length.size != 0) {
+        field_write(&plan->length, header, plan->big_endian, data_len);
+    }
+
+    // increment counter
+    uint64_t counter = 0;
+    if (plan->counter.size != 0) {
+        counter = field_read(&plan->counter, header, plan->big_endian);
+        if (increment_counter) {
+            counter = (counter + 1) % plan->counter_modulus;
+            field_write(&plan->counter, header, plan->big_endian, counter);
+        }
+        else if (plan->data_id_mode == E2E_LAYOUT_DATAID_LIST && counter >= plan->counter_modulus) {
+            return E2E_RESULT_COUNTER_RANGE;
+        }
+    }
+
+    // write data_id
+    if (plan->data_id.size != 0) {
+        field_write(&plan->data_id, header, plan->big_endian, data_id >> plan->data_id_shift);
+    }
+
+    // calculate CRC
+    uint64_t crc = plan_compute_crc(plan, data_ptr, data_len, offset, data_id, data_id_list, counter);
+    field_write(&plan->crc_field, header, plan->big_endian, crc);
+    return E2E_RESULT_OK;
+}
+
+e2e_result_t e2e_plan_check(const e2e_plan_t *plan,
+                            const uint8_t    *data_ptr,
+                            size_t            data_len,
+                            size_t            offset,
+                            uint32_t          data_id,
+                            const uint8_t    *data_id_list,
+                            uint32_t         *counter)
+{
+    if (!plan_fits(plan, data_len, offset)) {
+        return E2E_RESULT_BAD_FRAME;
+    }
+    const uint8_t *header         = data_ptr + offset;
+    uint64_t       counter_actual = 0;
+
+    if (plan->counter.size != 0) {
+        counter_actual = field_read(&plan->counter, header, plan->big_endian);
+    }
+    if (counter != NULL) {
+        *counter = (uint32_t)counter_actual;
+    }
+    if (plan->counter.size != 0) {
+        if (counter_actual >= plan->counter_modulus) {
+            return E2E_RESULT_COUNTER_RANGE;
+        }
+    }
+    if (plan->length.size != 0 && field_read(&plan->length, header, plan->big_endian) != data_len) {
+        return E2E_RESULT_LENGTH_MISMATCH;
+    }
+    if (plan->data_id.size != 0 && field_read(&plan->data_id, header, plan->big_endian) !=
+                                       ((data_id >> plan->data_id_shift) & field_max(&plan->data_id))) {
+        return E2E_RESULT_DATA_ID_MISMATCH;
+    }
+    if (field_read(&plan->crc_field, header, plan->big_endian) !=
+        plan_compute_crc(plan, data_ptr, data_len, offset, data_id, data_id_list, counter_actual)) {
+        return E2E_RESULT_CRC_MISMATCH;
+    }
+    return E2E_RESULT_OK;
+}
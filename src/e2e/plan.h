@@ -0,0 +1,124 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef PLAN_H
+#define PLAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crclib.h"
+#include "e2e_export.h"
+#include "e2elib.h"
+
+#define E2E_LAYOUT_MAX_RANGES 4u
+#define E2E_LAYOUT_END        INT64_MAX // stop of a range which ends with the frame
+
+// How the data_id enters the CRC besides a transmitted data_id field. The
+// modes follow the profile 1 modes, E2E_LAYOUT_DATAID_LIST is profile 2.
+typedef enum {
+    E2E_LAYOUT_DATAID_NONE,   // not at all
+    E2E_LAYOUT_DATAID_BOTH,   // data_id_size bytes of data_id in byte order
+    E2E_LAYOUT_DATAID_LOW,    // low byte
+    E2E_LAYOUT_DATAID_ALT,    // low byte for even counters, high byte for odd ones
+    E2E_LAYOUT_DATAID_NIBBLE, // like BOTH with only the low byte set, the rest is transmitted
+    E2E_LAYOUT_DATAID_LIST,   // data_id_list[counter]
+    E2E_LAYOUT_DATAID_COUNT
+} e2e_layout_data_id_mode_t;
+
+// Header field at a bit position relative to the header offset. Bit 0 is
+// the least significant bit of the first header byte. Fields of 8 bits and
+// more are byte aligned, narrower fields lie inside one byte. A width of 0
+// means that the layout has no such field.
+typedef struct {
+    uint32_t bit;
+    uint8_t  width;
+} e2e_layout_field_t;
+
+// Bytes [start, stop) of the frame, negative values count from the end of the frame
+typedef struct {
+    int64_t start;
+    int64_t stop;
+} e2e_layout_range_t;
+
+// Declarative description of an E2E profile variant
+typedef struct {
+    Crc_AlgorithmType  algorithm;
+    uint64_t           crc_initial; // CRC register before the first byte
+    uint64_t           crc_xor;     // xored to the CRC register after the last byte
+    bool               big_endian;  // byte order of the fields and of the data_id bytes in the CRC
+    e2e_layout_field_t crc;         // the width is implied by the algorithm
+    e2e_layout_field_t counter;
+    e2e_layout_field_t data_id; // transmits data_id >> data_id_shift
+    e2e_layout_field_t length;  // transmits the frame length
+    uint32_t           counter_max;
+    uint8_t            data_id_mode;
+    uint8_t            data_id_size; // E2E_LAYOUT_DATAID_BOTH and _NIBBLE, 1 to 4 bytes
+    uint8_t            data_id_shift;
+    bool               data_id_append; // data_id bytes after the covered bytes instead of before
+    uint32_t           range_count;    // CRC coverage, the CRC field is always left out
+    e2e_layout_range_t ranges[E2E_LAYOUT_MAX_RANGES];
+} e2e_layout_t;
+
+typedef uint64_t (*e2e_plan_crc_t)(const uint8_t *data_ptr, uint32_t length, uint64_t start_value);
+
+// Field with its byte position and masks resolved
+typedef struct {
+    uint32_t pos;   // byte position relative to the header offset
+    uint8_t  size;  // number of bytes, 0 if the field is absent
+    uint8_t  shift; // bit position inside the byte of a field narrower than 8 bits
+    uint8_t  mask;  // value mask of a field narrower than 8 bits, 0 for whole bytes
+    uint8_t  reserved;
+} e2e_plan_field_t;
+
+// Execution plan which e2e_plan_compile() derives from a layout once. The
+// protect and check functions only read it, so it can be shared by threads.
+typedef struct {
+    e2e_plan_crc_t     crc;       // CRC kernel, chained with start values
+    uint64_t           crc_start; // start value of the first kernel call
+    uint64_t           crc_xor;   // turns the last kernel result into the CRC
+    bool               big_endian;
+    uint8_t            data_id_mode;
+    uint8_t            data_id_size;
+    uint8_t            data_id_shift;
+    bool               data_id_append;
+    uint32_t           header_len; // bytes from the header offset to the end of the last field
+    uint64_t           counter_modulus;
+    e2e_plan_field_t   crc_field;
+    e2e_plan_field_t   counter;
+    e2e_plan_field_t   data_id;
+    e2e_plan_field_t   length;
+    uint32_t           range_count;
+    e2e_layout_range_t ranges[E2E_LAYOUT_MAX_RANGES];
+} e2e_plan_t;
+
+// Initialize a layout with the defaults of algorithm: the standard initial and
+// XOR values, big endian, data_id_size 2, the whole frame as CRC coverage and
+// no other fields than a CRC at bit 0.
+E2E_API void         e2e_layout_init(e2e_layout_t *layout, Crc_AlgorithmType algorithm);
+
+// Compile layout into plan. Returns NULL on success, otherwise an error message.
+E2E_API const char  *e2e_plan_compile(e2e_plan_t *plan, const e2e_layout_t *layout);
+
+// Protect or check the frame data_ptr[0:data_len] with the header at offset.
+// data_id_list must hold counter_max + 1 bytes for E2E_LAYOUT_DATAID_LIST and
+// is ignored otherwise. Return E2E_RESULT_BAD_FRAME if the header or a
+// coverage range does not fit the frame.
+E2E_API e2e_result_t e2e_plan_protect(const e2e_plan_t *plan,
+                                      uint8_t          *data_ptr,
+                                      size_t            data_len,
+                                      size_t            offset,
+                                      uint32_t          data_id,
+                                      const uint8_t    *data_id_list,
+                                      bool              increment_counter);
+E2E_API e2e_result_t e2e_plan_check(const e2e_plan_t *plan,
+                                    const uint8_t    *data_ptr,
+                                    size_t            data_len,
+                                    size_t            offset,
+                                    uint32_t          data_id,
+                                    const uint8_t    *data_id_list,
+                                    uint32_t         *counter);
+
+#endif
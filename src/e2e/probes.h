@@ -0,0 +1,35 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef PROBES_H
+#define PROBES_H
+
+// USDT probes of provider "e2e" for SystemTap, perf and bpftrace. They are
+// only compiled in if the build defines E2E_USDT (CMake option E2E_USDT). An
+// inactive probe is a single nop, so the option can stay on in production.
+//
+//   crcXX_entry(length)                    Crc_CalculateCRCXX() begins
+//   crcXX_return(length, crc)              Crc_CalculateCRCXX() returns
+//   pXX_protect_entry(length, data_id)     e2e.pXX.e2e_pXX_protect() begins
+//   pXX_protect_return(length, data_id, 0) e2e.pXX.e2e_pXX_protect() returns
+//   pXX_check_entry(length, data_id)       e2e.pXX.e2e_pXX_check() begins
+//   pXX_check_return(length, data_id, result)
+//                                          e2e.pXX.e2e_pXX_check() returns the e2e_result_t result
+//
+// For profile 2, data_id is the entry of the data id list which is selected by
+// the counter of the frame.
+
+#ifdef E2E_USDT
+#include <sys/sdt.h>
+
+#define E2E_PROBE1(name, a)       DTRACE_PROBE1(e2e, name, a)
+#define E2E_PROBE2(name, a, b)    DTRACE_PROBE2(e2e, name, a, b)
+#define E2E_PROBE3(name, a, b, c) DTRACE_PROBE3(e2e, name, a, b, c)
+#else
+#define E2E_PROBE1(name, a)       ((void)0)
+#define E2E_PROBE2(name, a, b)    ((void)0)
+#define E2E_PROBE3(name, a, b, c) ((void)0)
+#endif
+
+#endif
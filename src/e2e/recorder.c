@@ -0,0 +1,220 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "atomics.h"
+#include "e2elib.h"
+#include "recorder.h"
+
+static size_t align8(size_t value) { return (value + 7u) & ~(size_t)7u; }
+
+int e2e_recorder_create(e2e_recorder_t *recorder,
+                        uint32_t        count,
+                        uint32_t        depth,
+                        uint32_t        capacity,
+                        uint32_t        frame_size)
+{
+    memset(recorder, 0, sizeof(*recorder));
+    if (depth > E2E_RECORDER_MAX_DEPTH || capacity == 0 || capacity > E2E_RECORDER_MAX_CAPACITY ||
+        frame_size > E2E_RECORDER_MAX_FRAME_SIZE) {
+        return -1;
+    }
+
+    recorder->count           = count;
+    recorder->depth           = depth;
+    recorder->capacity        = capacity;
+    recorder->frame_size      = frame_size;
+    recorder->frame_slot_size = align8(sizeof(e2e_recorder_frame_t) + frame_size);
+    recorder->error_slot_size = align8(sizeof(e2e_recorder_error_t) + frame_size) +
+                                (size_t)depth * recorder->frame_slot_size;
+
+    uint64_t frames_size = (uint64_t)count * depth * recorder->frame_slot_size;
+    uint64_t errors_size = (uint64_t)capacity * recorder->error_slot_size;
+    if (frames_size > SIZE_MAX || errors_size > SIZE_MAX) {
+        return -1;
+    }
+    // calloc() initializes every sequence to 0, which no complete entry uses
+    recorder->frames = calloc(1, (size_t)frames_size + 1);
+    recorder->heads  = calloc((size_t)count + 1, sizeof(e2e_atomic_u64_t));
+    recorder->errors = calloc(1, (size_t)errors_size);
+    if (recorder->frames == NULL || recorder->heads == NULL || recorder->errors == NULL) {
+        e2e_recorder_destroy(recorder);
+        return -1;
+    }
+    e2e_atomic_store_u64(&recorder->error_head, 0);
+    return 0;
+}
+
+void e2e_recorder_destroy(e2e_recorder_t *recorder)
+{
+    free(recorder->frames);
+    free((void *)recorder->heads);
+    free(recorder->errors);
+    memset(recorder, 0, sizeof(*recorder));
+}
+
+uint64_t e2e_recorder_clock(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    uint64_t ticks = (uint64_t)counter.QuadPart;
+    uint64_t hz    = (uint64_t)frequency.QuadPart;
+    return ticks / hz * 1000000000u + ticks % hz * 1000000000u / hz;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#endif
+}
+
+uint8_t *e2e_recorder_frame_data(e2e_recorder_frame_t *frame) { return (uint8_t *)(frame + 1); }
+
+uint8_t *e2e_recorder_error_data(e2e_recorder_error_t *error) { return (uint8_t *)(error + 1); }
+
+e2e_recorder_frame_t *e2e_recorder_error_history(e2e_recorder_t       *recorder,
+                                                 e2e_recorder_error_t *error,
+                                                 uint32_t              i)
+{
+    uint8_t *history = (uint8_t *)error + align8(sizeof(e2e_recorder_error_t) + recorder->frame_size);
+    return (e2e_recorder_frame_t *)(history + (size_t)i * recorder->frame_slot_size);
+}
+
+static e2e_recorder_frame_t *frame_slot(e2e_recorder_t *recorder, uint32_t index, uint64_t position)
+{
+    size_t slot = (size_t)index * recorder->depth + (size_t)(position % recorder->depth);
+    return (e2e_recorder_frame_t *)(recorder->frames + slot * recorder->frame_slot_size);
+}
+
+static e2e_recorder_error_t *error_slot(e2e_recorder_t *recorder, uint64_t position)
+{
+    size_t slot = (size_t)(position % recorder->capacity);
+    return (e2e_recorder_error_t *)(recorder->errors + slot * recorder->error_slot_size);
+}
+
+// Copy a published entry, returns false if it was not complete or changed meanwhile
+static bool read_entry(e2e_atomic_u64_t *sequence, uint64_t position, void *target, const void *source, size_t size)
+{
+    uint64_t before = e2e_atomic_load_acquire_u64(sequence);
+    if (before != 2 * position + 2) {
+        return false;
+    }
+    memcpy(target, source, size);
+    e2e_atomic_fence_acquire();
+    return e2e_atomic_load_u64(sequence) == before;
+}
+
+static void record_frame(e2e_recorder_t *recorder,
+                         uint32_t        index,
+                         uint64_t        time,
+                         const uint8_t  *data_ptr,
+                         size_t          data_len,
+                         uint32_t        counter)
+{
+    uint64_t              position = e2e_atomic_fetch_add_u64(&recorder->heads[index], 1);
+    e2e_recorder_frame_t *frame    = frame_slot(recorder, index, position);
+    size_t                copied   = (data_len > recorder->frame_size) ? recorder->frame_size : data_len;
+
+    e2e_atomic_store_u64(&frame->sequence, 2 * position + 1);
+    e2e_atomic_fence_release();
+    frame->time    = time;
+    frame->length  = (uint32_t)data_len;
+    frame->counter = counter;
+    memcpy(e2e_recorder_frame_data(frame), data_ptr, copied);
+    e2e_atomic_store_release_u64(&frame->sequence, 2 * position + 2);
+}
+
+static void record_error(e2e_recorder_t     *recorder,
+                         uint32_t            index,
+                         uint64_t            id,
+                         const e2e_config_t *config,
+                         uint64_t            time,
+                         const uint8_t      *data_ptr,
+                         size_t              data_len,
+                         uint8_t             status,
+                         e2e_result_t        result,
+                         uint32_t            counter)
+{
+    // Two writers only meet in one slot if capacity errors are recorded while
+    // the first one is still copying. The reader then rejects the entry.
+    uint64_t              position = e2e_atomic_fetch_add_u64(&recorder->error_head, 1);
+    e2e_recorder_error_t *error    = error_slot(recorder, position);
+    size_t                copied   = (data_len > recorder->frame_size) ? recorder->frame_size : data_len;
+
+    e2e_atomic_store_u64(&error->sequence, 2 * position + 1);
+    e2e_atomic_fence_release();
+    error->id           = id;
+    error->time         = time;
+    error->index        = index;
+    error->length       = (uint32_t)data_len;
+    error->counter      = counter;
+    error->status       = status;
+    error->result       = (uint8_t)result;
+    error->received_crc = 0;
+    error->computed_crc = 0;
+    e2e_config_crc(config, data_ptr, data_len, &error->received_crc, &error->computed_crc);
+    memcpy(e2e_recorder_error_data(error), data_ptr, copied);
+
+    // snapshot the context frames of the message, oldest first
+    uint64_t head    = e2e_atomic_load_u64(&recorder->heads[index]);
+    uint64_t first   = (head > recorder->depth) ? head - recorder->depth : 0;
+    uint16_t history = 0;
+    for (uint64_t p = first; p < head; ++p) {
+        e2e_recorder_frame_t *source = frame_slot(recorder, index, p);
+        e2e_recorder_frame_t *target = e2e_recorder_error_history(recorder, error, history);
+        if (read_entry(&source->sequence, p, target, source, recorder->frame_slot_size)) {
+            ++history;
+        }
+    }
+    error->history = history;
+    e2e_atomic_store_release_u64(&error->sequence, 2 * position + 2);
+}
+
+void e2e_recorder_record(e2e_recorder_t     *recorder,
+                         uint32_t            index,
+                         uint64_t            id,
+                         const e2e_config_t *config,
+                         uint64_t            time,
+                         const uint8_t      *data_ptr,
+                         size_t              data_len,
+                         uint8_t             status,
+                         e2e_result_t        result,
+                         uint32_t            counter)
+{
+    if (time == E2E_RECORDER_NOW) {
+        time = e2e_recorder_clock();
+    }
+    if (status == E2E_STATUS_OK || status == E2E_STATUS_OKSOMELOST) {
+        if (recorder->depth > 0) {
+            record_frame(recorder, index, time, data_ptr, data_len, counter);
+        }
+    }
+    else {
+        record_error(recorder, index, id, config, time, data_ptr, data_len, status, result, counter);
+    }
+}
+
+uint64_t e2e_recorder_error_count(e2e_recorder_t *recorder)
+{
+    return e2e_atomic_load_u64(&recorder->error_head);
+}
+
+bool e2e_recorder_read_error(e2e_recorder_t *recorder, uint64_t position, e2e_recorder_error_t *entry)
+{
+    e2e_recorder_error_t *error = error_slot(recorder, position);
+    return read_entry(&error->sequence, position, entry, error, recorder->error_slot_size);
+}
@@ -0,0 +1,106 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atomics.h"
+#include "e2elib.h"
+
+#define E2E_RECORDER_MAX_DEPTH      256u
+#define E2E_RECORDER_MAX_CAPACITY   0x100000u
+#define E2E_RECORDER_MAX_FRAME_SIZE 0x10000u
+
+// time value which makes the recorder read its own monotonic clock
+#define E2E_RECORDER_NOW            UINT64_MAX
+
+// Entries are published with a sequence lock: sequence is odd while an entry is
+// written and 2 * position + 2 once entry number position is complete. Readers
+// copy an entry and accept it only if the sequence did not change meanwhile.
+
+// Recently accepted frame of a message, frame_size data bytes follow.
+typedef struct {
+    e2e_atomic_u64_t sequence;
+    uint64_t         time;
+    uint32_t         length; // length of the received frame, the copy may be truncated
+    uint32_t         counter;
+} e2e_recorder_frame_t;
+
+// Failed check, followed by frame_size bytes of the offending frame and by
+// history context frames of the same message, oldest first. The CRC fields are
+// only valid if result is not E2E_RESULT_BAD_FRAME.
+typedef struct {
+    e2e_atomic_u64_t sequence;
+    uint64_t         id;
+    uint64_t         time;
+    uint64_t         received_crc;
+    uint64_t         computed_crc;
+    uint32_t         index; // message index in the table
+    uint32_t         length;
+    uint32_t         counter;
+    uint8_t          status;  // E2E_STATUS_*
+    uint8_t          result;  // e2e_result_t, E2E_RESULT_OK for sequence errors
+    uint16_t         history; // number of context frames
+} e2e_recorder_error_t;
+
+// Fixed memory flight recorder: a ring of the last depth accepted frames per
+// message and a ring of the last capacity errors. All memory is allocated up
+// front and recording is lock-free, so it can run on every check.
+typedef struct {
+    uint32_t          count; // number of messages
+    uint32_t          depth;
+    uint32_t          capacity;
+    uint32_t          frame_size;
+    size_t            frame_slot_size;
+    size_t            error_slot_size;
+    uint8_t          *frames; // count * depth frame slots
+    e2e_atomic_u64_t *heads;  // number of recorded frames per message
+    uint8_t          *errors; // capacity error slots
+    e2e_atomic_u64_t  error_head;
+} e2e_recorder_t;
+
+int      e2e_recorder_create(e2e_recorder_t *recorder,
+                             uint32_t        count,
+                             uint32_t        depth,
+                             uint32_t        capacity,
+                             uint32_t        frame_size);
+void     e2e_recorder_destroy(e2e_recorder_t *recorder);
+
+// Record the outcome of a check of message index. Frames with status OK or
+// OKSOMELOST extend the history, all other statuses create an error entry.
+void     e2e_recorder_record(e2e_recorder_t     *recorder,
+                             uint32_t            index,
+                             uint64_t            id,
+                             const e2e_config_t *config,
+                             uint64_t            time,
+                             const uint8_t      *data_ptr,
+                             size_t              data_len,
+                             uint8_t             status,
+                             e2e_result_t        result,
+                             uint32_t            counter);
+
+// Number of errors recorded so far, including overwritten ones
+uint64_t e2e_recorder_error_count(e2e_recorder_t *recorder);
+
+// Copy error number position into entry, which must hold error_slot_size bytes.
+// Returns false if the entry was overwritten or is still being written.
+bool     e2e_recorder_read_error(e2e_recorder_t *recorder, uint64_t position, e2e_recorder_error_t *entry);
+
+// Frame data following a frame or error entry
+uint8_t *e2e_recorder_frame_data(e2e_recorder_frame_t *frame);
+uint8_t *e2e_recorder_error_data(e2e_recorder_error_t *error);
+
+// Context frame number i of an error entry
+e2e_recorder_frame_t *e2e_recorder_error_history(e2e_recorder_t       *recorder,
+                                                 e2e_recorder_error_t *error,
+                                                 uint32_t              i);
+
+// Monotonic clock in nanoseconds
+uint64_t e2e_recorder_clock(void);
+
+#endif
@@ -0,0 +1,105 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "atomics.h"
+#include "ring.h"
+
+int e2e_ring_init(e2e_ring_t *ring, void *block, size_t size, uint32_t frame_size)
+{
+    // keep the slot headers 8 byte aligned
+    uint64_t slot_size = (sizeof(e2e_ring_slot_t) + (uint64_t)frame_size + 7u) & ~(uint64_t)7u;
+
+    if (size < E2E_RING_HEADER_SIZE || ((uintptr_t)block & 7u) != 0) {
+        return -1;
+    }
+    uint64_t slot_count = (size - E2E_RING_HEADER_SIZE) / slot_size;
+    if (slot_count == 0 || slot_count > UINT32_MAX) {
+        return -1;
+    }
+
+    ring->header     = (e2e_ring_header_t *)block;
+    ring->slots      = (uint8_t *)block + E2E_RING_HEADER_SIZE;
+    ring->slot_count = (uint32_t)slot_count;
+    ring->slot_size  = (uint32_t)slot_size;
+    ring->frame_size = frame_size;
+    e2e_atomic_store_u64(&ring->header->head, 0);
+    e2e_atomic_store_u64(&ring->header->tail, 0);
+    return 0;
+}
+
+static e2e_ring_slot_t *ring_slot(e2e_ring_t *ring, uint64_t position)
+{
+    return (e2e_ring_slot_t *)(ring->slots + (size_t)(position % ring->slot_count) * ring->slot_size);
+}
+
+e2e_ring_slot_t *e2e_ring_reserve(e2e_ring_t *ring)
+{
+    uint64_t head = e2e_atomic_load_u64(&ring->header->head);
+    uint64_t tail = e2e_atomic_load_acquire_u64(&ring->header->tail);
+    if (head - tail >= ring->slot_count) {
+        return NULL;
+    }
+    return ring_slot(ring, head);
+}
+
+void e2e_ring_commit(e2e_ring_t *ring)
+{
+    uint64_t head = e2e_atomic_load_u64(&ring->header->head);
+    e2e_atomic_store_release_u64(&ring->header->head, head + 1);
+}
+
+bool e2e_ring_push(e2e_ring_t    *ring,
+                   uint64_t       id,
+                   uint64_t       time,
+                   uint32_t       status,
+                   const uint8_t *data,
+                   uint32_t       length)
+{
+    if (length > ring->frame_size) {
+        return false;
+    }
+    e2e_ring_slot_t *slot = e2e_ring_reserve(ring);
+    if (slot == NULL) {
+        return false;
+    }
+    slot->id     = id;
+    slot->time   = time;
+    slot->length = length;
+    slot->status = status;
+    if (length > 0) {
+        memcpy(e2e_ring_slot_data(slot), data, length);
+    }
+    e2e_ring_commit(ring);
+    return true;
+}
+
+e2e_ring_slot_t *e2e_ring_peek(e2e_ring_t *ring)
+{
+    uint64_t tail = e2e_atomic_load_u64(&ring->header->tail);
+    uint64_t head = e2e_atomic_load_acquire_u64(&ring->header->head);
+    if (head == tail) {
+        return NULL;
+    }
+    return ring_slot(ring, tail);
+}
+
+void e2e_ring_release(e2e_ring_t *ring)
+{
+    uint64_t tail = e2e_atomic_load_u64(&ring->header->tail);
+    e2e_atomic_store_release_u64(&ring->header->tail, tail + 1);
+}
+
+uint8_t *e2e_ring_slot_data(e2e_ring_slot_t *slot) { return (uint8_t *)(slot + 1); }
+
+uint64_t e2e_ring_size(e2e_ring_t *ring)
+{
+    uint64_t tail = e2e_atomic_load_acquire_u64(&ring->header->tail);
+    uint64_t head = e2e_atomic_load_acquire_u64(&ring->header->head);
+    return head - tail;
+}
@@ -0,0 +1,70 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef RING_H
+#define RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atomics.h"
+
+#define E2E_RING_HEADER_SIZE    128u
+#define E2E_RING_MAX_FRAME_SIZE 0x1000000u
+
+// Single producer, single consumer ring of frames inside a caller provided
+// memory block. The block starts with the write and read positions on separate
+// cache lines, followed by slot_count slots of slot_size bytes.
+typedef struct {
+    e2e_atomic_u64_t head; // number of frames written
+    uint8_t          head_padding[64 - sizeof(e2e_atomic_u64_t)];
+    e2e_atomic_u64_t tail; // number of frames read
+    uint8_t          tail_padding[64 - sizeof(e2e_atomic_u64_t)];
+} e2e_ring_header_t;
+
+// Every slot starts with this header, the frame data follows immediately.
+typedef struct {
+    uint64_t id;
+    uint64_t time;
+    uint32_t length;
+    uint32_t status;
+} e2e_ring_slot_t;
+
+typedef struct {
+    e2e_ring_header_t *header;
+    uint8_t           *slots;
+    uint32_t           slot_count;
+    uint32_t           slot_size;
+    uint32_t           frame_size; // maximum frame length
+} e2e_ring_t;
+
+// Bind ring to a memory block and reset it, returns -1 if the block cannot hold one slot.
+int              e2e_ring_init(e2e_ring_t *ring, void *block, size_t size, uint32_t frame_size);
+
+// Producer side: reserve the next free slot or return NULL if the ring is full,
+// then publish it with e2e_ring_commit().
+e2e_ring_slot_t *e2e_ring_reserve(e2e_ring_t *ring);
+void             e2e_ring_commit(e2e_ring_t *ring);
+
+// Producer side: copy a frame into the next free slot and publish it, returns
+// false if the ring is full or length exceeds frame_size.
+bool             e2e_ring_push(e2e_ring_t    *ring,
+                               uint64_t       id,
+                               uint64_t       time,
+                               uint32_t       status,
+                               const uint8_t *data,
+                               uint32_t       length);
+
+// Consumer side: return the oldest frame or NULL if the ring is empty, then
+// hand the slot back with e2e_ring_release().
+e2e_ring_slot_t *e2e_ring_peek(e2e_ring_t *ring);
+void             e2e_ring_release(e2e_ring_t *ring);
+
+uint64_t         e2e_ring_size(e2e_ring_t *ring);
+
+// Frame data of a slot
+uint8_t         *e2e_ring_slot_data(e2e_ring_slot_t *slot);
+
+#endif
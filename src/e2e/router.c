@@ -0,0 +1,482 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "e2elib.h"
+#include "module.h"
+#include "table.h"
+
+typedef struct {
+    PyObject_HEAD
+    e2e_table_t table;
+    Py_buffer   view;     // snapshot buffer which holds the table, view.obj is NULL otherwise
+    PyObject   *recorder; // FlightRecorder which owns the recorder of the table
+} RouterObject;
+
+// clang-format off
+PyDoc_STRVAR(router_doc,
+             "Router(configs: Mapping[int, Config] | Iterable[tuple[int, Config]], *, buffer: Buffer | None = None)\n"
+             "Receiver for many E2E protected messages which are identified by a message id, \n"
+             "e.g. a CAN identifier or a SOME/IP message id. \n"
+             "\n"
+             "The configurations are stored in a native hash table together with the \n"
+             "counter state of every message. Each checked frame yields one of the \n"
+             "``E2E_STATUS_*`` codes. \n"
+             "\n"
+             "A router can be shared between threads. The counter state is updated with \n"
+             "atomic compare-and-swap operations instead of a lock and :meth:`check_batch` \n"
+             "releases the GIL while it evaluates the frames. \n"
+             "\n"
+             "The state survives a restart with :meth:`snapshot` and :meth:`from_snapshot`. \n"
+             "\n"
+             "Processes share one router by placing the table in shared memory, e.g. \n"
+             "the `buf` of a :class:`multiprocessing.shared_memory.SharedMemory` with \n"
+             ":meth:`buffer_size` bytes. Other processes attach to the same segment with \n"
+             ":meth:`from_snapshot`. The counters and statistics are updated with atomic \n"
+             "operations, so all processes may check frames at the same time. \n"
+             "\n"
+             ":param configs: \n"
+             "    Mapping of message id to :class:`~e2e.Config`. The table cannot be \n"
+             "    changed after construction. \n"
+             ":param buffer: \n"
+             "    Writable, 8 byte aligned buffer which receives the table instead of \n"
+             "    private memory. It is kept alive by the router. \n");
+// clang-format on
+static PyObject *router_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    PyObject     *configs;
+    PyObject     *buffer   = Py_None;
+    static char  *kwlist[] = {"configs", "buffer", NULL};
+    module_state *state    = get_module_state_by_type(type);
+
+    if (state == NULL) {
+        return NULL;
+    }
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$O:Router", kwlist, &configs, &buffer)) {
+        return NULL;
+    }
+
+    RouterObject *self = (RouterObject *)alloc_instance(type);
+    if (self == NULL) {
+        return NULL;
+    }
+    if (buffer != Py_None &&
+        PyObject_GetBuffer(buffer, &self->view, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) < 0) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    if (table_from_configs(state, &self->table, configs, (buffer != Py_None) ? &self->view : NULL) < 0) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    return (PyObject *)self;
+}
+
+static void router_dealloc(PyObject *self)
+{
+    PyTypeObject *type   = Py_TYPE(self);
+    RouterObject *router = (RouterObject *)self;
+    e2e_table_destroy(&router->table);
+    if (router->view.obj != NULL) {
+        PyBuffer_Release(&router->view);
+    }
+    Py_XDECREF(router->recorder);
+    freefunc tp_free = (freefunc)PyType_GetSlot(type, Py_tp_free);
+    tp_free(self);
+    Py_DECREF(type);
+}
+
+e2e_table_t *table_from_object(module_state *state, PyObject *obj)
+{
+    if (!PyObject_TypeCheck(obj, state->router_type)) {
+        PyErr_Format(PyExc_TypeError, "Expected an e2e.Router instance, got %R.", Py_TYPE(obj));
+        return NULL;
+    }
+    return &((RouterObject *)obj)->table;
+}
+
+int router_attach_recorder(PyObject *router, PyObject *recorder_obj, e2e_recorder_t *recorder)
+{
+    RouterObject *self = (RouterObject *)router;
+    int           result;
+
+    // the recorder memory must live as long as the router, so it cannot be replaced
+#ifdef Py_GIL_DISABLED
+    Py_BEGIN_CRITICAL_SECTION(router);
+#endif
+    if (self->recorder != NULL) {
+        PyErr_SetString(PyExc_ValueError, "Router already has a FlightRecorder.");
+        result = -1;
+    }
+    else {
+        Py_INCREF(recorder_obj);
+        self->recorder = recorder_obj;
+        e2e_table_set_recorder(&self->table, recorder);
+        result = 0;
+    }
+#ifdef Py_GIL_DISABLED
+    Py_END_CRITICAL_SECTION();
+#endif
+    return result;
+}
+
+// clang-format off
+PyDoc_STRVAR(router_check_doc,
+             "check(id: int, data: bytes) -> int\n"
+             "Check one frame and update the counter state of its message. \n"
+             "\n"
+             ":param int id: \n"
+             "    Message id \n"
+             ":param bytes data: \n"
+             "    `bytes-like object <https://docs.python.org/3/glossary.html#term-bytes-like-object>`_\n"
+             "    which contains the received frame. \n"
+             ":return: \n"
+             "    One of the ``E2E_STATUS_*`` codes, :attr:`~e2e.E2E_STATUS_UNKNOWN_ID` if \n"
+             "    `id` is not configured.");
+// clang-format on
+static PyObject *router_check(PyObject *self, PyObject *args)
+{
+    unsigned long long id;
+    Py_buffer          data;
+
+    if (!PyArg_ParseTuple(args, "Ky*:check", &id, &data)) {
+        return NULL;
+    }
+    uint8_t status = e2e_table_check_id(&((RouterObject *)self)->table,
+                                        id,
+                                        E2E_RECORDER_NOW,
+                                        (uint8_t *)data.buf,
+                                        (size_t)data.len);
+    PyBuffer_Release(&data);
+
+    return PyLong_FromUnsignedLong(status);
+}
+
+// clang-format off
+PyDoc_STRVAR(router_check_batch_doc,
+             "check_batch(ids: Sequence[int] | Buffer, frames: Sequence[bytes]) -> bytes\n"
+             "Check many frames in a single call. \n"
+             "\n"
+             ":param ids: \n"
+             "    Message id of each frame. Either a sequence of int or a buffer of \n"
+             "    unsigned integers like :class:`array.array`. \n"
+             ":param frames: \n"
+             "    Sequence of `bytes-like objects <https://docs.python.org/3/glossary.html#term-bytes-like-object>`_\n"
+             "    in reception order. \n"
+             ":return: \n"
+             "    One ``E2E_STATUS_*`` code per frame.");
+// clang-format on
+static PyObject *router_check_batch(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    PyObject    *ids_obj;
+    PyObject    *frames_obj;
+    PyObject    *result  = NULL;
+    uint64_t    *ids     = NULL;
+    Py_buffer   *buffers = NULL;
+    Py_ssize_t   count;
+    static char *kwlist[] = {"ids", "frames", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO:check_batch", kwlist, &ids_obj, &frames_obj)) {
+        return NULL;
+    }
+    if ((ids = read_ids(ids_obj, &count)) == NULL) {
+        return NULL;
+    }
+    if ((buffers = acquire_frames(frames_obj, count)) == NULL) {
+        goto exit;
+    }
+    if ((result = PyBytes_FromStringAndSize(NULL, count)) == NULL) {
+        goto exit;
+    }
+
+    // The table layout is immutable after construction and the counter state
+    // is updated atomically, so the frames can be checked without the GIL.
+    e2e_table_t *table    = &((RouterObject *)self)->table;
+    uint8_t     *statuses = (uint8_t *)PyBytes_AsString(result);
+    Py_BEGIN_ALLOW_THREADS
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        statuses[i] = e2e_table_check_id(table,
+                                         ids[i],
+                                         E2E_RECORDER_NOW,
+                                         (uint8_t *)buffers[i].buf,
+                                         (size_t)buffers[i].len);
+    }
+    Py_END_ALLOW_THREADS
+
+exit:
+    release_frames(buffers, count);
+    PyMem_Free(ids);
+    return result;
+}
+
+// clang-format off
+PyDoc_STRVAR(router_index_doc,
+             "index(id: int) -> int\n"
+             "Return the position of message `id` in the state tables. \n"
+             "\n"
+             ":raises KeyError: \n"
+             "    if `id` is not configured");
+// clang-format on
+static PyObject *router_index(PyObject *self, PyObject *id_obj)
+{
+    unsigned long long id = PyLong_AsUnsignedLongLong(id_obj);
+    if (id == (unsigned long long)-1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    int64_t index = e2e_table_find(&((RouterObject *)self)->table, id);
+    if (index < 0) {
+        PyErr_SetObject(PyExc_KeyError, id_obj);
+        return NULL;
+    }
+    return PyLong_FromLongLong(index);
+}
+
+// clang-format off
+PyDoc_STRVAR(router_reset_doc,
+             "reset() -> None\n"
+             "Forget the counter state and statistics of all messages.");
+// clang-format on
+static PyObject *router_reset(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    e2e_table_reset(&((RouterObject *)self)->table);
+    Py_RETURN_NONE;
+}
+
+// clang-format off
+PyDoc_STRVAR(router_snapshot_doc,
+             "snapshot() -> bytes\n"
+             "Serialize the configurations and the counter state of all messages. \n"
+             "\n"
+             "The snapshot is the native table itself: a versioned header followed by \n"
+             "the hash index and one 64 byte aligned array per column. It can be written \n"
+             "to a file and mapped back with :meth:`from_snapshot`. The state of every \n"
+             "message is read atomically, so other threads may keep checking frames. \n"
+             "The format depends on the byte order of the machine.");
+// clang-format on
+static PyObject *router_snapshot(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    e2e_table_t *table  = &((RouterObject *)self)->table;
+    PyObject    *result = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)table->header->size);
+    if (result == NULL) {
+        return NULL;
+    }
+    e2e_table_copy(table, PyBytes_AsString(result));
+    return result;
+}
+
+// clang-format off
+PyDoc_STRVAR(router_from_snapshot_doc,
+             "from_snapshot(buffer: Buffer) -> Router\n"
+             "Create a router from the output of :meth:`snapshot`. \n"
+             "\n"
+             "A writable, 8 byte aligned buffer like :class:`mmap.mmap` is used in place \n"
+             "without parsing the entries: the router keeps the buffer alive and updates \n"
+             "the counter state inside it. The buffer must not be modified otherwise \n"
+             "while the router exists. Other buffers are copied. \n"
+             "\n"
+             ":param buffer: \n"
+             "    C-contiguous buffer which starts with a snapshot \n"
+             ":raises ValueError: \n"
+             "    if the buffer does not contain a valid snapshot of this version");
+// clang-format on
+static PyObject *router_from_snapshot(PyObject *cls, PyObject *buffer)
+{
+    RouterObject *self = (RouterObject *)alloc_instance((PyTypeObject *)cls);
+    if (self == NULL) {
+        return NULL;
+    }
+
+    Py_buffer view;
+    bool      in_place = true;
+    if (PyObject_GetBuffer(buffer, &view, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) < 0) {
+        PyErr_Clear();
+        if (PyObject_GetBuffer(buffer, &view, PyBUF_C_CONTIGUOUS) < 0) {
+            Py_DECREF(self);
+            return NULL;
+        }
+        in_place = false;
+    }
+    in_place = in_place && ((uintptr_t)view.buf & 7u) == 0;
+
+    e2e_table_t table;
+    if (e2e_table_bind(&table, view.buf, (size_t)view.len) < 0 || e2e_table_validate(&table) < 0) {
+        PyErr_SetString(PyExc_ValueError, "Buffer does not contain a valid router snapshot.");
+        PyBuffer_Release(&view);
+        Py_DECREF(self);
+        return NULL;
+    }
+
+    if (in_place) {
+        self->table = table;
+        self->view  = view;
+        return (PyObject *)self;
+    }
+
+    void *block = malloc((size_t)table.header->size);
+    if (block == NULL) {
+        PyBuffer_Release(&view);
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    memcpy(block, view.buf, (size_t)table.header->size);
+    PyBuffer_Release(&view);
+    e2e_table_bind(&self->table, block, (size_t)table.header->size);
+    self->table.owned = true;
+    return (PyObject *)self;
+}
+
+// clang-format off
+PyDoc_STRVAR(router_buffer_size_doc,
+             "buffer_size(count: int) -> int\n"
+             "Return the number of bytes of the table of a router with `count` messages, \n"
+             "i.e. the minimum size of the `buffer` argument and the size of a snapshot.");
+// clang-format on
+static PyObject *router_buffer_size(PyObject *Py_UNUSED(cls), PyObject *count_obj)
+{
+    Py_ssize_t count = PyLong_AsSsize_t(count_obj);
+    if (count == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    if (count < 0 || count > E2E_TABLE_MAX_COUNT) {
+        PyErr_SetString(PyExc_ValueError, "Parameter \"count\" is out of range.");
+        return NULL;
+    }
+    return PyLong_FromUnsignedLongLong(e2e_table_size((uint32_t)count));
+}
+
+static Py_ssize_t router_length(PyObject *self) { return ((RouterObject *)self)->table.header->count; }
+
+static int router_contains(PyObject *self, PyObject *id_obj)
+{
+    if (!PyLong_Check(id_obj)) {
+        return 0;
+    }
+    unsigned long long id = PyLong_AsUnsignedLongLong(id_obj);
+    if (id == (unsigned long long)-1 && PyErr_Occurred()) {
+        if (!PyErr_ExceptionMatches(PyExc_OverflowError)) {
+            return -1;
+        }
+        PyErr_Clear();
+        return 0;
+    }
+    return e2e_table_find(&((RouterObject *)self)->table, id) >= 0;
+}
+
+static PyObject *router_get_ids(PyObject *self, void *closure)
+{
+    e2e_table_t *table = &((RouterObject *)self)->table;
+    return column_view(get_module_state_by_type(Py_TYPE(self)),
+                       self,
+                       table->ids,
+                       table->header->count,
+                       sizeof(uint64_t),
+                       "Q");
+}
+
+static PyObject *router_get_counters(PyObject *self, void *closure)
+{
+    e2e_table_t *table = &((RouterObject *)self)->table;
+    return column_view(get_module_state_by_type(Py_TYPE(self)),
+                       self,
+                       table->counters,
+                       table->header->count,
+                       sizeof(int64_t),
+                       "q");
+}
+
+static PyObject *router_get_statuses(PyObject *self, void *closure)
+{
+    e2e_table_t *table = &((RouterObject *)self)->table;
+    return column_view(get_module_state_by_type(Py_TYPE(self)),
+                       self,
+                       table->statuses,
+                       table->header->count,
+                       sizeof(uint8_t),
+                       "B");
+}
+
+static PyObject *router_get_frames(PyObject *self, void *closure)
+{
+    e2e_table_t *table = &((RouterObject *)self)->table;
+    return column_view(get_module_state_by_type(Py_TYPE(self)),
+                       self,
+                       table->frames,
+                       table->header->count,
+                       sizeof(uint64_t),
+                       "Q");
+}
+
+static PyObject *router_get_errors(PyObject *self, void *closure)
+{
+    e2e_table_t *table = &((RouterObject *)self)->table;
+    return column_view(get_module_state_by_type(Py_TYPE(self)),
+                       self,
+                       table->errors,
+                       table->header->count,
+                       sizeof(uint64_t),
+                       "Q");
+}
+
+static PyObject *router_get_recorder(PyObject *self, void *closure)
+{
+    PyObject *recorder = ((RouterObject *)self)->recorder;
+    if (recorder == NULL) {
+        Py_RETURN_NONE;
+    }
+    Py_INCREF(recorder);
+    return recorder;
+}
+
+// clang-format off
+static PyMethodDef router_methods[] = {
+    {"check",         (PyCFunction)router_check,         METH_VARARGS,                 router_check_doc},
+    {"check_batch",   (PyCFunction)router_check_batch,   METH_VARARGS | METH_KEYWORDS, router_check_batch_doc},
+    {"index",         (PyCFunction)router_index,         METH_O,                       router_index_doc},
+    {"reset",         (PyCFunction)router_reset,         METH_NOARGS,                  router_reset_doc},
+    {"snapshot",      (PyCFunction)router_snapshot,      METH_NOARGS,                  router_snapshot_doc},
+    {"from_snapshot", (PyCFunction)router_from_snapshot, METH_O | METH_CLASS,          router_from_snapshot_doc},
+    {"buffer_size",   (PyCFunction)router_buffer_size,   METH_O | METH_STATIC,         router_buffer_size_doc},
+    {NULL} // sentinel
+};
+
+static PyGetSetDef router_getset[] = {
+    {"ids",      router_get_ids,      NULL, "Message id of each table row (read-only memoryview)", NULL},
+    {"counters", router_get_counters, NULL, "Last received counter, -1 before the first valid frame (read-only memoryview)", NULL},
+    {"statuses", router_get_statuses, NULL, "Status of the last checked frame (read-only memoryview)", NULL},
+    {"frames",   router_get_frames,   NULL, "Number of checked frames (read-only memoryview)", NULL},
+    {"errors",   router_get_errors,   NULL, "Number of frames with status E2E_STATUS_ERROR (read-only memoryview)", NULL},
+    {"recorder", router_get_recorder, NULL, "FlightRecorder which records the checks or None", NULL},
+    {NULL} // sentinel
+};
+
+static PyType_Slot router_slots[] = {
+    {Py_tp_doc,       (void *)router_doc},
+    {Py_tp_new,       router_new},
+    {Py_tp_dealloc,   router_dealloc},
+    {Py_tp_methods,   router_methods},
+    {Py_tp_getset,    router_getset},
+    {Py_sq_length,    router_length},
+    {Py_sq_contains,  router_contains},
+    {0, NULL}
+};
+// clang-format on
+
+static PyType_Spec router_spec = {.name      = "e2e.Router",
+                                  .basicsize = sizeof(RouterObject),
+                                  .itemsize  = 0,
+                                  .flags     = Py_TPFLAGS_DEFAULT,
+                                  .slots     = router_slots};
+
+int router_init_type(PyObject *module, module_state *state)
+{
+    state->router_type = add_type(module, &router_spec);
+    return (state->router_type == NULL) ? -1 : 0;
+}
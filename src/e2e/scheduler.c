@@ -0,0 +1,404 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e2elib.h"
+#include "module.h"
+#include "ring.h"
+#include "table.h"
+#include "wheel.h"
+
+#ifdef Py_GIL_DISABLED
+#define SCHEDULER_LOCK(self)   Py_BEGIN_CRITICAL_SECTION(self)
+#define SCHEDULER_UNLOCK(self) Py_END_CRITICAL_SECTION()
+#else
+#define SCHEDULER_LOCK(self)
+#define SCHEDULER_UNLOCK(self)
+#endif
+
+typedef struct {
+    PyObject_HEAD
+    uint32_t      count;
+    uint32_t      capacity;
+    uint64_t      resolution;
+    uint32_t     *slots; // hash index over ids
+    uint64_t     *ids;
+    e2e_config_t *configs;
+    uint8_t      *frames; // current frame of every message, frame_size bytes each
+    uint32_t     *lengths;
+    uint32_t      frame_size;
+    uint64_t     *periods;
+    uint64_t     *next_times; // time of the next transmission
+    uint64_t     *sent;       // number of transmitted frames
+    uint32_t     *due;        // messages collected by the wheel and not yet sent up to now
+    uint32_t      due_count;
+    e2e_wheel_t   wheel;
+} SchedulerObject;
+
+// Wheel tick of a transmission time. Ticks are shifted by one, so that a
+// message which is due at the start time is not already in the past.
+static uint64_t scheduler_tick(const SchedulerObject *self, uint64_t time)
+{
+    return time / self->resolution + (time % self->resolution != 0) + 1;
+}
+
+static void scheduler_collect(void *context, uint32_t index)
+{
+    SchedulerObject *self        = (SchedulerObject *)context;
+    self->due[self->due_count++] = index;
+}
+
+static int scheduler_load(SchedulerObject *self, PyObject *messages, uint64_t start)
+{
+    module_state *state = get_module_state_by_type(Py_TYPE((PyObject *)self));
+    PyObject     *items = PySequence_List(messages);
+    Py_buffer    *templates;
+    Py_ssize_t    count;
+
+    if (state == NULL || items == NULL) {
+        Py_XDECREF(items);
+        return -1;
+    }
+    count = PyList_Size(items);
+    if (count > E2E_TABLE_MAX_COUNT) {
+        PyErr_SetString(PyExc_ValueError, "Too many messages.");
+        Py_DECREF(items);
+        return -1;
+    }
+    if ((templates = PyMem_Calloc((size_t)count + 1, sizeof(Py_buffer))) == NULL) {
+        PyErr_NoMemory();
+        Py_DECREF(items);
+        return -1;
+    }
+
+    self->count      = (uint32_t)count;
+    self->capacity   = e2e_hash_capacity(self->count);
+    self->slots      = PyMem_Calloc(self->capacity, sizeof(uint32_t));
+    self->ids        = PyMem_Calloc((size_t)count + 1, sizeof(uint64_t));
+    self->configs    = PyMem_Calloc((size_t)count + 1, sizeof(e2e_config_t));
+    self->lengths    = PyMem_Calloc((size_t)count + 1, sizeof(uint32_t));
+    self->periods    = PyMem_Calloc((size_t)count + 1, sizeof(uint64_t));
+    self->next_times = PyMem_Calloc((size_t)count + 1, sizeof(uint64_t));
+    self->sent       = PyMem_Calloc((size_t)count + 1, sizeof(uint64_t));
+    self->due        = PyMem_Calloc((size_t)count + 1, sizeof(uint32_t));
+    if (self->slots == NULL || self->ids == NULL || self->configs == NULL || self->lengths == NULL ||
+        self->periods == NULL || self->next_times == NULL || self->sent == NULL || self->due == NULL ||
+        e2e_wheel_create(&self->wheel, self->count, scheduler_tick(self, start) - 1) < 0) {
+        PyErr_NoMemory();
+        goto error;
+    }
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        PyObject           *entry = PySequence_Tuple(PyList_GetItem(items, i));
+        PyObject           *config_obj;
+        PyObject           *template_obj;
+        const e2e_config_t *config;
+        unsigned long long  id;
+        unsigned long long  period;
+        unsigned long long  offset = 0;
+
+        if (entry == NULL) {
+            goto error;
+        }
+        if (!PyArg_ParseTuple(entry, "KOOK|K:Scheduler", &id, &config_obj, &template_obj, &period, &offset)) {
+            Py_DECREF(entry);
+            goto error;
+        }
+        config = config_from_object(state, config_obj);
+        if (config == NULL || PyObject_GetBuffer(template_obj, &templates[i], PyBUF_SIMPLE) < 0) {
+            Py_DECREF(entry);
+            goto error;
+        }
+        Py_DECREF(entry);
+
+        if (period == 0) {
+            PyErr_Format(PyExc_ValueError, "Period of message id %llu must be positive.", id);
+            goto error;
+        }
+        if (e2e_config_frame_length(config, (size_t)templates[i].len) == 0) {
+            PyErr_Format(PyExc_ValueError, "Template of message id %llu does not fit its Config.", id);
+            goto error;
+        }
+        self->ids[i]        = id;
+        self->configs[i]    = *config;
+        self->lengths[i]    = (uint32_t)templates[i].len;
+        self->periods[i]    = period;
+        self->next_times[i] = start + offset;
+        if (self->lengths[i] > self->frame_size) {
+            self->frame_size = self->lengths[i];
+        }
+        if (e2e_hash_insert(self->slots, self->capacity, self->ids, (uint32_t)i) < 0) {
+            PyErr_Format(PyExc_ValueError, "Duplicate message id %llu.", id);
+            goto error;
+        }
+    }
+
+    if ((self->frames = PyMem_Calloc((size_t)count * self->frame_size + 1, 1)) == NULL) {
+        PyErr_NoMemory();
+        goto error;
+    }
+    for (uint32_t i = 0; i < self->count; ++i) {
+        memcpy(self->frames + (size_t)i * self->frame_size, templates[i].buf, self->lengths[i]);
+        e2e_wheel_arm(&self->wheel, i, scheduler_tick(self, self->next_times[i]));
+    }
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        PyBuffer_Release(&templates[i]);
+    }
+    PyMem_Free(templates);
+    Py_DECREF(items);
+    return 0;
+
+error:
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        if (templates[i].obj != NULL) {
+            PyBuffer_Release(&templates[i]);
+        }
+    }
+    PyMem_Free(templates);
+    Py_DECREF(items);
+    return -1;
+}
+
+// clang-format off
+PyDoc_STRVAR(scheduler_doc,
+             "Scheduler(messages: Iterable[tuple[int, Config, bytes, int] | tuple[int, Config, bytes, int, int]], *, start: int = 0, resolution: int = 1)\n"
+             "Cyclic transmit scheduler for many E2E protected messages. \n"
+             "\n"
+             "Every message has a frame template, a period and an optional offset. The \n"
+             "transmission times are kept in a hierarchical timing wheel. :meth:`tick` \n"
+             "protects every due frame natively, incrementing the counter like \n"
+             "``e2e_pXX_protect(increment_counter=True)``, and writes it into a \n"
+             ":class:`FrameRing`. All times are integers in the same unit, e.g. milliseconds \n"
+             "or the result of :func:`time.monotonic_ns`. The cost of :meth:`tick` depends \n"
+             "on the due messages, not on the number of wheel ticks since the last call. \n"
+             "\n"
+             ":param messages: \n"
+             "    Iterable of (message id, :class:`~e2e.Config`, template, period) or \n"
+             "    (message id, :class:`~e2e.Config`, template, period, offset) tuples. The \n"
+             "    template is the initial frame including the E2E header. \n"
+             ":param int start: \n"
+             "    Start time, the first transmission of a message is at `start` + offset. \n"
+             ":param int resolution: \n"
+             "    Length of one timing wheel tick. A message is still sent by the first \n"
+             "    :meth:`tick` at or after its transmission time. \n");
+// clang-format on
+static PyObject *scheduler_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    PyObject          *messages;
+    unsigned long long start      = 0;
+    unsigned long long resolution = 1;
+    static char       *kwlist[]   = {"messages", "start", "resolution", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args,
+                                     kwargs,
+                                     "O|$KK:Scheduler",
+                                     kwlist,
+                                     &messages,
+                                     &start,
+                                     &resolution)) {
+        return NULL;
+    }
+    if (resolution == 0) {
+        PyErr_SetString(PyExc_ValueError, "Parameter \"resolution\" must be positive.");
+        return NULL;
+    }
+
+    SchedulerObject *self = (SchedulerObject *)alloc_instance(type);
+    if (self == NULL) {
+        return NULL;
+    }
+    self->resolution = resolution;
+    if (scheduler_load(self, messages, start) < 0) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    return (PyObject *)self;
+}
+
+static void scheduler_dealloc(PyObject *self)
+{
+    PyTypeObject    *type      = Py_TYPE(self);
+    SchedulerObject *scheduler = (SchedulerObject *)self;
+    e2e_wheel_destroy(&scheduler->wheel);
+    PyMem_Free(scheduler->slots);
+    PyMem_Free(scheduler->ids);
+    PyMem_Free(scheduler->configs);
+    PyMem_Free(scheduler->frames);
+    PyMem_Free(scheduler->lengths);
+    PyMem_Free(scheduler->periods);
+    PyMem_Free(scheduler->next_times);
+    PyMem_Free(scheduler->sent);
+    PyMem_Free(scheduler->due);
+    freefunc tp_free = (freefunc)PyType_GetSlot(type, Py_tp_free);
+    tp_free(self);
+    Py_DECREF(type);
+}
+
+// Write all transmissions of the due messages up to now into ring
+static uint64_t scheduler_transmit(SchedulerObject *self, uint64_t now, e2e_ring_t *ring)
+{
+    uint64_t written = 0;
+    uint32_t pending = 0;
+
+    e2e_wheel_advance(&self->wheel, scheduler_tick(self, now), scheduler_collect, self);
+    for (uint32_t k = 0; k < self->due_count; ++k) {
+        uint32_t index = self->due[k];
+        uint8_t *frame = self->frames + (size_t)index * self->frame_size;
+
+        while (self->next_times[index] <= now) {
+            e2e_ring_slot_t *slot = e2e_ring_reserve(ring);
+            if (slot == NULL) {
+                // ring is full, the message stays due and is retried on the next tick
+                break;
+            }
+            e2e_config_protect(&self->configs[index], frame, self->lengths[index], true);
+            memcpy(e2e_ring_slot_data(slot), frame, self->lengths[index]);
+            slot->id     = self->ids[index];
+            slot->time   = self->next_times[index];
+            slot->length = self->lengths[index];
+            slot->status = 0;
+            e2e_ring_commit(ring);
+
+            self->next_times[index] += self->periods[index];
+            self->sent[index]++;
+            written++;
+        }
+        uint64_t tick = scheduler_tick(self, self->next_times[index]);
+        if (tick > self->wheel.now) {
+            e2e_wheel_arm(&self->wheel, index, tick);
+        }
+        else {
+            // the transmission lies within the current wheel tick, the wheel would
+            // only expire it on the next one, a whole resolution late
+            self->due[pending++] = index;
+        }
+    }
+    self->due_count = pending;
+    return written;
+}
+
+// clang-format off
+PyDoc_STRVAR(scheduler_tick_doc,
+             "tick(now: int, ring: FrameRing) -> int\n"
+             "Protect all frames which are due at or before `now` and write them into `ring`. \n"
+             "Messages which missed several periods are sent once per missed period. If the \n"
+             "ring is full, the remaining frames stay due until the next tick. \n"
+             "\n"
+             ":param int now: \n"
+             "    Current time \n"
+             ":param FrameRing ring: \n"
+             "    Destination ring, its `frame_size` must fit the largest template. \n"
+             ":return: \n"
+             "    Number of written frames");
+// clang-format on
+static PyObject *scheduler_tick_method(PyObject *self, PyObject *args)
+{
+    SchedulerObject   *scheduler = (SchedulerObject *)self;
+    unsigned long long now;
+    PyObject          *ring_obj;
+    e2e_ring_t        *ring;
+    uint64_t           written;
+
+    if (!PyArg_ParseTuple(args, "KO:tick", &now, &ring_obj)) {
+        return NULL;
+    }
+    if ((ring = ring_from_object(get_module_state_by_type(Py_TYPE(self)), ring_obj)) == NULL) {
+        return NULL;
+    }
+    if (ring->frame_size < scheduler->frame_size) {
+        PyErr_Format(PyExc_ValueError,
+                     "Frame size of the ring must be at least %lu.",
+                     (unsigned long)scheduler->frame_size);
+        return NULL;
+    }
+
+    SCHEDULER_LOCK(self);
+    written = scheduler_transmit(scheduler, now, ring);
+    SCHEDULER_UNLOCK(self);
+    return PyLong_FromUnsignedLongLong(written);
+}
+
+static Py_ssize_t scheduler_length(PyObject *self) { return ((SchedulerObject *)self)->count; }
+
+static PyObject *scheduler_get_ids(PyObject *self, void *closure)
+{
+    SchedulerObject *scheduler = (SchedulerObject *)self;
+    return column_view(get_module_state_by_type(Py_TYPE(self)),
+                       self,
+                       scheduler->ids,
+                       scheduler->count,
+                       sizeof(uint64_t),
+                       "Q");
+}
+
+static PyObject *scheduler_get_next_times(PyObject *self, void *closure)
+{
+    SchedulerObject *scheduler = (SchedulerObject *)self;
+    return column_view(get_module_state_by_type(Py_TYPE(self)),
+                       self,
+                       scheduler->next_times,
+                       scheduler->count,
+                       sizeof(uint64_t),
+                       "Q");
+}
+
+static PyObject *scheduler_get_sent(PyObject *self, void *closure)
+{
+    SchedulerObject *scheduler = (SchedulerObject *)self;
+    return column_view(get_module_state_by_type(Py_TYPE(self)),
+                       self,
+                       scheduler->sent,
+                       scheduler->count,
+                       sizeof(uint64_t),
+                       "Q");
+}
+
+static PyObject *scheduler_get_frame_size(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((SchedulerObject *)self)->frame_size);
+}
+
+// clang-format off
+static PyMethodDef scheduler_methods[] = {
+    {"tick", (PyCFunction)scheduler_tick_method, METH_VARARGS, scheduler_tick_doc},
+    {NULL} // sentinel
+};
+
+static PyGetSetDef scheduler_getset[] = {
+    {"ids",        scheduler_get_ids,        NULL, "Message id of each table row (read-only memoryview)", NULL},
+    {"next_times", scheduler_get_next_times, NULL, "Time of the next transmission (read-only memoryview)", NULL},
+    {"sent",       scheduler_get_sent,       NULL, "Number of transmitted frames (read-only memoryview)", NULL},
+    {"frame_size", scheduler_get_frame_size, NULL, "Length of the largest template", NULL},
+    {NULL} // sentinel
+};
+
+static PyType_Slot scheduler_slots[] = {
+    {Py_tp_doc,     (void *)scheduler_doc},
+    {Py_tp_new,     scheduler_new},
+    {Py_tp_dealloc, scheduler_dealloc},
+    {Py_tp_methods, scheduler_methods},
+    {Py_tp_getset,  scheduler_getset},
+    {Py_sq_length,  scheduler_length},
+    {0, NULL}
+};
+// clang-format on
+
+static PyType_Spec scheduler_spec = {.name      = "e2e.Scheduler",
+                                     .basicsize = sizeof(SchedulerObject),
+                                     .itemsize  = 0,
+                                     .flags     = Py_TPFLAGS_DEFAULT,
+                                     .slots     = scheduler_slots};
+
+int scheduler_init_type(PyObject *module, module_state *state)
+{
+    state->scheduler_type = add_type(module, &scheduler_spec);
+    return (state->scheduler_type == NULL) ? -1 : 0;
+}
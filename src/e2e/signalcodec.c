@@ -0,0 +1,596 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "codec.h"
+#include "e2elib.h"
+#include "module.h"
+
+typedef struct {
+    PyObject_HEAD
+    PyObject           *names;      // tuple of the signal names in signal order
+    PyObject           *index;      // {name: position}
+    Py_ssize_t          count;
+    uint32_t            frame_size; // bytes which a frame needs for all signals
+    e2e_codec_signal_t *signals;
+} SignalCodecObject;
+
+// Parse one (name, start_bit, length, byteorder, signed, scale, offset) tuple
+static int signalcodec_parse_signal(PyObject *item, PyObject **name, e2e_codec_signal_t *signal)
+{
+    Py_ssize_t  start_bit;
+    Py_ssize_t  length;
+    const char *byteorder = "little";
+    int         is_signed = false;
+    double      scale     = 1.0;
+    double      offset    = 0.0;
+
+    PyObject   *tuple     = PySequence_Tuple(item);
+    if (tuple == NULL) {
+        return -1;
+    }
+    int ok = PyArg_ParseTuple(tuple,
+                              "Unn|spdd:SignalCodec",
+                              name,
+                              &start_bit,
+                              &length,
+                              &byteorder,
+                              &is_signed,
+                              &scale,
+                              &offset);
+    if (ok) {
+        Py_INCREF(*name);
+    }
+    Py_DECREF(tuple);
+    if (!ok) {
+        return -1;
+    }
+    if (strcmp(byteorder, "big") != 0 && strcmp(byteorder, "little") != 0) {
+        PyErr_Format(PyExc_ValueError, "Byte order of signal %R must be \"big\" or \"little\".", *name);
+        return -1;
+    }
+    if (start_bit < 0 || start_bit > UINT32_MAX || length < 0 || length > UINT8_MAX) {
+        PyErr_Format(PyExc_ValueError, "Start bit or length of signal %R out of range.", *name);
+        return -1;
+    }
+    const char *error = e2e_codec_compile(signal,
+                                          (uint32_t)start_bit,
+                                          (uint8_t)length,
+                                          byteorder[0] == 'b',
+                                          (bool)is_signed,
+                                          scale,
+                                          offset);
+    if (error != NULL) {
+        PyErr_Format(PyExc_ValueError, "Signal %R: %s", *name, error);
+        return -1;
+    }
+    return 0;
+}
+
+// Set ValueError and return -1 if a signal shares bits with an earlier one
+static int signalcodec_check_overlap(SignalCodecObject *self)
+{
+    uint8_t *used = PyMem_Calloc(self->frame_size, 1);
+    if (used == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (Py_ssize_t i = 0; i < self->count; ++i) {
+        if (e2e_codec_unpack(&self->signals[i], used) != 0) {
+            PyErr_Format(PyExc_ValueError,
+                         "Signal %R overlaps another signal.",
+                         PyTuple_GetItem(self->names, i));
+            PyMem_Free(used);
+            return -1;
+        }
+        e2e_codec_pack(&self->signals[i], used, UINT64_MAX);
+    }
+    PyMem_Free(used);
+    return 0;
+}
+
+// Set ValueError and return -1 if a signal shares a byte with the E2E header
+// of config. Profiles 1 and 2 have the CRC in byte 0 and the counter in byte 1,
+// the other profiles have their header at the configured offset.
+static int signalcodec_check_header(SignalCodecObject *self, const e2e_config_t *config)
+{
+    uint64_t start  = config->offset;
+    uint64_t length = 2;
+
+    switch (config->profile) {
+        case 1:
+        case 2:
+            start = 0;
+            break;
+        case 4:
+            length = P04HEADER_LEN;
+            break;
+        case 5:
+            length = P05HEADER_LEN;
+            break;
+        case 6:
+            length = P06HEADER_LEN;
+            break;
+        case 7:
+            length = P07HEADER_LEN;
+            break;
+    }
+    for (Py_ssize_t i = 0; i < self->count; ++i) {
+        const e2e_codec_signal_t *signal = &self->signals[i];
+        for (uint8_t j = 0; j < signal->segment_count; ++j) {
+            uint64_t byte = signal->segments[j].byte;
+            if (byte >= start && byte < start + length) {
+                PyErr_Format(PyExc_ValueError,
+                             "Signal %R overlaps the E2E header of the Config.",
+                             PyTuple_GetItem(self->names, i));
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+// clang-format off
+PyDoc_STRVAR(signalcodec_doc,
+             "SignalCodec(signals: Iterable[tuple[str, int, int] | tuple[str, int, int, str, bool, float, float]])\n"
+             "Native codec for the signals of a message, described like the signals of a DBC \n"
+             "file. The bit layout is compiled once, :meth:`pack_protect` packs all signals \n"
+             "and protects the frame in one call, :meth:`check_unpack` checks and unpacks a \n"
+             "whole batch of frames into typed columns without holding the GIL. \n"
+             "\n"
+             "Each signal is a tuple ``(name, start_bit, length[, byteorder[, signed[, scale[, offset]]]])``. \n"
+             "`start_bit` is the start bit of the DBC file: the least significant bit for \n"
+             "``\"little\"`` endian (Intel) signals and the most significant bit for ``\"big\"`` \n"
+             "endian (Motorola) signals, bit `i` is bit ``i % 8`` of byte ``i // 8``. The \n"
+             "physical value is ``raw * scale + offset``. The defaults are ``\"little\"``, \n"
+             "unsigned, a scale of 1 and an offset of 0. Signals must not overlap each other \n"
+             "and must not overlap the E2E header of the message. \n"
+             "\n"
+             ":param signals: \n"
+             "    Signal descriptions, the order defines the order of the values. \n");
+// clang-format on
+static PyObject *signalcodec_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    PyObject    *signals_obj;
+    static char *kwlist[] = {"signals", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O:SignalCodec", kwlist, &signals_obj)) {
+        return NULL;
+    }
+    PyObject *signals = PySequence_Tuple(signals_obj);
+    if (signals == NULL) {
+        return NULL;
+    }
+    SignalCodecObject *self = (SignalCodecObject *)alloc_instance(type);
+    if (self == NULL) {
+        Py_DECREF(signals);
+        return NULL;
+    }
+    self->count = PyTuple_Size(signals);
+    if (self->count == 0) {
+        PyErr_SetString(PyExc_ValueError, "A SignalCodec needs at least one signal.");
+        goto error;
+    }
+    self->names   = PyTuple_New(self->count);
+    self->index   = PyDict_New();
+    self->signals = PyMem_Calloc((size_t)self->count, sizeof(e2e_codec_signal_t));
+    if (self->names == NULL || self->index == NULL || self->signals == NULL) {
+        if (!PyErr_Occurred()) {
+            PyErr_NoMemory();
+        }
+        goto error;
+    }
+    for (Py_ssize_t i = 0; i < self->count; ++i) {
+        PyObject *name = NULL;
+        if (signalcodec_parse_signal(PyTuple_GetItem(signals, i), &name, &self->signals[i]) < 0) {
+            Py_XDECREF(name);
+            goto error;
+        }
+        // PyTuple_SetItem() steals the reference
+        PyTuple_SetItem(self->names, i, name);
+        int contained = PyDict_Contains(self->index, name);
+        if (contained != 0) {
+            if (contained > 0) {
+                PyErr_Format(PyExc_ValueError, "Duplicate signal name %R.", name);
+            }
+            goto error;
+        }
+        PyObject *position = PyLong_FromSsize_t(i);
+        if (position == NULL || PyDict_SetItem(self->index, name, position) < 0) {
+            Py_XDECREF(position);
+            goto error;
+        }
+        Py_DECREF(position);
+        if (self->signals[i].end > self->frame_size) {
+            self->frame_size = self->signals[i].end;
+        }
+    }
+    if (signalcodec_check_overlap(self) < 0) {
+        goto error;
+    }
+    Py_DECREF(signals);
+    return (PyObject *)self;
+
+error:
+    Py_DECREF(signals);
+    Py_DECREF(self);
+    return NULL;
+}
+
+static void signalcodec_dealloc(PyObject *self)
+{
+    PyTypeObject      *type  = Py_TYPE(self);
+    SignalCodecObject *codec = (SignalCodecObject *)self;
+    Py_XDECREF(codec->names);
+    Py_XDECREF(codec->index);
+    PyMem_Free(codec->signals);
+    freefunc tp_free = (freefunc)PyType_GetSlot(type, Py_tp_free);
+    tp_free(self);
+    Py_DECREF(type);
+}
+
+// Convert the value of signal i into its raw value or set ValueError and return -1.
+// Integers are converted exactly for signals without scale and offset.
+static int signalcodec_encode(SignalCodecObject *self, Py_ssize_t i, PyObject *value, uint64_t *raw)
+{
+    const e2e_codec_signal_t *signal = &self->signals[i];
+    bool                      ok;
+
+    if (signal->integer && PyLong_Check(value)) {
+        int overflow;
+        if (signal->is_signed) {
+            long long number = PyLong_AsLongLongAndOverflow(value, &overflow);
+            if (number == -1 && PyErr_Occurred()) {
+                return -1;
+            }
+            long long limit = (long long)((UINT64_C(1) << (signal->length - 1)) - 1u);
+            ok              = !overflow && number >= -limit - 1 && number <= limit;
+            *raw            = (uint64_t)number & (UINT64_MAX >> (64 - signal->length));
+        }
+        else {
+            unsigned long long number = PyLong_AsUnsignedLongLong(value);
+            if (number == (unsigned long long)-1 && PyErr_Occurred()) {
+                if (!PyErr_ExceptionMatches(PyExc_OverflowError)) {
+                    return -1;
+                }
+                PyErr_Clear();
+                number = UINT64_MAX;
+                ok     = false;
+            }
+            else {
+                ok = number <= (UINT64_MAX >> (64 - signal->length));
+            }
+            *raw = number;
+        }
+    }
+    else {
+        double number = PyFloat_AsDouble(value);
+        if (number == -1.0 && PyErr_Occurred()) {
+            return -1;
+        }
+        ok = e2e_codec_encode(signal, number, raw);
+    }
+    if (!ok) {
+        PyErr_Format(PyExc_ValueError,
+                     "Value %R is out of the range of signal %R.",
+                     value,
+                     PyTuple_GetItem(self->names, i));
+        return -1;
+    }
+    return 0;
+}
+
+// Encode values, a dict or a sequence in signal order, into raws. present[i]
+// is false for signals which a dict leaves out.
+static int signalcodec_encode_values(SignalCodecObject *self,
+                                     PyObject          *values,
+                                     uint64_t          *raws,
+                                     bool              *present)
+{
+    if (PyDict_Check(values)) {
+        PyObject  *key;
+        PyObject  *value;
+        Py_ssize_t pos = 0;
+        memset(present, 0, (size_t)self->count * sizeof(bool));
+        while (PyDict_Next(values, &pos, &key, &value)) {
+            PyObject *position = PyDict_GetItemWithError(self->index, key);
+            if (position == NULL) {
+                if (!PyErr_Occurred()) {
+                    PyErr_Format(PyExc_KeyError, "Unknown signal %R.", key);
+                }
+                return -1;
+            }
+            Py_ssize_t i = PyLong_AsSsize_t(position);
+            if (signalcodec_encode(self, i, value, &raws[i]) < 0) {
+                return -1;
+            }
+            present[i] = true;
+        }
+        return 0;
+    }
+
+    PyObject *tuple = PySequence_Tuple(values);
+    if (tuple == NULL) {
+        return -1;
+    }
+    if (PyTuple_Size(tuple) != self->count) {
+        PyErr_Format(PyExc_ValueError, "Expected %zd values, got %zd.", self->count, PyTuple_Size(tuple));
+        Py_DECREF(tuple);
+        return -1;
+    }
+    for (Py_ssize_t i = 0; i < self->count; ++i) {
+        if (signalcodec_encode(self, i, PyTuple_GetItem(tuple, i), &raws[i]) < 0) {
+            Py_DECREF(tuple);
+            return -1;
+        }
+        present[i] = true;
+    }
+    Py_DECREF(tuple);
+    return 0;
+}
+
+// clang-format off
+PyDoc_STRVAR(signalcodec_pack_protect_doc,
+             "pack_protect(data: bytearray, values: Sequence[float] | dict[str, float], config: Config, *, increment_counter: bool = True) -> None\n"
+             "Pack the signal values into the frame and calculate its CRC inplace, like the \n"
+             "``e2e_pXX_protect`` function of the profile of `config`. All values, the \n"
+             "frame length and the position of the E2E header are validated before the \n"
+             "frame is modified. \n"
+             "\n"
+             ":param bytearray data: \n"
+             "    Mutable `bytes-like object <https://docs.python.org/3/glossary.html#term-bytes-like-object>`_, \n"
+             "    the counter of the previous frame is read from it. \n"
+             ":param values: \n"
+             "    Physical values in signal order, or a dict ``{name: value}``. Signals which \n"
+             "    the dict leaves out keep their bits. A value is rounded to the nearest raw \n"
+             "    value, an int is taken exactly for signals without scale and offset. \n"
+             ":param Config config: \n"
+             "    Profile, data id, header offset etc. of the message \n"
+             ":param bool increment_counter: \n"
+             "    If `True` the counter will be incremented before calculating the CRC. \n"
+             ":raises ValueError: \n"
+             "    if a value is out of the range of its signal, if the frame does not fit \n"
+             "    `config` or the signals, or if a signal overlaps the E2E header");
+// clang-format on
+static PyObject *signalcodec_pack_protect(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    SignalCodecObject *codec = (SignalCodecObject *)self;
+    Py_buffer          data;
+    PyObject          *values;
+    PyObject          *config_obj;
+    int                increment = true;
+    static char       *kwlist[]  = {"data", "values", "config", "increment_counter", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args,
+                                     kwargs,
+                                     "w*OO|$p:pack_protect",
+                                     kwlist,
+                                     &data,
+                                     &values,
+                                     &config_obj,
+                                     &increment)) {
+        return NULL;
+    }
+    module_state       *state   = get_module_state_by_type(Py_TYPE(self));
+    PyObject           *result  = NULL;
+    uint64_t           *raws    = NULL;
+    bool               *present = NULL;
+    const e2e_config_t *config  = config_from_object(state, config_obj);
+    if (config == NULL) {
+        goto exit;
+    }
+    if (data.len < (Py_ssize_t)codec->frame_size) {
+        PyErr_Format(PyExc_ValueError,
+                     "Frame of length %zd is too short, the signals need %zd bytes.",
+                     data.len,
+                     (Py_ssize_t)codec->frame_size);
+        goto exit;
+    }
+    if (e2e_config_frame_length(config, (size_t)data.len) == 0) {
+        PyErr_Format(PyExc_ValueError, "Frame of length %zd does not fit its Config.", data.len);
+        goto exit;
+    }
+    if (signalcodec_check_header(codec, config) < 0) {
+        goto exit;
+    }
+    raws    = PyMem_Malloc((size_t)codec->count * sizeof(uint64_t));
+    present = PyMem_Malloc((size_t)codec->count * sizeof(bool));
+    if (raws == NULL || present == NULL) {
+        PyErr_NoMemory();
+        goto exit;
+    }
+    if (signalcodec_encode_values(codec, values, raws, present) < 0) {
+        goto exit;
+    }
+    for (Py_ssize_t i = 0; i < codec->count; ++i) {
+        if (present[i]) {
+            e2e_codec_pack(&codec->signals[i], (uint8_t *)data.buf, raws[i]);
+        }
+    }
+    e2e_result_t status = e2e_config_protect(config, (uint8_t *)data.buf, (size_t)data.len, (bool)increment);
+    if (status != E2E_RESULT_OK) {
+        PyErr_Format(PyExc_ValueError, "Frame of length %zd does not fit its Config.", data.len);
+        goto exit;
+    }
+    result = Py_None;
+    Py_INCREF(result);
+
+exit:
+    PyMem_Free(raws);
+    PyMem_Free(present);
+    PyBuffer_Release(&data);
+    return result;
+}
+
+static void signalcodec_free_columns(PyObject *capsule)
+{
+    PyMem_Free(PyCapsule_GetPointer(capsule, NULL));
+}
+
+// clang-format off
+PyDoc_STRVAR(signalcodec_check_unpack_doc,
+             "check_unpack(frames: Sequence[bytes], config: Config) -> tuple[bytes, dict[str, memoryview]]\n"
+             "Check many frames of the message in a single call and unpack their signals. \n"
+             "Like :meth:`FrameView.check` the counter is not evaluated, use :class:`Router` \n"
+             "for sequence checks. \n"
+             "\n"
+             ":param frames: \n"
+             "    Sequence of `bytes-like objects <https://docs.python.org/3/glossary.html#term-bytes-like-object>`_. \n"
+             ":param Config config: \n"
+             "    Profile, data id, header offset etc. of the message \n"
+             ":return: \n"
+             "    ``E2E_STATUS_OK`` or ``E2E_STATUS_ERROR`` for every frame and one read-only \n"
+             "    column per signal. Columns of signals without scale and offset hold the \n"
+             "    raw values as ``int64`` or ``uint64`` and are 0 for invalid frames, the \n"
+             "    other columns hold the physical values as ``float64`` and are NaN for \n"
+             "    invalid frames. A frame is invalid if its CRC is wrong or if it is too \n"
+             "    short for the signals. \n"
+             ":raises ValueError: \n"
+             "    if a signal overlaps the E2E header of `config`");
+// clang-format on
+static PyObject *signalcodec_check_unpack(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    SignalCodecObject *codec = (SignalCodecObject *)self;
+    PyObject          *frames_obj;
+    PyObject          *config_obj;
+    static char       *kwlist[] = {"frames", "config", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO:check_unpack", kwlist, &frames_obj, &config_obj)) {
+        return NULL;
+    }
+    module_state       *state  = get_module_state_by_type(Py_TYPE(self));
+    const e2e_config_t *config = config_from_object(state, config_obj);
+    if (config == NULL || signalcodec_check_header(codec, config) < 0) {
+        return NULL;
+    }
+    Py_ssize_t count = PyObject_Length(frames_obj);
+    if (count < 0) {
+        return NULL;
+    }
+
+    PyObject  *result   = NULL;
+    PyObject  *statuses = NULL;
+    PyObject  *columns  = NULL;
+    PyObject  *owner    = NULL;
+    Py_buffer *buffers  = NULL;
+    uint64_t  *block    = NULL;
+
+    if ((buffers = acquire_frames(frames_obj, count)) == NULL) {
+        return NULL;
+    }
+    statuses = PyBytes_FromStringAndSize(NULL, count);
+    columns  = PyDict_New();
+    if (statuses == NULL || columns == NULL) {
+        goto exit;
+    }
+    // one block for all columns, the capsule frees it with the last column
+    if ((block = PyMem_Malloc((size_t)(count * codec->count + 1) * sizeof(uint64_t))) == NULL) {
+        PyErr_NoMemory();
+        goto exit;
+    }
+    if ((owner = PyCapsule_New(block, NULL, signalcodec_free_columns)) == NULL) {
+        PyMem_Free(block);
+        goto exit;
+    }
+
+    // the signals and the configuration are immutable, so the frames can be
+    // checked and unpacked without the GIL
+    uint8_t *status_ptr = (uint8_t *)PyBytes_AsString(statuses);
+    Py_BEGIN_ALLOW_THREADS
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        const uint8_t *frame = (const uint8_t *)buffers[i].buf;
+        bool           valid = buffers[i].len >= (Py_ssize_t)codec->frame_size &&
+                     e2e_config_check(config, frame, (size_t)buffers[i].len, NULL) == E2E_RESULT_OK;
+        status_ptr[i]        = valid ? E2E_STATUS_OK : E2E_STATUS_ERROR;
+        for (Py_ssize_t j = 0; j < codec->count; ++j) {
+            const e2e_codec_signal_t *signal = &codec->signals[j];
+            uint64_t                 *column = block + j * count;
+            if (signal->integer) {
+                column[i] = valid ? e2e_codec_unpack(signal, frame) : 0;
+            }
+            else {
+                double value = valid ? e2e_codec_decode(signal, e2e_codec_unpack(signal, frame)) : NAN;
+                memcpy(&column[i], &value, sizeof(double));
+            }
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    for (Py_ssize_t j = 0; j < codec->count; ++j) {
+        const e2e_codec_signal_t *signal = &codec->signals[j];
+        const char               *format = signal->integer ? (signal->is_signed ? "q" : "Q") : "d";
+        const uint64_t           *buf    = block + j * count;
+        PyObject                 *column = column_view(state, owner, buf, count, sizeof(uint64_t), format);
+        if (column == NULL || PyDict_SetItem(columns, PyTuple_GetItem(codec->names, j), column) < 0) {
+            Py_XDECREF(column);
+            goto exit;
+        }
+        Py_DECREF(column);
+    }
+    result = PyTuple_Pack(2, statuses, columns);
+
+exit:
+    release_frames(buffers, count);
+    Py_XDECREF(statuses);
+    Py_XDECREF(columns);
+    Py_XDECREF(owner);
+    return result;
+}
+
+static Py_ssize_t signalcodec_length(PyObject *self) { return ((SignalCodecObject *)self)->count; }
+
+static PyObject *signalcodec_get_names(PyObject *self, void *closure)
+{
+    PyObject *names = ((SignalCodecObject *)self)->names;
+    Py_INCREF(names);
+    return names;
+}
+
+static PyObject *signalcodec_get_frame_size(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(((SignalCodecObject *)self)->frame_size);
+}
+
+// clang-format off
+static PyMethodDef signalcodec_methods[] = {
+    {"pack_protect", (PyCFunction)signalcodec_pack_protect, METH_VARARGS | METH_KEYWORDS, signalcodec_pack_protect_doc},
+    {"check_unpack", (PyCFunction)signalcodec_check_unpack, METH_VARARGS | METH_KEYWORDS, signalcodec_check_unpack_doc},
+    {NULL} // sentinel
+};
+
+static PyGetSetDef signalcodec_getset[] = {
+    {"names",      signalcodec_get_names,      NULL, "Signal names in signal order", NULL},
+    {"frame_size", signalcodec_get_frame_size, NULL, "Minimum frame length in bytes for all signals", NULL},
+    {NULL} // sentinel
+};
+
+static PyType_Slot signalcodec_slots[] = {
+    {Py_tp_doc,     (void *)signalcodec_doc},
+    {Py_tp_new,     signalcodec_new},
+    {Py_tp_dealloc, signalcodec_dealloc},
+    {Py_tp_methods, signalcodec_methods},
+    {Py_tp_getset,  signalcodec_getset},
+    {Py_sq_length,  signalcodec_length},
+    {0, NULL}
+};
+// clang-format on
+
+static PyType_Spec signalcodec_spec = {.name      = "e2e.SignalCodec",
+                                       .basicsize = sizeof(SignalCodecObject),
+                                       .itemsize  = 0,
+                                       .flags     = Py_TPFLAGS_DEFAULT,
+                                       .slots     = signalcodec_slots};
+
+int signalcodec_init_type(PyObject *module, module_state *state)
+{
+    state->signalcodec_type = add_type(module, &signalcodec_spec);
+    return (state->signalcodec_type == NULL) ? -1 : 0;
+}
@@ -0,0 +1,334 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#include "atomics.h"
+#include "e2elib.h"
+#include "stats.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+// Counters of one thread. Only the owning thread writes, so increments are a
+// relaxed load and store instead of a locked read-modify-write.
+typedef struct stats_block {
+    struct stats_block *next;
+    e2e_atomic_i64_t    owned; // 1 while a thread records into the block
+    e2e_atomic_u64_t    calls[E2E_STAT_COUNT];
+    e2e_atomic_u64_t    bytes[E2E_STAT_COUNT];
+    e2e_atomic_u64_t    failures[E2E_STAT_COUNT][E2E_STATS_REASONS];
+    e2e_atomic_u64_t    latency[E2E_STAT_COUNT][E2E_STATS_BUCKETS];
+} stats_block_t;
+
+e2e_atomic_u8_t                    e2e_stats_enabled;
+
+// All blocks ever created. A finished thread hands its block back and the
+// next new thread continues counting in it, so the calls of finished threads
+// stay in the totals and the list only grows with the number of concurrent
+// threads. Blocks are never freed, readers walk the list without a lock.
+static e2e_atomic_ptr_t            blocks;
+static THREAD_LOCAL stats_block_t *thread_block;
+
+// Thread exit hook which releases the block of the thread
+#ifdef _WIN32
+static DWORD          exit_key      = FLS_OUT_OF_INDEXES;
+static INIT_ONCE      exit_key_once = INIT_ONCE_STATIC_INIT;
+#else
+static pthread_key_t  exit_key;
+static bool           exit_key_valid;
+static pthread_once_t exit_key_once = PTHREAD_ONCE_INIT;
+#endif
+
+static const char *const stat_names[E2E_STAT_COUNT] = {
+    "e2e_p01_protect",
+    "e2e_p01_check",
+    "e2e_p02_protect",
+    "e2e_p02_check",
+    "e2e_p04_protect",
+    "e2e_p04_check",
+    "e2e_p05_protect",
+    "e2e_p05_check",
+    "e2e_p06_protect",
+    "e2e_p06_check",
+    "e2e_p07_protect",
+    "e2e_p07_check",
+    "calculate_crc8",
+    "calculate_crc8_h2f",
+    "calculate_crc16",
+    "calculate_crc16_arc",
+    "calculate_crc32",
+    "calculate_crc32_p4",
+    "calculate_crc64",
+};
+
+static const char *const reason_names[E2E_STATS_REASONS] = {
+    NULL,
+    "bad_frame",
+    "length_mismatch",
+    "data_id_mismatch",
+    "counter_range",
+    "crc_mismatch",
+};
+
+uint64_t e2e_stats_clock(void)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#elif defined(_WIN32)
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)counter.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#endif
+}
+
+static const char *clock_name(void)
+{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    return "tsc";
+#elif defined(__aarch64__)
+    return "cntvct";
+#elif defined(_WIN32)
+    return "qpc";
+#else
+    return "ns";
+#endif
+}
+
+static void release_block(void *block)
+{
+    if (block != NULL) {
+        thread_block = NULL;
+        e2e_atomic_store_i64(&((stats_block_t *)block)->owned, 0);
+    }
+}
+
+#ifdef _WIN32
+static void WINAPI release_block_fls(void *block) { release_block(block); }
+
+static BOOL CALLBACK create_exit_key(PINIT_ONCE once, void *parameter, void **context)
+{
+    exit_key = FlsAlloc(release_block_fls);
+    return TRUE;
+}
+
+// Call release_block() when the current thread exits, false if that is not possible
+static bool register_exit(stats_block_t *block)
+{
+    InitOnceExecuteOnce(&exit_key_once, create_exit_key, NULL, NULL);
+    return exit_key != FLS_OUT_OF_INDEXES && FlsSetValue(exit_key, block);
+}
+#else
+static void create_exit_key(void) { exit_key_valid = pthread_key_create(&exit_key, release_block) == 0; }
+
+// Call release_block() when the current thread exits, false if that is not possible
+static bool register_exit(stats_block_t *block)
+{
+    pthread_once(&exit_key_once, create_exit_key);
+    return exit_key_valid && pthread_setspecific(exit_key, block) == 0;
+}
+#endif
+
+// Take over a block which a finished thread released
+static stats_block_t *claim_block(void)
+{
+    for (stats_block_t *block = e2e_atomic_load_ptr(&blocks); block != NULL; block = block->next) {
+        int64_t expected = 0;
+        while (e2e_atomic_load_i64(&block->owned) == 0) {
+            if (e2e_atomic_cas_i64(&block->owned, &expected, 1)) {
+                return block;
+            }
+            expected = 0;
+        }
+    }
+    return NULL;
+}
+
+static stats_block_t *get_thread_block(void)
+{
+    if (thread_block != NULL) {
+        return thread_block;
+    }
+    stats_block_t *block = claim_block();
+    if (block == NULL) {
+        block = calloc(1, sizeof(stats_block_t));
+        if (block == NULL) {
+            return NULL;
+        }
+        block->owned = 1;
+        void *head   = e2e_atomic_load_ptr(&blocks);
+        do {
+            block->next = (stats_block_t *)head;
+        } while (!e2e_atomic_cas_ptr(&blocks, &head, block));
+    }
+    // without an exit hook the block stays with this thread forever
+    register_exit(block);
+    thread_block = block;
+    return block;
+}
+
+static void bump(e2e_atomic_u64_t *counter, uint64_t value)
+{
+    e2e_atomic_store_u64(counter, e2e_atomic_load_u64(counter) + value);
+}
+
+static uint32_t log2_bucket(uint64_t value)
+{
+    uint32_t bucket = 0;
+    while (value > 1 && bucket < E2E_STATS_BUCKETS - 1) {
+        value >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void e2e_stats_record(e2e_stat_t stat, uint64_t start, size_t bytes, e2e_result_t result)
+{
+    uint64_t       elapsed = e2e_stats_clock() - start;
+    stats_block_t *block   = get_thread_block();
+    if (block == NULL) {
+        return;
+    }
+    bump(&block->calls[stat], 1);
+    bump(&block->bytes[stat], bytes);
+    if (result != E2E_RESULT_OK && (unsigned)result < E2E_STATS_REASONS) {
+        bump(&block->failures[stat][result], 1);
+    }
+    bump(&block->latency[stat][log2_bucket(elapsed)], 1);
+}
+
+// Sum up the counters of statistic stat over all threads into a dict
+static PyObject *stat_dict(e2e_stat_t stat)
+{
+    uint64_t calls                       = 0;
+    uint64_t bytes                       = 0;
+    uint64_t failures[E2E_STATS_REASONS] = {0};
+    uint64_t latency[E2E_STATS_BUCKETS]  = {0};
+
+    for (stats_block_t *block = e2e_atomic_load_ptr(&blocks); block != NULL; block = block->next) {
+        calls += e2e_atomic_load_u64(&block->calls[stat]);
+        bytes += e2e_atomic_load_u64(&block->bytes[stat]);
+        for (uint32_t i = 0; i < E2E_STATS_REASONS; ++i) {
+            failures[i] += e2e_atomic_load_u64(&block->failures[stat][i]);
+        }
+        for (uint32_t i = 0; i < E2E_STATS_BUCKETS; ++i) {
+            latency[i] += e2e_atomic_load_u64(&block->latency[stat][i]);
+        }
+    }
+
+    PyObject *failure_dict = PyDict_New();
+    PyObject *latency_list = PyList_New(E2E_STATS_BUCKETS);
+    if (failure_dict == NULL || latency_list == NULL) {
+        goto error;
+    }
+    for (uint32_t i = 1; i < E2E_STATS_REASONS; ++i) {
+        PyObject *value = PyLong_FromUnsignedLongLong(failures[i]);
+        if (value == NULL || PyDict_SetItemString(failure_dict, reason_names[i], value) < 0) {
+            Py_XDECREF(value);
+            goto error;
+        }
+        Py_DECREF(value);
+    }
+    for (uint32_t i = 0; i < E2E_STATS_BUCKETS; ++i) {
+        PyObject *value = PyLong_FromUnsignedLongLong(latency[i]);
+        if (value == NULL) {
+            goto error;
+        }
+        PyList_SetItem(latency_list, i, value);
+    }
+    return Py_BuildValue("{s:K,s:K,s:N,s:N}",
+                         "calls",
+                         (unsigned long long)calls,
+                         "bytes",
+                         (unsigned long long)bytes,
+                         "failures",
+                         failure_dict,
+                         "latency",
+                         latency_list);
+
+error:
+    Py_XDECREF(failure_dict);
+    Py_XDECREF(latency_list);
+    return NULL;
+}
+
+static PyObject *py_stats(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *result = PyDict_New();
+    if (result == NULL) {
+        return NULL;
+    }
+    for (e2e_stat_t stat = 0; stat < E2E_STAT_COUNT; ++stat) {
+        PyObject *value = stat_dict(stat);
+        if (value == NULL || PyDict_SetItemString(result, stat_names[stat], value) < 0) {
+            Py_XDECREF(value);
+            Py_DECREF(result);
+            return NULL;
+        }
+        Py_DECREF(value);
+    }
+    return Py_BuildValue("(sN)", clock_name(), result);
+}
+
+// Number of counter blocks, for tests
+static PyObject *py_stats_blocks(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    Py_ssize_t count = 0;
+    for (stats_block_t *block = e2e_atomic_load_ptr(&blocks); block != NULL; block = block->next) {
+        ++count;
+    }
+    return PyLong_FromSsize_t(count);
+}
+
+static PyObject *py_enable_stats(PyObject *module, PyObject *enabled)
+{
+    int flag = PyObject_IsTrue(enabled);
+    if (flag < 0) {
+        return NULL;
+    }
+    e2e_atomic_store_u8(&e2e_stats_enabled, (uint8_t)flag);
+    Py_RETURN_NONE;
+}
+
+// clang-format off
+static struct PyMethodDef stats_methods[] = {
+    {"_stats",        (PyCFunction)py_stats,        METH_NOARGS, NULL},
+    {"_stats_blocks", (PyCFunction)py_stats_blocks, METH_NOARGS, NULL},
+    {"_enable_stats", (PyCFunction)py_enable_stats, METH_O,      NULL},
+    {NULL} // sentinel
+};
+// clang-format on
+
+int e2e_stats_add_functions(PyObject *module) { return PyModule_AddFunctions(module, stats_methods); }
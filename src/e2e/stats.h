@@ -0,0 +1,73 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef STATS_H
+#define STATS_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atomics.h"
+#include "e2elib.h"
+
+// Opt-in call statistics of the Python entry points of e2e.crc and e2e.pXX.
+// Counters live in per-thread blocks, so recording never contends; readers sum
+// up all blocks. When statistics are disabled a call costs one relaxed load.
+
+#define E2E_STATS_BUCKETS 32u // latency histogram bins, bin i counts [2^i, 2^(i+1)) clock ticks
+#define E2E_STATS_REASONS (E2E_RESULT_CRC_MISMATCH + 1)
+
+typedef enum {
+    E2E_STAT_P01_PROTECT,
+    E2E_STAT_P01_CHECK,
+    E2E_STAT_P02_PROTECT,
+    E2E_STAT_P02_CHECK,
+    E2E_STAT_P04_PROTECT,
+    E2E_STAT_P04_CHECK,
+    E2E_STAT_P05_PROTECT,
+    E2E_STAT_P05_CHECK,
+    E2E_STAT_P06_PROTECT,
+    E2E_STAT_P06_CHECK,
+    E2E_STAT_P07_PROTECT,
+    E2E_STAT_P07_CHECK,
+    E2E_STAT_CRC8,
+    E2E_STAT_CRC8_H2F,
+    E2E_STAT_CRC16,
+    E2E_STAT_CRC16_ARC,
+    E2E_STAT_CRC32,
+    E2E_STAT_CRC32_P4,
+    E2E_STAT_CRC64,
+    E2E_STAT_COUNT
+} e2e_stat_t;
+
+extern e2e_atomic_u8_t e2e_stats_enabled;
+
+// Cycle counter where the CPU has one (x86 TSC, ARM generic timer), monotonic nanoseconds otherwise
+uint64_t               e2e_stats_clock(void);
+
+// Start time of a measured call, 0 if statistics are disabled
+static inline uint64_t e2e_stats_start(void)
+{
+    return e2e_atomic_load_u8(&e2e_stats_enabled) ? e2e_stats_clock() : 0;
+}
+
+// Count a call which started at start. result is E2E_RESULT_OK for protect and CRC functions.
+void                   e2e_stats_record(e2e_stat_t stat, uint64_t start, size_t bytes, e2e_result_t result);
+
+// Same as e2e_stats_record() but does nothing if start is 0
+static inline void     e2e_stats_stop(e2e_stat_t stat, uint64_t start, size_t bytes, e2e_result_t result)
+{
+    if (start != 0) {
+        e2e_stats_record(stat, start, bytes, result);
+    }
+}
+
+// Add _stats() and _enable_stats() to module
+int                    e2e_stats_add_functions(PyObject *module);
+
+#endif
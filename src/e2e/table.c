@@ -0,0 +1,326 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "e2elib.h"
+#include "table.h"
+
+static uint64_t align_up(uint64_t value)
+{
+    return (value + E2E_TABLE_ALIGNMENT - 1) & ~(uint64_t)(E2E_TABLE_ALIGNMENT - 1);
+}
+
+// finalizer of MurmurHash3, spreads sequential CAN ids over all slots
+static uint64_t hash_id(uint64_t id)
+{
+    id ^= id >> 33;
+    id *= 0xff51afd7ed558ccdULL;
+    id ^= id >> 33;
+    id *= 0xc4ceb9fe1a85ec53ULL;
+    id ^= id >> 33;
+    return id;
+}
+
+uint32_t e2e_hash_capacity(uint32_t count)
+{
+    // keep the load factor at or below 0.5
+    uint32_t capacity = 8;
+    while (capacity < 2 * (uint64_t)count) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+int e2e_hash_insert(uint32_t *slots, uint32_t capacity, const uint64_t *ids, uint32_t index)
+{
+    uint32_t mask = capacity - 1;
+    uint32_t slot = (uint32_t)hash_id(ids[index]) & mask;
+
+    // linear probing, the load factor guarantees a free slot
+    while (slots[slot] != 0) {
+        if (ids[slots[slot] - 1] == ids[index]) {
+            return -1;
+        }
+        slot = (slot + 1) & mask;
+    }
+    slots[slot] = index + 1;
+    return 0;
+}
+
+int64_t e2e_hash_find(const uint32_t *slots, uint32_t capacity, const uint64_t *ids, uint64_t id)
+{
+    uint32_t mask = capacity - 1;
+    uint32_t slot = (uint32_t)hash_id(id) & mask;
+
+    while (slots[slot] != 0) {
+        uint32_t index = slots[slot] - 1;
+        if (ids[index] == id) {
+            return index;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+// Compute the layout of a table with count messages, returns the block size
+static uint64_t table_layout(e2e_table_header_t *header, uint32_t count)
+{
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, E2E_TABLE_MAGIC, sizeof(header->magic));
+    header->version         = E2E_TABLE_VERSION;
+    header->count           = count;
+    header->capacity        = e2e_hash_capacity(count);
+
+    uint64_t size           = align_up(sizeof(e2e_table_header_t));
+    header->slots_offset    = size;
+    size                    = align_up(size + (uint64_t)header->capacity * sizeof(uint32_t));
+    header->ids_offset      = size;
+    size                    = align_up(size + (uint64_t)count * sizeof(uint64_t));
+    header->configs_offset  = size;
+    size                    = align_up(size + (uint64_t)count * sizeof(e2e_config_t));
+    header->counters_offset = size;
+    size                    = align_up(size + (uint64_t)count * sizeof(int64_t));
+    header->statuses_offset = size;
+    size                    = align_up(size + (uint64_t)count * sizeof(uint8_t));
+    header->frames_offset   = size;
+    size                    = align_up(size + (uint64_t)count * sizeof(uint64_t));
+    header->errors_offset   = size;
+    size                    = align_up(size + (uint64_t)count * sizeof(uint64_t));
+    header->size            = size;
+    return size;
+}
+
+uint64_t e2e_table_size(uint32_t count)
+{
+    e2e_table_header_t header;
+    return table_layout(&header, count);
+}
+
+int e2e_table_init(e2e_table_t *table, void *block, size_t size, uint32_t count)
+{
+    e2e_table_header_t header;
+
+    if (count > E2E_TABLE_MAX_COUNT || table_layout(&header, count) > size) {
+        return -1;
+    }
+    memset(block, 0, (size_t)header.size);
+    memcpy(block, &header, sizeof(header));
+    if (e2e_table_bind(table, block, size) < 0) {
+        return -1;
+    }
+    e2e_table_reset(table);
+    return 0;
+}
+
+int e2e_table_create(e2e_table_t *table, uint32_t count)
+{
+    if (count > E2E_TABLE_MAX_COUNT) {
+        return -1;
+    }
+    uint64_t size = e2e_table_size(count);
+    if (size > SIZE_MAX) {
+        return -1;
+    }
+    void *block = malloc((size_t)size);
+    if (block == NULL) {
+        return -1;
+    }
+    if (e2e_table_init(table, block, (size_t)size, count) < 0) {
+        free(block);
+        return -1;
+    }
+    table->owned = true;
+    return 0;
+}
+
+void e2e_table_destroy(e2e_table_t *table)
+{
+    if (table->owned) {
+        free(table->header);
+    }
+    memset(table, 0, sizeof(*table));
+}
+
+// true if a column of count items starts aligned and ends inside the block
+static bool column_fits(const e2e_table_header_t *header, uint64_t offset, uint64_t count, uint64_t itemsize)
+{
+    return offset >= sizeof(e2e_table_header_t) && (offset & (E2E_TABLE_ALIGNMENT - 1)) == 0 &&
+           offset <= header->size && count * itemsize <= header->size - offset;
+}
+
+int e2e_table_bind(e2e_table_t *table, void *block, size_t size)
+{
+    e2e_table_header_t *header = (e2e_table_header_t *)block;
+
+    if (size < sizeof(e2e_table_header_t) || ((uintptr_t)block & 7u) != 0 ||
+        memcmp(header->magic, E2E_TABLE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != E2E_TABLE_VERSION || header->size > size ||
+        header->count > E2E_TABLE_MAX_COUNT || header->capacity < 2 * (uint64_t)header->count ||
+        (header->capacity & (header->capacity - 1)) != 0) {
+        return -1;
+    }
+    uint64_t count = header->count;
+    if (!column_fits(header, header->slots_offset, header->capacity, sizeof(uint32_t)) ||
+        !column_fits(header, header->ids_offset, count, sizeof(uint64_t)) ||
+        !column_fits(header, header->configs_offset, count, sizeof(e2e_config_t)) ||
+        !column_fits(header, header->counters_offset, count, sizeof(int64_t)) ||
+        !column_fits(header, header->statuses_offset, count, sizeof(uint8_t)) ||
+        !column_fits(header, header->frames_offset, count, sizeof(uint64_t)) ||
+        !column_fits(header, header->errors_offset, count, sizeof(uint64_t))) {
+        return -1;
+    }
+
+    uint8_t *base   = (uint8_t *)block;
+    table->header   = header;
+    table->owned    = false;
+    table->slots    = (uint32_t *)(base + header->slots_offset);
+    table->ids      = (uint64_t *)(base + header->ids_offset);
+    table->configs  = (e2e_config_t *)(base + header->configs_offset);
+    table->counters = (e2e_atomic_i64_t *)(base + header->counters_offset);
+    table->statuses = (e2e_atomic_u8_t *)(base + header->statuses_offset);
+    table->frames   = (e2e_atomic_u64_t *)(base + header->frames_offset);
+    table->errors   = (e2e_atomic_u64_t *)(base + header->errors_offset);
+    e2e_atomic_store_ptr(&table->recorder, NULL);
+    return 0;
+}
+
+int e2e_table_insert(e2e_table_t *table, uint32_t index, uint64_t id, const e2e_config_t *config)
+{
+    table->ids[index] = id;
+    if (e2e_hash_insert(table->slots, table->header->capacity, table->ids, index) < 0) {
+        return -1;
+    }
+    table->configs[index] = *config;
+    return 0;
+}
+
+int64_t e2e_table_find(const e2e_table_t *table, uint64_t id)
+{
+    return e2e_hash_find(table->slots, table->header->capacity, table->ids, id);
+}
+
+uint8_t e2e_table_check(e2e_table_t   *table,
+                        uint32_t       index,
+                        uint64_t       time,
+                        const uint8_t *data_ptr,
+                        size_t         data_len)
+{
+    const e2e_config_t *config   = &table->configs[index];
+    uint32_t            counter  = 0;
+    e2e_result_t        result;
+    uint8_t             status;
+
+    e2e_atomic_add_u64(&table->frames[index], 1);
+    result = e2e_config_check(config, data_ptr, data_len, &counter);
+    if (result != E2E_RESULT_OK) {
+        e2e_atomic_add_u64(&table->errors[index], 1);
+        status = E2E_STATUS_ERROR;
+    }
+    else {
+        // Evaluate the sequence against the last counter and publish the new
+        // counter with compare-and-swap. If another thread advanced the counter
+        // in between, the evaluation is repeated against its counter, so every
+        // frame is compared with exactly one predecessor.
+        int64_t last_counter = e2e_atomic_load_i64(&table->counters[index]);
+        do {
+            if (last_counter < 0) {
+                // first valid frame synchronizes the receiver
+                status = E2E_STATUS_OK;
+            }
+            else {
+                uint32_t delta = e2e_counter_delta(config->profile, (uint32_t)last_counter, counter);
+                status         = e2e_sequence_status(delta, config->max_delta_counter);
+            }
+        } while (!e2e_atomic_cas_i64(&table->counters[index], &last_counter, counter));
+    }
+    e2e_atomic_store_u8(&table->statuses[index], status);
+
+    e2e_recorder_t *recorder = (e2e_recorder_t *)e2e_atomic_load_ptr(&table->recorder);
+    if (recorder != NULL) {
+        e2e_recorder_record(recorder,
+                            index,
+                            table->ids[index],
+                            config,
+                            time,
+                            data_ptr,
+                            data_len,
+                            status,
+                            result,
+                            counter);
+    }
+    return status;
+}
+
+uint8_t e2e_table_check_id(e2e_table_t   *table,
+                           uint64_t       id,
+                           uint64_t       time,
+                           const uint8_t *data_ptr,
+                           size_t         data_len)
+{
+    int64_t index = e2e_table_find(table, id);
+    if (index < 0) {
+        return E2E_STATUS_UNKNOWN_ID;
+    }
+    return e2e_table_check(table, (uint32_t)index, time, data_ptr, data_len);
+}
+
+void e2e_table_set_recorder(e2e_table_t *table, e2e_recorder_t *recorder)
+{
+    e2e_atomic_store_ptr(&table->recorder, recorder);
+}
+
+void e2e_table_reset(e2e_table_t *table)
+{
+    uint32_t count = table->header->count;
+    for (uint32_t i = 0; i < count; ++i) {
+        e2e_atomic_store_i64(&table->counters[i], -1);
+        e2e_atomic_store_u8(&table->statuses[i], E2E_STATUS_NONEWDATA);
+        e2e_atomic_store_u64(&table->frames[i], 0);
+        e2e_atomic_store_u64(&table->errors[i], 0);
+    }
+}
+
+int e2e_table_validate(const e2e_table_t *table)
+{
+    uint32_t count    = table->header->count;
+    uint32_t capacity = table->header->capacity;
+    uint32_t used     = 0;
+
+    for (uint32_t slot = 0; slot < capacity; ++slot) {
+        if (table->slots[slot] > count) {
+            return -1;
+        }
+        used += (table->slots[slot] != 0);
+    }
+    // with at most half of the slots in use every lookup ends at an empty slot,
+    // the entries themselves are not parsed
+    return used == count ? 0 : -1;
+}
+
+void e2e_table_copy(const e2e_table_t *table, void *block)
+{
+    const e2e_table_header_t *header = table->header;
+    uint32_t                  count  = header->count;
+    uint8_t                  *base   = (uint8_t *)block;
+
+    // header, hash slots, ids and configs are immutable after construction
+    memset(block, 0, (size_t)header->size);
+    memcpy(block, header, (size_t)header->counters_offset);
+
+    int64_t  *counters = (int64_t *)(base + header->counters_offset);
+    uint8_t  *statuses = base + header->statuses_offset;
+    uint64_t *frames   = (uint64_t *)(base + header->frames_offset);
+    uint64_t *errors   = (uint64_t *)(base + header->errors_offset);
+    for (uint32_t i = 0; i < count; ++i) {
+        counters[i] = e2e_atomic_load_i64(&table->counters[i]);
+        statuses[i] = e2e_atomic_load_u8(&table->statuses[i]);
+        frames[i]   = e2e_atomic_load_u64(&table->frames[i]);
+        errors[i]   = e2e_atomic_load_u64(&table->errors[i]);
+    }
+}
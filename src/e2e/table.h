@@ -0,0 +1,116 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef TABLE_H
+#define TABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atomics.h"
+#include "e2elib.h"
+#include "recorder.h"
+
+#define E2E_TABLE_MAGIC     "E2ETABLE"
+#define E2E_TABLE_VERSION   1u
+#define E2E_TABLE_ALIGNMENT 64u
+#define E2E_TABLE_MAX_COUNT 0x40000000u
+
+// The message table is a single memory block: this header followed by the hash
+// slots and one array per column. Offsets are relative to the start of the block.
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t count;    // number of messages
+    uint32_t capacity; // number of hash slots, power of two
+    uint32_t reserved;
+    uint64_t size; // size of the whole block in bytes
+    uint64_t slots_offset;
+    uint64_t ids_offset;
+    uint64_t configs_offset;
+    uint64_t counters_offset;
+    uint64_t statuses_offset;
+    uint64_t frames_offset;
+    uint64_t errors_offset;
+} e2e_table_header_t;
+
+typedef struct {
+    e2e_table_header_t *header;
+    bool                owned; // block was allocated by e2e_table_create()
+    uint32_t           *slots; // index + 1 of the message, 0 for an empty slot
+    uint64_t           *ids;
+    e2e_config_t       *configs;
+    e2e_atomic_i64_t   *counters; // last received counter, -1 before the first valid frame
+    e2e_atomic_u8_t    *statuses; // E2E_STATUS_* of the last check
+    e2e_atomic_u64_t   *frames;   // number of checked frames
+    e2e_atomic_u64_t   *errors;   // number of frames with E2E_STATUS_ERROR
+    e2e_atomic_ptr_t    recorder; // e2e_recorder_t which records the checks, may be NULL
+} e2e_table_t;
+
+// Open addressing index of 64 bit ids. slots holds index + 1 of the id in
+// ids, 0 marks an empty slot. capacity must be e2e_hash_capacity(count).
+uint32_t e2e_hash_capacity(uint32_t count);
+
+// Add ids[index] to the index, returns -1 if the id is already in use.
+int      e2e_hash_insert(uint32_t *slots, uint32_t capacity, const uint64_t *ids, uint32_t index);
+
+// Returns the index of id or -1 if the id is unknown.
+int64_t  e2e_hash_find(const uint32_t *slots, uint32_t capacity, const uint64_t *ids, uint64_t id);
+
+// Size of the memory block of a table with count messages
+uint64_t e2e_table_size(uint32_t count);
+
+// Lay out an empty table with count messages in a caller provided, 8 byte
+// aligned block, e.g. shared memory. Returns -1 if the block is too small.
+int      e2e_table_init(e2e_table_t *table, void *block, size_t size, uint32_t count);
+
+// Same as e2e_table_init() in a block which is allocated and owned by the table
+int      e2e_table_create(e2e_table_t *table, uint32_t count);
+void     e2e_table_destroy(e2e_table_t *table);
+
+// Point the column pointers into an existing block, returns -1 if the header
+// is invalid. The block must be 8 byte aligned.
+int      e2e_table_bind(e2e_table_t *table, void *block, size_t size);
+
+// Check the hash slots of a bound block which was not created by this process,
+// returns -1 if a lookup could leave the columns. The configurations are not
+// validated, e2e_config_frame_length() keeps even a corrupted one within the frame.
+int      e2e_table_validate(const e2e_table_t *table);
+
+// Copy the table into block, which must hold table->header->size bytes. The
+// state columns are read atomically, so concurrent checks are allowed.
+void     e2e_table_copy(const e2e_table_t *table, void *block);
+
+// Returns -1 if the id is already in use.
+int      e2e_table_insert(e2e_table_t *table, uint32_t index, uint64_t id, const e2e_config_t *config);
+
+// Returns the message index or -1 if the id is unknown.
+int64_t  e2e_table_find(const e2e_table_t *table, uint64_t id);
+
+// Check a frame against the configuration of message index, update its
+// sequence state and return the E2E_STATUS_* value. The state is updated
+// with atomic operations only, so concurrent calls need no lock. time is
+// only passed on to the recorder, E2E_RECORDER_NOW stands for the current time.
+uint8_t  e2e_table_check(e2e_table_t   *table,
+                         uint32_t       index,
+                         uint64_t       time,
+                         const uint8_t *data_ptr,
+                         size_t         data_len);
+
+// Same as e2e_table_check() but looks up the message by id, returns
+// E2E_STATUS_UNKNOWN_ID if the id is not in the table.
+uint8_t  e2e_table_check_id(e2e_table_t   *table,
+                            uint64_t       id,
+                            uint64_t       time,
+                            const uint8_t *data_ptr,
+                            size_t         data_len);
+
+// Install a recorder which sees every subsequent check. It must outlive the
+// table or be removed with e2e_table_set_recorder(table, NULL) while no check runs.
+void     e2e_table_set_recorder(e2e_table_t *table, e2e_recorder_t *recorder);
+
+void     e2e_table_reset(e2e_table_t *table);
+
+#endif
@@ -33,7 +33,7 @@ void uint64_to_littleendian(uint8_t *target, uint64_t value)
 }
 
 // read uint16_t from littleendian byte order buffer
-uint16_t littleendian_to_uint16(uint8_t *source)
+uint16_t littleendian_to_uint16(const uint8_t *source)
 {
     uint16_t value = 0;
     size_t   len   = sizeof(value);
@@ -44,7 +44,7 @@ uint16_t littleendian_to_uint16(uint8_t *source)
 }
 
 // read uint32_t from littleendian byte order buffer
-uint32_t littleendian_to_uint32(uint8_t *source)
+uint32_t littleendian_to_uint32(const uint8_t *source)
 {
     uint32_t value = 0;
     size_t   len   = sizeof(value);
@@ -55,7 +55,7 @@ uint32_t littleendian_to_uint32(uint8_t *source)
 }
 
 // read uint64_t from littleendian byte order buffer
-uint64_t littleendian_to_uint64(uint8_t *source)
+uint64_t littleendian_to_uint64(const uint8_t *source)
 {
     uint64_t value = 0;
     size_t   len   = sizeof(value);
@@ -93,7 +93,7 @@ void uint64_to_bigendian(uint8_t *target, uint64_t value)
 }
 
 // read uint16_t from bigendian byte order buffer
-uint16_t bigendian_to_uint16(uint8_t *source)
+uint16_t bigendian_to_uint16(const uint8_t *source)
 {
     uint16_t value = 0;
     size_t   len   = sizeof(value);
@@ -104,7 +104,7 @@ uint16_t bigendian_to_uint16(uint8_t *source)
 }
 
 // read uint32_t from bigendian byte order buffer
-uint32_t bigendian_to_uint32(uint8_t *source)
+uint32_t bigendian_to_uint32(const uint8_t *source)
 {
     uint32_t value = 0;
     size_t   len   = sizeof(value);
@@ -115,7 +115,7 @@ uint32_t bigendian_to_uint32(uint8_t *source)
 }
 
 // read uint64_t from bigendian byte order buffer
-uint64_t bigendian_to_uint64(uint8_t *source)
+uint64_t bigendian_to_uint64(const uint8_t *source)
 {
     uint64_t value = 0;
     size_t   len   = sizeof(value);
@@ -0,0 +1,318 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "atomics.h"
+#include "e2elib.h"
+#include "module.h"
+#include "ring.h"
+#include "table.h"
+
+// frames which are checked before the stop flag is read again
+#define VERIFIER_BATCH 256u
+
+typedef struct {
+    PyObject_HEAD
+    PyObject          *router;
+    PyObject          *input;
+    PyObject          *output;
+    e2e_table_t       *table;
+    e2e_ring_t        *input_ring;
+    e2e_ring_t        *output_ring;
+    bool               errors_only;
+    long long          idle_time; // microseconds
+    PyThread_type_lock wakeup;    // held by the owner, released to stop the thread
+    PyThread_type_lock done;      // held while the thread runs
+    bool               running;   // thread was started and not yet joined
+    e2e_atomic_u64_t   stop;
+    e2e_atomic_u64_t   processed;
+    e2e_atomic_u64_t   failed;
+} VerifierObject;
+
+// Check the frames of the input ring and post the results, returns the number
+// of checked frames. A frame is only taken when the output ring has room for
+// its result, so no result is lost and no frame is checked twice.
+static uint32_t verifier_process(VerifierObject *self)
+{
+    e2e_ring_t *input  = self->input_ring;
+    e2e_ring_t *output = self->output_ring;
+    uint32_t    count  = 0;
+
+    while (count < VERIFIER_BATCH) {
+        e2e_ring_slot_t *in = e2e_ring_peek(input);
+        if (in == NULL) {
+            break;
+        }
+        e2e_ring_slot_t *out = e2e_ring_reserve(output);
+        if (out == NULL) {
+            break;
+        }
+
+        const uint8_t *data   = e2e_ring_slot_data(in);
+        uint32_t       length = (in->length > input->frame_size) ? input->frame_size : in->length;
+        uint8_t        status = e2e_table_check_id(self->table, in->id, in->time, data, length);
+        if (status != E2E_STATUS_OK) {
+            e2e_atomic_add_u64(&self->failed, 1);
+        }
+        if (!self->errors_only || status != E2E_STATUS_OK) {
+            uint32_t copied = (length > output->frame_size) ? output->frame_size : length;
+            out->id         = in->id;
+            out->time       = in->time;
+            out->length     = copied;
+            out->status     = status;
+            memcpy(e2e_ring_slot_data(out), data, copied);
+            e2e_ring_commit(output);
+        }
+        e2e_ring_release(input);
+        ++count;
+    }
+    e2e_atomic_add_u64(&self->processed, count);
+    return count;
+}
+
+// Thread function, runs without the GIL and without touching Python objects
+static void verifier_run(void *arg)
+{
+    VerifierObject *self = (VerifierObject *)arg;
+
+    while (!e2e_atomic_load_acquire_u64(&self->stop)) {
+        if (verifier_process(self) > 0) {
+            continue;
+        }
+        // nothing to do, sleep until the idle time elapsed or close() wakes us up
+        if (PyThread_acquire_lock_timed(self->wakeup, self->idle_time, 0) == PY_LOCK_ACQUIRED) {
+            PyThread_release_lock(self->wakeup);
+        }
+    }
+    PyThread_release_lock(self->done);
+}
+
+// Stop the thread and wait for it
+static void verifier_join(VerifierObject *self)
+{
+    if (!self->running) {
+        return;
+    }
+    e2e_atomic_store_release_u64(&self->stop, 1);
+    PyThread_release_lock(self->wakeup);
+    PyThread_acquire_lock(self->done, WAIT_LOCK);
+    PyThread_release_lock(self->done);
+    self->running = false;
+}
+
+// clang-format off
+PyDoc_STRVAR(verifier_doc,
+             "Verifier(router: Router, input: FrameRing, output: FrameRing, *, errors_only: bool = False, idle_time: int = 100)\n"
+             "Background thread which checks frames outside of the GIL. \n"
+             "\n"
+             "The producer, e.g. a capture thread, appends received frames to `input` with \n"
+             ":meth:`FrameRing.push`. The verifier takes them in order, checks them with \n"
+             "`router` and posts the results to `output`, which Python polls with \n"
+             "``output.drain(status=True)``. Both rings are single producer, single consumer: \n"
+             "while the verifier runs it is the only consumer of `input` and the only \n"
+             "producer of `output`. When `output` is full, the verifier waits instead of \n"
+             "dropping results. \n"
+             "\n"
+             "The thread starts on construction and runs until :meth:`close` is called or \n"
+             "the verifier is garbage collected. \n"
+             "\n"
+             ":param Router router: \n"
+             "    Configurations and counter state of the messages \n"
+             ":param FrameRing input: \n"
+             "    Ring of received frames \n"
+             ":param FrameRing output: \n"
+             "    Ring of results. The status of every frame is stored with the frame data, \n"
+             "    which is truncated to the `frame_size` of this ring. \n"
+             ":param bool errors_only: \n"
+             "    Post only frames whose status is not :attr:`~e2e.E2E_STATUS_OK`. \n"
+             ":param int idle_time: \n"
+             "    Time in microseconds the thread sleeps when `input` is empty \n");
+// clang-format on
+static PyObject *verifier_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    PyObject     *router;
+    PyObject     *input;
+    PyObject     *output;
+    int           errors_only = 0;
+    long long     idle_time   = 100;
+    static char  *kwlist[]    = {"router", "input", "output", "errors_only", "idle_time", NULL};
+    module_state *state       = get_module_state_by_type(type);
+
+    if (state == NULL) {
+        return NULL;
+    }
+    if (!PyArg_ParseTupleAndKeywords(args,
+                                     kwargs,
+                                     "OOO|$pL:Verifier",
+                                     kwlist,
+                                     &router,
+                                     &input,
+                                     &output,
+                                     &errors_only,
+                                     &idle_time)) {
+        return NULL;
+    }
+    if (idle_time <= 0 || idle_time > 1000000) {
+        PyErr_SetString(PyExc_ValueError, "Parameter \"idle_time\" must be between 1 and 1000000.");
+        return NULL;
+    }
+    if (input == output) {
+        PyErr_SetString(PyExc_ValueError, "Parameters \"input\" and \"output\" must be different rings.");
+        return NULL;
+    }
+
+    e2e_table_t *table       = table_from_object(state, router);
+    e2e_ring_t  *input_ring  = (table == NULL) ? NULL : ring_from_object(state, input);
+    e2e_ring_t  *output_ring = (input_ring == NULL) ? NULL : ring_from_object(state, output);
+    if (output_ring == NULL) {
+        return NULL;
+    }
+
+    VerifierObject *self = (VerifierObject *)alloc_instance(type);
+    if (self == NULL) {
+        return NULL;
+    }
+    Py_INCREF(router);
+    Py_INCREF(input);
+    Py_INCREF(output);
+    self->router      = router;
+    self->input       = input;
+    self->output      = output;
+    self->table       = table;
+    self->input_ring  = input_ring;
+    self->output_ring = output_ring;
+    self->errors_only = errors_only;
+    self->idle_time   = idle_time;
+    e2e_atomic_store_u64(&self->stop, 0);
+    e2e_atomic_store_u64(&self->processed, 0);
+    e2e_atomic_store_u64(&self->failed, 0);
+
+    self->wakeup = PyThread_allocate_lock();
+    self->done   = PyThread_allocate_lock();
+    if (self->wakeup == NULL || self->done == NULL) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    PyThread_acquire_lock(self->wakeup, WAIT_LOCK);
+    PyThread_acquire_lock(self->done, WAIT_LOCK);
+    if (PyThread_start_new_thread(verifier_run, self) == (unsigned long)-1) {
+        PyErr_SetString(PyExc_RuntimeError, "Cannot start the verifier thread.");
+        Py_DECREF(self);
+        return NULL;
+    }
+    self->running = true;
+    return (PyObject *)self;
+}
+
+static void verifier_dealloc(PyObject *self)
+{
+    PyTypeObject   *type     = Py_TYPE(self);
+    VerifierObject *verifier = (VerifierObject *)self;
+
+    // the thread does not need the GIL, so it can be joined while holding it
+    verifier_join(verifier);
+    if (verifier->wakeup != NULL) {
+        PyThread_free_lock(verifier->wakeup);
+    }
+    if (verifier->done != NULL) {
+        PyThread_free_lock(verifier->done);
+    }
+    Py_XDECREF(verifier->router);
+    Py_XDECREF(verifier->input);
+    Py_XDECREF(verifier->output);
+    freefunc tp_free = (freefunc)PyType_GetSlot(type, Py_tp_free);
+    tp_free(self);
+    Py_DECREF(type);
+}
+
+// clang-format off
+PyDoc_STRVAR(verifier_close_doc,
+             "close() -> None\n"
+             "Stop the thread and wait until it has finished. Frames which are still in \n"
+             "`input` stay there. Calling :meth:`close` again has no effect.");
+// clang-format on
+static PyObject *verifier_close(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    VerifierObject *verifier = (VerifierObject *)self;
+
+#ifdef Py_GIL_DISABLED
+    Py_BEGIN_CRITICAL_SECTION(self);
+#endif
+    Py_BEGIN_ALLOW_THREADS
+    verifier_join(verifier);
+    Py_END_ALLOW_THREADS
+#ifdef Py_GIL_DISABLED
+    Py_END_CRITICAL_SECTION();
+#endif
+    Py_RETURN_NONE;
+}
+
+static PyObject *verifier_enter(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    Py_INCREF(self);
+    return self;
+}
+
+static PyObject *verifier_exit(PyObject *self, PyObject *Py_UNUSED(args))
+{
+    return verifier_close(self, NULL);
+}
+
+static PyObject *verifier_get_running(PyObject *self, void *closure)
+{
+    return PyBool_FromLong(((VerifierObject *)self)->running);
+}
+
+static PyObject *verifier_get_processed(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLongLong(e2e_atomic_load_u64(&((VerifierObject *)self)->processed));
+}
+
+static PyObject *verifier_get_failed(PyObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLongLong(e2e_atomic_load_u64(&((VerifierObject *)self)->failed));
+}
+
+// clang-format off
+static PyMethodDef verifier_methods[] = {
+    {"close",     (PyCFunction)verifier_close, METH_NOARGS,  verifier_close_doc},
+    {"__enter__", (PyCFunction)verifier_enter, METH_NOARGS,  NULL},
+    {"__exit__",  (PyCFunction)verifier_exit,  METH_VARARGS, NULL},
+    {NULL} // sentinel
+};
+
+static PyGetSetDef verifier_getset[] = {
+    {"running",   verifier_get_running,   NULL, "True until close() was called", NULL},
+    {"processed", verifier_get_processed, NULL, "Number of checked frames", NULL},
+    {"failed",    verifier_get_failed,    NULL, "Number of frames whose status was not E2E_STATUS_OK", NULL},
+    {NULL} // sentinel
+};
+
+static PyType_Slot verifier_slots[] = {
+    {Py_tp_doc,     (void *)verifier_doc},
+    {Py_tp_new,     verifier_new},
+    {Py_tp_dealloc, verifier_dealloc},
+    {Py_tp_methods, verifier_methods},
+    {Py_tp_getset,  verifier_getset},
+    {0, NULL}
+};
+// clang-format on
+
+static PyType_Spec verifier_spec = {.name      = "e2e.Verifier",
+                                    .basicsize = sizeof(VerifierObject),
+                                    .itemsize  = 0,
+                                    .flags     = Py_TPFLAGS_DEFAULT,
+                                    .slots     = verifier_slots};
+
+int verifier_init_type(PyObject *module, module_state *state)
+{
+    state->verifier_type = add_type(module, &verifier_spec);
+    return (state->verifier_type == NULL) ? -1 : 0;
+}
@@ -0,0 +1,211 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wheel.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// index of the lowest set bit, x must not be 0
+static uint32_t wheel_ctz(uint64_t x)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctzll(x);
+#endif
+}
+
+int e2e_wheel_create(e2e_wheel_t *wheel, uint32_t count, uint64_t now)
+{
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->now       = now;
+    wheel->count     = count;
+    wheel->next      = calloc((size_t)count + 1, sizeof(uint32_t));
+    wheel->prev      = calloc((size_t)count + 1, sizeof(uint32_t));
+    wheel->slots     = calloc((size_t)count + 1, sizeof(uint32_t));
+    wheel->deadlines = calloc((size_t)count + 1, sizeof(uint64_t));
+    if (wheel->next == NULL || wheel->prev == NULL || wheel->slots == NULL || wheel->deadlines == NULL) {
+        e2e_wheel_destroy(wheel);
+        return -1;
+    }
+    return 0;
+}
+
+void e2e_wheel_destroy(e2e_wheel_t *wheel)
+{
+    free(wheel->next);
+    free(wheel->prev);
+    free(wheel->slots);
+    free(wheel->deadlines);
+    memset(wheel, 0, sizeof(*wheel));
+}
+
+static void wheel_link(e2e_wheel_t *wheel, uint32_t index)
+{
+    uint64_t deadline = wheel->deadlines[index];
+    uint32_t slot;
+
+    if (deadline <= wheel->now) {
+        deadline = wheel->now + 1;
+    }
+    else if (deadline - wheel->now >= E2E_WHEEL_HORIZON) {
+        deadline = wheel->now + E2E_WHEEL_HORIZON - 1;
+    }
+
+    uint64_t delta = deadline - wheel->now;
+    uint32_t level = 0;
+    while (level < E2E_WHEEL_LEVELS - 1 && delta >= ((uint64_t)1 << (E2E_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    slot = level * E2E_WHEEL_SLOTS + ((uint32_t)(deadline >> (E2E_WHEEL_BITS * level)) & E2E_WHEEL_MASK);
+
+    uint32_t head       = wheel->heads[slot];
+    wheel->next[index]  = head;
+    wheel->prev[index]  = 0;
+    wheel->slots[index] = slot + 1;
+    if (head != 0) {
+        wheel->prev[head - 1] = index + 1;
+    }
+    wheel->heads[slot]                      = index + 1;
+    wheel->occupied[slot / E2E_WHEEL_SLOTS] |= (uint64_t)1 << (slot & E2E_WHEEL_MASK);
+}
+
+static void wheel_unlink(e2e_wheel_t *wheel, uint32_t index)
+{
+    uint32_t slot = wheel->slots[index] - 1;
+    uint32_t next = wheel->next[index];
+    uint32_t prev = wheel->prev[index];
+
+    if (prev != 0) {
+        wheel->next[prev - 1] = next;
+    }
+    else {
+        wheel->heads[slot] = next;
+        if (next == 0) {
+            wheel->occupied[slot / E2E_WHEEL_SLOTS] &= ~((uint64_t)1 << (slot & E2E_WHEEL_MASK));
+        }
+    }
+    if (next != 0) {
+        wheel->prev[next - 1] = prev;
+    }
+    wheel->slots[index] = 0;
+}
+
+void e2e_wheel_arm(e2e_wheel_t *wheel, uint32_t index, uint64_t deadline)
+{
+    if (wheel->slots[index] != 0) {
+        wheel_unlink(wheel, index);
+    }
+    wheel->deadlines[index] = deadline;
+    wheel_link(wheel, index);
+}
+
+void e2e_wheel_disarm(e2e_wheel_t *wheel, uint32_t index)
+{
+    if (wheel->slots[index] != 0) {
+        wheel_unlink(wheel, index);
+    }
+}
+
+bool e2e_wheel_armed(const e2e_wheel_t *wheel, uint32_t index) { return wheel->slots[index] != 0; }
+
+// Detach all entries of a slot and either expire or re-insert them
+static void wheel_flush(e2e_wheel_t *wheel, uint32_t slot, e2e_wheel_expire_t expire, void *context)
+{
+    uint32_t entry                           = wheel->heads[slot];
+    wheel->heads[slot]                       = 0;
+    wheel->occupied[slot / E2E_WHEEL_SLOTS] &= ~((uint64_t)1 << (slot & E2E_WHEEL_MASK));
+
+    while (entry != 0) {
+        uint32_t index      = entry - 1;
+        entry               = wheel->next[index];
+        wheel->slots[index] = 0;
+        if (wheel->deadlines[index] <= wheel->now) {
+            expire(context, index);
+        }
+        else {
+            wheel_link(wheel, index);
+        }
+    }
+}
+
+// Return the first tick after now at which an occupied slot is flushed, or
+// UINT64_MAX if the wheel is empty. Slot s of level l is flushed at the ticks
+// whose bits [6 * l, 6 * l + 6) equal s and whose lower bits are all 0.
+static uint64_t wheel_next_tick(const e2e_wheel_t *wheel)
+{
+    uint64_t next = UINT64_MAX;
+    for (uint32_t level = 0; level < E2E_WHEEL_LEVELS; ++level) {
+        uint64_t occupied = wheel->occupied[level];
+        if (occupied == 0) {
+            continue;
+        }
+        uint32_t shift   = E2E_WHEEL_BITS * level;
+        uint64_t current = wheel->now >> shift;
+        // rotate the bitmap so that bit 0 is the slot after the current one
+        uint32_t rotate  = (uint32_t)(current + 1) & E2E_WHEEL_MASK;
+        uint64_t rotated = (occupied >> rotate) | (occupied << ((E2E_WHEEL_SLOTS - rotate) & E2E_WHEEL_MASK));
+        uint64_t tick    = (current + 1 + wheel_ctz(rotated)) << shift;
+        if (tick < next) {
+            next = tick;
+        }
+    }
+    return next;
+}
+
+void e2e_wheel_advance(e2e_wheel_t *wheel, uint64_t now, e2e_wheel_expire_t expire, void *context)
+{
+    if (now <= wheel->now) {
+        return;
+    }
+    if (now - wheel->now >= E2E_WHEEL_HORIZON) {
+        // stepping through every tick would take longer than re-inserting all entries
+        wheel->now = now;
+        for (uint32_t index = 0; index < wheel->count; ++index) {
+            if (wheel->slots[index] == 0) {
+                continue;
+            }
+            wheel_unlink(wheel, index);
+            if (wheel->deadlines[index] <= now) {
+                expire(context, index);
+            }
+            else {
+                wheel_link(wheel, index);
+            }
+        }
+        return;
+    }
+
+    while (wheel->now < now) {
+        // jump to the next tick at which an occupied slot comes up, the ticks
+        // in between would only flush empty slots
+        uint64_t tick = wheel_next_tick(wheel);
+        if (tick > now) {
+            wheel->now = now;
+            break;
+        }
+        wheel->now = tick;
+
+        // move the entries of the upper levels down when their slot comes up
+        uint32_t level = 1;
+        while (level < E2E_WHEEL_LEVELS && (tick & (((uint64_t)1 << (E2E_WHEEL_BITS * level)) - 1)) == 0) {
+            level++;
+        }
+        while (--level > 0) {
+            uint32_t slot =
+                level * E2E_WHEEL_SLOTS + ((uint32_t)(tick >> (E2E_WHEEL_BITS * level)) & E2E_WHEEL_MASK);
+            wheel_flush(wheel, slot, expire, context);
+        }
+        wheel_flush(wheel, (uint32_t)tick & E2E_WHEEL_MASK, expire, context);
+    }
+}
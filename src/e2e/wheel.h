@@ -0,0 +1,53 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+#ifndef WHEEL_H
+#define WHEEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define E2E_WHEEL_LEVELS 4u
+#define E2E_WHEEL_BITS   6u
+#define E2E_WHEEL_SLOTS  (1u << E2E_WHEEL_BITS)
+#define E2E_WHEEL_MASK   (E2E_WHEEL_SLOTS - 1u)
+
+// Deadlines further away than the horizon are parked in the last slot of the
+// top level and re-inserted when it cascades.
+#define E2E_WHEEL_HORIZON ((uint64_t)1 << (E2E_WHEEL_BITS * E2E_WHEEL_LEVELS))
+
+// Hierarchical timing wheel over a fixed number of entries. Every entry can be
+// armed with one deadline, measured in ticks. Arming, re-arming and disarming
+// are O(1), entries are linked into their slot with index + 1, 0 ends a list.
+// One bit per non-empty slot lets e2e_wheel_advance() skip empty ticks.
+typedef struct {
+    uint64_t  now; // current tick
+    uint32_t  count;
+    uint64_t  occupied[E2E_WHEEL_LEVELS]; // bit s is set if slot s of the level holds entries
+    uint32_t  heads[E2E_WHEEL_LEVELS * E2E_WHEEL_SLOTS];
+    uint32_t *next;
+    uint32_t *prev;
+    uint32_t *slots; // slot + 1 of the entry, 0 if the entry is not armed
+    uint64_t *deadlines;
+} e2e_wheel_t;
+
+// Called for every expired entry. The entry is disarmed before the call and
+// may be armed again from within the callback.
+typedef void (*e2e_wheel_expire_t)(void *context, uint32_t index);
+
+int  e2e_wheel_create(e2e_wheel_t *wheel, uint32_t count, uint64_t now);
+void e2e_wheel_destroy(e2e_wheel_t *wheel);
+
+// Arm or re-arm entry index. Deadlines which are not in the future expire on
+// the next tick.
+void e2e_wheel_arm(e2e_wheel_t *wheel, uint32_t index, uint64_t deadline);
+void e2e_wheel_disarm(e2e_wheel_t *wheel, uint32_t index);
+bool e2e_wheel_armed(const e2e_wheel_t *wheel, uint32_t index);
+
+// Advance the wheel to tick now and call expire for every entry with a
+// deadline at or before now. The cost grows with the number of expirations
+// and cascades, not with the number of ticks in between.
+void e2e_wheel_advance(e2e_wheel_t *wheel, uint64_t now, e2e_wheel_expire_t expire, void *context);
+
+#endif
@@ -0,0 +1,9 @@
+import e2e
+
+
+def p05_frame(counter: int, data_id: int = 0x1234) -> bytes:
+    """Return an 8 byte profile 5 frame with the given counter."""
+    data = bytearray(8)
+    data[2] = (counter - 1) & 0xFF
+    e2e.p05.e2e_p05_protect(data, len(data) - 2, data_id, increment_counter=True)
+    return bytes(data)
@@ -0,0 +1,124 @@
+import os
+import random
+import subprocess
+import sys
+import types
+
+import pytest
+
+from e2e import _backend, _e2e
+
+try:
+    from e2e import _cffi
+except (ImportError, OSError):
+    _cffi = None
+
+needs_cffi = pytest.mark.skipif(
+    _cffi is None, reason="cffi or _e2e_core (CMake option E2E_CFFI) is missing"
+)
+
+INTEGERS = [0, 1, 2, 3, 5, 12, 19, 20, 24, 0xFFFF, 0x10003, 2**32 + 5, -1, 2**70]
+
+
+def _extension(name):
+    module = types.ModuleType(name)
+    _e2e._init_submodule(module)
+    return module
+
+
+def _call(func, data, args, kwargs):
+    """Return the result or the exception, and the buffer afterwards."""
+    if isinstance(data, bytearray):
+        data = bytearray(data)
+    try:
+        result = func(data, *args, **kwargs)
+    except TypeError:
+        result = TypeError  # the messages of the argument parsers differ
+    except ValueError as exc:
+        result = (ValueError, str(exc))
+    return result, bytes(data) if isinstance(data, bytearray) else None
+
+
+def _data(rng):
+    size = rng.choice([0, 1, 2, 3, 4, 5, 8, 11, 12, 19, 20, 21, 32])
+    raw = bytes(rng.getrandbits(8) for _ in range(size))
+    return rng.choice([raw, bytearray(raw), memoryview(raw), bytearray(raw)])
+
+
+def _integer(rng):
+    return rng.choice(INTEGERS + [rng.randrange(64)])
+
+
+def _offset(rng, length):
+    # around the last offset at which the header still lies within length
+    if 0 <= length <= 0xFFFF and rng.random() < 0.5:
+        return rng.randrange(max(0, length - 24), length + 4)
+    return rng.choice([0, 33, 0xFFFF, -1])
+
+
+@needs_cffi
+@pytest.mark.parametrize("name", sorted(_cffi.FUNCTIONS) if _cffi else [])
+def test_same_as_extension(name):
+    rng = random.Random(name)
+    extension = _extension(name)
+    for func in _cffi.FUNCTIONS[name]:
+        reference = getattr(extension, func.__name__)
+        for _ in range(3000):
+            data = _data(rng)
+            if func.__name__.startswith("calculate_crc"):
+                args, kwargs = (), {}
+                if rng.random() < 0.5:
+                    kwargs["start_value"] = _integer(rng)
+                    kwargs["first_call"] = rng.random() < 0.5
+            elif name == "e2e.p02":
+                ids = bytes(rng.choice([16, 16, 15]))
+                args, kwargs = (_integer(rng), ids), {}
+            else:
+                args, kwargs = (_integer(rng), _integer(rng)), {}
+                if name == "e2e.p01" and rng.random() < 0.5:
+                    kwargs["data_id_mode"] = rng.choice([0, 1, 2, 3, _integer(rng)])
+                elif rng.random() < 0.5:
+                    kwargs["offset"] = _offset(rng, args[0])
+            if func.__name__.endswith("protect") and rng.random() < 0.5:
+                kwargs["increment_counter"] = rng.random() < 0.5
+            expected = _call(reference, data, args, kwargs)
+            assert _call(func, data, args, kwargs) == expected, (data, args, kwargs)
+
+
+@needs_cffi
+def test_round_trip():
+    data = bytearray(8)
+    _cffi.e2e_p05_protect(data, 6, 0x1234)
+    assert _extension("e2e.p05").e2e_p05_check(data, 6, 0x1234)
+    assert _cffi.e2e_p05_check(data, 6, 0x1234)
+    assert _cffi.calculate_crc32(b"123456789") == 0xCBF43926
+    with pytest.raises(ValueError, match="must be mutable"):
+        _cffi.e2e_p05_protect(b"\x00" * 8, 6, 0x1234)
+
+
+@needs_cffi
+def test_profile_tests_with_cffi():
+    directory = os.path.dirname(__file__)
+    tests = ["test_crc.py"] + [f"test_p0{n}.py" for n in "124567"]
+    env = dict(os.environ, E2E_BACKEND="cffi")
+    code = "import e2e._backend as b; assert b.NAME == 'cffi', b.NAME"
+    subprocess.run([sys.executable, "-c", code], check=True, env=env)
+    subprocess.run(
+        [sys.executable, "-m", "pytest", "-q", "-p", "no:cacheprovider", *tests],
+        check=True,
+        cwd=directory,
+        env=env,
+    )
+
+
+def test_default_backend():
+    expected = "cffi" if sys.implementation.name == "pypy" and _cffi else "extension"
+    if "E2E_BACKEND" not in os.environ:
+        assert _backend.NAME == expected
+    import e2e.p05
+
+    module = _cffi if _backend.NAME == "cffi" else _e2e
+    assert e2e.p05.e2e_p05_check.__module__ == "e2e.p05"
+    assert (e2e.p05.e2e_p05_check is getattr(_cffi, "e2e_p05_check", None)) == (
+        module is _cffi
+    )
@@ -0,0 +1,226 @@
+import ctypes
+import os
+
+import pytest
+
+import e2e
+from e2e.crc import CRC32_CHECK, calculate_crc32
+from e2e.p05 import e2e_p05_check, e2e_p05_protect
+
+# members of e2e_capi_t in e2e_capi.h
+CRC_FUNC = ctypes.CFUNCTYPE(
+    ctypes.c_uint32, ctypes.c_char_p, ctypes.c_uint32, ctypes.c_uint32, ctypes.c_bool
+)
+
+
+class CAPI(ctypes.Structure):
+    _fields_ = [
+        ("version", ctypes.c_uint32),
+        ("size", ctypes.c_uint32),
+        ("crc8", ctypes.c_void_p),
+        ("crc8h2f", ctypes.c_void_p),
+        ("crc16", ctypes.c_void_p),
+        ("crc16arc", ctypes.c_void_p),
+        ("crc32", CRC_FUNC),
+        ("crc32p4", ctypes.c_void_p),
+        ("crc64", ctypes.c_void_p),
+        ("compute_p01_crc", ctypes.c_void_p),
+        ("compute_p02_crc", ctypes.c_void_p),
+        ("compute_p04_crc", ctypes.c_void_p),
+        ("compute_p05_crc", ctypes.c_void_p),
+        ("compute_p06_crc", ctypes.c_void_p),
+        ("compute_p07_crc", ctypes.c_void_p),
+        ("p01_protect", ctypes.c_void_p),
+        ("p01_check", ctypes.c_void_p),
+        ("p02_protect", ctypes.c_void_p),
+        ("p02_check", ctypes.c_void_p),
+        ("p04_protect", ctypes.c_void_p),
+        ("p04_check", ctypes.c_void_p),
+        (
+            "p05_protect",
+            ctypes.CFUNCTYPE(
+                None,
+                ctypes.c_void_p,
+                ctypes.c_uint16,
+                ctypes.c_uint16,
+                ctypes.c_uint16,
+                ctypes.c_bool,
+            ),
+        ),
+        (
+            "p05_check",
+            ctypes.CFUNCTYPE(
+                ctypes.c_int,
+                ctypes.c_void_p,
+                ctypes.c_uint16,
+                ctypes.c_uint16,
+                ctypes.c_uint16,
+                ctypes.c_void_p,
+            ),
+        ),
+        ("p06_protect", ctypes.c_void_p),
+        ("p06_check", ctypes.c_void_p),
+        ("p07_protect", ctypes.c_void_p),
+        ("p07_check", ctypes.c_void_p),
+        ("config_error", ctypes.CFUNCTYPE(ctypes.c_char_p, ctypes.c_void_p)),
+        (
+            "config_frame_length",
+            ctypes.CFUNCTYPE(ctypes.c_uint32, ctypes.c_void_p, ctypes.c_size_t),
+        ),
+        (
+            "config_protect",
+            ctypes.CFUNCTYPE(
+                ctypes.c_int,
+                ctypes.c_void_p,
+                ctypes.c_void_p,
+                ctypes.c_size_t,
+                ctypes.c_bool,
+            ),
+        ),
+        (
+            "config_check",
+            ctypes.CFUNCTYPE(
+                ctypes.c_int,
+                ctypes.c_void_p,
+                ctypes.c_char_p,
+                ctypes.c_size_t,
+                ctypes.c_void_p,
+            ),
+        ),
+        # version 2, PYFUNCTYPE keeps the GIL and raises the exception on NULL
+        ("ring_from_object", ctypes.PYFUNCTYPE(ctypes.c_void_p, ctypes.py_object)),
+        ("ring_reserve", ctypes.CFUNCTYPE(ctypes.c_void_p, ctypes.c_void_p)),
+        ("ring_commit", ctypes.CFUNCTYPE(None, ctypes.c_void_p)),
+        ("ring_slot_data", ctypes.CFUNCTYPE(ctypes.c_void_p, ctypes.c_void_p)),
+        (
+            "ring_push",
+            ctypes.CFUNCTYPE(
+                ctypes.c_bool,
+                ctypes.c_void_p,
+                ctypes.c_uint64,
+                ctypes.c_uint64,
+                ctypes.c_uint32,
+                ctypes.c_char_p,
+                ctypes.c_uint32,
+            ),
+        ),
+    ]
+
+
+class Config(ctypes.Structure):
+    # e2e_config_t in e2elib.h
+    _fields_ = [
+        ("profile", ctypes.c_uint8),
+        ("data_id_mode", ctypes.c_uint8),
+        ("reserved", ctypes.c_uint16),
+        ("length", ctypes.c_uint32),
+        ("data_id", ctypes.c_uint32),
+        ("offset", ctypes.c_uint32),
+        ("max_delta_counter", ctypes.c_uint32),
+        ("data_id_list", ctypes.c_uint8 * 16),
+    ]
+
+
+class RingSlot(ctypes.Structure):
+    # e2e_ring_slot_t in ring.h
+    _fields_ = [
+        ("id", ctypes.c_uint64),
+        ("time", ctypes.c_uint64),
+        ("length", ctypes.c_uint32),
+        ("status", ctypes.c_uint32),
+    ]
+
+
+def _capi() -> CAPI:
+    get_pointer = ctypes.pythonapi.PyCapsule_GetPointer
+    get_pointer.restype = ctypes.c_void_p
+    get_pointer.argtypes = [ctypes.py_object, ctypes.c_char_p]
+    return CAPI.from_address(get_pointer(e2e._C_API, b"e2e._C_API"))
+
+
+def test_capsule():
+    api = _capi()
+    assert api.version >= 2
+    assert api.size >= ctypes.sizeof(CAPI)
+
+
+def test_crc():
+    api = _capi()
+    assert api.crc32(b"123456789", 9, 0, True) == CRC32_CHECK
+    data = os.urandom(100)
+    assert api.crc32(data, len(data), 0, True) == calculate_crc32(data)
+
+
+def test_protect_check():
+    api = _capi()
+    frame = (ctypes.c_uint8 * 8)()
+    api.p05_protect(ctypes.addressof(frame), 6, 0x1234, 0, True)
+    data = bytearray(8)
+    e2e_p05_protect(data, 6, 0x1234, increment_counter=True)
+    assert bytes(frame) == data
+    assert e2e_p05_check(bytes(frame), 6, 0x1234)
+
+    counter = ctypes.c_uint32()
+    assert api.p05_check(ctypes.addressof(frame), 6, 0x1234, 0, ctypes.byref(counter)) == 0
+    assert counter.value == 1
+    frame[7] ^= 1
+    assert api.p05_check(ctypes.addressof(frame), 6, 0x1234, 0, None) != 0
+
+
+@pytest.mark.parametrize("profile, length", [(4, 21), (5, 10), (6, 14), (7, 29)])
+def test_config_header_beyond_length(profile, length):
+    # the header at offset 10 does not fit into length, nothing must read past it
+    api = _capi()
+    config = Config(profile=profile, length=length, offset=10, max_delta_counter=1)
+    assert b"offset" in api.config_error(ctypes.byref(config))
+    bad_frame = 1  # E2E_RESULT_BAD_FRAME
+    for size in range(64):
+        frame = (ctypes.c_uint8 * max(size, 1))()
+        assert api.config_frame_length(ctypes.byref(config), size) == 0
+        assert api.config_check(ctypes.byref(config), bytes(size), size, None) == bad_frame
+        result = api.config_protect(ctypes.byref(config), frame, size, True)
+        assert result == bad_frame
+        assert bytes(frame) == bytes(max(size, 1))
+
+    config.length += 1
+    assert api.config_error(ctypes.byref(config)) is None
+    frame = (ctypes.c_uint8 * 64)()
+    assert api.config_protect(ctypes.byref(config), frame, config.length + 2, True) == 0
+    assert api.config_check(ctypes.byref(config), bytes(frame), config.length + 2, None) == 0
+
+
+def test_ring_producer():
+    api = _capi()
+    frame_ring = e2e.FrameRing(bytearray(128 + 3 * 32), 8)
+    ring = api.ring_from_object(frame_ring)
+    assert ring
+    with pytest.raises(TypeError):
+        api.ring_from_object(bytearray(8))
+
+    assert api.ring_push(ring, 0x100, 1000, e2e.E2E_STATUS_OK, b"\x01\x02\x03", 3)
+    assert not api.ring_push(ring, 0x100, 1000, 0, bytes(9), 9)
+
+    slot = api.ring_reserve(ring)
+    assert slot
+    header = RingSlot.from_address(slot)
+    header.id, header.time, header.length = 0x200, 2000, 8
+    header.status = e2e.E2E_STATUS_ERROR
+    ctypes.memmove(api.ring_slot_data(slot), b"abcdefgh", 8)
+    api.ring_commit(ring)
+
+    assert api.ring_push(ring, 0x300, 3000, 0, None, 0)
+    assert not api.ring_push(ring, 0x400, 4000, 0, b"x", 1)
+    assert not api.ring_reserve(ring)
+
+    assert frame_ring.drain(status=True) == [
+        (0x100, 1000, e2e.E2E_STATUS_OK, b"\x01\x02\x03"),
+        (0x200, 2000, e2e.E2E_STATUS_ERROR, b"abcdefgh"),
+        (0x300, 3000, 0, b""),
+    ]
+    assert api.ring_push(ring, 0x400, 4000, 0, b"x", 1)
+    assert frame_ring.pop() == (0x400, 4000, b"x")
+
+
+def test_get_include():
+    for header in ("e2e_capi.h", "crclib.h", "e2elib.h", "ring.h", "atomics.h"):
+        assert os.path.isfile(os.path.join(e2e.get_include(), header))
@@ -1,5 +1,14 @@
+import json
+import os
+import random
+import subprocess
+import sys
 from concurrent.futures import ThreadPoolExecutor
+
+import pytest
+
 import e2e.crc
+from e2e import _crctune
 
 
 # fmt: off
@@ -247,3 +256,151 @@ def test_multithreaded():
             tasks.append(pool.submit(test_calculate_crc64))
         for task in tasks:
             task.result()
+
+
+CALCULATE = {
+    "crc8": e2e.crc.calculate_crc8,
+    "crc8h2f": e2e.crc.calculate_crc8_h2f,
+    "crc16": e2e.crc.calculate_crc16,
+    "crc16arc": e2e.crc.calculate_crc16_arc,
+    "crc32": e2e.crc.calculate_crc32,
+    "crc32p4": e2e.crc.calculate_crc32_p4,
+    "crc64": e2e.crc.calculate_crc64,
+}
+WIDTHS = {
+    "crc8": 8,
+    "crc8h2f": 8,
+    "crc16": 16,
+    "crc16arc": 16,
+    "crc32": 32,
+    "crc32p4": 32,
+    "crc64": 64,
+}
+
+
+@pytest.fixture
+def kernel_cache(monkeypatch, tmp_path):
+    path = tmp_path / "crc_kernels.json"
+    monkeypatch.setenv("E2E_CRC_CACHE", str(path))
+    monkeypatch.delenv("E2E_CRC_KERNEL", raising=False)
+    yield path
+    monkeypatch.undo()
+    _crctune.load()
+
+
+def _results(seed):
+    rng = random.Random(seed)
+    results = []
+    for name, func in CALCULATE.items():
+        for length in range(0, 70):
+            data = bytes(rng.getrandbits(8) for _ in range(length))
+            start = rng.getrandbits(WIDTHS[name])
+            results.append(func(data))
+            results.append(func(data, start_value=start, first_call=False))
+    return results
+
+
+def test_kernels_agree(kernel_cache, monkeypatch):
+    results = {}
+    for kernel in _crctune.KERNELS:
+        monkeypatch.setenv("E2E_CRC_KERNEL", kernel)
+        _crctune.load()
+        algorithms = e2e.crc.backend()["algorithms"]
+        assert all(value["kernel"] == kernel for value in algorithms.values())
+        results[kernel] = _results(1234)
+
+        # the profile modules follow the selection as well
+        data = bytearray(100)
+        e2e.p07.e2e_p07_protect(data, 100, 0x0A0B0C0D)
+        assert e2e.p07.e2e_p07_check(data, 100, 0x0A0B0C0D)
+    assert results["table"] == results["slice8"]
+
+
+def test_backend(kernel_cache):
+    backend = e2e.crc.backend()
+    assert backend["cache"] == str(kernel_cache)
+    assert backend["kernels"] == ["table", "slice8"]
+    assert set(backend["algorithms"]) == set(CALCULATE)
+    for value in backend["algorithms"].values():
+        assert value["source"] == "default"
+        assert value["kernel"] in ("table", "slice8", "table+slice8")
+
+
+def test_tune(kernel_cache):
+    thresholds = e2e.crc.tune(sizes=(8, 64), min_time=1e-4, repeats=1)
+    assert set(thresholds) == set(CALCULATE)
+    assert all(t in (8, 64, _crctune.NEVER) for t in thresholds.values())
+    backend = e2e.crc.backend()
+    for name, value in backend["algorithms"].items():
+        assert value["threshold"] == thresholds[name]
+        assert value["source"] == "tuned"
+
+    with open(kernel_cache) as f:
+        cache = json.load(f)
+    assert cache["cpus"][backend["cpu"]] == thresholds
+
+    _crctune.load()
+    algorithms = e2e.crc.backend()["algorithms"]
+    assert all(value["source"] == "cache" for value in algorithms.values())
+
+
+def test_kernel_environment(kernel_cache, monkeypatch):
+    monkeypatch.setenv("E2E_CRC_KERNEL", "crc32=table,crc64=slice8")
+    _crctune.load()
+    algorithms = e2e.crc.backend()["algorithms"]
+    assert algorithms["crc32"] == {
+        "threshold": _crctune.NEVER,
+        "kernel": "table",
+        "source": "environment",
+    }
+    assert algorithms["crc64"]["kernel"] == "slice8"
+    assert algorithms["crc16"]["source"] == "default"
+
+    monkeypatch.setenv("E2E_CRC_KERNEL", "crc32=pclmul")
+    with pytest.warns(UserWarning, match="pclmul"):
+        _crctune.load()
+
+
+@pytest.mark.parametrize(
+    "cpus",
+    [
+        [],
+        "cpus",
+        {"CPU": []},
+        {"CPU": {"crc32": "fast"}},
+        {"CPU": {"crc32": -1}},
+        {"CPU": {"crc32": 2**32}},
+        {"CPU": {"crc32": 16.5}},
+        {"CPU": {"crc32": None}},
+    ],
+)
+def test_invalid_cache(kernel_cache, cpus):
+    # a stale or hand-edited cache is ignored with a warning
+    if isinstance(cpus, dict):
+        cpus = {_crctune.cpu_signature(): cpus["CPU"]}
+    kernel_cache.write_text(json.dumps({"version": 1, "cpus": cpus}))
+    with pytest.warns(UserWarning, match="invalid"):
+        _crctune.load()
+    algorithms = e2e.crc.backend()["algorithms"]
+    assert all(value["source"] == "default" for value in algorithms.values())
+
+    # importing e2e must not fail either
+    code = "import e2e.crc; e2e.crc.calculate_crc32(b'123456789')"
+    env = dict(os.environ, E2E_CRC_CACHE=str(kernel_cache))
+    subprocess.run([sys.executable, "-W", "ignore", "-c", code], check=True, env=env)
+
+    # tune replaces the invalid data
+    thresholds = e2e.crc.tune(sizes=(8,), min_time=1e-5, repeats=1)
+    with open(kernel_cache) as f:
+        assert json.load(f)["cpus"][_crctune.cpu_signature()] == thresholds
+
+
+def test_cache_keeps_valid_thresholds(kernel_cache):
+    entry = {"crc8": 8, "crc32": "fast", "crc128": 4}
+    cache = {"version": 1, "cpus": {_crctune.cpu_signature(): entry}}
+    kernel_cache.write_text(json.dumps(cache))
+    with pytest.warns(UserWarning, match="crc32"):
+        _crctune.load()
+    algorithms = e2e.crc.backend()["algorithms"]
+    assert algorithms["crc8"] == {"threshold": 8, "kernel": "slice8", "source": "cache"}
+    assert algorithms["crc32"]["source"] == "default"
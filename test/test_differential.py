@@ -0,0 +1,62 @@
+import importlib.util
+import random
+from pathlib import Path
+
+import pytest
+
+import e2e
+from e2e import _crctune
+
+_PATH = Path(__file__).parents[1] / "fuzz" / "crc_differential.py"
+
+_CHECK_VALUES = {
+    "calculate_crc8": e2e.crc.CRC8_CHECK,
+    "calculate_crc8_h2f": e2e.crc.CRC8H2F_CHECK,
+    "calculate_crc16": e2e.crc.CRC16_CHECK,
+    "calculate_crc16_arc": e2e.crc.CRC16ARC_CHECK,
+    "calculate_crc32": e2e.crc.CRC32_CHECK,
+    "calculate_crc32_p4": e2e.crc.CRC32P4_CHECK,
+    "calculate_crc64": e2e.crc.CRC64_CHECK,
+}
+
+
+@pytest.fixture(scope="module")
+def differential():
+    if not _PATH.exists():
+        pytest.skip("fuzz/crc_differential.py not available")
+    spec = importlib.util.spec_from_file_location("crc_differential", _PATH)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    yield module
+    _crctune.load()  # undo the kernels which the cases forced
+
+
+def test_reference_check_values(differential):
+    assert set(differential.ALGORITHMS) == set(_CHECK_VALUES)
+    for name, reference in differential.ALGORITHMS.items():
+        assert reference(b"123456789") == _CHECK_VALUES[name], name
+
+
+def test_crc_differential(differential):
+    for seed in range(300):
+        differential.fuzz_crc(random.Random(seed), 1024)
+
+
+def test_crc_differential_kernels(differential, monkeypatch):
+    # every case runs with the table kernel, slice-by-8 and a mixed selection
+    thresholds = []
+    force_kernels = differential.force_kernels
+
+    def record(algorithms, threshold):
+        thresholds.append(threshold)
+        force_kernels(algorithms, threshold)
+
+    monkeypatch.setattr(differential, "force_kernels", record)
+    differential.fuzz_crc(random.Random(0), 1024)
+    assert thresholds[:2] == [_crctune.NEVER, 0]
+    assert 0 < thresholds[2] < 100
+
+
+def test_profile_differential(differential):
+    for seed in range(300):
+        differential.fuzz_profile(random.Random(seed))
@@ -0,0 +1,92 @@
+import mmap
+
+import pytest
+
+import e2e
+from e2e.p05 import e2e_p05_check, e2e_p05_protect
+from e2e.p07 import e2e_p07_check
+
+
+def test_protect_check():
+    config = e2e.Config(5, 0x1234)
+    buffer = bytearray(8 * 100)
+    view = e2e.FrameView(buffer)
+    assert len(view) == len(buffer)
+    assert not view.readonly
+    for offset in range(0, len(buffer), 8):
+        view.protect(offset, 8, config)
+
+    # the same bytes as with e2e_p05_protect on every slice
+    expected = bytearray(8)
+    e2e_p05_protect(expected, 6, 0x1234)
+    assert buffer[:8] == expected
+    for offset in range(0, len(buffer), 8):
+        assert view.check(offset, 8, config)
+        assert e2e_p05_check(buffer[offset : offset + 8], 6, 0x1234)
+
+    buffer[17] ^= 0xFF
+    assert not view.check(16, 8, config)
+    assert view.check(24, 8, config)
+    # the frame is too short for the header
+    assert not view.check(0, 2, config)
+    with pytest.raises(ValueError):
+        view.protect(0, 2, config)
+
+
+def test_header_offset_and_length():
+    config = e2e.Config(7, 0x0A0B0C0D, offset=4, length=32)
+    buffer = bytearray(3 + 40)
+    view = e2e.FrameView(buffer)
+    view.protect(3, 40, config, increment_counter=False)
+    assert e2e_p07_check(buffer[3:], 32, 0x0A0B0C0D, offset=4)
+    assert view.check(3, 40, config)
+
+
+def test_bounds():
+    config = e2e.Config(5, 0x1234)
+    view = e2e.FrameView(bytearray(16))
+    for offset, length in ((9, 8), (16, 1), (-1, 8), (0, -1), (0, 17)):
+        with pytest.raises(IndexError):
+            view.check(offset, length, config)
+        with pytest.raises(IndexError):
+            view.protect(offset, length, config)
+    view.protect(8, 8, config)
+    with pytest.raises(TypeError):
+        view.check(0, 8, None)
+
+
+def test_readonly():
+    config = e2e.Config(5, 0x1234)
+    data = bytearray(8)
+    e2e_p05_protect(data, 6, 0x1234)
+    view = e2e.FrameView(bytes(data))
+    assert view.readonly
+    assert view.check(0, 8, config)
+    with pytest.raises(ValueError):
+        view.protect(0, 8, config)
+
+
+def test_release():
+    config = e2e.Config(5, 0x1234)
+    buffer = bytearray(16)
+    with e2e.FrameView(buffer) as view:
+        with pytest.raises(BufferError):
+            buffer.extend(b"\x00")
+        view.protect(0, 8, config)
+    assert view.released
+    buffer.extend(b"\x00")
+    with pytest.raises(ValueError):
+        view.check(0, 8, config)
+    with pytest.raises(ValueError):
+        len(view)
+    view.release()
+
+
+def test_mmap():
+    config = e2e.Config(5, 0x1234)
+    with mmap.mmap(-1, 4096) as mapped:
+        view = e2e.FrameView(mapped)
+        for offset in range(0, 4096, 64):
+            view.protect(offset, 64, config)
+        assert all(view.check(offset, 64, config) for offset in range(0, 4096, 64))
+        view.release()
@@ -0,0 +1,259 @@
+import random
+
+import pytest
+
+import e2e
+from e2e.p01 import (
+    E2E_P01_DATAID_ALT,
+    E2E_P01_DATAID_BOTH,
+    E2E_P01_DATAID_LOW,
+    E2E_P01_DATAID_NIBBLE,
+    e2e_p01_check,
+    e2e_p01_protect,
+)
+from e2e.p02 import e2e_p02_check, e2e_p02_protect
+from e2e.p04 import e2e_p04_check, e2e_p04_protect
+from e2e.p05 import e2e_p05_check, e2e_p05_protect
+from e2e.p06 import e2e_p06_check, e2e_p06_protect
+from e2e.p07 import e2e_p07_check, e2e_p07_protect
+
+P01_MODES = {
+    E2E_P01_DATAID_BOTH: {"data_id_mode": "both"},
+    E2E_P01_DATAID_ALT: {"data_id_mode": "alternating"},
+    E2E_P01_DATAID_LOW: {"data_id_mode": "low"},
+    E2E_P01_DATAID_NIBBLE: {
+        "data_id_mode": "nibble",
+        "data_id": (12, 4),
+        "data_id_shift": 8,
+    },
+}
+
+
+def p01_layout(data_id_mode):
+    return e2e.Layout(
+        "crc8",
+        0,
+        counter=(8, 4),
+        counter_max=14,
+        byteorder="little",
+        data_id_position="prepend",
+        crc_initial=0x00,
+        crc_xor=0x00,
+        **P01_MODES[data_id_mode],
+    )
+
+
+P02 = e2e.Layout("crc8h2f", 0, counter=(8, 4), data_id_mode="list")
+P04 = e2e.Layout("crc32p4", 64, length=(0, 16), counter=(16, 16), data_id=(32, 32))
+P05 = e2e.Layout("crc16", 0, counter=(16, 8), byteorder="little", data_id_mode="both")
+P06 = e2e.Layout("crc16", 0, length=(16, 16), counter=(32, 8), data_id_mode="both")
+P07 = e2e.Layout("crc64", 0, length=(64, 32), counter=(96, 32), data_id=(128, 32))
+
+
+def compare(layout, protect, check, data_id, frame_length, size, offset=0):
+    # protect and check the same random frames with the layout and the built-in profile
+    rng = random.Random(size * 31 + offset)
+    data = bytearray(rng.getrandbits(8) for _ in range(size))
+    expected = bytearray(data)
+    for _ in range(20):
+        protect(expected)
+        layout.protect(data, data_id, offset=offset, length=frame_length)
+        assert data == expected
+        assert check(expected)
+        assert layout.check(data, data_id, offset=offset, length=frame_length)
+    for index in range(frame_length):
+        data[index] ^= 0x10
+        assert layout.check(data, data_id, offset=offset, length=frame_length) is check(data)
+        data[index] ^= 0x10
+
+
+@pytest.mark.parametrize("data_id_mode", list(P01_MODES))
+@pytest.mark.parametrize("size", [3, 8, 40])
+def test_p01(data_id_mode, size):
+    layout = p01_layout(data_id_mode)
+    length = size - 1
+    compare(
+        layout,
+        lambda d: e2e_p01_protect(d, length, 0x1234, data_id_mode=data_id_mode),
+        lambda d: e2e_p01_check(d, length, 0x1234, data_id_mode=data_id_mode),
+        0x1234,
+        size,
+        size,
+    )
+
+
+@pytest.mark.parametrize("size", [3, 8, 40])
+def test_p02(size):
+    data_id_list = bytes(range(0x40, 0x50))
+    length = size - 1
+    compare(
+        P02,
+        lambda d: e2e_p02_protect(d, length, data_id_list),
+        lambda d: e2e_p02_check(d, length, data_id_list),
+        data_id_list,
+        size,
+        size,
+    )
+
+
+@pytest.mark.parametrize("size", [12, 20, 100])
+@pytest.mark.parametrize("offset", [0, 4])
+def test_p04(size, offset):
+    length = size + offset
+    compare(
+        P04,
+        lambda d: e2e_p04_protect(d, length, 0x0A0B0C0D, offset=offset),
+        lambda d: e2e_p04_check(d, length, 0x0A0B0C0D, offset=offset),
+        0x0A0B0C0D,
+        length,
+        length + 2,  # the bytes after length are not protected
+        offset,
+    )
+
+
+@pytest.mark.parametrize("size", [4, 8, 100])
+@pytest.mark.parametrize("offset", [0, 1])
+def test_p05(size, offset):
+    length = size - 2
+    compare(
+        P05,
+        lambda d: e2e_p05_protect(d, length, 0x1234, offset=offset),
+        lambda d: e2e_p05_check(d, length, 0x1234, offset=offset),
+        0x1234,
+        size,
+        size + 4,
+        offset,
+    )
+
+
+@pytest.mark.parametrize("size", [5, 8, 100])
+@pytest.mark.parametrize("offset", [0, 3])
+def test_p06(size, offset):
+    length = size + offset
+    compare(
+        P06,
+        lambda d: e2e_p06_protect(d, length, 0x1234, offset=offset),
+        lambda d: e2e_p06_check(d, length, 0x1234, offset=offset),
+        0x1234,
+        length,
+        length + 2,
+        offset,
+    )
+
+
+@pytest.mark.parametrize("size", [20, 32, 100])
+@pytest.mark.parametrize("offset", [0, 8])
+def test_p07(size, offset):
+    length = size + offset
+    compare(
+        P07,
+        lambda d: e2e_p07_protect(d, length, 0x0A0B0C0D, offset=offset),
+        lambda d: e2e_p07_check(d, length, 0x0A0B0C0D, offset=offset),
+        0x0A0B0C0D,
+        length,
+        length + 2,
+        offset,
+    )
+
+
+def test_custom_layout():
+    # CRC at the end, counter in the high nibble of byte 1, data_id in front of the data
+    layout = e2e.Layout(
+        "crc16arc",
+        7 * 8,
+        counter=(12, 4),
+        data_id_mode="both",
+        data_id_position="prepend",
+        coverage=[(0, -2)],
+    )
+    assert layout.algorithm == "crc16arc"
+    assert layout.header_length == 9
+    assert layout.counter_max == 15
+    assert layout.data_id_mode == "both"
+
+    data = bytearray(9)
+    layout.protect(data, 0x1234, increment_counter=False)
+    layout.protect(data, 0x1234)
+    assert data[1] == 0x10
+    expected = e2e.crc.calculate_crc16_arc(b"\x12\x34" + data[:7])
+    assert data[7:] == expected.to_bytes(2, "big")
+    assert layout.check(data, 0x1234)
+    assert not layout.check(data, 0x1235)
+
+    # the byte after the covered range is not protected
+    data.append(0xAA)
+    layout.protect(data, 0x1234, length=9)
+    data[9] = 0x55
+    assert layout.check(data, 0x1234, length=9)
+
+
+def test_counter_range():
+    layout = p01_layout(E2E_P01_DATAID_BOTH)
+    data = bytearray(8)
+    data[1] = 0x0F
+    assert not layout.check(data, 0x1234)
+    layout.protect(data, 0x1234)
+    assert data[1] & 0x0F == 1
+
+    data = bytearray(8)
+    data[1] = 0x0F
+    layout = e2e.Layout("crc8", 0, counter=(8, 4), counter_max=14, data_id_mode="list")
+    with pytest.raises(ValueError):
+        layout.protect(data, bytes(15), increment_counter=False)
+    with pytest.raises(ValueError):
+        layout.protect(data, bytes(16))
+
+
+def test_frame_errors():
+    data = bytearray(8)
+    with pytest.raises(ValueError):
+        P07.protect(data, 0)
+    with pytest.raises(ValueError):
+        P07.check(bytes(8), 0)
+    with pytest.raises(ValueError):
+        P05.protect(bytes(8), 0)
+    with pytest.raises(ValueError):
+        P05.protect(data, 0, offset=6)
+    with pytest.raises(ValueError):
+        P05.protect(data, 0, length=9)
+    with pytest.raises(ValueError):
+        P05.protect(data, 0, offset=-1)
+    with pytest.raises(ValueError):
+        P05.protect(data, 1 << 32)
+    with pytest.raises(TypeError):
+        P05.protect(data, "1")
+
+    layout = e2e.Layout("crc8", 0, length=(8, 8))
+    layout.protect(bytearray(255), 0)
+    with pytest.raises(ValueError):
+        layout.protect(bytearray(256), 0)
+
+
+@pytest.mark.parametrize(
+    "kwargs",
+    [
+        {"algorithm": "crc12", "crc": 0},
+        {"algorithm": "crc16", "crc": 4},
+        {"algorithm": "crc16", "crc": 0, "counter": (4, 8)},
+        {"algorithm": "crc16", "crc": 0, "counter": (20, 12)},
+        {"algorithm": "crc16", "crc": 0, "counter": (6, 4)},
+        {"algorithm": "crc16", "crc": 0, "counter": (8, 64)},
+        {"algorithm": "crc16", "crc": 0, "counter": (8, 8), "data_id": (8, 8)},
+        {"algorithm": "crc16", "crc": 0, "counter": (8, 8), "counter_max": 256},
+        {"algorithm": "crc16", "crc": 0, "counter": (8, 8), "counter_max": 0},
+        {"algorithm": "crc16", "crc": 0, "counter": [16, 8]},
+        {"algorithm": "crc16", "crc": 0, "byteorder": "middle"},
+        {"algorithm": "crc16", "crc": 0, "data_id_mode": "high"},
+        {"algorithm": "crc16", "crc": 0, "data_id_mode": "alternating"},
+        {"algorithm": "crc16", "crc": 0, "data_id_mode": "both", "data_id_size": 5},
+        {"algorithm": "crc16", "crc": 0, "data_id_position": "middle"},
+        {"algorithm": "crc16", "crc": 0, "crc_initial": 0x10000},
+        {"algorithm": "crc16", "crc": 0, "coverage": []},
+        {"algorithm": "crc16", "crc": 0, "coverage": [(4, 2)]},
+        {"algorithm": "crc16", "crc": 0, "coverage": [(0, None)] * 5},
+        {"algorithm": "crc16", "crc": 0, "coverage": [0, 1]},
+    ],
+)
+def test_invalid_layout(kwargs):
+    with pytest.raises((TypeError, ValueError)):
+        e2e.Layout(**kwargs)
@@ -0,0 +1,145 @@
+import random
+
+import pytest
+
+import e2e
+
+
+def test_monitor_construction():
+    monitor = e2e.DeadlineMonitor({0x100: 10, 0x200: 20}, cycle_times={0x100: 5})
+    assert len(monitor) == 2
+    assert 0x100 in monitor
+    assert 0x300 not in monitor
+    assert list(monitor.ids) == [0x100, 0x200]
+    assert list(monitor.last_seen) == [-1, -1]
+    assert monitor.cycle_histogram.shape == (2, 32)
+    assert monitor.cycle_histogram.readonly
+
+    assert len(e2e.DeadlineMonitor([(1, 10), (2, 10)])) == 2
+
+    with pytest.raises(ValueError):
+        e2e.DeadlineMonitor({1: 0})
+    with pytest.raises(ValueError):
+        e2e.DeadlineMonitor([(1, 10), (1, 10)])
+    with pytest.raises(ValueError):
+        e2e.DeadlineMonitor({1: 10}, cycle_times={2: 10})
+    with pytest.raises(ValueError):
+        e2e.DeadlineMonitor({1: 10}, resolution=0)
+    with pytest.raises(TypeError):
+        e2e.DeadlineMonitor({1: "10"})
+
+
+def test_monitor_poll():
+    monitor = e2e.DeadlineMonitor({0x100: 10, 0x200: 25}, start=1000)
+    assert monitor.poll(1009) == []
+    assert monitor.poll(1010) == [0x100]
+    assert monitor.poll(1020) == []
+    assert list(monitor.timed_out) == [1, 0]
+
+    monitor.received(0x100, 1020)
+    assert list(monitor.timed_out) == [0, 0]
+    assert monitor.poll(1024) == []
+    assert monitor.poll(1025) == [0x200]
+    assert monitor.poll(1029) == []
+    monitor.received(0x100, 1029)
+    assert monitor.poll(1038) == []
+    assert monitor.poll(1039) == [0x100]
+    assert monitor.last_seen[0] == 1029
+
+    # time does not run backwards
+    assert monitor.poll(0) == []
+
+    with pytest.raises(KeyError):
+        monitor.received(0x300, 1040)
+
+
+def test_monitor_resolution():
+    # deadlines are rounded up to full ticks
+    monitor = e2e.DeadlineMonitor({1: 1500}, resolution=1000)
+    assert monitor.poll(1999) == []
+    assert monitor.poll(2000) == [1]
+
+
+def test_monitor_long_timeouts():
+    timeouts = {1: 1, 2: 100, 3: 5000, 4: 300_000, 5: 20_000_000, 6: 2**40}
+    monitor = e2e.DeadlineMonitor(timeouts)
+    for now in (0, 1, 99, 100, 4999, 5000, 299_999, 300_000, 19_999_999):
+        expected = [i for i, t in timeouts.items() if t == now]
+        assert monitor.poll(now) == expected, now
+    assert monitor.poll(20_000_000) == [5]
+    assert monitor.poll(2**40 - 1) == []
+    assert monitor.poll(2**40) == [6]
+
+
+def test_monitor_random():
+    rng = random.Random(0)
+    timeouts = {i: rng.randint(1, 5000) for i in range(200)}
+    monitor = e2e.DeadlineMonitor(timeouts)
+    deadlines = dict(timeouts)
+
+    now = 0
+    while now < 100_000:
+        now += rng.randint(1, 300)
+        for message_id in rng.sample(sorted(timeouts), 20):
+            monitor.received(message_id, now)
+            deadlines[message_id] = now + timeouts[message_id]
+        now += rng.randint(1, 300)
+        expected = sorted(i for i, d in deadlines.items() if d <= now)
+        assert sorted(monitor.poll(now)) == expected
+        for message_id in expected:
+            del deadlines[message_id]
+
+
+def test_monitor_nanoseconds():
+    # time.monotonic_ns() with resolution 1: the polls are millions of ticks
+    # apart and must still report every expiration exactly once
+    rng = random.Random(1)
+    start = 10**15
+    timeouts = {i: rng.randint(50, 150) * 1_000_000 + rng.randint(0, 999) for i in range(10_000)}
+    monitor = e2e.DeadlineMonitor(timeouts, start=start)
+    deadlines = {i: start + t for i, t in timeouts.items()}
+
+    now = start
+    for _ in range(40):
+        now += 5_000_000
+        expected = sorted(i for i, d in deadlines.items() if d <= now)
+        assert sorted(monitor.poll(now)) == expected
+        for message_id in expected:
+            monitor.received(message_id, now)
+            deadlines[message_id] = now + timeouts[message_id]
+    assert len(monitor.poll(now + 10**9)) == len(timeouts)
+
+
+def test_monitor_histograms():
+    monitor = e2e.DeadlineMonitor({1: 100}, cycle_times={1: 10})
+    for now in (0, 10, 20, 31, 40, 56):
+        monitor.received(1, now)
+    cycle = monitor.cycle_histogram.tolist()[0]
+    jitter = monitor.jitter_histogram.tolist()[0]
+    # cycle times 10, 10, 11, 9, 16
+    assert cycle[4] == 4  # [8, 16)
+    assert cycle[5] == 1  # [16, 32)
+    assert sum(cycle) == 5
+    # jitter 0, 0, 1, 1, 6
+    assert jitter[0] == 2
+    assert jitter[1] == 2
+    assert jitter[3] == 1
+    assert sum(jitter) == 5
+
+
+def test_monitor_received_batch():
+    monitor = e2e.DeadlineMonitor({1: 10, 2: 10})
+    ok = e2e.E2E_STATUS_OK
+    error = e2e.E2E_STATUS_ERROR
+    monitor.received_batch([1, 2, 3], [5, 5, 5], bytes([ok, error, ok]))
+    assert list(monitor.last_seen) == [5, -1]
+    assert monitor.poll(10) == [2]
+    assert monitor.poll(15) == [1]
+
+    monitor.received_batch([1, 2], [20, 21])
+    assert list(monitor.last_seen) == [20, 21]
+
+    with pytest.raises(ValueError):
+        monitor.received_batch([1, 2], [20])
+    with pytest.raises(ValueError):
+        monitor.received_batch([1, 2], [20, 21], b"\x00")
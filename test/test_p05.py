@@ -1,4 +1,7 @@
 from concurrent.futures import ThreadPoolExecutor
+
+import pytest
+
 import e2e
 
 
@@ -73,7 +76,13 @@ def test_e2e_p05_check():
     )
 
 
-def test_multithreaded():
+def test_offset_beyond_length():
+    # the header at offset must lie within length, this used to crash
+    with pytest.raises(ValueError):
+        e2e.p05.e2e_p05_check(bytes(20), 4, 0x1234, offset=10)
+    with pytest.raises(ValueError):
+        e2e.p05.e2e_p05_protect(bytearray(20), 4, 0x1234, offset=10)
+
     tasks = []
     with ThreadPoolExecutor() as pool:
         for _ in range(1000):
@@ -0,0 +1,56 @@
+import os
+import subprocess
+import sys
+
+import e2e
+
+
+def test_lazy_submodules():
+    code = (
+        "import sys\n"
+        "import e2e\n"
+        "assert not {'e2e.crc', 'e2e.p01', 'e2e.p05'} & set(sys.modules)\n"
+        "e2e.p05.e2e_p05_protect(bytearray(8), 6, 0x1234)\n"
+        "assert 'e2e.p05' in sys.modules and 'e2e.p01' not in sys.modules\n"
+        "import e2e.p01\n"
+        "from e2e import crc\n"
+        "assert crc.calculate_crc8(b'123456789') == crc.CRC8_CHECK\n"
+    )
+    subprocess.run([sys.executable, "-c", code], check=True)
+
+
+def test_import_time():
+    # typing, the statistics and the CRC kernel cache are loaded on first use,
+    # they used to make "import e2e" several times slower
+    code = (
+        "import sys\n"
+        "import e2e\n"
+        "slow = {'typing', 'json', 'e2e._stats', 'e2e._crctune'} & set(sys.modules)\n"
+        "assert not slow, slow\n"
+        "assert e2e.stats()['enabled'] is False\n"
+        "assert 'e2e._stats' in sys.modules and 'e2e._crctune' not in sys.modules\n"
+        "import e2e.p05\n"
+        "assert 'e2e._crctune' in sys.modules\n"
+    )
+    env = {k: v for k, v in os.environ.items() if not k.startswith("E2E_")}
+    subprocess.run([sys.executable, "-c", code], check=True, env=env)
+
+
+def test_import_environment():
+    code = (
+        "import e2e\n"
+        "assert e2e.stats()['enabled'] is True\n"
+        "from e2e import _crctune\n"
+        "assert _crctune.backend()['algorithms']['crc32']['kernel'] == 'table'\n"
+    )
+    env = dict(os.environ, E2E_STATS="1", E2E_CRC_KERNEL="table")
+    subprocess.run([sys.executable, "-c", code], check=True, env=env)
+
+
+def test_submodules():
+    for name in ("crc", "p01", "p02", "p04", "p05", "p06", "p07"):
+        assert name in dir(e2e)
+        module = getattr(e2e, name)
+        assert module.__name__ == f"e2e.{name}"
+    assert e2e.p05.e2e_p05_check.__module__ == "e2e.p05"
+    assert e2e.crc.calculate_crc32.__module__ == "e2e.crc"
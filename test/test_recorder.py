@@ -0,0 +1,88 @@
+import pytest
+
+import e2e
+from _frames import p05_frame
+
+
+def test_recorder_construction():
+    router = e2e.Router({0x100: e2e.Config(5, 0x1234, 6)})
+    assert router.recorder is None
+
+    recorder = e2e.FlightRecorder(router, depth=2, capacity=3, frame_size=4)
+    assert router.recorder is recorder
+    assert recorder.depth == 2
+    assert recorder.capacity == 3
+    assert recorder.frame_size == 4
+    assert recorder.errors == 0
+    assert recorder.dump() == []
+
+    with pytest.raises(ValueError):
+        e2e.FlightRecorder(router)
+    with pytest.raises(TypeError):
+        e2e.FlightRecorder(object())
+    with pytest.raises(ValueError):
+        e2e.FlightRecorder(e2e.Router({}), depth=257)
+    with pytest.raises(ValueError):
+        e2e.FlightRecorder(e2e.Router({}), capacity=0)
+
+
+def test_recorder_errors():
+    router = e2e.Router({0x100: e2e.Config(5, 0x1234, 6), 0x200: e2e.Config(5, 0x1234, 6)})
+    recorder = e2e.FlightRecorder(router, depth=2, capacity=3, frame_size=8)
+
+    for counter in (1, 2, 3):
+        assert router.check(0x100, p05_frame(counter)) == e2e.E2E_STATUS_OK
+    corrupted = bytearray(p05_frame(4))
+    corrupted[0] ^= 0xFF
+    assert router.check(0x100, corrupted) == e2e.E2E_STATUS_ERROR
+    assert router.check(0x100, p05_frame(6)) == e2e.E2E_STATUS_WRONGSEQUENCE
+    assert router.check(0x200, b"\x00") == e2e.E2E_STATUS_ERROR
+
+    errors = recorder.dump()
+    assert recorder.errors == 3
+    assert [(e["id"], e["status"], e["reason"]) for e in errors] == [
+        (0x100, e2e.E2E_STATUS_ERROR, "crc_mismatch"),
+        (0x100, e2e.E2E_STATUS_WRONGSEQUENCE, "sequence"),
+        (0x200, e2e.E2E_STATUS_ERROR, "bad_frame"),
+    ]
+
+    crc_error = errors[0]
+    assert crc_error["index"] == router.index(0x100)
+    assert crc_error["frame"] == bytes(corrupted)
+    assert crc_error["length"] == 8
+    assert crc_error["counter"] == 4
+    assert crc_error["received_crc"] == int.from_bytes(corrupted[0:2], "little")
+    assert crc_error["computed_crc"] == int.from_bytes(p05_frame(4)[0:2], "little")
+    assert crc_error["time"] > 0
+    # the last two good frames are the context
+    assert [(c, f) for _, c, f in crc_error["history"]] == [(2, p05_frame(2)), (3, p05_frame(3))]
+
+    assert errors[1]["counter"] == 6
+    assert errors[1]["received_crc"] == errors[1]["computed_crc"]
+    assert errors[2]["received_crc"] is None
+    assert errors[2]["history"] == []
+
+    # older errors are overwritten
+    router.check(0x200, b"\x00")
+    assert recorder.errors == 4
+    assert [e["reason"] for e in recorder.dump()] == ["sequence", "bad_frame", "bad_frame"]
+
+
+def test_recorder_verifier():
+    router = e2e.Router({0x100: e2e.Config(5, 0x1234, 6)})
+    recorder = e2e.FlightRecorder(router, depth=1, frame_size=4)
+    input = e2e.FrameRing(bytearray(128 + 8 * 32), 8)
+    output = e2e.FrameRing(bytearray(128 + 8 * 24), 0)
+
+    with e2e.Verifier(router, input, output, errors_only=True) as verifier:
+        input.push(0x100, 10, p05_frame(1))
+        input.push(0x100, 20, p05_frame(1))
+        while verifier.processed < 2:
+            pass
+
+    (error,) = recorder.dump()
+    assert error["time"] == 20
+    assert error["status"] == e2e.E2E_STATUS_REPEATED
+    assert error["frame"] == p05_frame(1)[:4]
+    assert error["length"] == 8
+    assert error["history"] == [(10, 1, p05_frame(1)[:4])]
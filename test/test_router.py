@@ -0,0 +1,318 @@
+import mmap
+import multiprocessing
+import sys
+from array import array
+from concurrent.futures import ThreadPoolExecutor
+
+try:
+    from multiprocessing import shared_memory
+except ImportError:  # Python 3.7
+    shared_memory = None
+
+import pytest
+
+import e2e
+from _frames import p05_frame
+
+
+def _p04_frame(counter: int, data_id: int = 0x0A0B0C0D) -> bytes:
+    data = bytearray(16)
+    data[2:4] = ((counter - 1) & 0xFFFF).to_bytes(2, "big")
+    e2e.p04.e2e_p04_protect(data, len(data), data_id, increment_counter=True)
+    return bytes(data)
+
+
+def test_config():
+    config = e2e.Config(4, 0x0A0B0C0D, 16, offset=0, max_delta_counter=3)
+    assert config.profile == 4
+    assert config.data_id == 0x0A0B0C0D
+    assert config.length == 16
+    assert config.offset == 0
+    assert config.max_delta_counter == 3
+    assert config.data_id_list is None
+
+    config = e2e.Config(2, data_id_list=bytes(range(16)))
+    assert config.data_id_list == bytes(range(16))
+
+    with pytest.raises(ValueError):
+        e2e.Config(3)
+    with pytest.raises(ValueError):
+        e2e.Config(2)
+    with pytest.raises(ValueError):
+        e2e.Config(2, data_id_list=b"\x00")
+    with pytest.raises(ValueError):
+        e2e.Config(5, 0x10000)
+    with pytest.raises(ValueError):
+        e2e.Config(1, 0x1234, data_id_mode=4)
+    with pytest.raises(ValueError):
+        e2e.Config(1, 0x1234, max_delta_counter=15)
+    with pytest.raises(ValueError):
+        e2e.Config(4, 0x0A0B0C0D, max_delta_counter=0)
+
+
+@pytest.mark.parametrize(
+    "profile, data_id, shortest",
+    [(4, 0x0A0B0C0D, 22), (5, 0x1234, 11), (6, 0x1234, 15), (7, 0x0A0B0C0D, 30)],
+)
+def test_config_header_beyond_length(profile, data_id, shortest):
+    # the header at offset 10 must lie within length, a shorter length used to
+    # crash every check of profile 5 and 6
+    with pytest.raises(ValueError, match="offset"):
+        e2e.Config(profile, data_id, shortest - 1, offset=10)
+    config = e2e.Config(profile, data_id, shortest, offset=10)
+
+    router = e2e.Router([(1, config)])
+    view = e2e.FrameView(bytearray(64))
+    for size in range(40):
+        assert router.check(1, bytes(size)) != e2e.E2E_STATUS_OK
+        assert not view.check(0, size, config)
+
+    # frames derive their length, the header must still fit
+    router = e2e.Router([(1, e2e.Config(profile, data_id, offset=10))])
+    for size in range(40):
+        assert router.check(1, bytes(size)) != e2e.E2E_STATUS_OK
+
+
+def test_router_construction():
+    config = e2e.Config(5, 0x1234)
+    router = e2e.Router({0x100: config, 0x200: config})
+    assert len(router) == 2
+    assert 0x100 in router
+    assert 0x300 not in router
+    assert "a" not in router
+    assert router.index(0x100) != router.index(0x200)
+    with pytest.raises(KeyError):
+        router.index(0x300)
+
+    router = e2e.Router([(1, config), (2, config)])
+    assert len(router) == 2
+
+    assert len(e2e.Router({})) == 0
+
+    with pytest.raises(ValueError):
+        e2e.Router([(1, config), (1, config)])
+    with pytest.raises(TypeError):
+        e2e.Router({1: "config"})
+    with pytest.raises(TypeError):
+        e2e.Router([1])
+
+
+def test_router_check_sequence():
+    router = e2e.Router(
+        {
+            0x100: e2e.Config(4, 0x0A0B0C0D, 16, max_delta_counter=2),
+            0x200: e2e.Config(5, 0x1234, 6),
+        }
+    )
+    assert router.check(0x100, _p04_frame(10)) == e2e.E2E_STATUS_OK
+    assert router.check(0x100, _p04_frame(11)) == e2e.E2E_STATUS_OK
+    assert router.check(0x100, _p04_frame(11)) == e2e.E2E_STATUS_REPEATED
+    assert router.check(0x100, _p04_frame(13)) == e2e.E2E_STATUS_OKSOMELOST
+    assert router.check(0x100, _p04_frame(16)) == e2e.E2E_STATUS_WRONGSEQUENCE
+    assert router.check(0x100, _p04_frame(17)) == e2e.E2E_STATUS_OK
+
+    # counter wrap around
+    assert router.check(0x200, p05_frame(255)) == e2e.E2E_STATUS_OK
+    assert router.check(0x200, p05_frame(0)) == e2e.E2E_STATUS_OK
+
+    # corrupted frame does not change the counter state
+    frame = bytearray(p05_frame(1))
+    frame[-1] ^= 0xFF
+    assert router.check(0x200, frame) == e2e.E2E_STATUS_ERROR
+    assert router.check(0x200, p05_frame(1)) == e2e.E2E_STATUS_OK
+
+    # wrong length and wrong data id
+    assert router.check(0x200, p05_frame(2)[:7]) == e2e.E2E_STATUS_ERROR
+    assert router.check(0x100, _p04_frame(18, 0x01020304)) == e2e.E2E_STATUS_ERROR
+
+    assert router.check(0x300, p05_frame(1)) == e2e.E2E_STATUS_UNKNOWN_ID
+
+    index = router.index(0x200)
+    assert router.counters[index] == 1
+    assert router.statuses[index] == e2e.E2E_STATUS_ERROR
+    assert router.frames[index] == 5
+    assert router.errors[index] == 2
+
+    router.reset()
+    assert list(router.counters) == [-1, -1]
+    assert list(router.statuses) == [e2e.E2E_STATUS_NONEWDATA] * 2
+    assert list(router.frames) == [0, 0]
+    assert router.check(0x200, p05_frame(200)) == e2e.E2E_STATUS_OK
+
+
+def test_router_check_batch():
+    router = e2e.Router(
+        {
+            0x100: e2e.Config(4, 0x0A0B0C0D),
+            0x200: e2e.Config(5, 0x1234, 6),
+        }
+    )
+    ids = [0x100, 0x200, 0x100, 0x200, 0x300]
+    frames = [_p04_frame(1), p05_frame(1), _p04_frame(1), p05_frame(3), b""]
+    expected = bytes(
+        [
+            e2e.E2E_STATUS_OK,
+            e2e.E2E_STATUS_OK,
+            e2e.E2E_STATUS_REPEATED,
+            e2e.E2E_STATUS_WRONGSEQUENCE,
+            e2e.E2E_STATUS_UNKNOWN_ID,
+        ]
+    )
+    assert router.check_batch(ids, frames) == expected
+
+    for typecode in "HILQ":
+        router.reset()
+        assert router.check_batch(array(typecode, ids), frames) == expected
+
+    with pytest.raises(ValueError):
+        router.check_batch(ids[:2], frames)
+    with pytest.raises(TypeError):
+        router.check_batch(array("d", ids), frames)
+    with pytest.raises(TypeError):
+        router.check_batch(ids, [None] * len(ids))
+
+
+def test_router_columns():
+    router = e2e.Router({0x100: e2e.Config(5, 0x1234)})
+    view = router.ids
+    assert view.readonly
+    assert view.format == "Q"
+    assert list(view) == [0x100]
+    with pytest.raises(TypeError):
+        view[0] = 1
+
+    # the view keeps the router alive
+    del router
+    assert view[0] == 0x100
+
+
+def test_router_threads():
+    count = 64
+    router = e2e.Router({i: e2e.Config(5, i) for i in range(count)})
+    frames = [[p05_frame(c, i) for c in range(256)] for i in range(count)]
+
+    def receive(message_id: int):
+        return [router.check(message_id, frame) for frame in frames[message_id]]
+
+    with ThreadPoolExecutor(max_workers=8) as executor:
+        results = list(executor.map(receive, range(count)))
+    for statuses in results:
+        assert set(statuses) == {e2e.E2E_STATUS_OK}
+    assert list(router.frames) == [256] * count
+    assert list(router.counters) == [255] * count
+
+
+def test_router_threads_contention():
+    # all threads receive the same frame, exactly one of them may see it first
+    router = e2e.Router({0x100: e2e.Config(5, 0x1234, 6)})
+    frame = p05_frame(1)
+    count = 1000
+
+    def receive(_):
+        return router.check_batch([0x100] * count, [frame] * count)
+
+    with ThreadPoolExecutor(max_workers=8) as executor:
+        results = b"".join(executor.map(receive, range(8)))
+    assert results.count(e2e.E2E_STATUS_OK) == 1
+    assert results.count(e2e.E2E_STATUS_REPEATED) == 8 * count - 1
+    assert router.frames[0] == 8 * count
+    assert router.counters[0] == 1
+
+
+def test_router_snapshot(tmp_path):
+    config = e2e.Config(5, 0x1234, 6)
+    router = e2e.Router({0x100 + i: config for i in range(100)})
+    router.check_batch([0x100, 0x101, 0x100], [p05_frame(1), p05_frame(7), p05_frame(2)])
+
+    snapshot = router.snapshot()
+    restored = e2e.Router.from_snapshot(snapshot)
+    assert len(restored) == 100
+    assert restored.index(0x150) == router.index(0x150)
+    assert restored.counters.tolist() == router.counters.tolist()
+    assert restored.frames.tolist() == router.frames.tolist()
+    assert restored.check(0x100, p05_frame(3)) == e2e.E2E_STATUS_OK
+    assert restored.check(0x101, p05_frame(9)) == e2e.E2E_STATUS_WRONGSEQUENCE
+    assert restored.check(0x1FF, p05_frame(1)) == e2e.E2E_STATUS_UNKNOWN_ID
+
+    # the original is unaffected
+    assert router.check(0x100, p05_frame(3)) == e2e.E2E_STATUS_OK
+
+    # a writable mapping is used in place
+    path = tmp_path / "router.bin"
+    path.write_bytes(snapshot)
+    with open(path, "r+b") as f, mmap.mmap(f.fileno(), 0) as mapping:
+        mapped = e2e.Router.from_snapshot(mapping)
+        assert mapped.check(0x100, p05_frame(3)) == e2e.E2E_STATUS_OK
+        del mapped
+    assert e2e.Router.from_snapshot(path.read_bytes()).counters[0] == 3
+
+
+def test_router_snapshot_invalid():
+    router = e2e.Router({0x100: e2e.Config(5, 0x1234)})
+    snapshot = bytearray(router.snapshot())
+
+    with pytest.raises(ValueError):
+        e2e.Router.from_snapshot(snapshot[:32])
+    with pytest.raises(ValueError):
+        e2e.Router.from_snapshot(b"x" * len(snapshot))
+
+    # wrong version
+    corrupted = bytearray(snapshot)
+    corrupted[8] ^= 0xFF
+    with pytest.raises(ValueError):
+        e2e.Router.from_snapshot(corrupted)
+
+    # hash index points outside of the table
+    corrupted = bytearray(snapshot)
+    slots_offset = int.from_bytes(snapshot[32:40], sys.byteorder)
+    corrupted[slots_offset : slots_offset + 32] = b"\xff" * 32
+    with pytest.raises(ValueError):
+        e2e.Router.from_snapshot(corrupted)
+
+    # the configurations are not parsed, a corrupted profile, length or offset
+    # fails every check
+    configs_offset = int.from_bytes(snapshot[48:56], sys.byteorder)
+    for offset, value in ((0, b"\x63"), (4, b"\xff\xff"), (12, b"\xff\xff")):
+        corrupted = bytearray(snapshot)
+        corrupted[configs_offset + offset : configs_offset + offset + len(value)] = value
+        router = e2e.Router.from_snapshot(corrupted)
+        for size in range(40):
+            assert router.check(0x100, bytes(size)) == e2e.E2E_STATUS_ERROR
+
+
+def _check_shared(name: str, counter: int) -> int:
+    shm = shared_memory.SharedMemory(name)
+    router = e2e.Router.from_snapshot(shm.buf)
+    status = router.check(0x100, p05_frame(counter))
+    del router
+    shm.close()
+    return status
+
+
+@pytest.mark.skipif(sys.version_info < (3, 8), reason="requires shared_memory")
+def test_router_shared_memory():
+    configs = {0x100: e2e.Config(5, 0x1234, 6), 0x200: e2e.Config(5, 0x1234, 6)}
+    assert e2e.Router.buffer_size(2) == len(e2e.Router(configs).snapshot())
+
+    with pytest.raises(ValueError):
+        e2e.Router(configs, buffer=bytearray(64))
+    with pytest.raises(BufferError):
+        e2e.Router(configs, buffer=bytes(e2e.Router.buffer_size(2)))
+
+    shm = shared_memory.SharedMemory(create=True, size=e2e.Router.buffer_size(len(configs)))
+    try:
+        router = e2e.Router(configs, buffer=shm.buf)
+        assert router.check(0x100, p05_frame(1)) == e2e.E2E_STATUS_OK
+
+        # another process continues the sequence
+        with multiprocessing.get_context("spawn").Pool(1) as pool:
+            assert pool.apply(_check_shared, (shm.name, 2)) == e2e.E2E_STATUS_OK
+            assert pool.apply(_check_shared, (shm.name, 2)) == e2e.E2E_STATUS_REPEATED
+
+        assert router.counters[router.index(0x100)] == 2
+        assert router.frames[router.index(0x100)] == 3
+        assert router.check(0x100, p05_frame(3)) == e2e.E2E_STATUS_OK
+        del router
+    finally:
+        shm.close()
+        shm.unlink()
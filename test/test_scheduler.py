@@ -0,0 +1,172 @@
+import pytest
+
+import e2e
+
+
+def _template(length: int = 16) -> bytes:
+    return bytes(length)
+
+
+def test_frame_ring():
+    buffer = bytearray(128 + 4 * 32)
+    ring = e2e.FrameRing(buffer, 8)
+    assert ring.capacity == 4
+    assert ring.frame_size == 8
+    assert len(ring) == 0
+    assert ring.pop() is None
+    assert ring.drain() == []
+
+    assert ring.push(0x100, 1, b"\x01\x02")
+    assert ring.push(0x200, 2, b"")
+    assert len(ring) == 2
+    assert ring.pop() == (0x100, 1, b"\x01\x02")
+    assert ring.pop(status=True) == (0x200, 2, 0, b"")
+    for i in range(4):
+        assert ring.push(i, i, bytes(8))
+    assert not ring.push(4, 4, bytes(8))
+    assert [i for i, _, _ in ring.drain()] == [0, 1, 2, 3]
+    with pytest.raises(ValueError):
+        ring.push(0, 0, bytes(9))
+
+    with pytest.raises(ValueError):
+        e2e.FrameRing(bytearray(128), 8)
+    with pytest.raises(BufferError):
+        e2e.FrameRing(bytes(1024), 8)
+
+
+def test_scheduler_protect():
+    config = e2e.Config(4, 0x0A0B0C0D)
+    scheduler = e2e.Scheduler([(0x100, config, _template(), 10)])
+    ring = e2e.FrameRing(bytearray(4096), 16)
+    assert len(scheduler) == 1
+    assert scheduler.frame_size == 16
+
+    assert scheduler.tick(0, ring) == 1
+    assert scheduler.tick(9, ring) == 0
+    assert scheduler.tick(10, ring) == 1
+    frames = ring.drain()
+    assert [(i, t) for i, t, _ in frames] == [(0x100, 0), (0x100, 10)]
+
+    # the frames match the output of e2e_p04_protect with increment_counter=True
+    data = bytearray(_template())
+    for _, _, frame in frames:
+        e2e.p04.e2e_p04_protect(data, len(data), 0x0A0B0C0D, increment_counter=True)
+        assert frame == data
+        assert e2e.p04.e2e_p04_check(frame, len(frame), 0x0A0B0C0D)
+
+    assert list(scheduler.sent) == [2]
+    assert list(scheduler.next_times) == [20]
+
+
+def test_scheduler_periods_and_offsets():
+    config = e2e.Config(5, 0x1234, 6)
+    scheduler = e2e.Scheduler(
+        [
+            (1, config, _template(8), 10),
+            (2, config, _template(8), 25, 5),
+            (3, config, _template(8), 1000, 100_000),
+        ],
+        start=1000,
+    )
+    ring = e2e.FrameRing(bytearray(65536), 8)
+    sent = []
+    for now in range(1000, 1101):
+        scheduler.tick(now, ring)
+        sent.extend((i, t) for i, t, _ in ring.drain())
+    assert [t for i, t in sent if i == 1] == list(range(1000, 1101, 10))
+    assert [t for i, t in sent if i == 2] == list(range(1005, 1101, 25))
+    assert [t for i, t in sent if i == 3] == []
+
+    # skipped periods are caught up
+    assert scheduler.tick(1200, ring) == 10 + 4
+    assert list(scheduler.next_times) == [1210, 1205, 101_000]
+
+
+def test_scheduler_resolution():
+    # the wheel tick of a message may come up before its transmission time, it
+    # must go out on the first call at or after that time, not a tick later
+    config = e2e.Config(5, 0x1234, 6)
+    scheduler = e2e.Scheduler(
+        [(1, config, _template(8), 1000, 1550), (2, config, _template(8), 700)],
+        resolution=1000,
+    )
+    ring = e2e.FrameRing(bytearray(65536), 8)
+    sent = []
+    for now in range(0, 5001, 100):
+        scheduler.tick(now, ring)
+        sent.extend((i, t, now) for i, t, _ in ring.drain())
+    assert [(t, now) for i, t, now in sent if i == 1] == [
+        (1550, 1600),
+        (2550, 2600),
+        (3550, 3600),
+        (4550, 4600),
+    ]
+    expected = [(t, t) for t in range(0, 5001, 700)]
+    assert [(t, now) for i, t, now in sent if i == 2] == expected
+
+
+def test_scheduler_ring_full():
+    config = e2e.Config(5, 0x1234, 6)
+    scheduler = e2e.Scheduler([(1, config, _template(8), 1)])
+    ring = e2e.FrameRing(bytearray(128 + 2 * 32), 8)
+    assert ring.capacity == 2
+
+    assert scheduler.tick(4, ring) == 2
+    assert scheduler.tick(4, ring) == 0
+    assert [t for _, t, _ in ring.drain()] == [0, 1]
+    assert scheduler.tick(5, ring) == 2
+    assert [t for _, t, _ in ring.drain(limit=1)] == [2]
+    assert scheduler.tick(6, ring) == 1
+    assert [t for _, t, _ in ring.drain()] == [3, 4]
+
+    # counters are consecutive although frames were deferred
+    counters = []
+    for now in range(7, 20):
+        scheduler.tick(now, ring)
+        counters.extend(frame[2] for _, _, frame in ring.drain())
+    assert counters == list(range(6, 21))
+
+
+def test_scheduler_errors():
+    config = e2e.Config(4, 0x0A0B0C0D)
+    with pytest.raises(ValueError):
+        e2e.Scheduler([(1, config, _template(), 0)])
+    with pytest.raises(ValueError):
+        e2e.Scheduler([(1, config, _template(4), 10)])
+    with pytest.raises(ValueError):
+        e2e.Scheduler([(1, config, _template(), 10), (1, config, _template(), 10)])
+    with pytest.raises(TypeError):
+        e2e.Scheduler([(1, None, _template(), 10)])
+    with pytest.raises(ValueError):
+        e2e.Scheduler([], resolution=0)
+
+    scheduler = e2e.Scheduler([(1, config, _template(32), 10)])
+    with pytest.raises(ValueError):
+        scheduler.tick(0, e2e.FrameRing(bytearray(1024), 16))
+    with pytest.raises(TypeError):
+        scheduler.tick(0, bytearray(1024))
+
+
+def test_scheduler_nanoseconds():
+    # time.monotonic_ns() with resolution 1: the ticks are millions of wheel
+    # ticks apart and every transmission must still go out exactly once
+    config = e2e.Config(5, 0x1234)
+    start = 10**15
+    periods = [(10 + i % 7) * 1_000_000 for i in range(2000)]
+    scheduler = e2e.Scheduler(
+        [(i, config, _template(8), period, i * 997) for i, period in enumerate(periods)],
+        start=start,
+    )
+    ring = e2e.FrameRing(bytearray(128 + 2048 * 32), 8)
+
+    sent = 0
+    for step in range(1, 41):
+        now = start + step * 5_000_000
+        count = scheduler.tick(now, ring)
+        assert len(ring.drain()) == count
+        sent += count
+
+    now = start + 200_000_000
+    expected = [(now - start - i * 997) // period + 1 for i, period in enumerate(periods)]
+    assert list(scheduler.sent) == expected
+    assert sent == sum(expected)
@@ -0,0 +1,96 @@
+from array import array
+
+import pytest
+
+import e2e
+from _frames import p05_frame
+
+
+def _p07_frame(counter: int, data_id: int) -> bytes:
+    data = bytearray(24)
+    data[12:16] = ((counter - 1) & 0xFFFFFFFF).to_bytes(4, "big")
+    e2e.p07.e2e_p07_protect(data, len(data), data_id, increment_counter=True)
+    return bytes(data)
+
+
+CONFIGS = {
+    0x100: e2e.Config(5, 0x100, 6, max_delta_counter=2),
+    0x200: e2e.Config(7, 0x200),
+}
+
+LOG = [
+    (0x100, p05_frame(1, 0x100)),
+    (0x200, _p07_frame(0xFFFFFFFF, 0x200)),
+    (0x100, p05_frame(2, 0x100)),
+    (0x200, _p07_frame(0, 0x200)),
+    (0x100, p05_frame(2, 0x100)),
+    (0x200, _p07_frame(2, 0x200)),
+    (0x100, p05_frame(4, 0x100)),
+    (0x100, p05_frame(5, 0x100)[:-1] + b"\xff"),
+    (0x300, b"\x00" * 8),
+    (0x100, p05_frame(5, 0x100)),
+]
+
+EXPECTED = bytes(
+    [
+        e2e.E2E_STATUS_OK,
+        e2e.E2E_STATUS_OK,
+        e2e.E2E_STATUS_OK,
+        e2e.E2E_STATUS_OK,
+        e2e.E2E_STATUS_REPEATED,
+        e2e.E2E_STATUS_WRONGSEQUENCE,
+        e2e.E2E_STATUS_OKSOMELOST,
+        e2e.E2E_STATUS_ERROR,
+        e2e.E2E_STATUS_UNKNOWN_ID,
+        e2e.E2E_STATUS_OK,
+    ]
+)
+
+
+def test_check_sequence():
+    keys = [key for key, _ in LOG]
+    frames = [frame for _, frame in LOG]
+    statuses, state = e2e.check_sequence(keys, frames, CONFIGS)
+    assert statuses == EXPECTED
+    assert state == {0x100: 5, 0x200: 2}
+
+    statuses, state = e2e.check_sequence(array("H", keys), frames, CONFIGS)
+    assert statuses == EXPECTED
+
+    statuses, state = e2e.check_sequence([], [], CONFIGS)
+    assert statuses == b""
+    assert state == {0x100: None, 0x200: None}
+
+
+def test_check_sequence_continuation():
+    keys = [key for key, _ in LOG]
+    frames = [frame for _, frame in LOG]
+
+    # split the log into batches of every possible size
+    for size in range(1, len(LOG) + 1):
+        state = None
+        statuses = b""
+        for start in range(0, len(LOG), size):
+            result, state = e2e.check_sequence(
+                keys[start : start + size],
+                frames[start : start + size],
+                CONFIGS,
+                state,
+            )
+            statuses += result
+        assert statuses == EXPECTED, size
+        assert state == {0x100: 5, 0x200: 2}
+
+
+def test_check_sequence_errors():
+    frame = p05_frame(1, 0x100)
+    with pytest.raises(ValueError):
+        e2e.check_sequence([0x100, 0x100], [frame], CONFIGS)
+    with pytest.raises(ValueError):
+        e2e.check_sequence([0x100], [frame], CONFIGS, {0x300: 1})
+    with pytest.raises(ValueError):
+        e2e.check_sequence([0x100], [frame], CONFIGS, {0x100: 256})
+    with pytest.raises(TypeError):
+        e2e.check_sequence([0x100], [frame], {0x100: None})
+    with pytest.raises(TypeError):
+        e2e.check_sequence(array("f", [1.0]), [frame], CONFIGS)
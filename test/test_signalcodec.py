@@ -0,0 +1,244 @@
+import math
+import random
+
+import pytest
+
+import e2e
+from e2e.p05 import e2e_p05_check, e2e_p05_protect
+
+CONFIG = e2e.Config(5, data_id=0x1234, length=22)
+
+
+def reference_pack(data, start_bit, length, byteorder, raw):
+    # DBC bit layout on the frame as one big integer
+    size = len(data)
+    mask = (1 << length) - 1
+    if byteorder == "little":
+        frame = int.from_bytes(data, "little")
+        frame = frame & ~(mask << start_bit) | (raw & mask) << start_bit
+        data[:] = frame.to_bytes(size, "little")
+    else:
+        msb = start_bit // 8 * 8 + 7 - start_bit % 8
+        shift = size * 8 - msb - length
+        frame = int.from_bytes(data, "big")
+        frame = frame & ~(mask << shift) | (raw & mask) << shift
+        data[:] = frame.to_bytes(size, "big")
+
+
+def reference_unpack(data, start_bit, length, byteorder, signed):
+    size = len(data)
+    if byteorder == "little":
+        raw = int.from_bytes(data, "little") >> start_bit
+    else:
+        msb = start_bit // 8 * 8 + 7 - start_bit % 8
+        raw = int.from_bytes(data, "big") >> (size * 8 - msb - length)
+    raw &= (1 << length) - 1
+    if signed and raw >> (length - 1):
+        raw -= 1 << length
+    return raw
+
+
+SIGNALS = [
+    ("intel_4", 24, 4, "little", False),
+    ("intel_13", 28, 13, "little", True),
+    ("motorola_1", 41, 1, "big", False),
+    ("motorola_12", 55, 12, "big", False),
+    ("motorola_19", 67, 19, "big", True),
+    ("intel_64", 128, 64, "little", False),
+]
+
+
+def random_raw(rng, length, signed):
+    if signed:
+        return rng.randrange(-(1 << (length - 1)), 1 << (length - 1))
+    return rng.randrange(1 << length)
+
+
+def test_pack_protect():
+    codec = e2e.SignalCodec(SIGNALS)
+    assert len(codec) == len(SIGNALS)
+    assert codec.names == tuple(signal[0] for signal in SIGNALS)
+    assert codec.frame_size == 24
+
+    rng = random.Random(5)
+    data = bytearray(24)
+    expected = bytearray(24)
+    for _ in range(50):
+        values = [random_raw(rng, signal[2], signal[4]) for signal in SIGNALS]
+        codec.pack_protect(data, values, CONFIG)
+        for signal, value in zip(SIGNALS, values):
+            reference_pack(expected, *signal[1:4], value)
+        e2e_p05_protect(expected, 22, 0x1234)
+        assert data == expected
+        assert e2e_p05_check(data, 22, 0x1234)
+
+    statuses, columns = codec.check_unpack([data, bytes(expected)], CONFIG)
+    assert statuses == bytes([e2e.E2E_STATUS_OK] * 2)
+    for name, start_bit, length, byteorder, signed in SIGNALS:
+        column = columns[name]
+        assert column.format == ("q" if signed else "Q")
+        value = reference_unpack(data, start_bit, length, byteorder, signed)
+        assert column.tolist() == [value, value]
+
+
+def test_scale_and_offset():
+    codec = e2e.SignalCodec(
+        [
+            ("speed", 24, 16, "little", False, 0.01),
+            ("temperature", 47, 8, "big", True, 0.5, -40.0),
+        ]
+    )
+    data = bytearray(8)
+    config = e2e.Config(5, data_id=0x1234, length=6)
+    codec.pack_protect(data, {"speed": 88.123, "temperature": 21.3}, config)
+    assert int.from_bytes(data[3:5], "little") == 8812
+    assert data[5] == 123
+    statuses, columns = codec.check_unpack([data], config)
+    assert statuses == bytes([e2e.E2E_STATUS_OK])
+    assert columns["speed"].format == "d"
+    assert columns["speed"][0] == pytest.approx(88.12)
+    assert columns["temperature"][0] == pytest.approx(21.5)
+
+    # signals left out of the dict keep their bits
+    codec.pack_protect(data, {"speed": 1.0}, config)
+    assert data[5] == 123
+    assert int.from_bytes(data[3:5], "little") == 100
+
+    with pytest.raises(ValueError):
+        codec.pack_protect(data, {"speed": 655.36}, config)
+    with pytest.raises(ValueError):
+        codec.pack_protect(data, {"temperature": -104.5}, config)
+    with pytest.raises(ValueError):
+        codec.pack_protect(data, {"speed": math.nan}, config)
+    with pytest.raises(KeyError):
+        codec.pack_protect(data, {"rpm": 0}, config)
+    with pytest.raises(ValueError):
+        codec.pack_protect(data, [1.0], config)
+    with pytest.raises(TypeError):
+        codec.pack_protect(data, ["1", 2], config)
+    # a failed call does not modify the frame
+    assert int.from_bytes(data[3:5], "little") == 100
+
+
+def test_check_unpack_invalid_frames():
+    codec = e2e.SignalCodec([("raw", 24, 8), ("physical", 32, 8, "little", False, 2.0)])
+    config = e2e.Config(5, data_id=0x1234, length=6)
+    frames = []
+    for value in range(4):
+        data = bytearray(8)
+        codec.pack_protect(data, [value, 2.0 * value], config)
+        frames.append(bytes(data))
+    frames[1] = frames[1][:3] + b"\xff" + frames[1][4:]
+    frames[3] = frames[3][:4]
+
+    statuses, columns = codec.check_unpack(frames, config)
+    ok, error = e2e.E2E_STATUS_OK, e2e.E2E_STATUS_ERROR
+    assert statuses == bytes([ok, error, ok, error])
+    assert columns["raw"].tolist() == [0, 0, 2, 0]
+    physical = columns["physical"].tolist()
+    assert physical[0] == 0.0 and physical[2] == 4.0
+    assert math.isnan(physical[1]) and math.isnan(physical[3])
+    assert columns["raw"].readonly
+
+    statuses, columns = codec.check_unpack([], config)
+    assert statuses == b""
+    assert len(columns["raw"]) == 0
+
+
+def test_integer_limits():
+    codec = e2e.SignalCodec(
+        [
+            ("u64", 0, 64),
+            ("s64", 64, 64, "little", True),
+            ("s1", 128, 1, "little", True),
+        ]
+    )
+    # the E2E header behind the signals
+    config = e2e.Config(5, data_id=0x1234, offset=17)
+    with pytest.raises(ValueError):
+        codec.pack_protect(bytearray(17), [1, 2, 3], config)
+
+    data = bytearray(20)
+    codec.pack_protect(data, [2**64 - 1, -(2**63), -1], config)
+    _, columns = codec.check_unpack([data], config)
+    assert columns["u64"][0] == 2**64 - 1
+    assert columns["s64"][0] == -(2**63)
+    assert columns["s1"][0] == -1
+    for values in ([2**64, 0, 0], [-1, 0, 0], [0, 2**63, 0], [0, 0, 1]):
+        with pytest.raises(ValueError):
+            codec.pack_protect(data, values, config)
+
+
+def test_frame_errors():
+    codec = e2e.SignalCodec([("a", 40, 8)])
+    with pytest.raises(ValueError):
+        codec.pack_protect(bytearray(5), [1], CONFIG)
+    with pytest.raises(TypeError):
+        codec.pack_protect(bytes(8), [1], CONFIG)
+    # the frame is shorter than the configured length
+    with pytest.raises(ValueError):
+        codec.pack_protect(bytearray(8), [1], CONFIG)
+    with pytest.raises(TypeError):
+        codec.check_unpack([bytes(8)], None)
+
+
+def test_frame_not_modified():
+    # the frame does not fit the Config, pack_protect must fail before packing
+    codec = e2e.SignalCodec([("y", 56, 8)])
+    data = bytearray(8)
+    with pytest.raises(ValueError):
+        codec.pack_protect(data, [0x55], e2e.Config(5, 0x1234, length=16))
+    assert data == bytearray(8)
+
+
+@pytest.mark.parametrize(
+    "config, start_bit",
+    [
+        (e2e.Config(1, 0x1234), 8),
+        (e2e.Config(2, data_id_list=bytes(16)), 0),
+        (e2e.Config(4, 0x0A0B0C0D, offset=2), 13 * 8),
+        (e2e.Config(5, 0x1234), 16),
+        (e2e.Config(5, 0x1234, offset=4), 32),
+        (e2e.Config(6, 0x1234), 4 * 8 + 3),
+        (e2e.Config(7, 0x0A0B0C0D), 19 * 8),
+    ],
+)
+def test_header_overlap(config, start_bit):
+    codec = e2e.SignalCodec([("x", start_bit, 8)])
+    data = bytearray(32)
+    with pytest.raises(ValueError, match="header"):
+        codec.pack_protect(data, [0x40], config)
+    assert data == bytearray(32)
+    with pytest.raises(ValueError, match="header"):
+        codec.check_unpack([bytes(32)], config)
+
+    # the byte behind the header is free
+    header = {1: 2, 2: 2, 4: 12, 5: 3, 6: 5, 7: 20}[config.profile] + config.offset
+    codec = e2e.SignalCodec([("x", header * 8, 8)])
+    codec.pack_protect(data, [0x40], config)
+    statuses, columns = codec.check_unpack([data], config)
+    assert statuses == bytes([e2e.E2E_STATUS_OK])
+    assert columns["x"][0] == 0x40
+
+
+@pytest.mark.parametrize(
+    "signals",
+    [
+        [],
+        [("a", 0, 0)],
+        [("a", 0, 65)],
+        [("a", -1, 8)],
+        [("a", 0, 8, "middle")],
+        [("a", 0, 8, "little", False, 0.0)],
+        [("a", 0, 8, "little", False, math.inf)],
+        [("a", 0, 8), ("a", 8, 8)],
+        [("a", 0, 8), ("b", 7, 2)],
+        [("a", 7, 8, "big"), ("b", 0, 1, "big")],
+        [(1, 0, 8)],
+        [("a", 0)],
+        ["a08"],
+    ],
+)
+def test_invalid_signals(signals):
+    with pytest.raises((TypeError, ValueError)):
+        e2e.SignalCodec(signals)
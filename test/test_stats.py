@@ -0,0 +1,108 @@
+import threading
+
+import pytest
+
+import e2e
+from e2e import _e2e
+
+
+@pytest.fixture
+def enabled_stats():
+    e2e.enable_stats()
+    e2e.reset_stats()
+    yield
+    e2e.enable_stats(False)
+
+
+def test_stats_disabled():
+    e2e.enable_stats(False)
+    e2e.reset_stats()
+    e2e.crc.calculate_crc8(b"123456789")
+    result = e2e.stats()
+    assert result["enabled"] is False
+    assert result["functions"]["calculate_crc8"]["calls"] == 0
+
+
+def test_stats_functions(enabled_stats):
+    result = e2e.stats()
+    assert result["enabled"] is True
+    assert result["clock"] in ("tsc", "cntvct", "qpc", "ns")
+    for name in (
+        "calculate_crc8",
+        "calculate_crc64",
+        "e2e_p01_protect",
+        "e2e_p02_check",
+        "e2e_p04_check",
+        "e2e_p05_check",
+        "e2e_p06_check",
+        "e2e_p07_protect",
+    ):
+        value = result["functions"][name]
+        assert value["calls"] == 0
+        assert value["bytes"] == 0
+        assert set(value["failures"]) == {
+            "bad_frame",
+            "length_mismatch",
+            "data_id_mismatch",
+            "counter_range",
+            "crc_mismatch",
+        }
+        assert value["latency"] == [0] * 32
+
+
+def test_stats_counts(enabled_stats):
+    data = bytearray(8)
+    e2e.p05.e2e_p05_protect(data, 6, 0x1234)
+    assert e2e.p05.e2e_p05_check(data, 6, 0x1234)
+    data[0] ^= 0xFF
+    assert not e2e.p05.e2e_p05_check(data, 6, 0x1234)
+    e2e.crc.calculate_crc32(b"123456789")
+
+    functions = e2e.stats()["functions"]
+    assert functions["e2e_p05_protect"]["calls"] == 1
+    assert functions["e2e_p05_protect"]["bytes"] == 8
+    assert functions["e2e_p05_check"]["calls"] == 2
+    assert functions["e2e_p05_check"]["bytes"] == 16
+    assert functions["e2e_p05_check"]["failures"]["crc_mismatch"] == 1
+    assert sum(functions["e2e_p05_check"]["latency"]) == 2
+    assert functions["calculate_crc32"]["calls"] == 1
+    assert functions["calculate_crc32"]["bytes"] == 9
+
+    e2e.reset_stats()
+    assert e2e.stats()["functions"]["e2e_p05_check"]["calls"] == 0
+
+
+def test_stats_threads(enabled_stats):
+    def work():
+        for _ in range(100):
+            e2e.crc.calculate_crc16(b"\x00" * 4)
+
+    threads = [threading.Thread(target=work) for _ in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    value = e2e.stats()["functions"]["calculate_crc16"]
+    assert value["calls"] == 400
+    assert value["bytes"] == 1600
+    assert sum(value["latency"]) == 400
+
+
+def test_stats_finished_threads(enabled_stats):
+    # a finished thread hands its counters on to the next thread
+    def work():
+        for _ in range(10):
+            e2e.crc.calculate_crc16(b"\x00" * 4)
+
+    work()
+    blocks = _e2e._stats_blocks()
+    for _ in range(200):
+        thread = threading.Thread(target=work)
+        thread.start()
+        thread.join()
+
+    assert _e2e._stats_blocks() - blocks < 10
+    value = e2e.stats()["functions"]["calculate_crc16"]
+    assert value["calls"] == 201 * 10
+    assert sum(value["latency"]) == 201 * 10
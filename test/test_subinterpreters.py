@@ -0,0 +1,83 @@
+import sys
+import threading
+
+import pytest
+
+try:
+    import _interpreters as interpreters  # Python 3.13+
+except ImportError:
+    try:
+        import _xxsubinterpreters as interpreters  # Python 3.12
+    except ImportError:
+        interpreters = None
+
+pytestmark = pytest.mark.skipif(
+    interpreters is None or sys.version_info < (3, 12),
+    reason="requires subinterpreters with their own GIL (Python 3.12+)",
+)
+
+SCRIPT = """
+import sys
+sys.path[:] = {path!r}
+
+import e2e
+
+router = e2e.Router({{0x100: e2e.Config(5, data_id=0x1234, length=8)}})
+data = bytearray(10)
+for counter in range({frames}):
+    e2e.p05.e2e_p05_protect(data, 8, 0x1234)
+    assert e2e.p05.e2e_p05_check(data, 8, 0x1234)
+    status = router.check(0x100, data)
+    assert status in (e2e.E2E_STATUS_OK, e2e.E2E_STATUS_NONEWDATA), status
+assert router.check(0x100, data) == e2e.E2E_STATUS_REPEATED
+assert e2e.crc.calculate_crc32(b"123456789") == e2e.crc.CRC32_CHECK
+"""
+
+
+def _create():
+    if sys.version_info >= (3, 13):
+        return interpreters.create("isolated")
+    return interpreters.create(isolated=True)
+
+
+def _run(interp, script):
+    # 3.12 raises on failure, 3.13 returns the exception info
+    error = interpreters.run_string(interp, script)
+    assert error is None, error
+
+
+@pytest.mark.skipif(
+    sys.version_info < (3, 13),
+    reason="threads which run subinterpreters deadlock on import in Python 3.12",
+)
+def test_isolated_interpreters():
+    script = SCRIPT.format(path=sys.path, frames=1000)
+    interps = [_create() for _ in range(4)]
+    errors = []
+
+    def worker(interp):
+        try:
+            _run(interp, script)
+        except Exception as exc:
+            errors.append(exc)
+
+    try:
+        threads = [threading.Thread(target=worker, args=(i,)) for i in interps]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+    finally:
+        for interp in interps:
+            interpreters.destroy(interp)
+    assert not errors, errors
+
+
+def test_reload_after_destroy():
+    script = SCRIPT.format(path=sys.path, frames=10)
+    for _ in range(3):
+        interp = _create()
+        try:
+            _run(interp, script)
+        finally:
+            interpreters.destroy(interp)
@@ -0,0 +1,82 @@
+import time
+
+import pytest
+
+import e2e
+from _frames import p05_frame
+
+
+def _ring(count: int, frame_size: int = 8) -> e2e.FrameRing:
+    return e2e.FrameRing(bytearray(128 + count * (24 + frame_size)), frame_size)
+
+
+def _wait(condition, timeout: float = 5.0) -> None:
+    deadline = time.monotonic() + timeout
+    while not condition():
+        assert time.monotonic() < deadline
+        time.sleep(0.001)
+
+
+def test_verifier():
+    router = e2e.Router({0x100: e2e.Config(5, 0x1234, 6)})
+    input, output = _ring(16), _ring(16)
+
+    with e2e.Verifier(router, input, output) as verifier:
+        assert verifier.running
+        for counter in (1, 2, 2, 4):
+            assert input.push(0x100, counter, p05_frame(counter))
+        assert input.push(0x200, 5, p05_frame(5))
+        assert input.push(0x100, 6, b"\x00" * 8)
+        _wait(lambda: verifier.processed == 6)
+
+        results = output.drain(status=True)
+        assert [(i, t, s) for i, t, s, _ in results] == [
+            (0x100, 1, e2e.E2E_STATUS_OK),
+            (0x100, 2, e2e.E2E_STATUS_OK),
+            (0x100, 2, e2e.E2E_STATUS_REPEATED),
+            (0x100, 4, e2e.E2E_STATUS_WRONGSEQUENCE),
+            (0x200, 5, e2e.E2E_STATUS_UNKNOWN_ID),
+            (0x100, 6, e2e.E2E_STATUS_ERROR),
+        ]
+        assert results[0][3] == p05_frame(1)
+        assert verifier.failed == 4
+    assert not verifier.running
+    assert router.frames[0] == 5
+    verifier.close()
+
+
+def test_verifier_errors_only_and_backpressure():
+    router = e2e.Router({0x100: e2e.Config(5, 0x1234, 6)})
+    input, output = _ring(64), _ring(2, frame_size=0)
+
+    with e2e.Verifier(router, input, output, errors_only=True, idle_time=50) as verifier:
+        for counter in range(1, 41):
+            assert input.push(0x100, counter, p05_frame(counter if counter % 10 else 1))
+
+        # the output ring holds two results, the verifier waits for the consumer
+        results = []
+
+        def poll() -> bool:
+            results.extend(output.drain(status=True))
+            return verifier.processed == 40 and len(output) == 0
+
+        _wait(poll)
+
+    # every tenth frame repeats counter 1, which breaks the sequence twice
+    expected = [10, 11, 20, 21, 30, 31, 40]
+    assert [(t, s) for _, t, s, _ in results] == [(t, e2e.E2E_STATUS_WRONGSEQUENCE) for t in expected]
+    assert all(data == b"" for _, _, _, data in results)
+    assert verifier.failed == len(expected)
+
+
+def test_verifier_arguments():
+    router = e2e.Router({})
+    ring = _ring(4)
+    with pytest.raises(TypeError):
+        e2e.Verifier(object(), ring, _ring(4))
+    with pytest.raises(TypeError):
+        e2e.Verifier(router, ring, bytearray(256))
+    with pytest.raises(ValueError):
+        e2e.Verifier(router, ring, ring)
+    with pytest.raises(ValueError):
+        e2e.Verifier(router, ring, _ring(4), idle_time=0)
@@ -0,0 +1,130 @@
+import os
+import random
+import re
+import shutil
+import subprocess
+
+import pytest
+
+import e2e
+
+# built with the CMake option E2E_VERIFY, E2E_VERIFY_TOOL points to the executable
+TOOL = os.environ.get("E2E_VERIFY_TOOL") or shutil.which("e2e-verify")
+pytestmark = pytest.mark.skipif(TOOL is None, reason="e2e-verify not built")
+
+DATA_ID_LIST = bytes(range(16))
+CONFIG = """\
+# id        arguments of e2e.Config
+0x100       profile=5 data_id=0x1234
+0x101       profile=2 data_id_list=000102030405060708090A0B0C0D0E0F max_delta_counter=2
+0x102       profile=7 data_id=0x0A0B0C0D
+0x18FF0001  profile=4 data_id=0x01020304 offset=8 max_delta_counter=3
+"""
+SIZES = {0x100: 8, 0x101: 8, 0x102: 64, 0x18FF0001: 32}
+
+
+def _protect(id_, data, increment):
+    if id_ == 0x100:
+        e2e.p05.e2e_p05_protect(data, 6, 0x1234, increment_counter=increment)
+    elif id_ == 0x101:
+        e2e.p02.e2e_p02_protect(data, 7, DATA_ID_LIST, increment_counter=increment)
+    elif id_ == 0x102:
+        e2e.p07.e2e_p07_protect(data, 64, 0x0A0B0C0D, increment_counter=increment)
+    else:
+        e2e.p04.e2e_p04_protect(
+            data, 32, 0x01020304, offset=8, increment_counter=increment
+        )
+
+
+CONFIGS = {
+    0x100: e2e.Config(5, 0x1234),
+    0x101: e2e.Config(2, data_id_list=DATA_ID_LIST, max_delta_counter=2),
+    0x102: e2e.Config(7, 0x0A0B0C0D),
+    0x18FF0001: e2e.Config(4, 0x01020304, offset=8, max_delta_counter=3),
+}
+NAMES = {
+    e2e.E2E_STATUS_REPEATED: "REPEATED",
+    e2e.E2E_STATUS_WRONGSEQUENCE: "WRONGSEQUENCE",
+    e2e.E2E_STATUS_ERROR: "ERROR",
+}
+
+
+def _capture(count, seed=0):
+    """Return candump lines with repeated, lost and corrupted frames."""
+    rng = random.Random(seed)
+    buffers = {id_: bytearray(size) for id_, size in SIZES.items()}
+    lines = []
+    for i in range(count):
+        id_ = rng.choice(list(SIZES))
+        data = buffers[id_]
+        for _ in range(rng.choice([1] * 20 + [2, 3, 5])):  # lost frames
+            _protect(id_, data, rng.random() > 0.02)  # repeated counter
+        frame = bytearray(data)
+        if rng.random() < 0.03:
+            frame[rng.randrange(len(frame))] ^= 1 << rng.randrange(8)
+        digits = 8 if id_ > 0x7FF else 3
+        separator = "##1" if len(frame) > 8 else "#"
+        frame_id = f"{id_:0{digits}X}"
+        lines.append(f"({i / 100:.6f}) can0 {frame_id}{separator}{frame.hex().upper()}")
+    lines.append(f"({count / 100:.6f}) can0 7FF#0102")  # unknown id
+    lines.append(f"({count / 100:.6f}) can0 100#R")  # remote frame, ignored
+    return lines
+
+
+def _expected(lines):
+    router = e2e.Router(CONFIGS)
+    errors = []
+    for number, line in enumerate(lines, 1):
+        frame = line.split()[2]
+        id_, _, data = frame.partition("#")
+        if data.startswith("R"):
+            continue
+        if data.startswith("#"):
+            data = data[2:]
+        status = router.check(int(id_, 16), bytes.fromhex(data))
+        if status in NAMES:
+            errors.append((number, int(id_, 16), NAMES[status]))
+    return errors
+
+
+@pytest.mark.parametrize("threads", [1, 3])
+def test_verify_tool(tmp_path, threads):
+    lines = _capture(3000)
+    (tmp_path / "messages.cfg").write_text(CONFIG)
+    # two files, the sequence continues in the second one
+    (tmp_path / "a.log").write_text("\n".join(lines[:1000]) + "\n")
+    (tmp_path / "b.log").write_text("\n".join(lines[1000:]) + "\n")
+
+    result = subprocess.run(
+        [TOOL, "-j", str(threads), "messages.cfg", "a.log", "b.log"],
+        cwd=tmp_path,
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        universal_newlines=True,
+    )
+    expected = _expected(lines)
+    assert expected
+    assert result.returncode == 1, result.stderr
+
+    errors = []
+    for match in re.finditer(r"^(\w)\.log:(\d+): 0x(\w+) (\w+)", result.stdout, re.M):
+        number = int(match.group(2)) + (1000 if match.group(1) == "b" else 0)
+        errors.append((number, int(match.group(3), 16), match.group(4)))
+    assert errors == expected
+    assert "1 frames with unknown id" in result.stdout
+    assert f"{len(lines) - 1} frames, {len(expected)} failed" in result.stdout
+    assert "ignored 1 lines" in result.stderr
+
+
+def test_verify_tool_config_error(tmp_path):
+    (tmp_path / "messages.cfg").write_text("0x100 profile=5 data_id=0x12345\n")
+    (tmp_path / "a.log").write_text("")
+    result = subprocess.run(
+        [TOOL, "messages.cfg", "a.log"],
+        cwd=tmp_path,
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        universal_newlines=True,
+    )
+    assert result.returncode == 2
+    assert "messages.cfg:1: Argument \"data_id\" must be a 16bit" in result.stderr
@@ -0,0 +1,661 @@
+/* SPDX-FileCopyrightText: 2022-present Artur Drogunow <artur.drogunow@zf.com>
+#
+# SPDX-License-Identifier: MIT */
+
+// Check the E2E protection of the frames in candump log files without Python.
+//
+//   e2e-verify [-j threads] [-m max_errors] config capture...
+//
+// The configuration file has one message per line, the CAN id followed by the
+// arguments of e2e.Config as key=value pairs, '#' starts a comment:
+//
+//   0x100  profile=5 data_id=0x1234 length=8
+//   0x101  profile=2 data_id_list=000102030405060708090A0B0C0D0E0F max_delta_counter=3
+//
+// The captures are candump log files (candump -l), e.g.
+//
+//   (1436509052.249713) can0 100#0102030405060708
+//   (1436509052.250021) can0 101##1000102030405060708090A0B0C0D0E0F
+//
+// and are read as one sequence in the given order. Every frame is checked with
+// e2e_table_check(), the function behind e2e.Router.check(), so the status is
+// the same as in Python. The messages are distributed over the threads and
+// every thread checks the frames of its messages in capture order, so the
+// sequence evaluation does not depend on the number of threads.
+//
+// Every frame with status REPEATED, WRONGSEQUENCE or ERROR is reported, then a
+// summary per message. The exit status is 0 if there is no such frame, 1 if
+// there is one and 2 for invalid arguments or input files.
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include "crclib.h"
+#include "e2elib.h"
+#include "table.h"
+
+#define MAX_LINE       1024u
+#define MAX_THREADS    256u
+#define MAX_FRAME_SIZE 64u
+
+// status columns of the summary
+enum { COLUMN_OK, COLUMN_OKSOMELOST, COLUMN_REPEATED, COLUMN_WRONGSEQUENCE, COLUMN_ERROR, COLUMN_COUNT };
+
+typedef struct {
+    uint64_t     id;
+    e2e_config_t config;
+} message_t;
+
+typedef struct {
+    message_t *items;
+    uint32_t   count;
+    size_t     capacity;
+} messages_t;
+
+typedef struct {
+    uint64_t id;
+    int64_t  index;       // message index in the table, -1 for an unknown id
+    size_t   data_offset; // position of the payload in frames_t.data
+    uint32_t length;
+    uint32_t file;
+    uint32_t line;
+} frame_t;
+
+typedef struct {
+    frame_t *items;
+    size_t   count;
+    size_t   capacity;
+    uint8_t *data;
+    size_t   data_size;
+    size_t   data_capacity;
+} frames_t;
+
+typedef struct {
+    e2e_table_t    *table;
+    const frames_t *frames;
+    uint8_t        *statuses;
+    uint32_t        thread;
+    uint32_t        thread_count;
+} worker_t;
+
+static void *grow(void *items, size_t *capacity, size_t needed, size_t itemsize)
+{
+    if (needed <= *capacity) {
+        return items;
+    }
+    size_t new_capacity = (*capacity == 0) ? 1024u : *capacity;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    void *new_items = realloc(items, new_capacity * itemsize);
+    if (new_items == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(2);
+    }
+    *capacity = new_capacity;
+    return new_items;
+}
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// Decode count bytes of hex digits, returns false if text is not exactly that long
+static bool parse_hex_bytes(const char *text, size_t text_len, uint8_t *target, size_t count)
+{
+    if (text_len != 2 * count) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        int high = hex_value(text[2 * i]);
+        int low  = hex_value(text[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        target[i] = (uint8_t)((high << 4) | low);
+    }
+    return true;
+}
+
+// Parse a decimal, 0x hex or 0 octal number up to max
+static bool parse_number(const char *text, uint64_t max, uint64_t *value)
+{
+    char *end;
+    if (*text == '\0' || *text == '-') {
+        return false;
+    }
+    errno  = 0;
+    *value = strtoull(text, &end, 0);
+    return errno == 0 && *end == '\0' && *value <= max;
+}
+
+static void config_error(const char *path, uint32_t line, const char *message, const char *token)
+{
+    fprintf(stderr, "%s:%u: %s%s%s\n", path, line, message, token ? ": " : "", token ? token : "");
+    exit(2);
+}
+
+// Parse the arguments of e2e.Config, the checks are the same as in Config.__new__()
+static void parse_message(const char *path, uint32_t line, char *text, message_t *message)
+{
+    bool  has_profile      = false;
+    bool  has_data_id_list = false;
+    char *token            = strtok(text, " \t\r\n");
+    memset(message, 0, sizeof(*message));
+    message->config.data_id_mode      = E2E_P01_DATAID_BOTH;
+    message->config.max_delta_counter = 1;
+
+    if (!parse_number(token, UINT64_MAX, &message->id)) {
+        config_error(path, line, "invalid message id", token);
+    }
+    while ((token = strtok(NULL, " \t\r\n")) != NULL) {
+        char *value = strchr(token, '=');
+        if (value == NULL) {
+            config_error(path, line, "expected key=value", token);
+        }
+        *value++        = '\0';
+        uint64_t number = 0;
+        bool     valid  = true;
+        if (strcmp(token, "data_id_list") == 0) {
+            uint8_t *list    = message->config.data_id_list;
+            valid            = parse_hex_bytes(value, strlen(value), list, P02DATAID_LIST_LEN);
+            has_data_id_list = true;
+        }
+        else if (strcmp(token, "profile") == 0) {
+            valid                   = parse_number(value, UINT8_MAX, &number);
+            message->config.profile = (uint8_t)number;
+            has_profile             = true;
+        }
+        else if (strcmp(token, "data_id") == 0) {
+            valid                   = parse_number(value, UINT32_MAX, &number);
+            message->config.data_id = (uint32_t)number;
+        }
+        else if (strcmp(token, "length") == 0) {
+            valid                  = parse_number(value, UINT32_MAX, &number);
+            message->config.length = (uint32_t)number;
+        }
+        else if (strcmp(token, "offset") == 0) {
+            valid                  = parse_number(value, UINT32_MAX, &number);
+            message->config.offset = (uint32_t)number;
+        }
+        else if (strcmp(token, "data_id_mode") == 0) {
+            valid                        = parse_number(value, UINT8_MAX, &number);
+            message->config.data_id_mode = (uint8_t)number;
+        }
+        else if (strcmp(token, "max_delta_counter") == 0) {
+            valid                             = parse_number(value, UINT32_MAX, &number);
+            message->config.max_delta_counter = (uint32_t)number;
+        }
+        else {
+            config_error(path, line, "unknown key", token);
+        }
+        if (!valid) {
+            config_error(path, line, "invalid value of", token);
+        }
+    }
+    if (!has_profile) {
+        config_error(path, line, "missing profile=", NULL);
+    }
+    if (message->config.profile == 2 && !has_data_id_list) {
+        config_error(path, line, "Profile 2 requires argument \"data_id_list\".", NULL);
+    }
+    const char *error = e2e_config_error(&message->config);
+    if (error != NULL) {
+        config_error(path, line, error, NULL);
+    }
+}
+
+static void read_config(const char *path, messages_t *messages)
+{
+    char     text[MAX_LINE];
+    uint32_t line = 0;
+    FILE    *file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        exit(2);
+    }
+    while (fgets(text, sizeof(text), file) != NULL) {
+        ++line;
+        char *comment = strchr(text, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+        if (strspn(text, " \t\r\n") == strlen(text)) {
+            continue;
+        }
+        size_t needed   = (size_t)messages->count + 1u;
+        messages->items = grow(messages->items, &messages->capacity, needed, sizeof(message_t));
+        parse_message(path, line, text, &messages->items[messages->count++]);
+    }
+    fclose(file);
+}
+
+// Parse "(time) interface ID#DATA" or "(time) interface ID##<flags>DATA" into
+// frame and frames->data, returns false for anything else, e.g. remote frames.
+static bool parse_frame(char *text, frames_t *frames, frame_t *frame)
+{
+    char *token = strtok(text, " \t\r\n");
+    if (token != NULL && token[0] == '(') {
+        token = strtok(NULL, " \t\r\n"); // interface
+        token = (token != NULL) ? strtok(NULL, " \t\r\n") : NULL;
+    }
+    if (token == NULL) {
+        return false;
+    }
+    char *data = strchr(token, '#');
+    if (data == NULL || data == token || data - token > 8) {
+        return false;
+    }
+    *data++   = '\0';
+    frame->id = 0;
+    for (const char *c = token; *c != '\0'; ++c) {
+        int digit = hex_value(*c);
+        if (digit < 0) {
+            return false;
+        }
+        frame->id = (frame->id << 4) | (uint64_t)digit;
+    }
+    if (*data == '#') {
+        // CAN FD, one hex digit of flags precedes the data
+        if (hex_value(data[1]) < 0) {
+            return false;
+        }
+        data += 2;
+    }
+    else if (*data == 'R') {
+        return false;
+    }
+    size_t length = strlen(data);
+    if (length % 2 != 0 || length / 2 > MAX_FRAME_SIZE) {
+        return false;
+    }
+    frames->data = grow(frames->data, &frames->data_capacity, frames->data_size + length / 2, 1);
+    if (!parse_hex_bytes(data, length, frames->data + frames->data_size, length / 2)) {
+        return false;
+    }
+    frame->data_offset  = frames->data_size;
+    frame->length       = (uint32_t)(length / 2);
+    frames->data_size  += length / 2;
+    return true;
+}
+
+static void read_capture(const char *path, uint32_t file_index, e2e_table_t *table, frames_t *frames)
+{
+    char     text[MAX_LINE];
+    uint32_t line          = 0;
+    uint32_t ignored       = 0;
+    uint32_t first_ignored = 0;
+    FILE    *file          = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        exit(2);
+    }
+    while (fgets(text, sizeof(text), file) != NULL) {
+        ++line;
+        size_t length = strlen(text);
+        if (length + 1 == sizeof(text) && text[length - 1] != '\n') {
+            // overlong line, skip the rest of it
+            int c;
+            while ((c = fgetc(file)) != EOF && c != '\n') {
+            }
+            first_ignored = first_ignored ? first_ignored : line;
+            ++ignored;
+            continue;
+        }
+        if (strspn(text, " \t\r\n") == length) {
+            continue;
+        }
+        frames->items = grow(frames->items, &frames->capacity, frames->count + 1, sizeof(frame_t));
+        frame_t *frame = &frames->items[frames->count];
+        if (!parse_frame(text, frames, frame)) {
+            first_ignored = first_ignored ? first_ignored : line;
+            ++ignored;
+            continue;
+        }
+        frame->index = e2e_table_find(table, frame->id);
+        frame->file  = file_index;
+        frame->line  = line;
+        ++frames->count;
+    }
+    if (ferror(file)) {
+        fprintf(stderr, "%s: read error\n", path);
+        exit(2);
+    }
+    fclose(file);
+    if (ignored > 0) {
+        fprintf(stderr,
+                "%s:%u: ignored %u lines which are no candump data frames\n",
+                path,
+                first_ignored,
+                ignored);
+    }
+}
+
+static void check_frames(worker_t *worker)
+{
+    const frames_t *frames = worker->frames;
+    for (size_t i = 0; i < frames->count; ++i) {
+        const frame_t *frame = &frames->items[i];
+        if (frame->index >= 0 && (uint64_t)frame->index % worker->thread_count == worker->thread) {
+            worker->statuses[i] = e2e_table_check(worker->table,
+                                                  (uint32_t)frame->index,
+                                                  0,
+                                                  frames->data + frame->data_offset,
+                                                  frame->length);
+        }
+    }
+}
+
+#ifdef _WIN32
+typedef HANDLE thread_t;
+
+static DWORD WINAPI thread_main(LPVOID arg)
+{
+    check_frames((worker_t *)arg);
+    return 0;
+}
+
+static bool thread_start(thread_t *thread, worker_t *worker)
+{
+    *thread = CreateThread(NULL, 0, thread_main, worker, 0, NULL);
+    return *thread != NULL;
+}
+
+static void thread_join(thread_t thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+static uint32_t cpu_count(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (uint32_t)info.dwNumberOfProcessors;
+}
+#else
+typedef pthread_t thread_t;
+
+static void *thread_main(void *arg)
+{
+    check_frames((worker_t *)arg);
+    return NULL;
+}
+
+static bool thread_start(thread_t *thread, worker_t *worker)
+{
+    return pthread_create(thread, NULL, thread_main, worker) == 0;
+}
+
+static void thread_join(thread_t thread) { pthread_join(thread, NULL); }
+
+static uint32_t cpu_count(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (uint32_t)count : 1u;
+}
+#endif
+
+static double seconds(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static const char *result_name(e2e_result_t result)
+{
+    switch (result) {
+        case E2E_RESULT_OK:
+            return "ok";
+        case E2E_RESULT_BAD_FRAME:
+            return "frame too short";
+        case E2E_RESULT_LENGTH_MISMATCH:
+            return "length mismatch";
+        case E2E_RESULT_DATA_ID_MISMATCH:
+            return "data id mismatch";
+        case E2E_RESULT_COUNTER_RANGE:
+            return "counter out of range";
+        default:
+            return "crc mismatch";
+    }
+}
+
+static int status_column(uint8_t status)
+{
+    switch (status) {
+        case E2E_STATUS_OK:
+            return COLUMN_OK;
+        case E2E_STATUS_OKSOMELOST:
+            return COLUMN_OKSOMELOST;
+        case E2E_STATUS_REPEATED:
+            return COLUMN_REPEATED;
+        case E2E_STATUS_WRONGSEQUENCE:
+            return COLUMN_WRONGSEQUENCE;
+        default:
+            return COLUMN_ERROR;
+    }
+}
+
+static uint32_t frame_counter(const e2e_config_t *config, const frames_t *frames, const frame_t *frame)
+{
+    uint32_t counter = 0;
+    e2e_config_check(config, frames->data + frame->data_offset, frame->length, &counter);
+    return counter;
+}
+
+// Print one line per failed frame in capture order, the counters of the
+// sequence errors are read again from the frame and its predecessor.
+static uint64_t report_errors(const messages_t *messages,
+                              const frames_t   *frames,
+                              const uint8_t    *statuses,
+                              char *const      *paths,
+                              uint64_t          max_errors)
+{
+    static const char *const names[COLUMN_COUNT] = {
+        "OK", "OKSOMELOST", "REPEATED", "WRONGSEQUENCE", "ERROR"};
+    uint64_t errors     = 0;
+    size_t  *last_valid = malloc(sizeof(size_t) * (messages->count + 1u));
+    if (last_valid == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(2);
+    }
+    for (uint32_t m = 0; m < messages->count; ++m) {
+        last_valid[m] = SIZE_MAX;
+    }
+
+    for (size_t i = 0; i < frames->count; ++i) {
+        const frame_t *frame = &frames->items[i];
+        if (frame->index < 0) {
+            continue;
+        }
+        const e2e_config_t *config = &messages->items[frame->index].config;
+        int                 column = status_column(statuses[i]);
+        if (column >= COLUMN_REPEATED && errors++ < max_errors) {
+            printf("%s:%u: 0x%llx %s",
+                   paths[frame->file],
+                   frame->line,
+                   (unsigned long long)frame->id,
+                   names[column]);
+            if (column == COLUMN_ERROR) {
+                const uint8_t *data = frames->data + frame->data_offset;
+                printf(" (%s)\n", result_name(e2e_config_check(config, data, frame->length, NULL)));
+            }
+            else {
+                printf(" (counter %u, previous %u)\n",
+                       frame_counter(config, frames, frame),
+                       frame_counter(config, frames, &frames->items[last_valid[frame->index]]));
+            }
+        }
+        if (column != COLUMN_ERROR) {
+            last_valid[frame->index] = i;
+        }
+    }
+    if (errors > max_errors) {
+        printf("... %llu more\n", (unsigned long long)(errors - max_errors));
+    }
+    free(last_valid);
+    return errors;
+}
+
+static void report_summary(const messages_t *messages, const frames_t *frames, const uint8_t *statuses)
+{
+    uint64_t (*counts)[COLUMN_COUNT] = calloc(messages->count + 1u, sizeof(*counts));
+    uint64_t unknown                 = 0;
+    if (counts == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(2);
+    }
+    for (size_t i = 0; i < frames->count; ++i) {
+        if (frames->items[i].index < 0) {
+            ++unknown;
+        }
+        else {
+            ++counts[frames->items[i].index][status_column(statuses[i])];
+        }
+    }
+
+    printf("%-12s %7s %12s %12s %12s %12s %14s %12s\n",
+           "id",
+           "profile",
+           "frames",
+           "ok",
+           "oksomelost",
+           "repeated",
+           "wrongsequence",
+           "error");
+    for (uint32_t m = 0; m < messages->count; ++m) {
+        uint64_t total = 0;
+        for (int c = 0; c < COLUMN_COUNT; ++c) {
+            total += counts[m][c];
+        }
+        printf("0x%-10llx %7u %12llu %12llu %12llu %12llu %14llu %12llu\n",
+               (unsigned long long)messages->items[m].id,
+               (unsigned int)messages->items[m].config.profile,
+               (unsigned long long)total,
+               (unsigned long long)counts[m][COLUMN_OK],
+               (unsigned long long)counts[m][COLUMN_OKSOMELOST],
+               (unsigned long long)counts[m][COLUMN_REPEATED],
+               (unsigned long long)counts[m][COLUMN_WRONGSEQUENCE],
+               (unsigned long long)counts[m][COLUMN_ERROR]);
+    }
+    if (unknown > 0) {
+        printf("%llu frames with unknown id\n", (unsigned long long)unknown);
+    }
+    free(counts);
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-j threads] [-m max_errors] config capture...\n", program);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t    thread_count = cpu_count();
+    uint64_t    max_errors   = UINT64_MAX;
+    messages_t  messages     = {0};
+    frames_t    frames       = {0};
+    e2e_table_t table;
+    uint64_t    number;
+    int         i;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; ++i) {
+        const char *value = (i + 1 < argc) ? argv[i + 1] : "";
+        if (strcmp(argv[i], "-j") == 0 && parse_number(value, MAX_THREADS, &number) && number > 0) {
+            thread_count = (uint32_t)number;
+            ++i;
+        }
+        else if (strcmp(argv[i], "-m") == 0 && parse_number(value, UINT64_MAX, &number)) {
+            max_errors = number;
+            ++i;
+        }
+        else {
+            usage(argv[0]);
+        }
+    }
+    if (argc - i < 2) {
+        usage(argv[0]);
+    }
+
+    read_config(argv[i], &messages);
+    if (e2e_table_create(&table, messages.count) < 0) {
+        fprintf(stderr, "%s: too many messages\n", argv[i]);
+        return 2;
+    }
+    for (uint32_t m = 0; m < messages.count; ++m) {
+        if (e2e_table_insert(&table, m, messages.items[m].id, &messages.items[m].config) < 0) {
+            unsigned long long id = messages.items[m].id;
+            fprintf(stderr, "%s: duplicate message id 0x%llx\n", argv[i], id);
+            return 2;
+        }
+    }
+    char *const *paths = &argv[i + 1];
+    for (int file = 0; file < argc - i - 1; ++file) {
+        read_capture(paths[file], (uint32_t)file, &table, &frames);
+    }
+
+    uint8_t *statuses = calloc(frames.count + 1u, 1);
+    if (statuses == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+    if (thread_count > messages.count) {
+        thread_count = (messages.count > 0) ? messages.count : 1u;
+    }
+    worker_t workers[MAX_THREADS];
+    thread_t threads[MAX_THREADS];
+    // without the slicing tables every crc runs byte by byte
+    Crc_Init();
+    double start = seconds();
+    for (uint32_t t = 0; t < thread_count; ++t) {
+        workers[t] = (worker_t){&table, &frames, statuses, t, thread_count};
+        if (!thread_start(&threads[t], &workers[t])) {
+            fprintf(stderr, "cannot start thread\n");
+            return 2;
+        }
+    }
+    for (uint32_t t = 0; t < thread_count; ++t) {
+        thread_join(threads[t]);
+    }
+    double elapsed = seconds() - start;
+
+    uint64_t errors = report_errors(&messages, &frames, statuses, paths, max_errors);
+    report_summary(&messages, &frames, statuses);
+    printf("%llu frames, %llu failed, checked in %.3f s with %u threads\n",
+           (unsigned long long)frames.count,
+           (unsigned long long)errors,
+           elapsed,
+           thread_count);
+
+    e2e_table_destroy(&table);
+    free(statuses);
+    free(frames.items);
+    free(frames.data);
+    free(messages.items);
+    return (errors > 0) ? 1 : 0;
+}